@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+
+#include "isobus/isobus/isobus_device_descriptor_object_pool.hpp"
+#include "isobus/isobus/isobus_standard_data_description_indices.hpp"
+#include "isobus/utility/to_string.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace isobus;
+
+namespace
+{
+	constexpr std::uint16_t DEVICE_ELEMENT_ID = 1;
+	constexpr std::uint16_t BOOM_ID = 2;
+	constexpr std::uint16_t WIDTH_PRESENTATION_ID = 3;
+	constexpr std::uint16_t FIRST_SECTION_ID = 100;
+	constexpr std::uint16_t OBJECTS_PER_SECTION = 5;
+
+	// Builds a sprayer DDOP with the given number of sections, which is what makes real DDOPs big
+	void build_sprayer_ddop(DeviceDescriptorObjectPool &ddop, std::uint16_t numberOfSections)
+	{
+		ddop.add_device("AgIsoStack++ Benchmark", "1.0.0", "123", "I++1.0", { { 'e', 'n', 0x50, 0x00, 0x55, 0x55, 0xFF } }, std::vector<std::uint8_t>(), 0);
+		ddop.add_device_element("Sprayer", 0, 0, task_controller_object::DeviceElementObject::Type::Device, DEVICE_ELEMENT_ID);
+		ddop.add_device_element("Boom", 1, DEVICE_ELEMENT_ID, task_controller_object::DeviceElementObject::Type::Function, BOOM_ID);
+		ddop.add_device_value_presentation("m", 0, 0.001f, 2, WIDTH_PRESENTATION_ID);
+
+		for (std::uint16_t i = 0; i < numberOfSections; i++)
+		{
+			const std::uint16_t sectionID = FIRST_SECTION_ID + (i * OBJECTS_PER_SECTION);
+			ddop.add_device_element("Section " + isobus::to_string(static_cast<int>(i)), static_cast<std::uint16_t>(i + 2), BOOM_ID, task_controller_object::DeviceElementObject::Type::Section, sectionID);
+			ddop.add_device_property("Offset X", -20, static_cast<std::uint16_t>(DataDescriptionIndex::DeviceElementOffsetX), WIDTH_PRESENTATION_ID, sectionID + 1);
+			ddop.add_device_property("Offset Y", (1067 * i) - 18288, static_cast<std::uint16_t>(DataDescriptionIndex::DeviceElementOffsetY), WIDTH_PRESENTATION_ID, sectionID + 2);
+			ddop.add_device_property("Width", 2 * 1067, static_cast<std::uint16_t>(DataDescriptionIndex::ActualWorkingWidth), WIDTH_PRESENTATION_ID, sectionID + 3);
+			ddop.add_device_process_data("Work State",
+			                             static_cast<std::uint16_t>(DataDescriptionIndex::ActualWorkState),
+			                             task_controller_object::Object::NULL_OBJECT_ID,
+			                             static_cast<std::uint8_t>(task_controller_object::DeviceProcessDataObject::PropertiesBit::MemberOfDefaultSet),
+			                             static_cast<std::uint8_t>(task_controller_object::DeviceProcessDataObject::AvailableTriggerMethods::OnChange),
+			                             sectionID + 4);
+		}
+	}
+} // namespace
+
+// The argument is the number of sections in the DDOP
+static void BM_DDOPGenerateBinary(benchmark::State &state)
+{
+	DeviceDescriptorObjectPool ddop;
+	std::vector<std::uint8_t> binaryDDOP;
+
+	build_sprayer_ddop(ddop, static_cast<std::uint16_t>(state.range(0)));
+
+	for (auto _ : state)
+	{
+		if (!ddop.generate_binary_object_pool(binaryDDOP))
+		{
+			state.SkipWithError("The DDOP is invalid");
+			break;
+		}
+		benchmark::DoNotOptimize(binaryDDOP.data());
+	}
+	state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(binaryDDOP.size()));
+}
+BENCHMARK(BM_DDOPGenerateBinary)->Arg(16)->Arg(256);
+
+static void BM_DDOPDeserializeBinary(benchmark::State &state)
+{
+	std::vector<std::uint8_t> binaryDDOP;
+	{
+		DeviceDescriptorObjectPool ddop;
+		build_sprayer_ddop(ddop, static_cast<std::uint16_t>(state.range(0)));
+		ddop.generate_binary_object_pool(binaryDDOP);
+	}
+
+	for (auto _ : state)
+	{
+		DeviceDescriptorObjectPool ddop;
+		if (!ddop.deserialize_binary_object_pool(binaryDDOP))
+		{
+			state.SkipWithError("The DDOP couldn't be deserialized");
+			break;
+		}
+		benchmark::DoNotOptimize(ddop.size());
+	}
+	state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(binaryDDOP.size()));
+}
+BENCHMARK(BM_DDOPDeserializeBinary)->Arg(16)->Arg(256);
@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+
+#include "isobus/isobus/can_identifier.hpp"
+
+#include <array>
+#include <cstdint>
+
+using namespace isobus;
+
+namespace
+{
+	// A mix of PDU1 and PDU2 identifiers, like a busy bus would have
+	constexpr std::array<std::uint32_t, 8> RAW_IDENTIFIERS = { {
+	  0x18FEF180, // Engine speed, broadcast
+	  0x0CFE4980, // Ground based speed, broadcast
+	  0x18EAFF80, // PGN request to global
+	  0x1CEC2680, // TP connection management, destination specific
+	  0x1CEB2680, // TP data transfer, destination specific
+	  0x18EEFF26, // Address claim
+	  0x19F81452, // NMEA2000 fast packet
+	  0x14E72680 // VT to ECU
+	} };
+} // namespace
+
+static void BM_CANIdentifierDecode(benchmark::State &state)
+{
+	std::size_t index = 0;
+
+	for (auto _ : state)
+	{
+		const CANIdentifier identifier(RAW_IDENTIFIERS[index]);
+		benchmark::DoNotOptimize(identifier.get_parameter_group_number());
+		benchmark::DoNotOptimize(identifier.get_source_address());
+		benchmark::DoNotOptimize(identifier.get_destination_address());
+		benchmark::DoNotOptimize(identifier.get_priority());
+		index = (index + 1) % RAW_IDENTIFIERS.size();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CANIdentifierDecode);
+
+static void BM_CANIdentifierEncode(benchmark::State &state)
+{
+	std::uint8_t sourceAddress = 0;
+
+	for (auto _ : state)
+	{
+		const CANIdentifier identifier(CANIdentifier::Type::Extended, 0xEF00, CANIdentifier::CANPriority::PriorityDefault6, 0x26, sourceAddress);
+		benchmark::DoNotOptimize(identifier.get_identifier());
+		sourceAddress = static_cast<std::uint8_t>((sourceAddress + 1) % 0xFE);
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CANIdentifierEncode);
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include "isobus/isobus/can_network_manager.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace isobus;
+
+namespace
+{
+	constexpr std::size_t FRAMES_PER_UPDATE = 64;
+
+	void count_message(const CANMessage &, void *parent)
+	{
+		(*static_cast<std::uint64_t *>(parent))++;
+	}
+
+	CANMessageFrame create_broadcast_frame(std::uint32_t parameterGroupNumber, std::uint8_t sourceAddress)
+	{
+		CANMessageFrame frame = {};
+		frame.identifier = (6 << 26) | (parameterGroupNumber << 8) | sourceAddress;
+		frame.isExtendedFrame = true;
+		frame.dataLength = 8;
+		for (std::uint8_t i = 0; i < frame.dataLength; i++)
+		{
+			frame.data[i] = i;
+		}
+		return frame;
+	}
+} // namespace
+
+// Frames go through process_receive_can_message_frame into the default network manager's queue,
+// then are dispatched to callbacks by an update, like the hardware interface does.
+// The argument is the number of other PGNs with callbacks registered, to show the cost of the callback lookup.
+static void BM_ReceiveFrameToCallback(benchmark::State &state)
+{
+	const std::uint32_t numberOfOtherCallbacks = static_cast<std::uint32_t>(state.range(0));
+	std::uint64_t messagesReceived = 0;
+	std::vector<CANMessageFrame> frames;
+
+	CANNetworkManager::CANNetwork.initialize();
+	for (std::uint32_t i = 0; i < numberOfOtherCallbacks; i++)
+	{
+		CANNetworkManager::CANNetwork.add_any_control_function_parameter_group_number_callback(0xFF00 + i, count_message, nullptr);
+	}
+	CANNetworkManager::CANNetwork.add_any_control_function_parameter_group_number_callback(0xFEF1, count_message, &messagesReceived);
+
+	for (std::size_t i = 0; i < FRAMES_PER_UPDATE; i++)
+	{
+		frames.push_back(create_broadcast_frame(0xFEF1, static_cast<std::uint8_t>(0x80 + (i % 16))));
+	}
+
+	for (auto _ : state)
+	{
+		for (const auto &frame : frames)
+		{
+			CANNetworkManager::process_receive_can_message_frame(frame);
+		}
+		CANNetworkManager::CANNetwork.update();
+	}
+
+	CANNetworkManager::CANNetwork.remove_any_control_function_parameter_group_number_callback(0xFEF1, count_message, &messagesReceived);
+	for (std::uint32_t i = 0; i < numberOfOtherCallbacks; i++)
+	{
+		CANNetworkManager::CANNetwork.remove_any_control_function_parameter_group_number_callback(0xFF00 + i, count_message, nullptr);
+	}
+
+	if (messagesReceived != state.iterations() * FRAMES_PER_UPDATE)
+	{
+		state.SkipWithError("Not every frame reached the callback");
+	}
+	state.SetItemsProcessed(static_cast<std::int64_t>(messagesReceived));
+}
+BENCHMARK(BM_ReceiveFrameToCallback)->Arg(0)->Arg(16)->Arg(128);
+
+// The same path, but for frames nobody has a callback for, which should be dropped as cheaply as possible
+static void BM_ReceiveUnhandledFrame(benchmark::State &state)
+{
+	std::vector<CANMessageFrame> frames;
+
+	CANNetworkManager::CANNetwork.initialize();
+	for (std::size_t i = 0; i < FRAMES_PER_UPDATE; i++)
+	{
+		frames.push_back(create_broadcast_frame(0xFEF1, static_cast<std::uint8_t>(0x80 + (i % 16))));
+	}
+
+	for (auto _ : state)
+	{
+		for (const auto &frame : frames)
+		{
+			CANNetworkManager::process_receive_can_message_frame(frame);
+		}
+		CANNetworkManager::CANNetwork.update();
+	}
+	state.SetItemsProcessed(state.iterations() * FRAMES_PER_UPDATE);
+}
+BENCHMARK(BM_ReceiveUnhandledFrame);
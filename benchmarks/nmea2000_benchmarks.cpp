@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+
+#include "isobus/isobus/can_message.hpp"
+#include "isobus/isobus/nmea2000_message_definitions.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace isobus;
+using namespace NMEA2000Messages;
+
+namespace
+{
+	CANMessage create_message(std::uint32_t parameterGroupNumber, const std::vector<std::uint8_t> &data)
+	{
+		CANMessage retVal(0);
+		retVal.set_identifier(CANIdentifier(CANIdentifier::Type::Extended, parameterGroupNumber, CANIdentifier::CANPriority::PriorityDefault6, 0xFF, 0x52));
+		retVal.set_data(data.data(), static_cast<std::uint32_t>(data.size()));
+		return retVal;
+	}
+
+	void fill_gnss_position_data(GNSSPositionData &message)
+	{
+		message.set_sequence_id(5);
+		message.set_position_date(19551);
+		message.set_position_time(86400);
+		message.set_latitude(-72057594037298808);
+		message.set_longitude(720575);
+		message.set_altitude(5820000000);
+		message.set_type_of_system(GNSSPositionData::TypeOfSystem::GPSPlusSBASPlusGLONASS);
+		message.set_gnss_method(GNSSPositionData::GNSSMethod::RTKFixedInteger);
+		message.set_integrity(GNSSPositionData::Integrity::Safe);
+		message.set_number_of_space_vehicles(12);
+		message.set_horizontal_dilution_of_precision(-10);
+		message.set_positional_dilution_of_precision(-894);
+		message.set_geoidal_separation(10000);
+		message.set_number_of_reference_stations(1);
+		message.set_reference_station(0, 4, GNSSPositionData::TypeOfSystem::Galileo, 100);
+	}
+} // namespace
+
+static void BM_NMEA2000PositionRapidUpdateSerialize(benchmark::State &state)
+{
+	PositionRapidUpdate message(nullptr);
+	std::vector<std::uint8_t> buffer;
+	std::int32_t latitude = 0;
+
+	for (auto _ : state)
+	{
+		message.set_latitude(latitude++);
+		message.set_longitude(-latitude);
+		message.serialize(buffer);
+		benchmark::DoNotOptimize(buffer.data());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NMEA2000PositionRapidUpdateSerialize);
+
+static void BM_NMEA2000PositionRapidUpdateDeserialize(benchmark::State &state)
+{
+	constexpr std::uint32_t POSITION_RAPID_UPDATE_PGN = 0x1F801;
+	PositionRapidUpdate message(nullptr);
+	std::vector<std::uint8_t> buffer;
+
+	message.set_latitude(123456789);
+	message.set_longitude(-987654321);
+	message.serialize(buffer);
+	const CANMessage receivedMessage = create_message(POSITION_RAPID_UPDATE_PGN, buffer);
+
+	for (auto _ : state)
+	{
+		PositionRapidUpdate decodedMessage(nullptr);
+		benchmark::DoNotOptimize(decodedMessage.deserialize(receivedMessage));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NMEA2000PositionRapidUpdateDeserialize);
+
+static void BM_NMEA2000GNSSPositionDataSerialize(benchmark::State &state)
+{
+	GNSSPositionData message(nullptr);
+	std::vector<std::uint8_t> buffer;
+	std::uint8_t sequenceID = 0;
+
+	fill_gnss_position_data(message);
+	for (auto _ : state)
+	{
+		message.set_sequence_id(sequenceID++);
+		message.serialize(buffer);
+		benchmark::DoNotOptimize(buffer.data());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NMEA2000GNSSPositionDataSerialize);
+
+static void BM_NMEA2000GNSSPositionDataDeserialize(benchmark::State &state)
+{
+	constexpr std::uint32_t GNSS_POSITION_DATA_PGN = 0x1F805;
+	GNSSPositionData message(nullptr);
+	std::vector<std::uint8_t> buffer;
+
+	fill_gnss_position_data(message);
+	message.serialize(buffer);
+	const CANMessage receivedMessage = create_message(GNSS_POSITION_DATA_PGN, buffer);
+
+	for (auto _ : state)
+	{
+		GNSSPositionData decodedMessage(nullptr);
+		benchmark::DoNotOptimize(decodedMessage.deserialize(receivedMessage));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_NMEA2000GNSSPositionDataDeserialize);
@@ -0,0 +1,195 @@
+#include <benchmark/benchmark.h>
+
+#include "isobus/isobus/can_internal_control_function.hpp"
+#include "isobus/isobus/can_network_manager.hpp"
+#include "isobus/isobus/can_partnered_control_function.hpp"
+#include "isobus/isobus/nmea2000_fast_packet_protocol.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace isobus;
+
+namespace
+{
+	// Updates allowed for one message to get across before a benchmark gives up, so a regression can't hang the suite
+	constexpr std::uint32_t MAX_UPDATES_PER_MESSAGE = 100000;
+
+	bool forward_frame_to_network(const CANMessageFrame &frame, void *parentPointer)
+	{
+		static_cast<CANNetworkManager *>(parentPointer)->on_can_frame_received(frame);
+		return true;
+	}
+
+	//================================================================================================
+	/// @brief Two network managers wired back to back, each with a claimed internal control function
+	/// and the other one as its partner. Nothing is threaded, so the benchmarks measure only the
+	/// protocol work done in each update.
+	//================================================================================================
+	struct BackToBackNetworks
+	{
+		BackToBackNetworks()
+		{
+			constexpr std::uint64_t RAW_NAME_A = 0xA00083000FE000B1;
+			constexpr std::uint64_t RAW_NAME_B = 0xA00083000FE000B2;
+
+			// Whole ETP windows arrive between updates
+			networkA.get_configuration().set_receive_queue_depth(1024);
+			networkB.get_configuration().set_receive_queue_depth(1024);
+			networkA.set_can_frame_transmit_callback(forward_frame_to_network, &networkB);
+			networkB.set_can_frame_transmit_callback(forward_frame_to_network, &networkA);
+			networkA.initialize();
+			networkB.initialize();
+
+			internalECUA = InternalControlFunction::create(NAME(RAW_NAME_A), 0x71, 0, networkA);
+			internalECUB = InternalControlFunction::create(NAME(RAW_NAME_B), 0x72, 0, networkB);
+			partnerOnA = PartneredControlFunction::create(0, { NAMEFilter(NAME::NAMEParameters::IdentityNumber, RAW_NAME_B & 0x1FFFFF) }, networkA);
+			partnerOnB = PartneredControlFunction::create(0, { NAMEFilter(NAME::NAMEParameters::IdentityNumber, RAW_NAME_A & 0x1FFFFF) }, networkB);
+
+			for (std::uint32_t i = 0; (i < 200) && !get_is_ready(); i++)
+			{
+				update();
+				std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			}
+		}
+
+		~BackToBackNetworks()
+		{
+			partnerOnA->destroy();
+			partnerOnB->destroy();
+			internalECUA->destroy();
+			internalECUB->destroy();
+		}
+
+		bool get_is_ready() const
+		{
+			return internalECUA->get_address_valid() &&
+			  internalECUB->get_address_valid() &&
+			  partnerOnA->get_address_valid() &&
+			  partnerOnB->get_address_valid();
+		}
+
+		void update()
+		{
+			networkA.update();
+			networkB.update();
+		}
+
+		CANNetworkManager networkA;
+		CANNetworkManager networkB;
+		std::shared_ptr<InternalControlFunction> internalECUA;
+		std::shared_ptr<InternalControlFunction> internalECUB;
+		std::shared_ptr<PartneredControlFunction> partnerOnA;
+		std::shared_ptr<PartneredControlFunction> partnerOnB;
+	};
+
+	BackToBackNetworks &get_networks()
+	{
+		// Address claiming takes a while, so every benchmark shares one pair of networks
+		static BackToBackNetworks networks;
+		return networks;
+	}
+
+	struct TransferState
+	{
+		bool received = false;
+		bool transmitted = false;
+		bool successful = false;
+	};
+
+	void message_received(const CANMessage &, void *parent)
+	{
+		static_cast<TransferState *>(parent)->received = true;
+	}
+
+	void message_transmitted(std::uint32_t, std::uint32_t, std::shared_ptr<InternalControlFunction>, std::shared_ptr<ControlFunction>, bool successful, void *parent)
+	{
+		static_cast<TransferState *>(parent)->transmitted = true;
+		static_cast<TransferState *>(parent)->successful = successful;
+	}
+
+	std::vector<std::uint8_t> create_payload(std::size_t size)
+	{
+		std::vector<std::uint8_t> retVal(size);
+		for (std::size_t i = 0; i < size; i++)
+		{
+			retVal[i] = static_cast<std::uint8_t>(i);
+		}
+		return retVal;
+	}
+} // namespace
+
+// Destination specific messages from A to B, segmented and reassembled by TP (CMDT) up to 1785 bytes, and by ETP above that
+static void BM_DestinationSpecificTransfer(benchmark::State &state)
+{
+	BackToBackNetworks &networks = get_networks();
+	const std::vector<std::uint8_t> payload = create_payload(static_cast<std::size_t>(state.range(0)));
+	TransferState transfer;
+
+	if (!networks.get_is_ready())
+	{
+		state.SkipWithError("Address claiming failed");
+		return;
+	}
+	networks.partnerOnB->add_parameter_group_number_callback(0xEF00, message_received, &transfer);
+
+	for (auto _ : state)
+	{
+		transfer = TransferState();
+		networks.networkA.send_can_message(0xEF00, payload.data(), static_cast<std::uint32_t>(payload.size()), networks.internalECUA, networks.partnerOnA, CANIdentifier::CANPriority::PriorityLowest7, message_transmitted, &transfer);
+
+		// Wait for the sender to see the end of message acknowledgement too, so its session is finished
+		for (std::uint32_t i = 0; (i < MAX_UPDATES_PER_MESSAGE) && !(transfer.received && transfer.transmitted); i++)
+		{
+			networks.update();
+		}
+
+		if (!transfer.received || !transfer.successful)
+		{
+			state.SkipWithError("The message didn't get across");
+			break;
+		}
+	}
+	networks.partnerOnB->remove_parameter_group_number_callback(0xEF00, message_received, &transfer);
+	state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(payload.size()));
+}
+BENCHMARK(BM_DestinationSpecificTransfer)->Arg(100)->Arg(1785)->Arg(16384)->Arg(262144);
+
+// Broadcast NMEA2000 fast packet messages from A to B
+static void BM_FastPacketTransfer(benchmark::State &state)
+{
+	constexpr std::uint32_t GNSS_POSITION_DATA_PGN = 0x1F805;
+	BackToBackNetworks &networks = get_networks();
+	const std::vector<std::uint8_t> payload = create_payload(static_cast<std::size_t>(state.range(0)));
+	TransferState transfer;
+
+	if (!networks.get_is_ready())
+	{
+		state.SkipWithError("Address claiming failed");
+		return;
+	}
+	networks.networkB.get_fast_packet_protocol().register_multipacket_message_callback(GNSS_POSITION_DATA_PGN, message_received, &transfer);
+
+	for (auto _ : state)
+	{
+		transfer = TransferState();
+		networks.networkA.get_fast_packet_protocol().send_multipacket_message(GNSS_POSITION_DATA_PGN, payload.data(), static_cast<std::uint8_t>(payload.size()), networks.internalECUA, nullptr, CANIdentifier::CANPriority::PriorityLowest7, message_transmitted, &transfer);
+
+		for (std::uint32_t i = 0; (i < MAX_UPDATES_PER_MESSAGE) && !(transfer.received && transfer.transmitted); i++)
+		{
+			networks.update();
+		}
+
+		if (!transfer.received || !transfer.successful)
+		{
+			state.SkipWithError("The message didn't get across");
+			break;
+		}
+	}
+	networks.networkB.get_fast_packet_protocol().remove_multipacket_message_callback(GNSS_POSITION_DATA_PGN, message_received, &transfer);
+	state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(payload.size()));
+}
+BENCHMARK(BM_FastPacketTransfer)->Arg(47)->Arg(223);
@@ -0,0 +1,309 @@
+#include <benchmark/benchmark.h>
+
+#include "isobus/hardware_integration/can_hardware_interface.hpp"
+#include "isobus/hardware_integration/virtual_can_plugin.hpp"
+#include "isobus/isobus/can_internal_control_function.hpp"
+#include "isobus/isobus/can_network_manager.hpp"
+#include "isobus/isobus/can_partnered_control_function.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace isobus;
+
+namespace
+{
+	constexpr char VIRTUAL_CHANNEL_NAME[] = "isobus_benchmarks";
+	constexpr char FAN_OUT_CHANNEL_NAME[] = "isobus_benchmarks_fan_out";
+	constexpr std::uint64_t RAW_NAME_A = 0xA00083000FE000C1;
+	constexpr std::uint64_t RAW_NAME_B = 0xA00083000FE000C2;
+
+	//================================================================================================
+	/// @brief A second stack on the virtual bus, with its own network manager and its own thread
+	/// reading frames and updating it, like an ECU in a simulation would have
+	//================================================================================================
+	class VirtualBusStack
+	{
+	public:
+		VirtualBusStack() :
+		  plugin(VIRTUAL_CHANNEL_NAME)
+		{
+			network.set_can_frame_transmit_callback(transmit_frame, &plugin);
+			network.initialize();
+			plugin.open();
+			running = true;
+			thread = std::thread([this]() { run(); });
+		}
+
+		~VirtualBusStack()
+		{
+			running = false;
+			thread.join();
+			plugin.close();
+		}
+
+		CANNetworkManager network; ///< The second stack's network manager
+
+	private:
+		static bool transmit_frame(const CANMessageFrame &frame, void *parentPointer)
+		{
+			return static_cast<VirtualCANPlugin *>(parentPointer)->write_frame(frame);
+		}
+
+		void run()
+		{
+			constexpr std::size_t MAX_FRAMES_PER_UPDATE = 64;
+			CANMessageFrame frame = {};
+
+			while (running)
+			{
+				for (std::size_t i = 0; (i < MAX_FRAMES_PER_UPDATE) && plugin.read_frame(frame, 1); i++)
+				{
+					frame.channel = 0;
+					network.on_can_frame_received(frame);
+				}
+				network.update();
+			}
+		}
+
+		VirtualCANPlugin plugin; ///< This stack's connection to the virtual bus
+		std::thread thread; ///< Reads frames and updates the network manager
+		std::atomic_bool running = { false }; ///< If `true`, the thread keeps running
+	};
+
+	//================================================================================================
+	/// @brief The default stack on the hardware interface and a second stack, both on the same
+	/// virtual bus, each with a claimed internal control function and the other one as its partner
+	//================================================================================================
+	class TwoStacks
+	{
+	public:
+		TwoStacks()
+		{
+			CANNetworkManager::CANNetwork.initialize();
+			CANHardwareInterface::set_number_of_can_channels(1);
+			CANHardwareInterface::assign_can_channel_frame_handler(0, std::make_shared<VirtualCANPlugin>(VIRTUAL_CHANNEL_NAME));
+			CANHardwareInterface::start();
+			otherStack.reset(new VirtualBusStack());
+
+			internalECUA = InternalControlFunction::create(NAME(RAW_NAME_A), 0x81, 0);
+			partnerOnA = PartneredControlFunction::create(0, { NAMEFilter(NAME::NAMEParameters::IdentityNumber, RAW_NAME_B & 0x1FFFFF) });
+			internalECUB = InternalControlFunction::create(NAME(RAW_NAME_B), 0x82, 0, otherStack->network);
+			partnerOnB = PartneredControlFunction::create(0, { NAMEFilter(NAME::NAMEParameters::IdentityNumber, RAW_NAME_A & 0x1FFFFF) }, otherStack->network);
+
+			for (std::uint32_t i = 0; (i < 200) && !get_is_ready(); i++)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			}
+		}
+
+		~TwoStacks()
+		{
+			CANHardwareInterface::stop();
+			partnerOnA->destroy();
+			partnerOnB->destroy();
+			internalECUA->destroy();
+			internalECUB->destroy();
+		}
+
+		bool get_is_ready() const
+		{
+			return internalECUA->get_address_valid() &&
+			  internalECUB->get_address_valid() &&
+			  partnerOnA->get_address_valid() &&
+			  partnerOnB->get_address_valid();
+		}
+
+		// Declared first, so it outlives the control functions that refer back to its network manager
+		std::unique_ptr<VirtualBusStack> otherStack;
+		std::shared_ptr<InternalControlFunction> internalECUA;
+		std::shared_ptr<InternalControlFunction> internalECUB;
+		std::shared_ptr<PartneredControlFunction> partnerOnA;
+		std::shared_ptr<PartneredControlFunction> partnerOnB;
+	};
+
+	//================================================================================================
+	/// @brief Plugins that keep reading everything on the fan-out channel, each in its own thread
+	//================================================================================================
+	class FanOutReaders
+	{
+	public:
+		explicit FanOutReaders(std::size_t numberOfReaders)
+		{
+			running = true;
+			for (std::size_t i = 0; i < numberOfReaders; i++)
+			{
+				plugins.emplace_back(new VirtualCANPlugin(FAN_OUT_CHANNEL_NAME));
+				plugins.back()->open();
+			}
+			for (auto &plugin : plugins)
+			{
+				VirtualCANPlugin *reader = plugin.get();
+				threads.emplace_back([this, reader]() {
+					CANMessageFrame frames[64];
+					while (running)
+					{
+						reader->read_frames(frames, 64);
+					}
+				});
+			}
+		}
+
+		~FanOutReaders()
+		{
+			running = false;
+			for (auto &plugin : plugins)
+			{
+				plugin->close();
+			}
+			for (auto &thread : threads)
+			{
+				thread.join();
+			}
+		}
+
+	private:
+		std::vector<std::unique_ptr<VirtualCANPlugin>> plugins; ///< The reading plugins
+		std::vector<std::thread> threads; ///< One thread per reading plugin
+		std::atomic_bool running = { false }; ///< If `true`, the threads keep reading
+	};
+
+	struct TransferState
+	{
+		std::atomic<std::uint32_t> messagesReceived = { 0 };
+		std::atomic_bool transmitted = { false };
+		std::atomic_bool successful = { false };
+	};
+
+	void message_received(const CANMessage &, void *parent)
+	{
+		static_cast<TransferState *>(parent)->messagesReceived++;
+	}
+
+	void message_transmitted(std::uint32_t, std::uint32_t, std::shared_ptr<InternalControlFunction>, std::shared_ptr<ControlFunction>, bool successful, void *parent)
+	{
+		static_cast<TransferState *>(parent)->successful = successful;
+		static_cast<TransferState *>(parent)->transmitted = true;
+	}
+
+	bool wait_for(const std::function<bool()> &condition)
+	{
+		const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+		while (!condition() && (std::chrono::steady_clock::now() < timeout))
+		{
+			std::this_thread::yield();
+		}
+		return condition();
+	}
+} // namespace
+
+// Single frame broadcasts from the default stack, through both hardware layers, to a callback on the other stack
+static void BM_TwoStacksBroadcastFrames(benchmark::State &state)
+{
+	constexpr std::uint32_t MESSAGES_PER_ITERATION = 100;
+	const std::uint8_t data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	TwoStacks stacks;
+	TransferState transfer;
+
+	if (!stacks.get_is_ready())
+	{
+		state.SkipWithError("Address claiming failed");
+		return;
+	}
+	stacks.otherStack->network.add_any_control_function_parameter_group_number_callback(0xFEF1, message_received, &transfer);
+
+	for (auto _ : state)
+	{
+		transfer.messagesReceived = 0;
+		for (std::uint32_t i = 0; i < MESSAGES_PER_ITERATION; i++)
+		{
+			CANNetworkManager::CANNetwork.send_can_message(0xFEF1, data, sizeof(data), stacks.internalECUA);
+		}
+
+		if (!wait_for([&transfer]() { return transfer.messagesReceived >= MESSAGES_PER_ITERATION; }))
+		{
+			state.SkipWithError("Not every message got across");
+			break;
+		}
+	}
+	stacks.otherStack->network.remove_any_control_function_parameter_group_number_callback(0xFEF1, message_received, &transfer);
+	state.SetItemsProcessed(state.iterations() * MESSAGES_PER_ITERATION);
+}
+BENCHMARK(BM_TwoStacksBroadcastFrames)->Iterations(100)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Destination specific messages from the default stack to the other one, over TP (CMDT) or ETP depending on the size
+static void BM_TwoStacksTransfer(benchmark::State &state)
+{
+	std::vector<std::uint8_t> payload(static_cast<std::size_t>(state.range(0)));
+	TwoStacks stacks;
+	TransferState transfer;
+
+	if (!stacks.get_is_ready())
+	{
+		state.SkipWithError("Address claiming failed");
+		return;
+	}
+	for (std::size_t i = 0; i < payload.size(); i++)
+	{
+		payload[i] = static_cast<std::uint8_t>(i);
+	}
+	stacks.partnerOnB->add_parameter_group_number_callback(0xEF00, message_received, &transfer);
+
+	for (auto _ : state)
+	{
+		transfer.messagesReceived = 0;
+		transfer.transmitted = false;
+		CANNetworkManager::CANNetwork.send_can_message(0xEF00, payload.data(), static_cast<std::uint32_t>(payload.size()), stacks.internalECUA, stacks.partnerOnA, CANIdentifier::CANPriority::PriorityLowest7, message_transmitted, &transfer);
+
+		if (!wait_for([&transfer]() { return (0 != transfer.messagesReceived) && transfer.transmitted; }) ||
+		    !transfer.successful)
+		{
+			state.SkipWithError("The message didn't get across");
+			break;
+		}
+	}
+	stacks.partnerOnB->remove_parameter_group_number_callback(0xEF00, message_received, &transfer);
+	state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(payload.size()));
+}
+BENCHMARK(BM_TwoStacksTransfer)->Arg(1785)->Arg(65536)->Iterations(20)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// A 1 MB ETP transfer between the two stacks, like a large VT object pool upload, with fewer iterations since each one takes a while
+static void BM_TwoStacksLargeTransfer(benchmark::State &state)
+{
+	BM_TwoStacksTransfer(state);
+}
+BENCHMARK(BM_TwoStacksLargeTransfer)->Arg(1048576)->Iterations(3)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Every benchmark thread writes from its own plugin, to a channel that 4 other plugins are reading, like a simulation with many virtual ECUs
+static void BM_VirtualCANFanOut(benchmark::State &state)
+{
+	static std::unique_ptr<FanOutReaders> readers;
+	CANMessageFrame frame = {};
+	frame.identifier = 0x18FEF100 | static_cast<std::uint32_t>(state.thread_index());
+	frame.isExtendedFrame = true;
+	frame.dataLength = 8;
+
+	if (0 == state.thread_index())
+	{
+		readers.reset(new FanOutReaders(4));
+	}
+	VirtualCANPlugin writer(FAN_OUT_CHANNEL_NAME);
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(writer.write_frame(frame));
+	}
+	state.SetItemsProcessed(state.iterations());
+
+	if (0 == state.thread_index())
+	{
+		readers.reset();
+	}
+}
+BENCHMARK(BM_VirtualCANFanOut)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
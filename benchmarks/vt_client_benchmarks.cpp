@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include "isobus/isobus/can_internal_control_function.hpp"
+#include "isobus/isobus/can_partnered_control_function.hpp"
+#include "isobus/isobus/isobus_virtual_terminal_client.hpp"
+#include "isobus/utility/iop_file_interface.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace isobus;
+
+namespace
+{
+	// Exposes the pool scaling, and stands in for the capabilities a VT server would report
+	class BenchmarkVTClient : public VirtualTerminalClient
+	{
+	public:
+		BenchmarkVTClient(std::shared_ptr<PartneredControlFunction> partner, std::shared_ptr<InternalControlFunction> clientSource) :
+		  VirtualTerminalClient(partner, clientSource)
+		{
+			xPixels = 800;
+			yPixels = 800;
+			softKeyXAxisPixels = 120;
+			softKeyYAxisPixels = 100;
+			smallFontSizesBitfield = 0xFF;
+			largeFontSizesBitfield = 0xFF;
+		}
+
+		bool benchmark_scale_object_pools()
+		{
+			return scale_object_pools();
+		}
+	};
+} // namespace
+
+// Scales the example VT3 object pool, designed for a 480px data mask, up to an 800px one
+static void BM_VTScaleObjectPools(benchmark::State &state)
+{
+	const std::vector<std::uint8_t> objectPool = IOPFileInterface::read_iop_file(ISOBUS_BENCHMARK_SOURCE_DIR "/examples/virtual_terminal/version3_object_pool/VT3TestPool.iop");
+
+	if (objectPool.empty())
+	{
+		state.SkipWithError("Unable to load the example object pool");
+		return;
+	}
+
+	NAME clientNAME(0);
+	clientNAME.set_arbitrary_address_capable(true);
+	clientNAME.set_function_code(static_cast<std::uint8_t>(NAME::Function::OilSystemMonitor));
+	clientNAME.set_identity_number(0xBE);
+	auto internalECU = InternalControlFunction::create(clientNAME, 0x26, 0);
+	auto vtPartner = PartneredControlFunction::create(0, { NAMEFilter(NAME::NAMEParameters::FunctionCode, static_cast<std::uint8_t>(NAME::Function::VirtualTerminal)) });
+	{
+		BenchmarkVTClient client(vtPartner, internalECU);
+		client.set_object_pool(0, VirtualTerminalClient::VTVersion::Version3, &objectPool);
+		client.set_object_pool_scaling(0, 480, 80);
+
+		for (auto _ : state)
+		{
+			// Each call starts again from a copy of the original pool
+			if (!client.benchmark_scale_object_pools())
+			{
+				state.SkipWithError("Scaling the object pool failed");
+				break;
+			}
+		}
+	}
+	state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(objectPool.size()));
+
+	vtPartner->destroy();
+	internalECU->destroy();
+}
+BENCHMARK(BM_VTScaleObjectPools);
@@ -22,6 +22,10 @@
 #include "isobus/hardware_integration/virtual_can_plugin.hpp"
 #endif
 
+#ifdef ISOBUS_TRACEREPLAY_AVAILABLE
+#include "isobus/hardware_integration/can_trace_replay_plugin.hpp"
+#endif
+
 #ifdef ISOBUS_TWAI_AVAILABLE
 #include "isobus/hardware_integration/twai_plugin.hpp"
 #endif
@@ -9,11 +9,14 @@
 #ifndef CAN_HARDWARE_INTERFACE_HPP
 #define CAN_HARDWARE_INTERFACE_HPP
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <cstdint>
 #include <cstring>
 #include <deque>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -77,10 +80,80 @@ namespace isobus
 		static bool is_running();
 
 		/// @brief Called externally, adds a message to a CAN channel's Tx queue
+		/// @details Each channel queues frames by their CAN priority, and sends them in the order CAN arbitration
+		/// would, so a frame like an address claim doesn't have to wait behind a long transport protocol transfer.
+		/// Frames with the same priority are sent in the order they were added.
 		/// @param[in] frame The frame to add to the Tx queue
-		/// @returns `true` if the frame was accepted, otherwise `false` (maybe wrong channel assigned)
+		/// @returns `true` if the frame was accepted, otherwise `false` (maybe wrong channel assigned, or the channel's queue is full)
 		static bool transmit_can_frame(const isobus::CANMessageFrame &frame);
 
+		/// @brief Called externally, adds a message to a CAN channel's Tx queue without waiting for space in it
+		/// @details Works like `transmit_can_frame`, but tells a full queue apart from other failures.
+		/// After rejecting a frame because its queue was full, the channel reports that it has space again through
+		/// `on_transmit_space_available_from_hardware` once it has sent some of its queued frames.
+		/// @param[in] frame The frame to add to the Tx queue
+		/// @returns `Queued` if the frame was accepted, `WouldBlock` if the channel's queue or the queue for the frame's priority is full, otherwise `Failed`
+		static isobus::CANTransmitResult try_transmit_can_frame(const isobus::CANMessageFrame &frame);
+
+		/// @brief Sets how many frames can wait in a channel's Tx queue, across all priorities
+		/// @details This bounds how far the stack can get ahead of the bus, frames are rejected with `WouldBlock` while the limit is reached.
+		/// Each channel starts with a limit of `DEFAULT_TRANSMIT_QUEUE_LIMIT` frames.
+		/// @param[in] channelIndex The channel to set the limit for
+		/// @param[in] maxFrames The maximum number of frames to queue on the channel, or `0` for no limit
+		/// @returns `true` if the limit was set, otherwise `false` (the channel doesn't exist)
+		static bool set_transmit_queue_limit(std::uint8_t channelIndex, std::size_t maxFrames);
+
+		/// @brief Returns how many frames can wait in a channel's Tx queue, across all priorities
+		/// @param[in] channelIndex The channel to get the limit for
+		/// @returns The maximum number of frames to queue on the channel, or `0` if there is no limit or the channel doesn't exist
+		static std::size_t get_transmit_queue_limit(std::uint8_t channelIndex);
+
+		/// @brief Sets how many frames of a priority can wait in each channel's Tx queue
+		/// @details Frames of that priority are rejected by `transmit_can_frame` while the limit is reached.
+		/// There is no limit by default.
+		/// @note The function will fail if the interface is already started
+		/// @param[in] priority The CAN priority to set the limit for, from 0 (highest) to 7 (lowest)
+		/// @param[in] maxFrames The maximum number of frames of that priority to queue on each channel, or `0` for no limit
+		/// @returns `true` if the limit was set, otherwise `false`
+		static bool set_transmit_queue_depth_limit(std::uint8_t priority, std::size_t maxFrames);
+
+		/// @brief Returns how many frames of a priority can wait in each channel's Tx queue
+		/// @param[in] priority The CAN priority to get the limit for, from 0 (highest) to 7 (lowest)
+		/// @returns The maximum number of frames of that priority to queue on each channel, or `0` if there is no limit
+		static std::size_t get_transmit_queue_depth_limit(std::uint8_t priority);
+
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+		/// @brief Returns the most frames that have been waiting in a channel's Tx queues at once
+		/// @note This is only available when the stack is compiled with `CAN_STACK_ENABLE_INSTRUMENTATION`
+		/// @param[in] channelIndex The channel to get the high-water mark of
+		/// @returns The Tx queue high-water mark, or `0` if the channel doesn't exist
+		static std::size_t get_transmit_queue_high_water_mark(std::uint8_t channelIndex);
+
+		/// @brief Returns the most frames that have been waiting in a channel's Rx queue at once
+		/// @note This is only available when the stack is compiled with `CAN_STACK_ENABLE_INSTRUMENTATION`
+		/// @param[in] channelIndex The channel to get the high-water mark of
+		/// @returns The Rx queue high-water mark, or `0` if the channel doesn't exist
+		static std::size_t get_receive_queue_high_water_mark(std::uint8_t channelIndex);
+#endif
+
+		/// @brief Sets if channels share a single receive thread, instead of each getting their own
+		/// @details When this is enabled, every channel whose driver returns a descriptor from
+		/// `CANHardwarePlugin::get_receive_file_descriptor` is read by one thread that waits on all of them with epoll,
+		/// and the update thread is woken once for each batch of frames from all of those channels.
+		/// Channels whose driver doesn't have a descriptor still get their own thread.
+		/// This is only supported on Linux, and is disabled by default.
+		/// @note The function will fail if the interface is already started
+		/// @param[in] enabled `true` to use the shared receive thread, `false` to use a thread per channel
+		/// @returns `true` if the setting was changed, otherwise `false`
+		static bool set_shared_receive_thread_enabled(bool enabled);
+
+		/// @brief Returns if channels share a single receive thread, instead of each getting their own
+		/// @returns `true` if the shared receive thread is enabled, otherwise `false`
+		static bool get_shared_receive_thread_enabled();
+
+		/// @brief The number of frames that can wait in each channel's Tx queue unless changed with `set_transmit_queue_limit`
+		static constexpr std::size_t DEFAULT_TRANSMIT_QUEUE_LIMIT = 512;
+
 		/// @brief Get the event dispatcher for when a CAN message frame is received from hardware event
 		/// @returns The event dispatcher which can be used to register callbacks/listeners to
 		static isobus::EventDispatcher<const isobus::CANMessageFrame &> &get_can_frame_received_event_dispatcher();
@@ -90,10 +163,14 @@ namespace isobus
 		static isobus::EventDispatcher<const isobus::CANMessageFrame &> &get_can_frame_transmitted_event_dispatcher();
 
 		/// @brief Get the event dispatcher for when a periodic update is called
+		/// @details Periodic updates happen every periodic update interval, but only while this has listeners.
 		/// @returns The event dispatcher which can be used to register callbacks/listeners to
 		static isobus::EventDispatcher<> &get_periodic_update_event_dispatcher();
 
 		/// @brief Set the interval between periodic updates
+		/// @details This is also the shortest time between updates of the CAN stack that are driven by the stack's own timers.
+		/// The stack is otherwise only updated when a frame is received, when it requests an update,
+		/// or when one of its timers is due, so an idle bus doesn't wake the update thread every interval.
 		/// @param[in] value The interval between update calls in milliseconds
 		static void set_periodic_update_interval(std::uint32_t value);
 
@@ -102,16 +179,31 @@ namespace isobus
 		static std::uint32_t get_periodic_update_interval();
 
 	private:
+		/// @brief The number of Tx priority classes, one for each CAN priority
+		static constexpr std::uint8_t NUMBER_OF_TRANSMIT_PRIORITY_CLASSES = 8;
+
 		/// @brief Stores the Tx/Rx queues, mutexes, and driver needed to run a single CAN channel
 		struct CANHardware
 		{
-			std::mutex messagesToBeTransmittedMutex; ///< Mutex to protect the Tx queue
-			std::deque<isobus::CANMessageFrame> messagesToBeTransmitted; ///< Tx message queue for a CAN channel
+			std::mutex messagesToBeTransmittedMutex; ///< Mutex to protect the Tx queues
+			std::array<std::deque<isobus::CANMessageFrame>, NUMBER_OF_TRANSMIT_PRIORITY_CLASSES> messagesToBeTransmitted; ///< Tx message queues for a CAN channel, one for each priority with the highest priority first
+			std::size_t numberOfQueuedFrames = 0; ///< The number of frames in all of the Tx queues
+			std::size_t transmitQueueLimit = DEFAULT_TRANSMIT_QUEUE_LIMIT; ///< The most frames that can be in all of the Tx queues, `0` means no limit
+			bool transmitBlocked = false; ///< Stores if a frame was rejected because the Tx queues were full, and the stack hasn't been told there is space yet
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+			std::size_t transmitQueueHighWaterMark = 0; ///< The most frames that have been in the Tx queues at once
+#endif
 
 			std::mutex receivedMessagesMutex; ///< Mutex to protect the Rx queue
 			std::deque<isobus::CANMessageFrame> receivedMessages; ///< Rx message queue for a CAN channel
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+			std::size_t receiveQueueHighWaterMark = 0; ///< The most frames that have been in the Rx queue at once
+#endif
 
 			std::unique_ptr<std::thread> receiveMessageThread; ///< Thread to manage getting messages from a CAN channel
+			int sharedReceiveFileDescriptor = -1; ///< The descriptor the shared receive thread is waiting on for the channel, otherwise `-1`
+			bool sharedReceiveChannel = false; ///< Stores if the channel is read by the shared receive thread, even while its driver is invalid
+			std::atomic_bool receiveFiltersChanged = { true }; ///< Stores if the stack's receive filters for the channel need to be given to the driver
 
 			std::shared_ptr<CANHardwarePlugin> frameHandler; ///< The CAN driver to use for a CAN channel
 		};
@@ -129,6 +221,12 @@ namespace isobus
 		/// @brief The default update interval for the CAN stack. Mostly arbitrary
 		static constexpr std::uint32_t PERIODIC_UPDATE_INTERVAL = 4;
 
+		/// @brief The longest the update thread will sleep for, even if nothing needs to be done
+		static constexpr std::uint32_t MAX_UPDATE_THREAD_SLEEP_TIME_MS = 1000;
+
+		/// @brief The most frames that are moved to or from a driver in one call
+		static constexpr std::size_t FRAME_BATCH_SIZE = 32;
+
 		/// @brief The main CAN thread executes this function. Does most of the work of this class
 		static void update_thread_function();
 
@@ -136,30 +234,67 @@ namespace isobus
 		/// @param[in] channelIndex The associated CAN channel for the thread
 		static void receive_can_frame_thread_function(std::uint8_t channelIndex);
 
-		/// @brief Attempts to write a frame using the driver assigned to a frame's channel
-		/// @param[in] frame The frame to try and write to the bus
-		/// @returns `true` if the frame was sent from the buffer, otherwise `false`
-		static bool transmit_can_frame_from_buffer(const isobus::CANMessageFrame &frame);
+		/// @brief The shared receive thread executes this function, when it is enabled
+		static void shared_receive_thread_function();
+
+		/// @brief Tries to have the shared receive thread read a channel, instead of giving it its own thread
+		/// @param[in] channelIndex The channel to add to the shared receive thread
+		/// @returns `true` if the shared receive thread will read the channel, otherwise `false`
+		static bool add_shared_receive_channel(std::uint8_t channelIndex);
+
+		/// @brief Makes the shared receive thread wait on a channel's current file descriptor, if its driver is valid
+		/// @details Drivers can close and reopen their descriptor, like SocketCAN does when the interface goes down and up again,
+		/// so the shared receive thread checks its channels with this about as often as a channel's own thread would retry.
+		/// @param[in] channelIndex The shared receive channel to check
+		static void update_shared_receive_channel(std::uint8_t channelIndex);
+
+		/// @brief Adds frames that were read from a channel's driver to the channel's Rx queue
+		/// @param[in] channelIndex The channel the frames were read from
+		/// @param[in] frames The frames that were read
+		/// @param[in] numberOfFrames The number of frames in `frames`
+		static void queue_received_frames(std::uint8_t channelIndex, isobus::CANMessageFrame *frames, std::size_t numberOfFrames);
+
+		/// @brief Attempts to write frames using the driver assigned to a channel
+		/// @param[in] channelIndex The channel to write the frames on
+		/// @param[in] frames The frames to try and write to the bus
+		/// @param[in] numberOfFrames The number of frames in `frames`
+		/// @returns The number of frames that were sent from the buffer, starting with the first one
+		static std::size_t transmit_can_frames_from_buffer(std::uint8_t channelIndex, const isobus::CANMessageFrame *frames, std::size_t numberOfFrames);
+
+		/// @brief Returns which Tx priority class a frame belongs to, based on the bits of its identifier that win arbitration first
+		/// @param[in] frame The frame to get the priority class of
+		/// @returns The frame's priority class, where 0 is the highest priority
+		static std::uint8_t get_transmit_priority_class(const isobus::CANMessageFrame &frame);
+
+		/// @brief Gives the stack's current receive filters for a channel to its driver
+		/// @param[in] channelIndex The channel to update the filters of
+		static void update_receive_filters(std::uint8_t channelIndex);
 
-		/// @brief The periodic update thread executes this function
-		static void periodic_update_function();
+		/// @brief Wakes up the update thread, even if it is not done waiting for its next timer
+		static void request_update_thread_wakeup();
 
 		/// @brief Stops all threads related to the hardware interface
 		static void stop_threads();
 
 		static std::unique_ptr<std::thread> updateThread; ///< The main thread
-		static std::unique_ptr<std::thread> wakeupThread; ///< A thread that periodically wakes up the `updateThread`
+		static std::unique_ptr<std::thread> sharedReceiveThread; ///< The thread that reads every channel with a file descriptor, if enabled
+		static int sharedReceivePollFileDescriptor; ///< The epoll instance the shared receive thread waits on, or `-1`
+		static bool sharedReceiveThreadEnabled; ///< Stores if channels with a file descriptor should be read by the shared receive thread
 		static std::condition_variable updateThreadWakeupCondition; ///< A condition variable to allow for signaling the `updateThread` to wakeup
-		static std::atomic_bool stackNeedsUpdate; ///< Stores if the CAN thread needs to update the stack this iteration
-		static std::uint32_t periodicUpdateInterval; ///< The period between calls to the CAN stack update function in milliseconds
+		static bool updateThreadWakeupRequested; ///< Stores if the `updateThread` has been signaled to wake up, protected by `updateMutex`
+		static std::atomic_bool stackNeedsUpdate; ///< Stores if the CAN stack requested to be updated right away
+		static std::uint32_t periodicUpdateInterval; ///< The period between periodic update events, and the shortest time between timer driven CAN stack updates in milliseconds
+		static std::shared_ptr<std::function<void()>> stackUpdateRequestedListener; ///< Listens for the CAN stack requesting to be updated
+		static std::shared_ptr<std::function<void(const std::uint8_t &)>> receiveFiltersChangedListener; ///< Listens for the CAN stack changing a channel's receive filters
 
 		static isobus::EventDispatcher<const isobus::CANMessageFrame &> frameReceivedEventDispatcher; ///< The event dispatcher for when a CAN message frame is received from hardware event
 		static isobus::EventDispatcher<const isobus::CANMessageFrame &> frameTransmittedEventDispatcher; ///< The event dispatcher for when a CAN message has been transmitted via hardware
 		static isobus::EventDispatcher<> periodicUpdateEventDispatcher; ///< The event dispatcher for when a periodic update is called
 
 		static std::vector<std::unique_ptr<CANHardware>> hardwareChannels; ///< A list of all CAN channel's metadata
+		static std::array<std::size_t, NUMBER_OF_TRANSMIT_PRIORITY_CLASSES> transmitQueueDepthLimits; ///< The most frames of each priority that can wait in a channel's Tx queue, `0` means no limit
 		static std::mutex hardwareChannelsMutex; ///< Mutex to protect `hardwareChannels`
-		static std::mutex updateMutex; ///< A mutex for the main thread
+		static std::mutex updateMutex; ///< A mutex for waking up the main thread
 		static std::atomic_bool threadsStarted; ///< Stores if the threads have been started
 	};
 }
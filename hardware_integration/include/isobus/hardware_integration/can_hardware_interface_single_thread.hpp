@@ -13,6 +13,8 @@
 #include <cstdint>
 #include <cstring>
 #include <deque>
+#include <functional>
+#include <memory>
 #include <vector>
 
 #include "isobus/hardware_integration/can_hardware_plugin.hpp"
@@ -76,9 +78,33 @@ namespace isobus
 
 		/// @brief Called externally, adds a message to a CAN channel's Tx queue
 		/// @param[in] frame The frame to add to the Tx queue
-		/// @returns `true` if the frame was accepted, otherwise `false` (maybe wrong channel assigned)
+		/// @returns `true` if the frame was accepted, otherwise `false` (maybe wrong channel assigned, or the channel's queue is full)
 		static bool transmit_can_frame(const isobus::CANMessageFrame &frame);
 
+		/// @brief Called externally, adds a message to a CAN channel's Tx queue without waiting for space in it
+		/// @details Works like `transmit_can_frame`, but tells a full queue apart from other failures.
+		/// After rejecting a frame because its queue was full, the channel reports that it has space again through
+		/// `on_transmit_space_available_from_hardware` once it has sent some of its queued frames.
+		/// @param[in] frame The frame to add to the Tx queue
+		/// @returns `Queued` if the frame was accepted, `WouldBlock` if the channel's queue is full, otherwise `Failed`
+		static isobus::CANTransmitResult try_transmit_can_frame(const isobus::CANMessageFrame &frame);
+
+		/// @brief Sets how many frames can wait in a channel's Tx queue
+		/// @details Frames are rejected with `WouldBlock` while the limit is reached.
+		/// Each channel starts with a limit of `DEFAULT_TRANSMIT_QUEUE_LIMIT` frames.
+		/// @param[in] channelIndex The channel to set the limit for
+		/// @param[in] maxFrames The maximum number of frames to queue on the channel, or `0` for no limit
+		/// @returns `true` if the limit was set, otherwise `false` (the channel doesn't exist)
+		static bool set_transmit_queue_limit(std::uint8_t channelIndex, std::size_t maxFrames);
+
+		/// @brief Returns how many frames can wait in a channel's Tx queue
+		/// @param[in] channelIndex The channel to get the limit for
+		/// @returns The maximum number of frames to queue on the channel, or `0` if there is no limit or the channel doesn't exist
+		static std::size_t get_transmit_queue_limit(std::uint8_t channelIndex);
+
+		/// @brief The number of frames that can wait in each channel's Tx queue unless changed with `set_transmit_queue_limit`
+		static constexpr std::size_t DEFAULT_TRANSMIT_QUEUE_LIMIT = 512;
+
 		/// @brief Get the event dispatcher for when a CAN message frame is received from hardware event
 		/// @returns The event dispatcher which can be used to register callbacks/listeners to
 		static isobus::EventDispatcher<const isobus::CANMessageFrame &> &get_can_frame_received_event_dispatcher();
@@ -96,6 +122,8 @@ namespace isobus
 		struct CANHardware
 		{
 			std::deque<isobus::CANMessageFrame> messagesToBeTransmitted; ///< Tx message queue for a CAN channel
+			std::size_t transmitQueueLimit = DEFAULT_TRANSMIT_QUEUE_LIMIT; ///< The most frames that can be in the Tx queue, `0` means no limit
+			bool transmitBlocked = false; ///< Stores if a frame was rejected because the Tx queue was full, and the stack hasn't been told there is space yet
 			std::deque<isobus::CANMessageFrame> receivedMessages; ///< Rx message queue for a CAN channel
 			std::shared_ptr<CANHardwarePlugin> frameHandler; ///< The CAN driver to use for a CAN channel
 		};
@@ -119,6 +147,11 @@ namespace isobus
 		/// @returns `true` if the frame was transmitted, otherwise `false`
 		static bool transmit_can_frame_from_buffer(const isobus::CANMessageFrame &frame);
 
+		/// @brief Gives the stack's current receive filters for a channel to its driver
+		/// @param[in] channelIndex The channel to update the filters of
+		static void update_receive_filters(std::uint8_t channelIndex);
+
+		static std::shared_ptr<std::function<void(const std::uint8_t &)>> receiveFiltersChangedListener; ///< Listens for the CAN stack changing a channel's receive filters
 		static isobus::EventDispatcher<const isobus::CANMessageFrame &> frameReceivedEventDispatcher; ///< The event dispatcher for when a CAN message frame is received from hardware event
 		static isobus::EventDispatcher<const isobus::CANMessageFrame &> frameTransmittedEventDispatcher; ///< The event dispatcher for when a CAN message has been transmitted via hardware
 
@@ -9,8 +9,12 @@
 #ifndef CAN_HARDEWARE_PLUGIN_HPP
 #define CAN_HARDEWARE_PLUGIN_HPP
 
+#include "isobus/isobus/can_hardware_abstraction.hpp"
 #include "isobus/isobus/can_message_frame.hpp"
 
+#include <cstddef>
+#include <vector>
+
 namespace isobus
 {
 	//================================================================================================
@@ -43,6 +47,63 @@ namespace isobus
 		/// @param[in] canFrame The frame to write to the bus
 		/// @returns `true` if the frame was written, otherwise `false`
 		virtual bool write_frame(const isobus::CANMessageFrame &canFrame) = 0;
+
+		/// @brief Reads up to `maxFrames` frames from the bus synchronously
+		/// @details Drivers that can move more than one frame per call into the OS or hardware should override this,
+		/// the default implementation just reads a single frame with `read_frame`.
+		/// This should wait about as long as `read_frame` would for the first frame, but not for any frames after that.
+		/// @param[out] canFrames Buffer to store the frames that were read in, must hold at least `maxFrames` frames
+		/// @param[in] maxFrames The maximum number of frames to read
+		/// @returns The number of frames that were read
+		virtual std::size_t read_frames(isobus::CANMessageFrame *canFrames, std::size_t maxFrames)
+		{
+			std::size_t retVal = 0;
+
+			if ((0 != maxFrames) && (read_frame(canFrames[0])))
+			{
+				retVal = 1;
+			}
+			return retVal;
+		}
+
+		/// @brief Writes frames to the bus in order (synchronous)
+		/// @details Drivers that can move more than one frame per call into the OS or hardware should override this,
+		/// the default implementation calls `write_frame` for each frame until one fails.
+		/// @param[in] canFrames The frames to write to the bus
+		/// @param[in] numberOfFrames The number of frames in `canFrames`
+		/// @returns The number of frames that were written, starting with the first one
+		virtual std::size_t write_frames(const isobus::CANMessageFrame *canFrames, std::size_t numberOfFrames)
+		{
+			std::size_t retVal = 0;
+
+			while ((retVal < numberOfFrames) && (write_frame(canFrames[retVal])))
+			{
+				retVal++;
+			}
+			return retVal;
+		}
+
+		/// @brief Sets which frames the driver should receive, so the rest can be dropped before they reach the stack
+		/// @details Drivers that can filter frames in the OS or hardware should override this, the default
+		/// implementation doesn't support filtering. This may be called before `open`, in which case the filters
+		/// should be applied when the driver is opened, and from a different thread than `read_frame`.
+		/// @param[in] filters The frames to receive, or an empty list to receive every frame
+		/// @returns `true` if the driver applied the filters, otherwise `false`
+		virtual bool set_receive_filters(const std::vector<isobus::CANReceiveFilter> &filters)
+		{
+			(void)filters;
+			return false;
+		}
+
+		/// @brief Returns a file descriptor that is readable whenever the driver has frames waiting to be read
+		/// @details Drivers built on something that can be waited on with epoll, like a socket, should override this so
+		/// the hardware interface can service them from its shared receive thread. When the descriptor is readable,
+		/// `read_frames` must return without waiting. The default implementation doesn't have a descriptor.
+		/// @returns The file descriptor, or `-1` if the driver doesn't have one or isn't open
+		virtual int get_receive_file_descriptor() const
+		{
+			return -1;
+		}
 	};
 }
 #endif // CAN_HARDEWARE_PLUGIN_HPP
@@ -0,0 +1,66 @@
+//================================================================================================
+/// @file can_trace_format.hpp
+///
+/// @brief The binary file format that CAN frame traces are recorded in
+/// @details A trace file is a `CANTraceFileHeader` followed by `capacity` fixed size `CANTraceRecord`
+/// slots that are used as a ring. Record number `n` is stored in slot `n % capacity`, so once more than
+/// `capacity` records have been written, the oldest ones have been overwritten and the trace starts
+/// at record number `recordsWritten - capacity`. Everything is stored in the byte order of the machine
+/// that recorded the trace.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#ifndef CAN_TRACE_FORMAT_HPP
+#define CAN_TRACE_FORMAT_HPP
+
+#include "isobus/isobus/can_constants.hpp"
+
+#include <cstdint>
+
+namespace isobus
+{
+	//================================================================================================
+	/// @class CANTraceFileHeader
+	///
+	/// @brief The header at the start of every binary trace file
+	//================================================================================================
+	class CANTraceFileHeader
+	{
+	public:
+		static constexpr std::uint64_t MAGIC = 0x4543415254534F49; ///< Spells "ISOTRACE" when stored little endian
+		static constexpr std::uint32_t CURRENT_VERSION = 1; ///< The version of the format that is written by the stack
+
+		std::uint64_t magic; ///< Identifies the file as a trace, always `MAGIC`
+		std::uint32_t version; ///< The version of the format the file was written in
+		std::uint32_t recordSize; ///< The size of each record in bytes
+		std::uint64_t capacity; ///< The number of record slots that follow the header
+		std::uint64_t recordsWritten; ///< The total number of records written, including any that have been overwritten
+		std::uint64_t reserved[4]; ///< Unused, always zero
+	};
+
+	//================================================================================================
+	/// @class CANTraceRecord
+	///
+	/// @brief One frame in a binary trace file
+	//================================================================================================
+	class CANTraceRecord
+	{
+	public:
+		static constexpr std::uint8_t EXTENDED_FRAME_FLAG = 0x01; ///< Set if the frame uses a 29 bit identifier
+		static constexpr std::uint8_t FD_FRAME_FLAG = 0x02; ///< Set if the frame is a CAN FD frame
+		static constexpr std::uint8_t BIT_RATE_SWITCH_FLAG = 0x04; ///< Set if the CAN FD frame used bit rate switching
+		static constexpr std::uint8_t TRANSMITTED_FLAG = 0x08; ///< Set if the frame was transmitted, otherwise it was received
+
+		std::uint64_t recordTime_us; ///< When the frame was recorded, in microseconds of the recorder's monotonic clock
+		std::uint64_t timestamp_us; ///< The frame's own timestamp in the driver's time base, zero or `UINT64_MAX` if it didn't have one
+		std::uint32_t identifier; ///< The frame's identifier
+		std::uint8_t channel; ///< The CAN channel the frame was on
+		std::uint8_t flags; ///< A combination of the `_FLAG` values
+		std::uint8_t dataLength; ///< The number of bytes of `data` that are used
+		std::uint8_t reserved; ///< Unused, always zero
+		std::uint8_t data[CAN_FD_DATA_LENGTH]; ///< The frame's payload, padded with whatever was in the frame's buffer
+	};
+} // namespace isobus
+
+#endif // CAN_TRACE_FORMAT_HPP
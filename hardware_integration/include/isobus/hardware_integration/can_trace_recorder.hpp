@@ -0,0 +1,93 @@
+//================================================================================================
+/// @file can_trace_recorder.hpp
+///
+/// @brief Records every frame the hardware interface sends or receives into a memory-mapped trace file
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#ifndef CAN_TRACE_RECORDER_HPP
+#define CAN_TRACE_RECORDER_HPP
+
+#include "isobus/hardware_integration/can_trace_format.hpp"
+#include "isobus/isobus/can_message_frame.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace isobus
+{
+	//================================================================================================
+	/// @class CANTraceRecorder
+	///
+	/// @brief Records CAN frames into a binary trace file that is used as a ring
+	/// @details The file is mapped into memory when it is opened, so recording a frame is just a few
+	/// stores and a single copy of its payload into the mapping, without any formatting or system calls.
+	/// The OS writes the pages back to the file in the background, and when the recorder is closed.
+	/// While open, every frame the `CANHardwareInterface` receives or transmits is recorded,
+	/// and other frames can be added with `record`. The file layout is described in can_trace_format.hpp.
+	//================================================================================================
+	class CANTraceRecorder
+	{
+	public:
+		static constexpr std::uint64_t DEFAULT_CAPACITY = 65536; ///< The default number of frames the ring holds, about 5.5 MB
+
+		/// @brief Constructs a recorder that isn't recording yet
+		CANTraceRecorder() = default;
+
+		/// @brief Closes the trace file if it is still open
+		~CANTraceRecorder();
+
+		/// @brief Deleted copy constructor
+		CANTraceRecorder(const CANTraceRecorder &) = delete;
+
+		/// @brief Deleted copy assignment operator
+		/// @returns Nothing, this is deleted
+		CANTraceRecorder &operator=(const CANTraceRecorder &) = delete;
+
+		/// @brief Creates a trace file, replacing any file at the same path, and starts recording into it
+		/// @param[in] filePath The path of the trace file
+		/// @param[in] capacity The number of frames the ring holds before it overwrites the oldest, rounded up to a power of two
+		/// @returns `true` if the file was created and recording started, otherwise `false`
+		bool open(const std::string &filePath, std::uint64_t capacity = DEFAULT_CAPACITY);
+
+		/// @brief Stops recording and finishes writing the trace file
+		void close();
+
+		/// @brief Returns if the recorder has a trace file open
+		/// @returns `true` if frames are being recorded, otherwise `false`
+		bool get_is_open() const;
+
+		/// @brief Returns the number of frames the ring holds before it overwrites the oldest
+		/// @returns The capacity of the open trace file, or `0` if there isn't one
+		std::uint64_t get_capacity() const;
+
+		/// @brief Returns the number of frames recorded since the trace file was opened, including any that were overwritten
+		/// @returns The number of frames recorded
+		std::uint64_t get_number_of_records() const;
+
+		/// @brief Adds a frame to the trace
+		/// @details This can be called from any thread, but not at the same time as `open` or `close`.
+		/// Does nothing if the recorder isn't open.
+		/// @param[in] frame The frame to record
+		/// @param[in] transmitted `true` if the frame was transmitted, `false` if it was received
+		void record(const CANMessageFrame &frame, bool transmitted);
+
+	private:
+		CANTraceFileHeader *header = nullptr; ///< The header of the mapped trace file
+		CANTraceRecord *records = nullptr; ///< The record slots of the mapped trace file
+		std::size_t mappedSize = 0; ///< The number of bytes of the file that are mapped
+		std::uint64_t capacityMask = 0; ///< The capacity of the ring minus one, used to find a record's slot
+		int fileDescriptor = -1; ///< The open trace file, or `-1`
+		std::atomic<std::uint64_t> nextRecordNumber = { 0 }; ///< The number the next record to start being written will get
+		std::atomic<std::uint64_t> publishedRecords = { 0 }; ///< The number of records that are completely written, in order
+		std::shared_ptr<std::function<void(const CANMessageFrame &)>> frameReceivedListener; ///< Records frames received by the hardware interface
+		std::shared_ptr<std::function<void(const CANMessageFrame &)>> frameTransmittedListener; ///< Records frames transmitted by the hardware interface
+	};
+} // namespace isobus
+
+#endif // CAN_TRACE_RECORDER_HPP
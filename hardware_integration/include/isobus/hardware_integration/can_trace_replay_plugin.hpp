@@ -0,0 +1,195 @@
+//================================================================================================
+/// @file can_trace_replay_plugin.hpp
+///
+/// @brief A CAN driver that replays a recorded trace into the stack, for benchmarking and testing.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#ifndef CAN_TRACE_REPLAY_PLUGIN_HPP
+#define CAN_TRACE_REPLAY_PLUGIN_HPP
+
+#include "isobus/hardware_integration/can_hardware_plugin.hpp"
+#include "isobus/isobus/can_hardware_abstraction.hpp"
+#include "isobus/isobus/can_message_frame.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace isobus
+{
+	//================================================================================================
+	/// @class CANTraceReplayPlugin
+	///
+	/// @brief A CAN driver that replays the frames in a recorded trace as if they were received from the bus
+	/// @details Supports candump log files (`candump -l`), Vector ASC files, and the stack's own binary
+	/// trace files from `CANTraceRecorder`. The whole trace is loaded when the driver is opened, so reading
+	/// the file doesn't count against the stack when measuring throughput.
+	/// Frames are replayed with their original timing, with their timing sped up or slowed down, or as fast
+	/// as the hardware interface can read them. Frames that the stack transmits are discarded.
+	/// Once every frame has been replayed, the driver behaves like an idle bus.
+	//================================================================================================
+	class CANTraceReplayPlugin : public CANHardwarePlugin
+	{
+	public:
+		/// @brief The formats a trace file can be in
+		enum class TraceFormat : std::uint8_t
+		{
+			Automatic, ///< Work out the format from the contents of the file
+			Candump, ///< A candump log file, like `(1436509052.249713) can0 18FEF180#0102030405060708`
+			VectorASC, ///< A Vector ASC file
+			Binary ///< A binary trace file written by `CANTraceRecorder`
+		};
+
+		/// @brief How quickly frames are replayed
+		enum class ReplayMode : std::uint8_t
+		{
+			RealTime, ///< Frames are replayed with the same timing they were recorded with
+			ScaledTime, ///< Frames are replayed with their recorded timing multiplied by a speed factor
+			AsFastAsPossible ///< Frames are replayed as fast as they can be read, ignoring their timing
+		};
+
+		/// @brief Constructor for the trace replay driver
+		/// @param[in] filePath The trace file to replay
+		/// @param[in] format The format of the trace file
+		CANTraceReplayPlugin(const std::string &filePath, TraceFormat format = TraceFormat::Automatic);
+
+		/// @brief Sets how quickly frames are replayed
+		/// @note The function will fail if the driver is already open
+		/// @param[in] mode The replay mode to use
+		/// @param[in] speedFactor How much faster than recorded to replay in `ScaledTime` mode, like `2.0` for twice as fast
+		/// @returns `true` if the mode was set, otherwise `false`
+		bool set_replay_mode(ReplayMode mode, float speedFactor = 1.0f);
+
+		/// @brief Returns how quickly frames are replayed
+		/// @returns The replay mode
+		ReplayMode get_replay_mode() const;
+
+		/// @brief Sets which channel of the trace to replay, instead of every frame in it
+		/// @details Candump interfaces are numbered in the order they first appear in the trace, starting at 0,
+		/// and Vector ASC channels, which start at 1 in the file, are numbered from 0 as well.
+		/// @note The function will fail if the driver is already open
+		/// @param[in] channel The channel in the trace to replay
+		/// @returns `true` if the channel was set, otherwise `false`
+		bool set_trace_channel(std::uint8_t channel);
+
+		/// @brief Sets if frames that were recorded as transmitted are replayed
+		/// @details They are replayed by default, since a trace from another node's point of view is still bus traffic.
+		/// @note The function will fail if the driver is already open
+		/// @param[in] replayTransmitted `true` to replay transmitted frames, `false` to skip them
+		/// @returns `true` if the setting was changed, otherwise `false`
+		bool set_replay_transmitted_frames(bool replayTransmitted);
+
+		/// @brief Returns if the trace was loaded and the driver is open
+		/// @returns `true` if the driver is open, otherwise `false`
+		bool get_is_valid() const override;
+
+		/// @brief Stops replaying and unloads the trace
+		void close() override;
+
+		/// @brief Loads the trace, and gets ready to start replaying it on the first read
+		void open() override;
+
+		/// @brief Returns the next frame in the trace, waiting until it is due
+		/// @details Waits at most 100ms before returning `false` if no frame is due yet.
+		/// @param[in, out] canFrame The CAN frame that was read
+		/// @returns `true` if a CAN frame was read, otherwise `false`
+		bool read_frame(isobus::CANMessageFrame &canFrame) override;
+
+		/// @brief Discards a frame the stack transmitted
+		/// @param[in] canFrame The frame to write to the bus
+		/// @returns `true`, transmitting always succeeds
+		bool write_frame(const isobus::CANMessageFrame &canFrame) override;
+
+		/// @brief Returns every frame in the trace that is due, up to `maxFrames`
+		/// @details Waits at most 100ms for the first frame to be due.
+		/// @param[out] canFrames Buffer to store the frames that were read in
+		/// @param[in] maxFrames The maximum number of frames to read
+		/// @returns The number of frames that were read
+		std::size_t read_frames(isobus::CANMessageFrame *canFrames, std::size_t maxFrames) override;
+
+		/// @brief Returns the number of frames loaded from the trace
+		/// @returns The number of frames that will be replayed
+		std::size_t get_number_of_frames() const;
+
+		/// @brief Returns the number of frames that have been replayed so far
+		/// @returns The number of frames replayed
+		std::size_t get_number_of_frames_replayed() const;
+
+		/// @brief Returns the number of frames the stack has transmitted, which were discarded
+		/// @returns The number of frames written
+		std::size_t get_number_of_frames_written() const;
+
+		/// @brief Returns if every frame in the trace has been replayed
+		/// @returns `true` if the replay is finished, otherwise `false`
+		bool get_is_finished() const;
+
+	private:
+		/// @brief A frame from the trace, and when it was recorded
+		struct TraceFrame
+		{
+			std::uint64_t time_us; ///< When the frame was recorded, in the trace's own time base
+			CANMessageFrame frame; ///< The frame to replay
+		};
+
+		/// @brief The longest a read will wait for a frame to be due, so the driver can be closed promptly
+		static constexpr std::uint32_t READ_TIMEOUT_MS = 100;
+
+		/// @brief Looks at the start of the trace to find out what format it is in
+		/// @param[in] file The trace file, which is rewound afterwards
+		/// @returns The format of the trace
+		static TraceFormat detect_format(std::istream &file);
+
+		/// @brief Parses a time in seconds with a fractional part, like `1436509052.249713`, into microseconds
+		/// @param[in] text The time to parse
+		/// @param[out] time_us The parsed time in microseconds
+		/// @returns `true` if the time was parsed, otherwise `false`
+		static bool parse_time(const std::string &text, std::uint64_t &time_us);
+
+		/// @brief Loads a candump log file
+		/// @param[in] file The trace file
+		/// @returns `true` if the file was loaded, otherwise `false`
+		bool load_candump(std::istream &file);
+
+		/// @brief Loads a Vector ASC file
+		/// @param[in] file The trace file
+		/// @returns `true` if the file was loaded, otherwise `false`
+		bool load_vector_asc(std::istream &file);
+
+		/// @brief Loads a binary trace file written by `CANTraceRecorder`
+		/// @param[in] file The trace file
+		/// @returns `true` if the file was loaded, otherwise `false`
+		bool load_binary(std::istream &file);
+
+		/// @brief Adds a frame to the replay, if it is on the channel being replayed
+		/// @param[in] time_us When the frame was recorded, in the trace's own time base
+		/// @param[in] channel The channel the frame was on in the trace
+		/// @param[in] transmitted `true` if the frame was recorded as transmitted
+		/// @param[in] frame The frame to add
+		void add_frame(std::uint64_t time_us, std::uint8_t channel, bool transmitted, const CANMessageFrame &frame);
+
+		/// @brief Returns when a frame in the trace should be replayed
+		/// @param[in] index The index of the frame
+		/// @returns The time the frame is due
+		std::chrono::steady_clock::time_point get_due_time(std::size_t index) const;
+
+		const std::string filePath; ///< The trace file to replay
+		const TraceFormat format; ///< The format of the trace file
+		ReplayMode replayMode = ReplayMode::RealTime; ///< How quickly frames are replayed
+		float speedFactor = 1.0f; ///< How much faster than recorded frames are replayed in `ScaledTime` mode
+		std::int16_t traceChannel = -1; ///< The channel of the trace to replay, or `-1` for all of them
+		bool replayTransmittedFrames = true; ///< Stores if frames recorded as transmitted are replayed
+		std::vector<TraceFrame> frames; ///< The frames loaded from the trace
+		std::chrono::steady_clock::time_point replayStartTime; ///< When the first frame was replayed
+		std::atomic<std::size_t> nextFrameIndex = { 0 }; ///< The next frame to replay
+		std::atomic<std::size_t> numberOfFramesWritten = { 0 }; ///< The number of frames the stack has transmitted
+		std::atomic_bool running = { false }; ///< If `true`, the trace is loaded and the driver is open
+	};
+} // namespace isobus
+
+#endif // CAN_TRACE_REPLAY_PLUGIN_HPP
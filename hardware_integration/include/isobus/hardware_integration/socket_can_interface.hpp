@@ -11,12 +11,15 @@
 #define SOCKET_CAN_INTERFACE_HPP
 
 #include <string>
+#include <vector>
 
 #include "isobus/hardware_integration/can_hardware_plugin.hpp"
 #include "isobus/isobus/can_hardware_abstraction.hpp"
 #include "isobus/isobus/can_message_frame.hpp"
 
 struct sockaddr_can; ///< Forward declare the linux sockaddr_can struct
+struct canfd_frame; ///< Forward declare the linux canfd_frame struct
+struct msghdr; ///< Forward declare the linux msghdr struct
 
 namespace isobus
 {
@@ -24,6 +27,8 @@ namespace isobus
 	/// @class SocketCANInterface
 	///
 	/// @brief A CAN Driver for Linux socket CAN
+	/// @details Sends and receives both classical CAN and CAN FD frames. CAN FD frames
+	/// are only available if the kernel and the interface support them.
 	//================================================================================================
 	class SocketCANInterface : public CANHardwarePlugin
 	{
@@ -59,9 +64,55 @@ namespace isobus
 		/// @returns `true` if the frame was written, otherwise `false`
 		bool write_frame(const isobus::CANMessageFrame &canFrame) override;
 
+		/// @brief Reads as many frames as are available, up to `maxFrames`, with a single `recvmmsg` call.
+		/// @details Waits up to 100ms for the first frame to arrive.
+		/// @param[out] canFrames Buffer to store the frames that were read in
+		/// @param[in] maxFrames The maximum number of frames to read
+		/// @returns The number of frames that were read
+		std::size_t read_frames(isobus::CANMessageFrame *canFrames, std::size_t maxFrames) override;
+
+		/// @brief Writes frames to the bus with a single `sendmmsg` call (synchronous)
+		/// @param[in] canFrames The frames to write to the bus
+		/// @param[in] numberOfFrames The number of frames in `canFrames`
+		/// @returns The number of frames that were written, starting with the first one
+		std::size_t write_frames(const isobus::CANMessageFrame *canFrames, std::size_t numberOfFrames) override;
+
+		/// @brief Sets the socket's `CAN_RAW_FILTER` so the kernel drops frames the stack doesn't need
+		/// @details If there are more filters than the kernel accepts, every frame is received instead.
+		/// @param[in] filters The frames to receive, or an empty list to receive every frame
+		/// @returns `true` if the filters were applied, or will be when the socket is opened, otherwise `false`
+		bool set_receive_filters(const std::vector<isobus::CANReceiveFilter> &filters) override;
+
+		/// @brief Returns the socket, so it can be waited on alongside other channels
+		/// @returns The socket's file descriptor, or `-1` if the socket is not open
+		int get_receive_file_descriptor() const override;
+
 	private:
+		static constexpr std::size_t MAX_FRAMES_PER_SYSCALL = 32; ///< The most frames that will be moved by a single `recvmmsg` or `sendmmsg` call
+
+		/// @brief Converts a frame received from the socket into a stack frame
+		/// @param[in] socketFrame The frame that was received
+		/// @param[in] frameSize The number of bytes received, which tells classical CAN and CAN FD frames apart
+		/// @param[in] message The message header the frame was received with, used to find the timestamp
+		/// @param[out] canFrame The converted frame
+		/// @returns `true` if the frame was converted, `false` if it was an error frame or had an unexpected size
+		static bool convert_received_frame(const struct canfd_frame &socketFrame, std::size_t frameSize, struct msghdr &message, isobus::CANMessageFrame &canFrame);
+
+		/// @brief Converts a stack frame into a frame that can be sent on the socket
+		/// @param[in] canFrame The frame to convert
+		/// @param[out] socketFrame The converted frame
+		static void convert_frame_to_send(const isobus::CANMessageFrame &canFrame, struct canfd_frame &socketFrame);
+
+		/// @brief Handles an error from a socket call, closing the socket if the interface went down
+		void handle_socket_error();
+
+		/// @brief Applies the stored receive filters to the socket
+		/// @returns `true` if the filters were applied, otherwise `false`
+		bool apply_receive_filters();
+
 		struct sockaddr_can *pCANDevice; ///< The structure for CAN sockets
 		const std::string name; ///< The device name
+		std::vector<isobus::CANReceiveFilter> receiveFilters; ///< The frames to receive, empty to receive every frame
 		int fileDescriptor; ///< File descriptor for the socket
 	};
 }
@@ -16,11 +16,10 @@
 
 #include <atomic>
 #include <condition_variable>
-#include <deque>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
-#include <vector>
 
 namespace isobus
 {
@@ -31,6 +30,11 @@ namespace isobus
 	/// @details Any instance connecting to the same channel and in the same process can communicate.
 	/// However, this plugin does not implement rate limiting or any other CAN bus specific features,
 	/// like prioritization under heavy load.
+	///
+	/// Each channel is a ring of frames that every instance on it reads from with its own cursor, so writers
+	/// never wait on each other or on readers. An instance that falls more than `RING_SIZE` frames behind
+	/// loses the oldest ones, like a real CAN controller whose receive buffer overflows.
+	/// Each instance should only be read from one thread at a time.
 	//================================================================================================
 	class VirtualCANPlugin : public CANHardwarePlugin
 	{
@@ -68,11 +72,23 @@ namespace isobus
 		/// @returns `true` if a CAN frame was read, otherwise `false`
 		bool read_frame(isobus::CANMessageFrame &canFrame, std::uint32_t timeout) const;
 
+		/// @brief Returns all queued frames, up to `maxFrames`, from the hardware (synchronous). Waits up to 1 second for the first frame.
+		/// @param[out] canFrames Buffer to store the frames that were read in
+		/// @param[in] maxFrames The maximum number of frames to read
+		/// @returns The number of frames that were read
+		std::size_t read_frames(isobus::CANMessageFrame *canFrames, std::size_t maxFrames) override;
+
 		/// @brief Writes a frame to the bus (synchronous)
 		/// @param[in] canFrame The frame to write to the bus
 		/// @returns `true` if the frame was written, otherwise `false`
 		bool write_frame(const isobus::CANMessageFrame &canFrame) override;
 
+		/// @brief Writes frames to the bus (synchronous), waking up waiting readers only once for all of them
+		/// @param[in] canFrames The frames to write to the bus
+		/// @param[in] numberOfFrames The number of frames to write
+		/// @returns The number of frames that were written
+		std::size_t write_frames(const isobus::CANMessageFrame *canFrames, std::size_t numberOfFrames) override;
+
 		/// @brief Allows us to write messages as if we received them from the bus
 		/// @param[in] canFrame The frame to write to the bus
 		void write_frame_as_if_received(const isobus::CANMessageFrame &canFrame) const;
@@ -85,23 +101,65 @@ namespace isobus
 		void clear_queue() const;
 
 	private:
-		/// @brief A struct holding information about a virtual CAN device
-		struct VirtualDevice
+		/// @brief The number of frames each channel holds, which is how far behind a reader can fall. Must be a power of 2.
+		static constexpr std::uint64_t RING_SIZE = 4096;
+
+		/// @brief One frame in a channel's ring
+		struct Slot
 		{
-			std::deque<isobus::CANMessageFrame> queue; ///< A queue of CAN frames
-			std::condition_variable condition; ///< A condition variable to wake us up when a frame is received
+			/// @brief `2 * (position + 1)` once the frame at a position is written, and odd while it is being written
+			std::atomic<std::uint64_t> sequence = { 0 };
+			isobus::CANMessageFrame frame; ///< The frame
+			const VirtualCANPlugin *source = nullptr; ///< The instance that wrote the frame
+			const VirtualCANPlugin *destination = nullptr; ///< The only instance that should read the frame, or `nullptr` for all of them
 		};
 
-		static constexpr size_t MAX_QUEUE_SIZE = 1000; ///< The maximum size of the queue, mostly arbitrary
+		/// @brief A virtual CAN bus shared by every instance with the same channel name
+		struct VirtualChannel
+		{
+			/// @brief Constructor for a channel, which allocates its ring
+			VirtualChannel();
+
+			std::unique_ptr<Slot[]> slots; ///< The ring of frames, indexed by position modulo `RING_SIZE`
+			std::atomic<std::uint64_t> writeIndex = { 0 }; ///< The next position a writer will claim
+			std::atomic<std::uint32_t> numberOfDevices = { 0 }; ///< The number of instances on the channel
+			std::atomic<std::uint32_t> numberOfWaitingReaders = { 0 }; ///< The number of instances waiting for a frame
+			std::mutex waitMutex; ///< Only used by readers to sleep until a frame is written
+			std::condition_variable condition; ///< Wakes up waiting readers when frames are written
+		};
+
+		/// @brief Writes frames into the channel's ring, from this instance
+		/// @param[in] canFrames The frames to write
+		/// @param[in] numberOfFrames The number of frames to write
+		/// @param[in] destination The only instance that should read the frames, or `nullptr` for all of them
+		void publish_frames(const isobus::CANMessageFrame *canFrames, std::size_t numberOfFrames, const VirtualCANPlugin *destination) const;
+
+		/// @brief Moves the read cursor past frames that aren't for this instance, and past frames that were overwritten
+		/// @returns `true` if the frame at the read cursor is one for this instance, otherwise `false`
+		bool get_frame_available() const;
+
+		/// @brief Reads frames for this instance from the channel's ring without waiting
+		/// @param[out] canFrames Buffer to store the frames that were read in
+		/// @param[in] maxFrames The maximum number of frames to read
+		/// @returns The number of frames that were read
+		std::size_t receive_frames(isobus::CANMessageFrame *canFrames, std::size_t maxFrames) const;
+
+		/// @brief Waits until a frame for this instance is available, or the instance is closed
+		/// @param[in] timeout The longest to wait, in milliseconds
+		void wait_for_frame(std::uint32_t timeout) const;
+
+		/// @brief Wakes up every reader waiting on the channel
+		void wake_readers() const;
 
-		static std::mutex mutex; ///< Mutex to access channels and queues for thread safety
-		static std::map<std::string, std::vector<std::shared_ptr<VirtualDevice>>> channels; ///< A channel is a vector of devices
+		static std::mutex channelsMutex; ///< Only held while instances join or leave a channel
+		static std::map<std::string, std::weak_ptr<VirtualChannel>> channels; ///< The channels, by name
 
 		const std::string channel; ///< The virtual channel name
 		const bool receiveOwnMessages; ///< If `true`, the driver will receive its own messages
 
-		std::shared_ptr<VirtualDevice> ourDevice; ///< A pointer to the virtual device of this instance
-		std::atomic_bool running; ///< If `true`, the driver is running
+		std::shared_ptr<VirtualChannel> ourChannel; ///< The channel this instance is on
+		mutable std::atomic<std::uint64_t> readIndex = { 0 }; ///< The position of the next frame this instance reads
+		std::atomic_bool running = { false }; ///< If `true`, the driver is running
 	};
 }
 #endif // VIRTUAL_CAN_PLUGIN_HPP
\ No newline at end of file
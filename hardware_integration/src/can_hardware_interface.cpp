@@ -12,21 +12,33 @@
 #include "isobus/utility/to_string.hpp"
 
 #include <algorithm>
+#include <cerrno>
 #include <limits>
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
 namespace isobus
 {
 	std::unique_ptr<std::thread> CANHardwareInterface::updateThread;
-	std::unique_ptr<std::thread> CANHardwareInterface::wakeupThread;
+	std::unique_ptr<std::thread> CANHardwareInterface::sharedReceiveThread;
+	int CANHardwareInterface::sharedReceivePollFileDescriptor = -1;
+	bool CANHardwareInterface::sharedReceiveThreadEnabled = false;
 	std::condition_variable CANHardwareInterface::updateThreadWakeupCondition;
+	bool CANHardwareInterface::updateThreadWakeupRequested = false;
 	std::atomic_bool CANHardwareInterface::stackNeedsUpdate = { false };
 	std::uint32_t CANHardwareInterface::periodicUpdateInterval = PERIODIC_UPDATE_INTERVAL;
+	std::shared_ptr<std::function<void()>> CANHardwareInterface::stackUpdateRequestedListener;
+	std::shared_ptr<std::function<void(const std::uint8_t &)>> CANHardwareInterface::receiveFiltersChangedListener;
 
 	isobus::EventDispatcher<const isobus::CANMessageFrame &> CANHardwareInterface::frameReceivedEventDispatcher;
 	isobus::EventDispatcher<const isobus::CANMessageFrame &> CANHardwareInterface::frameTransmittedEventDispatcher;
 	isobus::EventDispatcher<> CANHardwareInterface::periodicUpdateEventDispatcher;
 
 	std::vector<std::unique_ptr<CANHardwareInterface::CANHardware>> CANHardwareInterface::hardwareChannels;
+	std::array<std::size_t, CANHardwareInterface::NUMBER_OF_TRANSMIT_PRIORITY_CLASSES> CANHardwareInterface::transmitQueueDepthLimits = {};
 	std::mutex CANHardwareInterface::hardwareChannelsMutex;
 	std::mutex CANHardwareInterface::updateMutex;
 	std::atomic_bool CANHardwareInterface::threadsStarted = { false };
@@ -43,6 +55,11 @@ namespace isobus
 		return CANHardwareInterface::transmit_can_frame(frame);
 	}
 
+	CANTransmitResult try_send_can_message_frame_to_hardware(const CANMessageFrame &frame)
+	{
+		return CANHardwareInterface::try_transmit_can_frame(frame);
+	}
+
 	bool CANHardwareInterface::set_number_of_can_channels(std::uint8_t value)
 	{
 		std::lock_guard<std::mutex> lock(hardwareChannelsMutex);
@@ -136,8 +153,19 @@ namespace isobus
 			return false;
 		}
 
+		stackUpdateRequestedListener = isobus::get_periodic_update_requested_event_dispatcher_from_hardware().add_listener([]() {
+			stackNeedsUpdate = true;
+			request_update_thread_wakeup();
+		});
+		receiveFiltersChangedListener = isobus::get_receive_filters_changed_event_dispatcher_from_hardware().add_listener([](const std::uint8_t &channelIndex) {
+			// Drivers are only touched from the update thread, which picks this up after the stack update that changed the filters
+			if (channelIndex < hardwareChannels.size())
+			{
+				hardwareChannels[channelIndex]->receiveFiltersChanged = true;
+				request_update_thread_wakeup();
+			}
+		});
 		updateThread.reset(new std::thread(update_thread_function));
-		wakeupThread.reset(new std::thread(periodic_update_function));
 
 		threadsStarted = true;
 
@@ -147,13 +175,21 @@ namespace isobus
 			{
 				hardwareChannels[i]->frameHandler->open();
 
-				if (hardwareChannels[i]->frameHandler->get_is_valid())
+				hardwareChannels[i]->receiveFiltersChanged = true;
+
+				if ((hardwareChannels[i]->frameHandler->get_is_valid()) &&
+				    (!add_shared_receive_channel(static_cast<std::uint8_t>(i))))
 				{
 					hardwareChannels[i]->receiveMessageThread.reset(new std::thread(receive_can_frame_thread_function, static_cast<std::uint8_t>(i)));
 				}
 			}
 		}
 
+		if (-1 != sharedReceivePollFileDescriptor)
+		{
+			sharedReceiveThread.reset(new std::thread(shared_receive_thread_function));
+		}
+
 		return true;
 	}
 
@@ -173,7 +209,12 @@ namespace isobus
 				channel->frameHandler = nullptr;
 			}
 			std::unique_lock<std::mutex> transmittingLock(channel->messagesToBeTransmittedMutex);
-			channel->messagesToBeTransmitted.clear();
+			for (auto &queue : channel->messagesToBeTransmitted)
+			{
+				queue.clear();
+			}
+			channel->numberOfQueuedFrames = 0;
+			channel->transmitBlocked = false;
 			transmittingLock.unlock();
 
 			std::unique_lock<std::mutex> receivingLock(channel->receivedMessagesMutex);
@@ -188,38 +229,175 @@ namespace isobus
 	}
 
 	bool CANHardwareInterface::transmit_can_frame(const isobus::CANMessageFrame &frame)
+	{
+		return isobus::CANTransmitResult::Queued == try_transmit_can_frame(frame);
+	}
+
+	isobus::CANTransmitResult CANHardwareInterface::try_transmit_can_frame(const isobus::CANMessageFrame &frame)
 	{
 		if (!threadsStarted)
 		{
 			isobus::CANStackLogger::error("[HardwareInterface] Cannot transmit message before interface is started.");
-			return false;
+			return isobus::CANTransmitResult::Failed;
 		}
 
 		if (frame.channel >= hardwareChannels.size())
 		{
 			isobus::CANStackLogger::error("[HardwareInterface] Cannot transmit message on channel " + isobus::to_string(frame.channel) +
 			                              ", because there are only " + isobus::to_string(hardwareChannels.size()) + " channels set.");
-			return false;
+			return isobus::CANTransmitResult::Failed;
 		}
 
 		const std::unique_ptr<CANHardware> &channel = hardwareChannels[frame.channel];
 		if (nullptr == channel->frameHandler)
 		{
 			isobus::CANStackLogger::error("[HardwareInterface] Cannot transmit message on channel " + isobus::to_string(frame.channel) + ", because it is not assigned.");
-			return false;
+			return isobus::CANTransmitResult::Failed;
 		}
 
 		if (channel->frameHandler->get_is_valid())
 		{
-			std::lock_guard<std::mutex> lock(channel->messagesToBeTransmittedMutex);
-			channel->messagesToBeTransmitted.push_back(frame);
+			const std::uint8_t priorityClass = get_transmit_priority_class(frame);
+			std::unique_lock<std::mutex> lock(channel->messagesToBeTransmittedMutex);
+			std::deque<isobus::CANMessageFrame> &queue = channel->messagesToBeTransmitted[priorityClass];
+
+			if (((0 == transmitQueueDepthLimits[priorityClass]) ||
+			     (queue.size() < transmitQueueDepthLimits[priorityClass])) &&
+			    ((0 == channel->transmitQueueLimit) ||
+			     (channel->numberOfQueuedFrames < channel->transmitQueueLimit)))
+			{
+				queue.push_back(frame);
+				channel->numberOfQueuedFrames++;
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+				channel->transmitQueueHighWaterMark = std::max(channel->transmitQueueHighWaterMark, channel->numberOfQueuedFrames);
+#endif
+				lock.unlock();
+
+				request_update_thread_wakeup();
+				return isobus::CANTransmitResult::Queued;
+			}
+			channel->transmitBlocked = true;
+			return isobus::CANTransmitResult::WouldBlock;
+		}
+		return isobus::CANTransmitResult::Failed;
+	}
+
+	bool CANHardwareInterface::set_transmit_queue_limit(std::uint8_t channelIndex, std::size_t maxFrames)
+	{
+		std::lock_guard<std::mutex> channelsLock(hardwareChannelsMutex);
 
-			updateThreadWakeupCondition.notify_all();
-			return true;
+		if (channelIndex >= hardwareChannels.size())
+		{
+			isobus::CANStackLogger::error("[HardwareInterface] Unable to set transmit queue limit on channel " + isobus::to_string(channelIndex) +
+			                              ", because there are only " + isobus::to_string(hardwareChannels.size()) + " channels set.");
+			return false;
+		}
+
+		std::lock_guard<std::mutex> lock(hardwareChannels[channelIndex]->messagesToBeTransmittedMutex);
+		hardwareChannels[channelIndex]->transmitQueueLimit = maxFrames;
+		return true;
+	}
+
+	std::size_t CANHardwareInterface::get_transmit_queue_limit(std::uint8_t channelIndex)
+	{
+		std::lock_guard<std::mutex> channelsLock(hardwareChannelsMutex);
+		std::size_t retVal = 0;
+
+		if (channelIndex < hardwareChannels.size())
+		{
+			std::lock_guard<std::mutex> lock(hardwareChannels[channelIndex]->messagesToBeTransmittedMutex);
+			retVal = hardwareChannels[channelIndex]->transmitQueueLimit;
+		}
+		return retVal;
+	}
+
+	bool CANHardwareInterface::set_transmit_queue_depth_limit(std::uint8_t priority, std::size_t maxFrames)
+	{
+		std::lock_guard<std::mutex> lock(hardwareChannelsMutex);
+
+		if (threadsStarted)
+		{
+			isobus::CANStackLogger::error("[HardwareInterface] Cannot set transmit queue depth limit after interface is started.");
+			return false;
 		}
-		return false;
+
+		if (priority >= NUMBER_OF_TRANSMIT_PRIORITY_CLASSES)
+		{
+			isobus::CANStackLogger::error("[HardwareInterface] Cannot set transmit queue depth limit for invalid priority " + isobus::to_string(static_cast<int>(priority)));
+			return false;
+		}
+
+		transmitQueueDepthLimits[priority] = maxFrames;
+		return true;
 	}
 
+	std::size_t CANHardwareInterface::get_transmit_queue_depth_limit(std::uint8_t priority)
+	{
+		std::size_t retVal = 0;
+
+		if (priority < NUMBER_OF_TRANSMIT_PRIORITY_CLASSES)
+		{
+			retVal = transmitQueueDepthLimits[priority];
+		}
+		return retVal;
+	}
+
+	bool CANHardwareInterface::set_shared_receive_thread_enabled(bool enabled)
+	{
+		std::lock_guard<std::mutex> lock(hardwareChannelsMutex);
+
+		if (threadsStarted)
+		{
+			isobus::CANStackLogger::error("[HardwareInterface] Cannot change the receive thread mode after interface is started.");
+			return false;
+		}
+
+#ifndef __linux__
+		if (enabled)
+		{
+			isobus::CANStackLogger::error("[HardwareInterface] The shared receive thread is not supported on this platform.");
+			return false;
+		}
+#endif
+
+		sharedReceiveThreadEnabled = enabled;
+		return true;
+	}
+
+	bool CANHardwareInterface::get_shared_receive_thread_enabled()
+	{
+		std::lock_guard<std::mutex> lock(hardwareChannelsMutex);
+		return sharedReceiveThreadEnabled;
+	}
+
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+	std::size_t CANHardwareInterface::get_transmit_queue_high_water_mark(std::uint8_t channelIndex)
+	{
+		std::lock_guard<std::mutex> channelsLock(hardwareChannelsMutex);
+		std::size_t retVal = 0;
+
+		if (channelIndex < hardwareChannels.size())
+		{
+			std::lock_guard<std::mutex> lock(hardwareChannels[channelIndex]->messagesToBeTransmittedMutex);
+			retVal = hardwareChannels[channelIndex]->transmitQueueHighWaterMark;
+		}
+		return retVal;
+	}
+
+	std::size_t CANHardwareInterface::get_receive_queue_high_water_mark(std::uint8_t channelIndex)
+	{
+		std::lock_guard<std::mutex> channelsLock(hardwareChannelsMutex);
+		std::size_t retVal = 0;
+
+		if (channelIndex < hardwareChannels.size())
+		{
+			std::lock_guard<std::mutex> lock(hardwareChannels[channelIndex]->receivedMessagesMutex);
+			retVal = hardwareChannels[channelIndex]->receiveQueueHighWaterMark;
+		}
+		return retVal;
+	}
+#endif
+
 	isobus::EventDispatcher<const isobus::CANMessageFrame &> &CANHardwareInterface::get_can_frame_received_event_dispatcher()
 	{
 		return frameReceivedEventDispatcher;
@@ -238,6 +416,7 @@ namespace isobus
 	void CANHardwareInterface::set_periodic_update_interval(std::uint32_t value)
 	{
 		periodicUpdateInterval = value;
+		request_update_thread_wakeup();
 	}
 
 	std::uint32_t CANHardwareInterface::get_periodic_update_interval()
@@ -251,57 +430,140 @@ namespace isobus
 		// Wait until everything is running
 		channelsLock.unlock();
 
+		std::uint32_t lastStackUpdateTimestamp_ms = 0;
+		std::uint32_t timeBetweenStackUpdates_ms = 0;
+		std::uint32_t lastPeriodicUpdateTimestamp_ms = 0;
+
 		while (threadsStarted)
 		{
+			// Sleep until a frame is received, something needs to be transmitted, or the next timer is due
+			std::uint32_t sleepTime_ms = SystemTiming::get_time_remaining_ms(lastStackUpdateTimestamp_ms, timeBetweenStackUpdates_ms);
+			const bool hasPeriodicUpdateListeners = (0 != periodicUpdateEventDispatcher.get_listener_count());
+
+			if (hasPeriodicUpdateListeners)
+			{
+				sleepTime_ms = std::min(sleepTime_ms, SystemTiming::get_time_remaining_ms(lastPeriodicUpdateTimestamp_ms, periodicUpdateInterval));
+			}
+			if (sleepTime_ms > MAX_UPDATE_THREAD_SLEEP_TIME_MS)
+			{
+				sleepTime_ms = MAX_UPDATE_THREAD_SLEEP_TIME_MS;
+			}
+
 			std::unique_lock<std::mutex> threadLock(updateMutex);
-			updateThreadWakeupCondition.wait_for(threadLock, std::chrono::seconds(1)); // Timeout after 1 second
+			updateThreadWakeupCondition.wait_for(threadLock, std::chrono::milliseconds(sleepTime_ms), [] { return updateThreadWakeupRequested; });
+			updateThreadWakeupRequested = false;
+			threadLock.unlock();
 
 			if (threadsStarted)
 			{
+				bool stackUpdateNeeded = (stackNeedsUpdate.exchange(false) ||
+				                          SystemTiming::time_expired_ms(lastStackUpdateTimestamp_ms, timeBetweenStackUpdates_ms));
+
 				// Stage 1 - Receiving messages from hardware
 				channelsLock.lock();
-				std::for_each(hardwareChannels.begin(), hardwareChannels.end(), [](const std::unique_ptr<CANHardware> &channel) {
-					std::lock_guard<std::mutex> lock(channel->receivedMessagesMutex);
-					while (!channel->receivedMessages.empty())
+				std::for_each(hardwareChannels.begin(), hardwareChannels.end(), [&stackUpdateNeeded](const std::unique_ptr<CANHardware> &channel) {
+					// Take everything that has been received so far in one go, so the receive thread isn't blocked while we process it
+					std::deque<isobus::CANMessageFrame> receivedFrames;
+					std::unique_lock<std::mutex> lock(channel->receivedMessagesMutex);
+					receivedFrames.swap(channel->receivedMessages);
+					lock.unlock();
+
+					for (const auto &frame : receivedFrames)
 					{
-						const auto &frame = channel->receivedMessages.front();
-
 						frameReceivedEventDispatcher.invoke(frame);
 						isobus::receive_can_message_frame_from_hardware(frame);
-
-						channel->receivedMessages.pop_front();
+					}
+					if (!receivedFrames.empty())
+					{
+						stackUpdateNeeded = true;
 					}
 				});
 				channelsLock.unlock();
 
 				// Stage 2 - Sending messages
-				if (stackNeedsUpdate)
+				if ((hasPeriodicUpdateListeners) &&
+				    (SystemTiming::time_expired_ms(lastPeriodicUpdateTimestamp_ms, periodicUpdateInterval)))
 				{
-					stackNeedsUpdate = false;
+					lastPeriodicUpdateTimestamp_ms = SystemTiming::get_timestamp_ms();
 					periodicUpdateEventDispatcher.invoke();
+				}
+
+				if (stackUpdateNeeded)
+				{
 					isobus::periodic_update_from_hardware();
+					lastStackUpdateTimestamp_ms = SystemTiming::get_timestamp_ms();
+					timeBetweenStackUpdates_ms = std::max(isobus::get_time_until_periodic_update_from_hardware(), periodicUpdateInterval);
 				}
 
+				channelsLock.lock();
+				for (std::size_t i = 0; i < hardwareChannels.size(); i++)
+				{
+					if (hardwareChannels[i]->receiveFiltersChanged.exchange(false))
+					{
+						update_receive_filters(static_cast<std::uint8_t>(i));
+					}
+				}
+				channelsLock.unlock();
+
 				// Stage 3 - Transmitting messages to hardware
 				channelsLock.lock();
-				std::for_each(hardwareChannels.begin(), hardwareChannels.end(), [](const std::unique_ptr<CANHardware> &channel) {
-					std::lock_guard<std::mutex> lock(channel->messagesToBeTransmittedMutex);
-					while (!channel->messagesToBeTransmitted.empty())
+				for (std::size_t i = 0; i < hardwareChannels.size(); i++)
+				{
+					const std::unique_ptr<CANHardware> &channel = hardwareChannels[i];
+					std::array<isobus::CANMessageFrame, FRAME_BATCH_SIZE> framesToTransmit;
+					std::unique_lock<std::mutex> lock(channel->messagesToBeTransmittedMutex);
+
+					std::size_t numberOfFrames = 0;
+					std::size_t totalFramesSent = 0;
+
+					do
 					{
-						const auto &frame = channel->messagesToBeTransmitted.front();
+						// Fill the batch in arbitration order, so that if the driver is congested, the frames it
+						// does take are the highest priority ones, and anything queued later can still overtake the rest
+						numberOfFrames = 0;
+						for (const auto &queue : channel->messagesToBeTransmitted)
+						{
+							const std::size_t framesFromQueue = std::min(queue.size(), framesToTransmit.size() - numberOfFrames);
+							std::copy_n(queue.begin(), framesFromQueue, framesToTransmit.begin() + numberOfFrames);
+							numberOfFrames += framesFromQueue;
+						}
 
-						if (transmit_can_frame_from_buffer(frame))
+						const std::size_t numberOfFramesSent = (0 != numberOfFrames) ? transmit_can_frames_from_buffer(static_cast<std::uint8_t>(i), framesToTransmit.data(), numberOfFrames) : 0;
+						for (std::size_t j = 0; j < numberOfFramesSent; j++)
 						{
-							frameTransmittedEventDispatcher.invoke(frame);
-							isobus::on_transmit_can_message_frame_from_hardware(frame);
-							channel->messagesToBeTransmitted.pop_front();
+							frameTransmittedEventDispatcher.invoke(framesToTransmit[j]);
+							isobus::on_transmit_can_message_frame_from_hardware(framesToTransmit[j]);
 						}
-						else
+
+						std::size_t framesToRemove = numberOfFramesSent;
+						for (auto &queue : channel->messagesToBeTransmitted)
+						{
+							const std::size_t framesFromQueue = std::min(queue.size(), framesToRemove);
+							queue.erase(queue.begin(), queue.begin() + framesFromQueue);
+							framesToRemove -= framesFromQueue;
+						}
+						channel->numberOfQueuedFrames -= numberOfFramesSent;
+						totalFramesSent += numberOfFramesSent;
+
+						if (numberOfFramesSent < numberOfFrames)
 						{
 							break;
 						}
+					} while (0 != numberOfFrames);
+
+					// Let the stack know it can resume whatever it had to hold back once the bus has taken some of the backlog
+					const bool transmitSpaceAvailable = ((channel->transmitBlocked) && (0 != totalFramesSent));
+					if (transmitSpaceAvailable)
+					{
+						channel->transmitBlocked = false;
 					}
-				});
+					lock.unlock();
+
+					if (transmitSpaceAvailable)
+					{
+						isobus::on_transmit_space_available_from_hardware(static_cast<std::uint8_t>(i));
+					}
+				}
 				channelsLock.unlock();
 			}
 		}
@@ -313,20 +575,20 @@ namespace isobus
 		// Wait until everything is running
 		channelsLock.unlock();
 
-		isobus::CANMessageFrame frame;
+		// Drivers that only support classical CAN don't touch the CAN FD fields, so start them cleared
+		std::array<isobus::CANMessageFrame, FRAME_BATCH_SIZE> frames = {};
 		while ((threadsStarted) &&
 		       (nullptr != hardwareChannels[channelIndex]->frameHandler))
 		{
 			if (hardwareChannels[channelIndex]->frameHandler->get_is_valid())
 			{
 				// Socket or other hardware still open
-				if (hardwareChannels[channelIndex]->frameHandler->read_frame(frame))
+				const std::size_t numberOfFrames = hardwareChannels[channelIndex]->frameHandler->read_frames(frames.data(), frames.size());
+
+				if (0 != numberOfFrames)
 				{
-					frame.channel = channelIndex;
-					std::unique_lock<std::mutex> receiveLock(hardwareChannels[channelIndex]->receivedMessagesMutex);
-					hardwareChannels[channelIndex]->receivedMessages.push_back(frame);
-					receiveLock.unlock();
-					updateThreadWakeupCondition.notify_all();
+					queue_received_frames(channelIndex, frames.data(), numberOfFrames);
+					request_update_thread_wakeup();
 				}
 			}
 			else
@@ -337,53 +599,223 @@ namespace isobus
 		}
 	}
 
-	bool CANHardwareInterface::transmit_can_frame_from_buffer(const isobus::CANMessageFrame &frame)
+	void CANHardwareInterface::shared_receive_thread_function()
+	{
+#ifdef __linux__
+		constexpr int POLL_TIMEOUT_MS = 100;
+		constexpr std::uint32_t CHANNEL_CHECK_INTERVAL_MS = 1000; // Same as the retry delay of a channel's own thread
+		std::unique_lock<std::mutex> channelsLock(hardwareChannelsMutex);
+		// Wait until everything is running
+		channelsLock.unlock();
+
+		std::array<struct epoll_event, CAN_PORT_MAXIMUM> events;
+		// Drivers that only support classical CAN don't touch the CAN FD fields, so start them cleared
+		std::array<isobus::CANMessageFrame, FRAME_BATCH_SIZE> frames = {};
+		std::uint32_t lastChannelCheckTimestamp_ms = SystemTiming::get_timestamp_ms();
+		while (threadsStarted)
+		{
+			const int numberOfEvents = epoll_wait(sharedReceivePollFileDescriptor, events.data(), static_cast<int>(events.size()), POLL_TIMEOUT_MS);
+			bool framesReceived = false;
+
+			for (int i = 0; i < numberOfEvents; i++)
+			{
+				const std::uint8_t channelIndex = static_cast<std::uint8_t>(events[i].data.u32);
+				const std::shared_ptr<CANHardwarePlugin> &frameHandler = hardwareChannels[channelIndex]->frameHandler;
+
+				if ((0 == (events[i].events & (EPOLLERR | EPOLLHUP))) &&
+				    (nullptr != frameHandler) &&
+				    (frameHandler->get_is_valid()))
+				{
+					// Level triggered, so anything left after one batch is picked up on the next wait
+					const std::size_t numberOfFrames = frameHandler->read_frames(frames.data(), frames.size());
+
+					if (0 != numberOfFrames)
+					{
+						queue_received_frames(channelIndex, frames.data(), numberOfFrames);
+						framesReceived = true;
+					}
+				}
+				else
+				{
+					// Stop waiting on it until the next channel check, otherwise the error would wake this thread up over and over
+					isobus::CANStackLogger::CAN_stack_log(isobus::CANStackLogger::LoggingLevel::Critical, "[CAN Rx Thread]: CAN Channel " + isobus::to_string(channelIndex) + " appears to be invalid.");
+					epoll_ctl(sharedReceivePollFileDescriptor, EPOLL_CTL_DEL, hardwareChannels[channelIndex]->sharedReceiveFileDescriptor, nullptr);
+					hardwareChannels[channelIndex]->sharedReceiveFileDescriptor = -1;
+				}
+			}
+
+			if (framesReceived)
+			{
+				request_update_thread_wakeup();
+			}
+
+			if (SystemTiming::time_expired_ms(lastChannelCheckTimestamp_ms, CHANNEL_CHECK_INTERVAL_MS))
+			{
+				lastChannelCheckTimestamp_ms = SystemTiming::get_timestamp_ms();
+				for (std::size_t i = 0; i < hardwareChannels.size(); i++)
+				{
+					if (hardwareChannels[i]->sharedReceiveChannel)
+					{
+						update_shared_receive_channel(static_cast<std::uint8_t>(i));
+					}
+				}
+			}
+		}
+#endif
+	}
+
+	bool CANHardwareInterface::add_shared_receive_channel(std::uint8_t channelIndex)
 	{
 		bool retVal = false;
-		if (frame.channel < hardwareChannels.size())
+
+#ifdef __linux__
+		const int fileDescriptor = hardwareChannels[channelIndex]->frameHandler->get_receive_file_descriptor();
+
+		if ((sharedReceiveThreadEnabled) && (fileDescriptor >= 0))
+		{
+			if (-1 == sharedReceivePollFileDescriptor)
+			{
+				sharedReceivePollFileDescriptor = epoll_create1(EPOLL_CLOEXEC);
+			}
+
+			if (-1 != sharedReceivePollFileDescriptor)
+			{
+				struct epoll_event event = {};
+				event.events = EPOLLIN;
+				event.data.u32 = channelIndex;
+				retVal = (0 == epoll_ctl(sharedReceivePollFileDescriptor, EPOLL_CTL_ADD, fileDescriptor, &event));
+			}
+
+			if (retVal)
+			{
+				hardwareChannels[channelIndex]->sharedReceiveFileDescriptor = fileDescriptor;
+				hardwareChannels[channelIndex]->sharedReceiveChannel = true;
+			}
+			else
+			{
+				isobus::CANStackLogger::warn("[HardwareInterface] Unable to add channel " + isobus::to_string(static_cast<int>(channelIndex)) + " to the shared receive thread, it will get its own thread instead.");
+			}
+		}
+#else
+		(void)channelIndex;
+#endif
+		return retVal;
+	}
+
+	void CANHardwareInterface::update_shared_receive_channel(std::uint8_t channelIndex)
+	{
+#ifdef __linux__
+		CANHardware &channel = *hardwareChannels[channelIndex];
+		const std::shared_ptr<CANHardwarePlugin> frameHandler = channel.frameHandler;
+		const int fileDescriptor = ((nullptr != frameHandler) && (frameHandler->get_is_valid())) ? frameHandler->get_receive_file_descriptor() : -1;
+
+		if ((-1 != channel.sharedReceiveFileDescriptor) && (fileDescriptor != channel.sharedReceiveFileDescriptor))
+		{
+			// This fails if the driver already closed the old descriptor, which removes it from the epoll instance anyway
+			epoll_ctl(sharedReceivePollFileDescriptor, EPOLL_CTL_DEL, channel.sharedReceiveFileDescriptor, nullptr);
+			channel.sharedReceiveFileDescriptor = -1;
+		}
+
+		if (fileDescriptor >= 0)
+		{
+			// Adding it again is the only way to notice a descriptor that was closed and reopened with the same number
+			struct epoll_event event = {};
+			event.events = EPOLLIN;
+			event.data.u32 = channelIndex;
+			if (0 == epoll_ctl(sharedReceivePollFileDescriptor, EPOLL_CTL_ADD, fileDescriptor, &event))
+			{
+				channel.sharedReceiveFileDescriptor = fileDescriptor;
+				isobus::CANStackLogger::info("[HardwareInterface] Channel " + isobus::to_string(static_cast<int>(channelIndex)) + " is being read by the shared receive thread again.");
+			}
+			else if (EEXIST == errno)
+			{
+				channel.sharedReceiveFileDescriptor = fileDescriptor;
+			}
+		}
+#else
+		(void)channelIndex;
+#endif
+	}
+
+	void CANHardwareInterface::queue_received_frames(std::uint8_t channelIndex, isobus::CANMessageFrame *frames, std::size_t numberOfFrames)
+	{
+		std::lock_guard<std::mutex> receiveLock(hardwareChannels[channelIndex]->receivedMessagesMutex);
+
+		for (std::size_t i = 0; i < numberOfFrames; i++)
 		{
-			retVal = ((nullptr != hardwareChannels[frame.channel]->frameHandler) &&
-			          (hardwareChannels[frame.channel]->frameHandler->write_frame(frame)));
+			frames[i].channel = channelIndex;
+			hardwareChannels[channelIndex]->receivedMessages.push_back(frames[i]);
+		}
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+		hardwareChannels[channelIndex]->receiveQueueHighWaterMark = std::max(hardwareChannels[channelIndex]->receiveQueueHighWaterMark, hardwareChannels[channelIndex]->receivedMessages.size());
+#endif
+	}
+
+	std::size_t CANHardwareInterface::transmit_can_frames_from_buffer(std::uint8_t channelIndex, const isobus::CANMessageFrame *frames, std::size_t numberOfFrames)
+	{
+		std::size_t retVal = 0;
+		if ((channelIndex < hardwareChannels.size()) &&
+		    (nullptr != hardwareChannels[channelIndex]->frameHandler))
+		{
+			retVal = hardwareChannels[channelIndex]->frameHandler->write_frames(frames, numberOfFrames);
 		}
 		return retVal;
 	}
 
-	void CANHardwareInterface::periodic_update_function()
+	std::uint8_t CANHardwareInterface::get_transmit_priority_class(const isobus::CANMessageFrame &frame)
 	{
-		std::unique_lock<std::mutex> channelsLock(hardwareChannelsMutex);
-		// Wait until everything is running
-		channelsLock.unlock();
+		std::uint8_t retVal;
 
-		while (threadsStarted)
+		if (frame.isExtendedFrame)
 		{
-			stackNeedsUpdate = true;
-			updateThreadWakeupCondition.notify_all();
-			std::this_thread::sleep_for(std::chrono::milliseconds(periodicUpdateInterval));
+			retVal = static_cast<std::uint8_t>((frame.identifier >> 26) & 0x07);
+		}
+		else
+		{
+			retVal = static_cast<std::uint8_t>((frame.identifier >> 8) & 0x07);
+		}
+		return retVal;
+	}
+
+	void CANHardwareInterface::request_update_thread_wakeup()
+	{
+		std::unique_lock<std::mutex> threadLock(updateMutex);
+		updateThreadWakeupRequested = true;
+		threadLock.unlock();
+		updateThreadWakeupCondition.notify_all();
+	}
+
+	void CANHardwareInterface::update_receive_filters(std::uint8_t channelIndex)
+	{
+		const std::shared_ptr<CANHardwarePlugin> &frameHandler = hardwareChannels[channelIndex]->frameHandler;
+
+		if (nullptr != frameHandler)
+		{
+			std::vector<isobus::CANReceiveFilter> filters;
+
+			if (!isobus::get_receive_filters_from_hardware(channelIndex, filters))
+			{
+				filters.clear();
+			}
+			frameHandler->set_receive_filters(filters);
 		}
 	}
 
 	void CANHardwareInterface::stop_threads()
 	{
 		threadsStarted = false;
+		stackUpdateRequestedListener = nullptr;
+		receiveFiltersChangedListener = nullptr;
 		if (nullptr != updateThread)
 		{
 			if (updateThread->joinable())
 			{
-				updateThreadWakeupCondition.notify_all();
+				request_update_thread_wakeup();
 				updateThread->join();
 			}
 			updateThread = nullptr;
 		}
 
-		if (nullptr != wakeupThread)
-		{
-			if (wakeupThread->joinable())
-			{
-				wakeupThread->join();
-			}
-			wakeupThread = nullptr;
-		}
-
 		std::for_each(hardwareChannels.begin(), hardwareChannels.end(), [](const std::unique_ptr<CANHardware> &channel) {
 			if (nullptr != channel->frameHandler)
 			{
@@ -398,5 +830,26 @@ namespace isobus
 				channel->receiveMessageThread = nullptr;
 			}
 		});
+
+		if (nullptr != sharedReceiveThread)
+		{
+			if (sharedReceiveThread->joinable())
+			{
+				sharedReceiveThread->join();
+			}
+			sharedReceiveThread = nullptr;
+		}
+		for (auto &channel : hardwareChannels)
+		{
+			channel->sharedReceiveFileDescriptor = -1;
+			channel->sharedReceiveChannel = false;
+		}
+#ifdef __linux__
+		if (-1 != sharedReceivePollFileDescriptor)
+		{
+			::close(sharedReceivePollFileDescriptor);
+			sharedReceivePollFileDescriptor = -1;
+		}
+#endif
 	}
 }
\ No newline at end of file
@@ -21,6 +21,7 @@ namespace isobus
 
 	std::vector<std::unique_ptr<CANHardwareInterface::CANHardware>> CANHardwareInterface::hardwareChannels;
 	bool CANHardwareInterface::started = false;
+	std::shared_ptr<std::function<void(const std::uint8_t &)>> CANHardwareInterface::receiveFiltersChangedListener;
 
 	CANHardwareInterface CANHardwareInterface::SINGLETON;
 
@@ -29,6 +30,11 @@ namespace isobus
 		return CANHardwareInterface::transmit_can_frame(frame);
 	}
 
+	CANTransmitResult try_send_can_message_frame_to_hardware(const CANMessageFrame &frame)
+	{
+		return CANHardwareInterface::try_transmit_can_frame(frame);
+	}
+
 	bool CANHardwareInterface::set_number_of_can_channels(std::uint8_t value)
 	{
 		if (started)
@@ -115,11 +121,20 @@ namespace isobus
 
 		started = true;
 
+		// The stack only changes its filters during its update, which runs on the same thread as the drivers here
+		receiveFiltersChangedListener = isobus::get_receive_filters_changed_event_dispatcher_from_hardware().add_listener([](const std::uint8_t &channelIndex) {
+			if (channelIndex < hardwareChannels.size())
+			{
+				update_receive_filters(channelIndex);
+			}
+		});
+
 		for (std::size_t i = 0; i < hardwareChannels.size(); i++)
 		{
 			if (nullptr != hardwareChannels[i]->frameHandler)
 			{
 				hardwareChannels[i]->frameHandler->open();
+				update_receive_filters(static_cast<std::uint8_t>(i));
 			}
 		}
 
@@ -134,12 +149,14 @@ namespace isobus
 			return false;
 		}
 
+		receiveFiltersChangedListener = nullptr;
 		std::for_each(hardwareChannels.begin(), hardwareChannels.end(), [](const std::unique_ptr<CANHardware> &channel) {
 			if (nullptr != channel->frameHandler)
 			{
 				channel->frameHandler = nullptr;
 			}
 			channel->messagesToBeTransmitted.clear();
+			channel->transmitBlocked = false;
 			channel->receivedMessages.clear();
 		});
 		return true;
@@ -150,32 +167,67 @@ namespace isobus
 	}
 
 	bool CANHardwareInterface::transmit_can_frame(const isobus::CANMessageFrame &frame)
+	{
+		return isobus::CANTransmitResult::Queued == try_transmit_can_frame(frame);
+	}
+
+	isobus::CANTransmitResult CANHardwareInterface::try_transmit_can_frame(const isobus::CANMessageFrame &frame)
 	{
 		if (!started)
 		{
 			isobus::CANStackLogger::error("[HardwareInterface] Cannot transmit message before interface is started.");
-			return false;
+			return isobus::CANTransmitResult::Failed;
 		}
 
 		if (frame.channel >= hardwareChannels.size())
 		{
 			isobus::CANStackLogger::error("[HardwareInterface] Cannot transmit message on channel %u, because there are only %u channels set.", frame.channel, hardwareChannels.size());
-			return false;
+			return isobus::CANTransmitResult::Failed;
 		}
 
 		const std::unique_ptr<CANHardware> &channel = hardwareChannels[frame.channel];
 		if (nullptr == channel->frameHandler)
 		{
 			isobus::CANStackLogger::error("[HardwareInterface] Cannot transmit message on channel %u, because it is not assigned.", frame.channel);
-			return false;
+			return isobus::CANTransmitResult::Failed;
 		}
 
 		if (channel->frameHandler->get_is_valid())
 		{
-			channel->messagesToBeTransmitted.push_back(frame);
-			return true;
+			if ((0 == channel->transmitQueueLimit) ||
+			    (channel->messagesToBeTransmitted.size() < channel->transmitQueueLimit))
+			{
+				channel->messagesToBeTransmitted.push_back(frame);
+				return isobus::CANTransmitResult::Queued;
+			}
+			channel->transmitBlocked = true;
+			return isobus::CANTransmitResult::WouldBlock;
+		}
+		return isobus::CANTransmitResult::Failed;
+	}
+
+	bool CANHardwareInterface::set_transmit_queue_limit(std::uint8_t channelIndex, std::size_t maxFrames)
+	{
+		if (channelIndex >= hardwareChannels.size())
+		{
+			isobus::CANStackLogger::error("[HardwareInterface] Unable to set transmit queue limit on channel " + isobus::to_string(channelIndex) +
+			                              ", because there are only " + isobus::to_string(hardwareChannels.size()) + " channels set.");
+			return false;
+		}
+
+		hardwareChannels[channelIndex]->transmitQueueLimit = maxFrames;
+		return true;
+	}
+
+	std::size_t CANHardwareInterface::get_transmit_queue_limit(std::uint8_t channelIndex)
+	{
+		std::size_t retVal = 0;
+
+		if (channelIndex < hardwareChannels.size())
+		{
+			retVal = hardwareChannels[channelIndex]->transmitQueueLimit;
 		}
-		return false;
+		return retVal;
 	}
 
 	isobus::EventDispatcher<const isobus::CANMessageFrame &> &CANHardwareInterface::get_can_frame_received_event_dispatcher()
@@ -211,7 +263,11 @@ namespace isobus
 			isobus::periodic_update_from_hardware();
 
 			// Stage 3 - Transmitting messages to hardware
-			std::for_each(hardwareChannels.begin(), hardwareChannels.end(), [](const std::unique_ptr<CANHardware> &channel) {
+			for (std::size_t i = 0; i < hardwareChannels.size(); i++)
+			{
+				const std::unique_ptr<CANHardware> &channel = hardwareChannels[i];
+				bool anyFramesSent = false;
+
 				while (!channel->messagesToBeTransmitted.empty())
 				{
 					const auto &frame = channel->messagesToBeTransmitted.front();
@@ -221,19 +277,27 @@ namespace isobus
 						frameTransmittedEventDispatcher.invoke(frame);
 						isobus::on_transmit_can_message_frame_from_hardware(frame);
 						channel->messagesToBeTransmitted.pop_front();
+						anyFramesSent = true;
 					}
 					else
 					{
 						break;
 					}
 				}
-			});
+
+				// Let the stack know it can resume whatever it had to hold back once the bus has taken some of the backlog
+				if ((channel->transmitBlocked) && (anyFramesSent))
+				{
+					channel->transmitBlocked = false;
+					isobus::on_transmit_space_available_from_hardware(static_cast<std::uint8_t>(i));
+				}
+			}
 		}
 	}
 
 	void CANHardwareInterface::receive_can_frame(std::uint8_t channelIndex)
 	{
-		isobus::CANMessageFrame frame;
+		isobus::CANMessageFrame frame = {};
 		if (started &&
 		    (nullptr != hardwareChannels[channelIndex]->frameHandler))
 		{
@@ -263,4 +327,20 @@ namespace isobus
 		}
 		return retVal;
 	}
+
+	void CANHardwareInterface::update_receive_filters(std::uint8_t channelIndex)
+	{
+		const std::shared_ptr<CANHardwarePlugin> &frameHandler = hardwareChannels[channelIndex]->frameHandler;
+
+		if (nullptr != frameHandler)
+		{
+			std::vector<isobus::CANReceiveFilter> filters;
+
+			if (!isobus::get_receive_filters_from_hardware(channelIndex, filters))
+			{
+				filters.clear();
+			}
+			frameHandler->set_receive_filters(filters);
+		}
+	}
 } // namespace isobus
\ No newline at end of file
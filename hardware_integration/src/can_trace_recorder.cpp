@@ -0,0 +1,174 @@
+//================================================================================================
+/// @file can_trace_recorder.cpp
+///
+/// @brief Records every frame the hardware interface sends or receives into a memory-mapped trace file
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#include "isobus/hardware_integration/can_trace_recorder.hpp"
+#include "isobus/isobus/can_stack_logger.hpp"
+
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+#include "isobus/hardware_integration/can_hardware_interface.hpp"
+#else
+#include "isobus/hardware_integration/can_hardware_interface_single_thread.hpp"
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace isobus
+{
+	static_assert(64 == sizeof(CANTraceFileHeader), "The trace file header must not change size");
+	static_assert(88 == sizeof(CANTraceRecord), "Trace records must not change size");
+	static_assert(std::is_trivially_copyable<CANTraceRecord>::value, "Trace records are copied straight into the file");
+
+	CANTraceRecorder::~CANTraceRecorder()
+	{
+		close();
+	}
+
+	bool CANTraceRecorder::open(const std::string &filePath, std::uint64_t capacity)
+	{
+		if (get_is_open())
+		{
+			CANStackLogger::error("[Trace]: Cannot open " + filePath + ", the recorder is already open.");
+			return false;
+		}
+
+		if ((0 == capacity) || (capacity > (static_cast<std::uint64_t>(1) << 32)))
+		{
+			CANStackLogger::error("[Trace]: Cannot open " + filePath + ", the capacity must be between 1 and 2^32 frames.");
+			return false;
+		}
+
+		std::uint64_t roundedCapacity = 1;
+		while (roundedCapacity < capacity)
+		{
+			roundedCapacity <<= 1;
+		}
+
+		fileDescriptor = ::open(filePath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (-1 == fileDescriptor)
+		{
+			CANStackLogger::error("[Trace]: Unable to create " + filePath);
+			return false;
+		}
+
+		mappedSize = static_cast<std::size_t>(sizeof(CANTraceFileHeader) + (roundedCapacity * sizeof(CANTraceRecord)));
+		if (0 != ftruncate(fileDescriptor, static_cast<off_t>(mappedSize)))
+		{
+			CANStackLogger::error("[Trace]: Unable to size " + filePath + " for the requested capacity");
+			::close(fileDescriptor);
+			fileDescriptor = -1;
+			return false;
+		}
+
+		int mappingFlags = MAP_SHARED;
+#ifdef MAP_POPULATE
+		// Fault every page in now, rather than the first time each one is recorded into
+		mappingFlags |= MAP_POPULATE;
+#endif
+		void *mapping = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, mappingFlags, fileDescriptor, 0);
+		if (MAP_FAILED == mapping)
+		{
+			CANStackLogger::error("[Trace]: Unable to map " + filePath + " into memory");
+			::close(fileDescriptor);
+			fileDescriptor = -1;
+			return false;
+		}
+
+		header = static_cast<CANTraceFileHeader *>(mapping);
+		records = reinterpret_cast<CANTraceRecord *>(static_cast<std::uint8_t *>(mapping) + sizeof(CANTraceFileHeader));
+		capacityMask = roundedCapacity - 1;
+		nextRecordNumber = 0;
+		publishedRecords = 0;
+
+		std::memset(header, 0, sizeof(CANTraceFileHeader));
+		header->magic = CANTraceFileHeader::MAGIC;
+		header->version = CANTraceFileHeader::CURRENT_VERSION;
+		header->recordSize = sizeof(CANTraceRecord);
+		header->capacity = roundedCapacity;
+
+		frameReceivedListener = CANHardwareInterface::get_can_frame_received_event_dispatcher().add_listener([this](const CANMessageFrame &frame) { record(frame, false); });
+		frameTransmittedListener = CANHardwareInterface::get_can_frame_transmitted_event_dispatcher().add_listener([this](const CANMessageFrame &frame) { record(frame, true); });
+		return true;
+	}
+
+	void CANTraceRecorder::close()
+	{
+		if (get_is_open())
+		{
+			frameReceivedListener.reset();
+			frameTransmittedListener.reset();
+
+			// The dispatchers hold their lock while calling listeners, so taking it here waits out any frame still being recorded
+			CANHardwareInterface::get_can_frame_received_event_dispatcher().get_listener_count();
+			CANHardwareInterface::get_can_frame_transmitted_event_dispatcher().get_listener_count();
+
+			msync(header, mappedSize, MS_SYNC);
+			munmap(header, mappedSize);
+			::close(fileDescriptor);
+			header = nullptr;
+			records = nullptr;
+			mappedSize = 0;
+			capacityMask = 0;
+			fileDescriptor = -1;
+		}
+	}
+
+	bool CANTraceRecorder::get_is_open() const
+	{
+		return (nullptr != header);
+	}
+
+	std::uint64_t CANTraceRecorder::get_capacity() const
+	{
+		return get_is_open() ? (capacityMask + 1) : 0;
+	}
+
+	std::uint64_t CANTraceRecorder::get_number_of_records() const
+	{
+		return publishedRecords.load(std::memory_order_acquire);
+	}
+
+	void CANTraceRecorder::record(const CANMessageFrame &frame, bool transmitted)
+	{
+		if (nullptr != records)
+		{
+			const std::uint64_t recordNumber = nextRecordNumber.fetch_add(1, std::memory_order_relaxed);
+			CANTraceRecord &slot = records[recordNumber & capacityMask];
+
+			// The frame's own timestamp is in the driver's time base, and is missing for some drivers and for transmitted frames,
+			// so replay needs a time from one clock that every record has
+			slot.recordTime_us = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+			slot.timestamp_us = frame.timestamp_us;
+			slot.identifier = frame.identifier;
+			slot.channel = frame.channel;
+			slot.flags = static_cast<std::uint8_t>((frame.isExtendedFrame ? CANTraceRecord::EXTENDED_FRAME_FLAG : 0) |
+			                                       (frame.isFDFrame ? CANTraceRecord::FD_FRAME_FLAG : 0) |
+			                                       (frame.isBitRateSwitch ? CANTraceRecord::BIT_RATE_SWITCH_FLAG : 0) |
+			                                       (transmitted ? CANTraceRecord::TRANSMITTED_FLAG : 0));
+			slot.dataLength = frame.dataLength;
+			slot.reserved = 0;
+			std::memcpy(slot.data, frame.data, sizeof(slot.data));
+
+			// Publish records in order, so the header never counts one that another thread is still writing.
+			// Received and transmitted frames come from different dispatchers, and anyone can call this, so writers can overlap.
+			// The wait is only for another writer to finish its copy, so give up the CPU rather than spin in case it was preempted.
+			while (recordNumber != publishedRecords.load(std::memory_order_acquire))
+			{
+				std::this_thread::yield();
+			}
+			header->recordsWritten = recordNumber + 1;
+			publishedRecords.store(recordNumber + 1, std::memory_order_release);
+		}
+	}
+} // namespace isobus
@@ -0,0 +1,533 @@
+//================================================================================================
+/// @file can_trace_replay_plugin.cpp
+///
+/// @brief A CAN driver that replays a recorded trace into the stack, for benchmarking and testing.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#include "isobus/hardware_integration/can_trace_replay_plugin.hpp"
+#include "isobus/hardware_integration/can_trace_format.hpp"
+#include "isobus/isobus/can_stack_logger.hpp"
+#include "isobus/utility/to_string.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <thread>
+
+namespace isobus
+{
+	namespace
+	{
+		/// @brief Parses a whole string as an unsigned number
+		/// @param[in] text The text to parse
+		/// @param[in] base The base of the number
+		/// @param[out] value The parsed number
+		/// @returns `true` if the whole string was a number, otherwise `false`
+		bool parse_number(const std::string &text, int base, std::uint32_t &value)
+		{
+			char *end = nullptr;
+			bool retVal = false;
+
+			if ((!text.empty()) && (0 != std::isxdigit(static_cast<unsigned char>(text[0]))))
+			{
+				const unsigned long parsedValue = std::strtoul(text.c_str(), &end, base);
+				retVal = (('\0' == *end) && (parsedValue <= 0xFFFFFFFF));
+				value = static_cast<std::uint32_t>(parsedValue);
+			}
+			return retVal;
+		}
+	} // namespace
+
+	CANTraceReplayPlugin::CANTraceReplayPlugin(const std::string &filePath, TraceFormat format) :
+	  filePath(filePath),
+	  format(format)
+	{
+	}
+
+	bool CANTraceReplayPlugin::set_replay_mode(ReplayMode mode, float speedFactor)
+	{
+		bool retVal = false;
+
+		if ((!running) && (speedFactor > 0.0f))
+		{
+			replayMode = mode;
+			this->speedFactor = (ReplayMode::ScaledTime == mode) ? speedFactor : 1.0f;
+			retVal = true;
+		}
+		return retVal;
+	}
+
+	CANTraceReplayPlugin::ReplayMode CANTraceReplayPlugin::get_replay_mode() const
+	{
+		return replayMode;
+	}
+
+	bool CANTraceReplayPlugin::set_trace_channel(std::uint8_t channel)
+	{
+		bool retVal = false;
+
+		if (!running)
+		{
+			traceChannel = channel;
+			retVal = true;
+		}
+		return retVal;
+	}
+
+	bool CANTraceReplayPlugin::set_replay_transmitted_frames(bool replayTransmitted)
+	{
+		bool retVal = false;
+
+		if (!running)
+		{
+			replayTransmittedFrames = replayTransmitted;
+			retVal = true;
+		}
+		return retVal;
+	}
+
+	bool CANTraceReplayPlugin::get_is_valid() const
+	{
+		return running;
+	}
+
+	void CANTraceReplayPlugin::close()
+	{
+		running = false;
+		frames.clear();
+		frames.shrink_to_fit();
+		nextFrameIndex = 0;
+	}
+
+	void CANTraceReplayPlugin::open()
+	{
+		std::ifstream file(filePath, std::ios::binary);
+		bool loaded = false;
+
+		frames.clear();
+		nextFrameIndex = 0;
+		numberOfFramesWritten = 0;
+
+		if (file)
+		{
+			switch ((TraceFormat::Automatic == format) ? detect_format(file) : format)
+			{
+				case TraceFormat::Candump:
+				{
+					loaded = load_candump(file);
+				}
+				break;
+
+				case TraceFormat::VectorASC:
+				{
+					loaded = load_vector_asc(file);
+				}
+				break;
+
+				case TraceFormat::Binary:
+				{
+					loaded = load_binary(file);
+				}
+				break;
+
+				default:
+					break;
+			}
+		}
+
+		if (loaded)
+		{
+			CANStackLogger::info("[Replay]: Loaded " + isobus::to_string(frames.size()) + " frames from " + filePath);
+			running = true;
+		}
+		else
+		{
+			CANStackLogger::error("[Replay]: Unable to load trace " + filePath);
+			frames.clear();
+		}
+	}
+
+	bool CANTraceReplayPlugin::read_frame(isobus::CANMessageFrame &canFrame)
+	{
+		return (1 == read_frames(&canFrame, 1));
+	}
+
+	bool CANTraceReplayPlugin::write_frame(const isobus::CANMessageFrame &)
+	{
+		numberOfFramesWritten++;
+		return true;
+	}
+
+	std::size_t CANTraceReplayPlugin::read_frames(isobus::CANMessageFrame *canFrames, std::size_t maxFrames)
+	{
+		std::size_t retVal = 0;
+		std::size_t frameIndex = nextFrameIndex;
+
+		if ((!running) || (0 == maxFrames))
+		{
+			return 0;
+		}
+
+		if (frameIndex >= frames.size())
+		{
+			// Nothing left to replay, so behave like an idle bus
+			std::this_thread::sleep_for(std::chrono::milliseconds(READ_TIMEOUT_MS));
+			return 0;
+		}
+
+		if (ReplayMode::AsFastAsPossible == replayMode)
+		{
+			retVal = std::min(maxFrames, frames.size() - frameIndex);
+			for (std::size_t i = 0; i < retVal; i++)
+			{
+				canFrames[i] = frames[frameIndex + i].frame;
+			}
+		}
+		else
+		{
+			if (0 == frameIndex)
+			{
+				replayStartTime = std::chrono::steady_clock::now();
+			}
+
+			const std::chrono::steady_clock::time_point dueTime = get_due_time(frameIndex);
+			const std::chrono::steady_clock::time_point timeoutTime = std::chrono::steady_clock::now() + std::chrono::milliseconds(READ_TIMEOUT_MS);
+			std::this_thread::sleep_until(std::min(dueTime, timeoutTime));
+
+			const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+			while ((retVal < maxFrames) &&
+			       ((frameIndex + retVal) < frames.size()) &&
+			       (get_due_time(frameIndex + retVal) <= now))
+			{
+				canFrames[retVal] = frames[frameIndex + retVal].frame;
+				retVal++;
+			}
+		}
+		nextFrameIndex = frameIndex + retVal;
+		return retVal;
+	}
+
+	std::size_t CANTraceReplayPlugin::get_number_of_frames() const
+	{
+		return frames.size();
+	}
+
+	std::size_t CANTraceReplayPlugin::get_number_of_frames_replayed() const
+	{
+		return nextFrameIndex;
+	}
+
+	std::size_t CANTraceReplayPlugin::get_number_of_frames_written() const
+	{
+		return numberOfFramesWritten;
+	}
+
+	bool CANTraceReplayPlugin::get_is_finished() const
+	{
+		return (running) && (nextFrameIndex >= frames.size());
+	}
+
+	CANTraceReplayPlugin::TraceFormat CANTraceReplayPlugin::detect_format(std::istream &file)
+	{
+		TraceFormat retVal = TraceFormat::VectorASC;
+		CANTraceFileHeader header;
+
+		if ((file.read(reinterpret_cast<char *>(&header), sizeof(header))) &&
+		    (CANTraceFileHeader::MAGIC == header.magic))
+		{
+			retVal = TraceFormat::Binary;
+		}
+		else
+		{
+			std::string line;
+
+			file.clear();
+			file.seekg(0);
+			while (std::getline(file, line))
+			{
+				const std::size_t firstCharacter = line.find_first_not_of(" \t\r");
+
+				if (std::string::npos != firstCharacter)
+				{
+					if ('(' == line[firstCharacter])
+					{
+						retVal = TraceFormat::Candump;
+					}
+					break;
+				}
+			}
+		}
+		file.clear();
+		file.seekg(0);
+		return retVal;
+	}
+
+	bool CANTraceReplayPlugin::parse_time(const std::string &text, std::uint64_t &time_us)
+	{
+		constexpr std::size_t MICROSECOND_DIGITS = 6;
+		const std::size_t decimalPoint = text.find('.');
+		const std::string seconds = text.substr(0, decimalPoint);
+		std::string fraction = (std::string::npos != decimalPoint) ? text.substr(decimalPoint + 1) : "";
+		bool retVal = false;
+
+		// Parsed as integers, since a double can't hold an epoch time to the microsecond
+		if ((!seconds.empty()) &&
+		    (std::all_of(seconds.begin(), seconds.end(), [](char character) { return 0 != std::isdigit(static_cast<unsigned char>(character)); })) &&
+		    (std::all_of(fraction.begin(), fraction.end(), [](char character) { return 0 != std::isdigit(static_cast<unsigned char>(character)); })))
+		{
+			fraction.resize(MICROSECOND_DIGITS, '0');
+			time_us = (std::strtoull(seconds.c_str(), nullptr, 10) * 1000000) + std::strtoull(fraction.c_str(), nullptr, 10);
+			retVal = true;
+		}
+		return retVal;
+	}
+
+	bool CANTraceReplayPlugin::load_candump(std::istream &file)
+	{
+		std::map<std::string, std::uint8_t> interfaceChannels;
+		std::string line;
+
+		while (std::getline(file, line))
+		{
+			std::istringstream tokens(line);
+			std::string timeText;
+			std::string interfaceName;
+			std::string frameText;
+			std::string direction;
+			std::uint64_t time_us = 0;
+
+			if ((!(tokens >> timeText >> interfaceName >> frameText)) ||
+			    (timeText.size() < 3) ||
+			    ('(' != timeText.front()) ||
+			    (')' != timeText.back()) ||
+			    (!parse_time(timeText.substr(1, timeText.size() - 2), time_us)))
+			{
+				continue;
+			}
+			tokens >> direction;
+
+			const std::size_t separator = frameText.find('#');
+			if (std::string::npos == separator)
+			{
+				continue;
+			}
+
+			CANMessageFrame frame = {};
+			std::string dataText = frameText.substr(separator + 1);
+			const std::string identifierText = frameText.substr(0, separator);
+			std::uint32_t identifier = 0;
+			bool valid = parse_number(identifierText, 16, identifier);
+
+			frame.identifier = identifier;
+			frame.isExtendedFrame = (identifierText.size() > 3);
+
+			if ((!dataText.empty()) && ('#' == dataText.front()))
+			{
+				// CAN FD frames have a second separator, followed by a flags digit
+				std::uint32_t flags = 0;
+				valid = valid && (dataText.size() >= 2) && parse_number(dataText.substr(1, 1), 16, flags);
+				frame.isFDFrame = true;
+				frame.isBitRateSwitch = (0 != (flags & 0x01));
+				dataText = dataText.substr(std::min<std::size_t>(2, dataText.size()));
+			}
+			else if ((!dataText.empty()) && ('R' == dataText.front()))
+			{
+				// Remote frames aren't used by ISOBUS
+				continue;
+			}
+
+			dataText.erase(std::remove(dataText.begin(), dataText.end(), '.'), dataText.end());
+			const std::size_t maximumLength = frame.isFDFrame ? CAN_FD_DATA_LENGTH : CAN_DATA_LENGTH;
+			valid = valid && (0 == (dataText.size() % 2)) && ((dataText.size() / 2) <= maximumLength);
+
+			for (std::size_t i = 0; valid && (i < dataText.size() / 2); i++)
+			{
+				std::uint32_t byte = 0;
+				valid = parse_number(dataText.substr(i * 2, 2), 16, byte);
+				frame.data[i] = static_cast<std::uint8_t>(byte);
+			}
+			frame.dataLength = static_cast<std::uint8_t>(dataText.size() / 2);
+
+			if (valid)
+			{
+				const auto interfaceChannel = interfaceChannels.insert(std::make_pair(interfaceName, static_cast<std::uint8_t>(interfaceChannels.size())));
+				add_frame(time_us, interfaceChannel.first->second, ("T" == direction), frame);
+			}
+		}
+		return true;
+	}
+
+	bool CANTraceReplayPlugin::load_vector_asc(std::istream &file)
+	{
+		std::string line;
+		int base = 16;
+		bool relativeTimestamps = false;
+		std::uint64_t previousTime_us = 0;
+
+		while (std::getline(file, line))
+		{
+			std::istringstream tokens(line);
+			std::vector<std::string> fields;
+			std::string field;
+			std::uint64_t time_us = 0;
+
+			while (tokens >> field)
+			{
+				fields.push_back(field);
+			}
+
+			if ((fields.size() >= 2) && ("base" == fields[0]))
+			{
+				base = ("dec" == fields[1]) ? 10 : 16;
+				relativeTimestamps = (fields.size() >= 4) && ("relative" == fields[3]);
+				continue;
+			}
+
+			if ((fields.size() < 6) || (!parse_time(fields[0], time_us)))
+			{
+				continue;
+			}
+
+			if (relativeTimestamps)
+			{
+				time_us += previousTime_us;
+				previousTime_us = time_us;
+			}
+
+			CANMessageFrame frame = {};
+			std::uint32_t channel = 0;
+			std::size_t dataIndex = 0;
+			std::size_t dataLength = 0;
+			std::string identifierText;
+			std::string direction;
+			bool valid = false;
+
+			if ("CANFD" == fields[1])
+			{
+				// <time> CANFD <channel> <Rx|Tx> <id> [symbolic name] <brs> <esi> <dlc> <data length> <data>...
+				std::size_t flagsIndex = 5;
+				if ((fields.size() > 6) && (!(("0" == fields[5] || "1" == fields[5]) && ("0" == fields[6] || "1" == fields[6]))))
+				{
+					flagsIndex = 6;
+				}
+
+				std::uint32_t length = 0;
+				if ((fields.size() > flagsIndex + 3) &&
+				    parse_number(fields[2], 10, channel) &&
+				    parse_number(fields[flagsIndex + 3], 10, length))
+				{
+					direction = fields[3];
+					identifierText = fields[4];
+					frame.isFDFrame = true;
+					frame.isBitRateSwitch = ("1" == fields[flagsIndex]);
+					dataIndex = flagsIndex + 4;
+					dataLength = length;
+					valid = (dataLength <= CAN_FD_DATA_LENGTH);
+				}
+			}
+			else
+			{
+				// <time> <channel> <id> <Rx|Tx> d <dlc> <data>...
+				std::uint32_t length = 0;
+				if (parse_number(fields[1], 10, channel) &&
+				    ("d" == fields[4]) &&
+				    parse_number(fields[5], 16, length))
+				{
+					identifierText = fields[2];
+					direction = fields[3];
+					dataIndex = 6;
+					dataLength = length;
+					valid = (dataLength <= CAN_DATA_LENGTH);
+				}
+			}
+
+			if ((!identifierText.empty()) && ('x' == identifierText.back()))
+			{
+				frame.isExtendedFrame = true;
+				identifierText.pop_back();
+			}
+
+			std::uint32_t identifier = 0;
+			valid = valid && (0 != channel) && (fields.size() >= (dataIndex + dataLength)) && parse_number(identifierText, base, identifier);
+			frame.identifier = identifier;
+			frame.dataLength = static_cast<std::uint8_t>(dataLength);
+
+			for (std::size_t i = 0; valid && (i < dataLength); i++)
+			{
+				std::uint32_t byte = 0;
+				valid = parse_number(fields[dataIndex + i], base, byte) && (byte <= 0xFF);
+				frame.data[i] = static_cast<std::uint8_t>(byte);
+			}
+
+			if (valid)
+			{
+				add_frame(time_us, static_cast<std::uint8_t>(channel - 1), ("Tx" == direction), frame);
+			}
+		}
+		return true;
+	}
+
+	bool CANTraceReplayPlugin::load_binary(std::istream &file)
+	{
+		CANTraceFileHeader header;
+		bool retVal = false;
+
+		if ((file.read(reinterpret_cast<char *>(&header), sizeof(header))) &&
+		    (CANTraceFileHeader::MAGIC == header.magic) &&
+		    (CANTraceFileHeader::CURRENT_VERSION == header.version) &&
+		    (sizeof(CANTraceRecord) == header.recordSize) &&
+		    (0 != header.capacity))
+		{
+			std::vector<CANTraceRecord> records(static_cast<std::size_t>(std::min(header.capacity, header.recordsWritten)));
+
+			// Once the ring has wrapped, the oldest frame left is in the slot after the newest one
+			const std::uint64_t firstRecord = (header.recordsWritten > header.capacity) ? (header.recordsWritten - header.capacity) : 0;
+			retVal = static_cast<bool>(file.read(reinterpret_cast<char *>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(CANTraceRecord))));
+
+			for (std::uint64_t recordNumber = firstRecord; retVal && (recordNumber < header.recordsWritten); recordNumber++)
+			{
+				const CANTraceRecord &record = records[static_cast<std::size_t>(recordNumber % header.capacity)];
+				CANMessageFrame frame = {};
+
+				if (record.dataLength <= CAN_FD_DATA_LENGTH)
+				{
+					frame.identifier = record.identifier;
+					frame.isExtendedFrame = (0 != (record.flags & CANTraceRecord::EXTENDED_FRAME_FLAG));
+					frame.isFDFrame = (0 != (record.flags & CANTraceRecord::FD_FRAME_FLAG));
+					frame.isBitRateSwitch = (0 != (record.flags & CANTraceRecord::BIT_RATE_SWITCH_FLAG));
+					frame.dataLength = record.dataLength;
+					std::memcpy(frame.data, record.data, record.dataLength);
+					add_frame(record.recordTime_us, record.channel, (0 != (record.flags & CANTraceRecord::TRANSMITTED_FLAG)), frame);
+				}
+			}
+		}
+		return retVal;
+	}
+
+	void CANTraceReplayPlugin::add_frame(std::uint64_t time_us, std::uint8_t channel, bool transmitted, const CANMessageFrame &frame)
+	{
+		if (((-1 == traceChannel) || (channel == traceChannel)) &&
+		    ((replayTransmittedFrames) || (!transmitted)))
+		{
+			TraceFrame traceFrame;
+			traceFrame.time_us = time_us;
+			traceFrame.frame = frame;
+			// The stack uses its own receive time, since the trace's time base means nothing to it
+			traceFrame.frame.timestamp_us = 0;
+			traceFrame.frame.channel = 0;
+			frames.push_back(traceFrame);
+		}
+	}
+
+	std::chrono::steady_clock::time_point CANTraceReplayPlugin::get_due_time(std::size_t index) const
+	{
+		const std::uint64_t traceOffset_us = (frames[index].time_us > frames[0].time_us) ? (frames[index].time_us - frames[0].time_us) : 0;
+		return replayStartTime + std::chrono::microseconds(static_cast<std::int64_t>(static_cast<double>(traceOffset_us) / speedFactor));
+	}
+} // namespace isobus
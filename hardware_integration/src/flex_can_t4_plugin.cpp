@@ -93,6 +93,8 @@ namespace isobus
 		canFrame.identifier = message.id;
 		canFrame.dataLength = message.len;
 		canFrame.isExtendedFrame = message.flags.extended;
+		canFrame.isFDFrame = false;
+		canFrame.isBitRateSwitch = false;
 		return retVal;
 	}
 
@@ -101,26 +103,30 @@ namespace isobus
 		CAN_message_t message;
 		bool retVal = false;
 
-		message.id = canFrame.identifier;
-		message.len = canFrame.dataLength;
-		message.flags.extended = true;
-		message.seq = true; // Ask for sequential transmission
-		memcpy(message.buf, canFrame.data, canFrame.dataLength);
-
-		if (0 == selectedChannel)
-		{
-			retVal = can0.write(message);
-		}
-		else if (1 == selectedChannel)
+		// The buses are set up for classical CAN, so only up to 8 bytes fit in a message
+		if ((!canFrame.isFDFrame) && (canFrame.dataLength <= isobus::CAN_DATA_LENGTH))
 		{
-			retVal = can1.write(message);
-		}
+			message.id = canFrame.identifier;
+			message.len = canFrame.dataLength;
+			message.flags.extended = true;
+			message.seq = true; // Ask for sequential transmission
+			memcpy(message.buf, canFrame.data, canFrame.dataLength);
+
+			if (0 == selectedChannel)
+			{
+				retVal = can0.write(message);
+			}
+			else if (1 == selectedChannel)
+			{
+				retVal = can1.write(message);
+			}
 #if defined(__IMXRT1062__)
-		else if (2 == selectedChannel)
-		{
-			retVal = can2.write(message);
-		}
+			else if (2 == selectedChannel)
+			{
+				retVal = can2.write(message);
+			}
 #endif
+		}
 		return retVal;
 	}
 }
@@ -286,6 +286,8 @@ namespace isobus
 
 		canFrame.dataLength = frame.can_dlc;
 		canFrame.isExtendedFrame = frame.can_id & CAN_EFF_FLAG;
+		canFrame.isFDFrame = false;
+		canFrame.isBitRateSwitch = false;
 		if (canFrame.isExtendedFrame)
 		{
 			canFrame.identifier = frame.can_id & CAN_EFF_MASK;
@@ -301,6 +303,12 @@ namespace isobus
 
 	bool InnoMakerUSB2CANWindowsPlugin::write_frame(const isobus::CANMessageFrame &canFrame)
 	{
+		// The adapter's host frame only carries classical CAN payloads
+		if ((canFrame.isFDFrame) || (canFrame.dataLength > isobus::CAN_DATA_LENGTH))
+		{
+			return false;
+		}
+
 		InnoMakerUsb2CanLib::InnoMakerDevice *device = driverInstance->getInnoMakerDevice(channel);
 		if (nullptr == device)
 		{
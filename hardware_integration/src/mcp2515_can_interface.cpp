@@ -247,6 +247,8 @@ namespace isobus
 			}
 
 			canFrame.dataLength = (buffer[5] & 0x0F);
+			canFrame.isFDFrame = false;
+			canFrame.isBitRateSwitch = false;
 			if (isobus::CAN_DATA_LENGTH >= canFrame.dataLength)
 			{
 				if ((read_register(dataRegister, canFrame.data, canFrame.dataLength)) &&
@@ -299,9 +301,13 @@ namespace isobus
 	{
 		bool retVal = false;
 
-		// Check if the write buffer is empty
+		// The MCP2515 is a classical CAN controller, so its transmit buffers hold 8 bytes of data
 		std::uint8_t ctrl;
-		if (read_register(ctrlRegister, ctrl))
+		if ((canFrame.isFDFrame) || (canFrame.dataLength > isobus::CAN_DATA_LENGTH))
+		{
+			isobus::CANStackLogger::error("[MCP2515] Failed to send message, CAN FD frames are not supported.");
+		}
+		else if (read_register(ctrlRegister, ctrl)) // Check if the write buffer is empty
 		{
 			if ((ctrl & 0x08) == 0)
 			{
@@ -61,6 +61,8 @@ namespace isobus
 			memcpy(canFrame.data, CANMsg.DATA, CANMsg.LEN);
 			canFrame.identifier = CANMsg.ID;
 			canFrame.isExtendedFrame = (PCAN_MESSAGE_EXTENDED == CANMsg.MSGTYPE);
+			canFrame.isFDFrame = false;
+			canFrame.isBitRateSwitch = false;
 			canFrame.timestamp_us = (CANTimeStamp.millis * 1000) + CANTimeStamp.micros;
 			retVal = true;
 		}
@@ -73,16 +75,20 @@ namespace isobus
 
 	bool PCANBasicWindowsPlugin::write_frame(const isobus::CANMessageFrame &canFrame)
 	{
-		TPCANStatus result;
-		TPCANMsg msgCanMessage;
+		TPCANStatus result = PCAN_ERROR_ILLDATA;
 
-		msgCanMessage.ID = canFrame.identifier;
-		msgCanMessage.LEN = canFrame.dataLength;
-		msgCanMessage.MSGTYPE = canFrame.isExtendedFrame ? PCAN_MESSAGE_EXTENDED : PCAN_MESSAGE_STANDARD;
-		memcpy(msgCanMessage.DATA, canFrame.data, canFrame.dataLength);
+		// TPCANMsg only has room for a classical CAN frame
+		if ((!canFrame.isFDFrame) && (canFrame.dataLength <= isobus::CAN_DATA_LENGTH))
+		{
+			TPCANMsg msgCanMessage;
 
-		result = CAN_Write(handle, &msgCanMessage);
+			msgCanMessage.ID = canFrame.identifier;
+			msgCanMessage.LEN = canFrame.dataLength;
+			msgCanMessage.MSGTYPE = canFrame.isExtendedFrame ? PCAN_MESSAGE_EXTENDED : PCAN_MESSAGE_STANDARD;
+			memcpy(msgCanMessage.DATA, canFrame.data, canFrame.dataLength);
 
+			result = CAN_Write(handle, &msgCanMessage);
+		}
 		return (PCAN_ERROR_OK == result);
 	}
 }
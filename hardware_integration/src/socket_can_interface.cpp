@@ -9,15 +9,18 @@
 #include "isobus/hardware_integration/socket_can_interface.hpp"
 #include "isobus/isobus/can_stack_logger.hpp"
 #include "isobus/utility/system_timing.hpp"
+#include "isobus/utility/to_string.hpp"
 
 #include <linux/can.h>
 #include <linux/can/raw.h>
 #include <net/if.h>
 #include <poll.h>
 #include <sys/ioctl.h>
+#include <sys/socket.h>
 #include <sys/time.h>
 #include <unistd.h>
 #include <algorithm>
+#include <cerrno>
 #include <chrono>
 #include <cstdint>
 #include <cstring>
@@ -74,15 +77,20 @@ namespace isobus
 			const int DROP_MONITOR = 1;
 			const int TIMESTAMPING = 0x58;
 			const int TIMESTAMP = 1;
+			const int ENABLE_CAN_FD_FRAMES = 1;
 			memset(&interfaceRequestStructure, 0, sizeof(interfaceRequestStructure));
 			strncpy(interfaceRequestStructure.ifr_name, name.c_str(), sizeof(interfaceRequestStructure.ifr_name));
 			setsockopt(fileDescriptor, SOL_CAN_RAW, CAN_RAW_RECV_OWN_MSGS, &RECEIVE_OWN_MESSAGES, sizeof(RECEIVE_OWN_MESSAGES));
 			setsockopt(fileDescriptor, SOL_SOCKET, SO_RXQ_OVFL, &DROP_MONITOR, sizeof(DROP_MONITOR));
 
+			// This fails on kernels without CAN FD support, in which case only classical frames are used
+			setsockopt(fileDescriptor, SOL_CAN_RAW, CAN_RAW_FD_FRAMES, &ENABLE_CAN_FD_FRAMES, sizeof(ENABLE_CAN_FD_FRAMES));
+
 			if (setsockopt(fileDescriptor, SOL_SOCKET, SO_TIMESTAMPING, &TIMESTAMPING, sizeof(TIMESTAMPING)) < 0)
 			{
 				setsockopt(fileDescriptor, SOL_SOCKET, SO_TIMESTAMP, &TIMESTAMP, sizeof(TIMESTAMP));
 			}
+			apply_receive_filters();
 
 			if (ioctl(fileDescriptor, SIOCGIFINDEX, &interfaceRequestStructure) >= 0)
 			{
@@ -106,10 +114,87 @@ namespace isobus
 		}
 	}
 
+	bool SocketCANInterface::set_receive_filters(const std::vector<isobus::CANReceiveFilter> &filters)
+	{
+		bool retVal = true;
+
+		receiveFilters = filters;
+		if (get_is_valid())
+		{
+			retVal = apply_receive_filters();
+		}
+		return retVal;
+	}
+
+	bool SocketCANInterface::apply_receive_filters()
+	{
+		std::vector<struct can_filter> socketFilters;
+		bool retVal = false;
+
+		if (receiveFilters.size() <= CAN_RAW_FILTER_MAX)
+		{
+			for (const auto &filter : receiveFilters)
+			{
+				struct can_filter socketFilter;
+
+				// Matching on the EFF flag keeps 11 and 29 bit identifiers from being mistaken for each other
+				if (filter.isExtendedFrame)
+				{
+					socketFilter.can_id = (filter.identifier & CAN_EFF_MASK) | CAN_EFF_FLAG;
+					socketFilter.can_mask = (filter.mask & CAN_EFF_MASK) | CAN_EFF_FLAG;
+				}
+				else
+				{
+					socketFilter.can_id = filter.identifier & CAN_SFF_MASK;
+					socketFilter.can_mask = (filter.mask & CAN_SFF_MASK) | CAN_EFF_FLAG;
+				}
+				socketFilters.push_back(socketFilter);
+			}
+		}
+		else
+		{
+			isobus::CANStackLogger::warn("[SocketCAN] " + name + " can't use " + isobus::to_string(receiveFilters.size()) + " receive filters, receiving every frame instead.");
+		}
+
+		if (socketFilters.empty())
+		{
+			// A filter that matches everything, which is also what the socket starts with
+			struct can_filter acceptAllFilter;
+			acceptAllFilter.can_id = 0;
+			acceptAllFilter.can_mask = 0;
+			socketFilters.push_back(acceptAllFilter);
+		}
+
+		if (setsockopt(fileDescriptor, SOL_CAN_RAW, CAN_RAW_FILTER, socketFilters.data(), static_cast<socklen_t>(socketFilters.size() * sizeof(struct can_filter))) == 0)
+		{
+			retVal = true;
+		}
+		else
+		{
+			isobus::CANStackLogger::error("[SocketCAN] Failed to set the receive filters on " + name + ", " + std::strerror(errno));
+		}
+		return retVal;
+	}
+
+	int SocketCANInterface::get_receive_file_descriptor() const
+	{
+		return fileDescriptor;
+	}
+
 	bool SocketCANInterface::read_frame(isobus::CANMessageFrame &canFrame)
+	{
+		return (1 == read_frames(&canFrame, 1));
+	}
+
+	bool SocketCANInterface::write_frame(const isobus::CANMessageFrame &canFrame)
+	{
+		return (1 == write_frames(&canFrame, 1));
+	}
+
+	std::size_t SocketCANInterface::read_frames(isobus::CANMessageFrame *canFrames, std::size_t maxFrames)
 	{
 		struct pollfd pollingFileDescriptor;
-		bool retVal = false;
+		std::size_t retVal = 0;
 
 		pollingFileDescriptor.fd = fileDescriptor;
 		pollingFileDescriptor.events = POLLIN;
@@ -117,71 +202,39 @@ namespace isobus
 
 		if (1 == poll(&pollingFileDescriptor, 1, 100))
 		{
-			canFrame.timestamp_us = std::numeric_limits<std::uint64_t>::max();
-			struct can_frame txFrame;
-			struct msghdr message;
-			struct iovec segment;
-
-			char lControlMessage[CMSG_SPACE(sizeof(struct timeval) + (3 * sizeof(struct timespec)) + sizeof(std::uint32_t))];
-
-			segment.iov_base = &txFrame;
-			segment.iov_len = sizeof(struct can_frame);
-			message.msg_iov = &segment;
-			message.msg_iovlen = 1;
-			message.msg_control = &lControlMessage;
-			message.msg_controllen = sizeof(lControlMessage);
-			message.msg_name = pCANDevice;
-			message.msg_namelen = sizeof(struct sockaddr_can);
-			message.msg_flags = 0;
-
-			if (recvmsg(fileDescriptor, &message, 0) > 0)
+			const std::size_t framesToRead = (maxFrames < MAX_FRAMES_PER_SYSCALL) ? maxFrames : MAX_FRAMES_PER_SYSCALL;
+			struct canfd_frame rxFrames[MAX_FRAMES_PER_SYSCALL];
+			struct mmsghdr messages[MAX_FRAMES_PER_SYSCALL];
+			struct iovec segments[MAX_FRAMES_PER_SYSCALL];
+			char controlMessages[MAX_FRAMES_PER_SYSCALL][CMSG_SPACE(sizeof(struct timeval) + (3 * sizeof(struct timespec)) + sizeof(std::uint32_t))];
+
+			for (std::size_t i = 0; i < framesToRead; i++)
 			{
-				if (0 == (txFrame.can_id & CAN_ERR_FLAG))
-				{
-					if (0 != (txFrame.can_id & CAN_EFF_FLAG))
-					{
-						canFrame.identifier = (txFrame.can_id & CAN_EFF_MASK);
-						canFrame.isExtendedFrame = true;
-					}
-					else
-					{
-						canFrame.identifier = (txFrame.can_id & CAN_SFF_MASK);
-						canFrame.isExtendedFrame = false;
-					}
-					canFrame.dataLength = txFrame.can_dlc;
-					memset(canFrame.data, 0, sizeof(canFrame.data));
-					memcpy(canFrame.data, txFrame.data, canFrame.dataLength);
+				segments[i].iov_base = &rxFrames[i];
+				segments[i].iov_len = sizeof(struct canfd_frame);
+				memset(&messages[i], 0, sizeof(struct mmsghdr));
+				messages[i].msg_hdr.msg_iov = &segments[i];
+				messages[i].msg_hdr.msg_iovlen = 1;
+				messages[i].msg_hdr.msg_control = controlMessages[i];
+				messages[i].msg_hdr.msg_controllen = sizeof(controlMessages[i]);
+			}
 
-					for (struct cmsghdr *pControlMessage = CMSG_FIRSTHDR(&message); (nullptr != pControlMessage) && (SOL_SOCKET == pControlMessage->cmsg_level); pControlMessage = CMSG_NXTHDR(&message, pControlMessage))
+			// Don't block for anything after the first frame, poll already did the waiting
+			int numberOfMessages = recvmmsg(fileDescriptor, messages, static_cast<unsigned int>(framesToRead), MSG_DONTWAIT, nullptr);
+
+			if (numberOfMessages > 0)
+			{
+				for (int i = 0; i < numberOfMessages; i++)
+				{
+					if (convert_received_frame(rxFrames[i], messages[i].msg_len, messages[i].msg_hdr, canFrames[retVal]))
 					{
-						switch (pControlMessage->cmsg_type)
-						{
-							case SO_TIMESTAMP:
-							{
-								struct timeval *time = (struct timeval *)CMSG_DATA(pControlMessage);
-
-								if (std::numeric_limits<std::uint64_t>::max() == canFrame.timestamp_us)
-								{
-									canFrame.timestamp_us = static_cast<std::uint64_t>(time->tv_usec) + (static_cast<std::uint64_t>(time->tv_sec) * 1000000);
-								}
-							}
-							break;
-
-							case SO_TIMESTAMPING:
-							{
-								struct timespec *time = (struct timespec *)(CMSG_DATA(pControlMessage));
-								canFrame.timestamp_us = (static_cast<std::uint64_t>(time[2].tv_nsec) / 1000) + (static_cast<std::uint64_t>(time[2].tv_sec) * 1000000);
-							}
-							break;
-						}
+						retVal++;
 					}
-					retVal = true;
 				}
 			}
-			else if (errno == ENETDOWN)
+			else
 			{
-				isobus::CANStackLogger::CAN_stack_log(isobus::CANStackLogger::LoggingLevel::Critical, "[SocketCAN] " + get_device_name() + " interface is down.");
-				close();
+				handle_socket_error();
 			}
 		}
 		else if (pollingFileDescriptor.revents & (POLLERR | POLLHUP))
@@ -191,29 +244,125 @@ namespace isobus
 		return retVal;
 	}
 
-	bool SocketCANInterface::write_frame(const isobus::CANMessageFrame &canFrame)
+	std::size_t SocketCANInterface::write_frames(const isobus::CANMessageFrame *canFrames, std::size_t numberOfFrames)
+	{
+		struct canfd_frame txFrames[MAX_FRAMES_PER_SYSCALL];
+		struct mmsghdr messages[MAX_FRAMES_PER_SYSCALL];
+		struct iovec segments[MAX_FRAMES_PER_SYSCALL];
+		std::size_t retVal = 0;
+
+		while (retVal < numberOfFrames)
+		{
+			const std::size_t remainingFrames = numberOfFrames - retVal;
+			const std::size_t framesToWrite = (remainingFrames < MAX_FRAMES_PER_SYSCALL) ? remainingFrames : MAX_FRAMES_PER_SYSCALL;
+
+			for (std::size_t i = 0; i < framesToWrite; i++)
+			{
+				convert_frame_to_send(canFrames[retVal + i], txFrames[i]);
+				segments[i].iov_base = &txFrames[i];
+				segments[i].iov_len = canFrames[retVal + i].isFDFrame ? CANFD_MTU : CAN_MTU;
+				memset(&messages[i], 0, sizeof(struct mmsghdr));
+				messages[i].msg_hdr.msg_iov = &segments[i];
+				messages[i].msg_hdr.msg_iovlen = 1;
+			}
+
+			int numberOfMessages = sendmmsg(fileDescriptor, messages, static_cast<unsigned int>(framesToWrite), 0);
+
+			if (numberOfMessages > 0)
+			{
+				retVal += static_cast<std::size_t>(numberOfMessages);
+
+				if (static_cast<std::size_t>(numberOfMessages) < framesToWrite)
+				{
+					// The socket buffer is full, let the caller try again later
+					break;
+				}
+			}
+			else
+			{
+				handle_socket_error();
+				break;
+			}
+		}
+		return retVal;
+	}
+
+	bool SocketCANInterface::convert_received_frame(const struct canfd_frame &socketFrame, std::size_t frameSize, struct msghdr &message, isobus::CANMessageFrame &canFrame)
 	{
-		struct can_frame txFrame;
 		bool retVal = false;
 
-		txFrame.can_id = canFrame.identifier;
-		txFrame.can_dlc = canFrame.dataLength;
-		memcpy(txFrame.data, canFrame.data, canFrame.dataLength);
+		if ((0 == (socketFrame.can_id & CAN_ERR_FLAG)) &&
+		    ((CAN_MTU == frameSize) || (CANFD_MTU == frameSize)))
+		{
+			if (0 != (socketFrame.can_id & CAN_EFF_FLAG))
+			{
+				canFrame.identifier = (socketFrame.can_id & CAN_EFF_MASK);
+				canFrame.isExtendedFrame = true;
+			}
+			else
+			{
+				canFrame.identifier = (socketFrame.can_id & CAN_SFF_MASK);
+				canFrame.isExtendedFrame = false;
+			}
+			canFrame.isFDFrame = (CANFD_MTU == frameSize);
+			canFrame.isBitRateSwitch = (canFrame.isFDFrame && (0 != (socketFrame.flags & CANFD_BRS)));
+			canFrame.dataLength = socketFrame.len;
+			memset(canFrame.data, 0, sizeof(canFrame.data));
+			memcpy(canFrame.data, socketFrame.data, canFrame.dataLength);
+			canFrame.timestamp_us = std::numeric_limits<std::uint64_t>::max();
+
+			for (struct cmsghdr *pControlMessage = CMSG_FIRSTHDR(&message); (nullptr != pControlMessage) && (SOL_SOCKET == pControlMessage->cmsg_level); pControlMessage = CMSG_NXTHDR(&message, pControlMessage))
+			{
+				switch (pControlMessage->cmsg_type)
+				{
+					case SO_TIMESTAMP:
+					{
+						struct timeval *time = (struct timeval *)CMSG_DATA(pControlMessage);
 
-		if (canFrame.isExtendedFrame)
+						if (std::numeric_limits<std::uint64_t>::max() == canFrame.timestamp_us)
+						{
+							canFrame.timestamp_us = static_cast<std::uint64_t>(time->tv_usec) + (static_cast<std::uint64_t>(time->tv_sec) * 1000000);
+						}
+					}
+					break;
+
+					case SO_TIMESTAMPING:
+					{
+						struct timespec *time = (struct timespec *)(CMSG_DATA(pControlMessage));
+						canFrame.timestamp_us = (static_cast<std::uint64_t>(time[2].tv_nsec) / 1000) + (static_cast<std::uint64_t>(time[2].tv_sec) * 1000000);
+					}
+					break;
+				}
+			}
+			retVal = true;
+		}
+		return retVal;
+	}
+
+	void SocketCANInterface::convert_frame_to_send(const isobus::CANMessageFrame &canFrame, struct canfd_frame &socketFrame)
+	{
+		memset(&socketFrame, 0, sizeof(struct canfd_frame));
+		socketFrame.can_id = canFrame.identifier;
+		socketFrame.len = canFrame.dataLength;
+		memcpy(socketFrame.data, canFrame.data, canFrame.dataLength);
+
+		if (canFrame.isFDFrame && canFrame.isBitRateSwitch)
 		{
-			txFrame.can_id |= CAN_EFF_FLAG;
+			socketFrame.flags = CANFD_BRS;
 		}
 
-		if (write(fileDescriptor, &txFrame, sizeof(struct can_frame)) > 0)
+		if (canFrame.isExtendedFrame)
 		{
-			retVal = true;
+			socketFrame.can_id |= CAN_EFF_FLAG;
 		}
-		else if (errno == ENETDOWN)
+	}
+
+	void SocketCANInterface::handle_socket_error()
+	{
+		if (errno == ENETDOWN)
 		{
 			isobus::CANStackLogger::CAN_stack_log(isobus::CANStackLogger::LoggingLevel::Critical, "[SocketCAN] " + get_device_name() + " interface is down.");
 			close();
 		}
-		return retVal;
 	}
 }
@@ -114,6 +114,8 @@ namespace isobus
 				canFrame.dataLength = CANMessage.m_bDLC;
 				canFrame.identifier = CANMessage.m_dwID;
 				canFrame.isExtendedFrame = (USBCAN_MSG_FF_EXT == CANMessage.m_bFF);
+				canFrame.isFDFrame = false;
+				canFrame.isBitRateSwitch = false;
 				canFrame.data[0] = CANMessage.m_bData[0];
 				canFrame.data[1] = CANMessage.m_bData[1];
 				canFrame.data[2] = CANMessage.m_bData[2];
@@ -137,7 +139,10 @@ namespace isobus
 	{
 		bool retVal = false;
 
-		if (get_is_valid())
+		// tCanMsgStruct can only hold a classical CAN frame
+		if ((get_is_valid()) &&
+		    (!canFrame.isFDFrame) &&
+		    (canFrame.dataLength <= isobus::CAN_DATA_LENGTH))
 		{
 			tCanMsgStruct CANMessage;
 
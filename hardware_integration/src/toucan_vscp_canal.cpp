@@ -87,9 +87,11 @@ namespace isobus
 		if (CANAL_ERROR_SUCCESS == result)
 		{
 			canFrame.dataLength = CANMsg.sizeData;
-			memcpy(canFrame.data, CANMsg.data, sizeof(canFrame.data));
+			memcpy(canFrame.data, CANMsg.data, sizeof(CANMsg.data));
 			canFrame.identifier = CANMsg.id;
 			canFrame.isExtendedFrame = (0 != (CANAL_IDFLAG_EXTENDED & CANMsg.flags));
+			canFrame.isFDFrame = false;
+			canFrame.isBitRateSwitch = false;
 			canFrame.timestamp_us = CANMsg.timestamp;
 		}
 		else
@@ -101,16 +103,20 @@ namespace isobus
 
 	bool TouCANPlugin::write_frame(const isobus::CANMessageFrame &canFrame)
 	{
-		std::uint32_t result = CANAL_ERROR_SUCCESS;
-		structCanalMsg msgCanMessage;
+		bool retVal = false;
 
-		msgCanMessage.id = canFrame.identifier;
-		msgCanMessage.sizeData = canFrame.dataLength;
-		msgCanMessage.flags = canFrame.isExtendedFrame ? CANAL_IDFLAG_EXTENDED : CANAL_IDFLAG_STANDARD;
-		memcpy(msgCanMessage.data, canFrame.data, canFrame.dataLength);
+		// CANAL messages have an 8 byte payload
+		if ((!canFrame.isFDFrame) && (canFrame.dataLength <= isobus::CAN_DATA_LENGTH))
+		{
+			structCanalMsg msgCanMessage;
 
-		result = CanalSend(handle, &msgCanMessage);
+			msgCanMessage.id = canFrame.identifier;
+			msgCanMessage.sizeData = canFrame.dataLength;
+			msgCanMessage.flags = canFrame.isExtendedFrame ? CANAL_IDFLAG_EXTENDED : CANAL_IDFLAG_STANDARD;
+			memcpy(msgCanMessage.data, canFrame.data, canFrame.dataLength);
 
-		return (CANAL_ERROR_SUCCESS == result);
+			retVal = (CANAL_ERROR_SUCCESS == CanalSend(handle, &msgCanMessage));
+		}
+		return retVal;
 	}
 }
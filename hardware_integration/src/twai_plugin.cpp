@@ -90,6 +90,8 @@ namespace isobus
 			{
 				canFrame.identifier = message.identifier;
 				canFrame.isExtendedFrame = message.extd;
+				canFrame.isFDFrame = false;
+				canFrame.isBitRateSwitch = false;
 				canFrame.dataLength = message.data_length_code;
 				if (isobus::CAN_DATA_LENGTH >= canFrame.dataLength)
 				{
@@ -112,19 +114,26 @@ namespace isobus
 		bool retVal = false;
 		twai_message_t message = {};
 
-		message.identifier = canFrame.identifier;
-		message.extd = canFrame.isExtendedFrame;
-		message.data_length_code = canFrame.dataLength;
-		memcpy(message.data, canFrame.data, canFrame.dataLength);
-
-		esp_err_t error = twai_transmit(&message, pdMS_TO_TICKS(100));
-		if (ESP_OK == error)
+		if ((canFrame.isFDFrame) || (canFrame.dataLength > isobus::CAN_DATA_LENGTH))
 		{
-			retVal = true;
+			isobus::CANStackLogger::CAN_stack_log(isobus::CANStackLogger::LoggingLevel::Error, "[TWAI] Error sending message: TWAI only supports classical CAN frames");
 		}
 		else
 		{
-			isobus::CANStackLogger::CAN_stack_log(isobus::CANStackLogger::LoggingLevel::Error, "[TWAI] Error sending message: " + isobus::to_string(esp_err_to_name(error)));
+			message.identifier = canFrame.identifier;
+			message.extd = canFrame.isExtendedFrame;
+			message.data_length_code = canFrame.dataLength;
+			memcpy(message.data, canFrame.data, canFrame.dataLength);
+
+			esp_err_t error = twai_transmit(&message, pdMS_TO_TICKS(100));
+			if (ESP_OK == error)
+			{
+				retVal = true;
+			}
+			else
+			{
+				isobus::CANStackLogger::CAN_stack_log(isobus::CANStackLogger::LoggingLevel::Error, "[TWAI] Error sending message: " + isobus::to_string(esp_err_to_name(error)));
+			}
 		}
 		return retVal;
 	}
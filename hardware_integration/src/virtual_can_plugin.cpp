@@ -8,25 +8,50 @@
 //================================================================================================
 #include "isobus/hardware_integration/virtual_can_plugin.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
 namespace isobus
 {
-	std::mutex VirtualCANPlugin::mutex;
-	std::map<std::string, std::vector<std::shared_ptr<VirtualCANPlugin::VirtualDevice>>> VirtualCANPlugin::channels;
+	std::mutex VirtualCANPlugin::channelsMutex;
+	std::map<std::string, std::weak_ptr<VirtualCANPlugin::VirtualChannel>> VirtualCANPlugin::channels;
+
+	VirtualCANPlugin::VirtualChannel::VirtualChannel() :
+	  slots(new Slot[RING_SIZE])
+	{
+	}
 
 	VirtualCANPlugin::VirtualCANPlugin(const std::string channel, const bool receiveOwnMessages) :
 	  channel(channel),
 	  receiveOwnMessages(receiveOwnMessages)
 	{
-		const std::lock_guard<std::mutex> lock(mutex);
-		ourDevice = std::make_shared<VirtualDevice>();
-		channels[channel].push_back(ourDevice);
+		const std::lock_guard<std::mutex> lock(channelsMutex);
+		ourChannel = channels[channel].lock();
+		if (nullptr == ourChannel)
+		{
+			ourChannel = std::make_shared<VirtualChannel>();
+			channels[channel] = ourChannel;
+		}
+		ourChannel->numberOfDevices++;
+
+		// Only frames written from now on are for us
+		readIndex = ourChannel->writeIndex.load();
 	}
 
 	VirtualCANPlugin::~VirtualCANPlugin()
 	{
 		// Prevent a deadlock in the read_frame() function
 		running = false;
-		ourDevice->condition.notify_one();
+		wake_readers();
+
+		const std::lock_guard<std::mutex> lock(channelsMutex);
+		ourChannel->numberOfDevices--;
+		ourChannel.reset();
+		if (channels[channel].expired())
+		{
+			channels.erase(channel);
+		}
 	}
 
 	bool VirtualCANPlugin::get_is_valid() const
@@ -47,33 +72,30 @@ namespace isobus
 	void VirtualCANPlugin::close()
 	{
 		running = false;
-		ourDevice->condition.notify_one();
+		wake_readers();
 	}
 
 	bool VirtualCANPlugin::write_frame(const isobus::CANMessageFrame &canFrame)
 	{
-		bool retVal = false;
-		const std::lock_guard<std::mutex> lock(mutex);
-		for (std::shared_ptr<VirtualDevice> device : channels[channel])
+		return (1 == write_frames(&canFrame, 1));
+	}
+
+	std::size_t VirtualCANPlugin::write_frames(const isobus::CANMessageFrame *canFrames, std::size_t numberOfFrames)
+	{
+		std::size_t retVal = 0;
+
+		// Like on a real bus, a frame can't be sent without anyone there to receive it
+		if (receiveOwnMessages || (ourChannel->numberOfDevices > 1))
 		{
-			if (device->queue.size() < MAX_QUEUE_SIZE)
-			{
-				if (receiveOwnMessages || device != ourDevice)
-				{
-					device->queue.push_back(canFrame);
-					device->condition.notify_one();
-					retVal = true;
-				}
-			}
+			publish_frames(canFrames, numberOfFrames, nullptr);
+			retVal = numberOfFrames;
 		}
 		return retVal;
 	}
 
 	void VirtualCANPlugin::write_frame_as_if_received(const isobus::CANMessageFrame &canFrame) const
 	{
-		const std::lock_guard<std::mutex> lock(mutex);
-		ourDevice->queue.push_back(canFrame);
-		ourDevice->condition.notify_one();
+		publish_frames(&canFrame, 1, this);
 	}
 
 	bool VirtualCANPlugin::read_frame(isobus::CANMessageFrame &canFrame)
@@ -83,26 +105,131 @@ namespace isobus
 
 	bool VirtualCANPlugin::read_frame(isobus::CANMessageFrame &canFrame, std::uint32_t timeout) const
 	{
-		std::unique_lock<std::mutex> lock(mutex);
-		ourDevice->condition.wait_for(lock, std::chrono::milliseconds(timeout), [this] { return !ourDevice->queue.empty() || !running; });
-		if (!ourDevice->queue.empty())
-		{
-			canFrame = ourDevice->queue.front();
-			ourDevice->queue.pop_front();
-			return true;
-		}
-		return false;
+		wait_for_frame(timeout);
+		return (1 == receive_frames(&canFrame, 1));
+	}
+
+	std::size_t VirtualCANPlugin::read_frames(isobus::CANMessageFrame *canFrames, std::size_t maxFrames)
+	{
+		wait_for_frame(1000);
+		return receive_frames(canFrames, maxFrames);
 	}
 
 	bool VirtualCANPlugin::get_queue_empty() const
 	{
-		const std::lock_guard<std::mutex> lock(mutex);
-		return ourDevice->queue.empty();
+		return !get_frame_available();
 	}
 
 	void VirtualCANPlugin::clear_queue() const
 	{
-		const std::lock_guard<std::mutex> lock(mutex);
-		ourDevice->queue.clear();
+		readIndex = ourChannel->writeIndex.load();
+	}
+
+	void VirtualCANPlugin::publish_frames(const isobus::CANMessageFrame *canFrames, std::size_t numberOfFrames, const VirtualCANPlugin *destination) const
+	{
+		const std::uint64_t firstPosition = ourChannel->writeIndex.fetch_add(numberOfFrames, std::memory_order_relaxed);
+
+		for (std::size_t i = 0; i < numberOfFrames; i++)
+		{
+			const std::uint64_t position = firstPosition + i;
+			Slot &slot = ourChannel->slots[position & (RING_SIZE - 1)];
+			const std::uint64_t previousSequence = (position >= RING_SIZE) ? (2 * (position + 1 - RING_SIZE)) : 0;
+
+			// The slot can only still be in use by a writer that is a whole lap behind
+			while (slot.sequence.load(std::memory_order_acquire) != previousSequence)
+			{
+				std::this_thread::yield();
+			}
+
+			// Readers that were lapped can see the frame change under them, so it's marked as being written first
+			slot.sequence.store(previousSequence + 1, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			slot.frame = canFrames[i];
+			slot.source = this;
+			slot.destination = destination;
+			slot.sequence.store(2 * (position + 1), std::memory_order_release);
+		}
+
+		// Readers only wait once they have run out of frames, so this wakes them at most once per batch
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (0 != ourChannel->numberOfWaitingReaders.load(std::memory_order_relaxed))
+		{
+			wake_readers();
+		}
+	}
+
+	bool VirtualCANPlugin::get_frame_available() const
+	{
+		bool retVal = false;
+		std::uint64_t position = readIndex.load(std::memory_order_relaxed);
+
+		while (!retVal)
+		{
+			const Slot &slot = ourChannel->slots[position & (RING_SIZE - 1)];
+			const std::uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+			if (sequence < (2 * (position + 1)))
+			{
+				// Not written yet
+				break;
+			}
+			else if (sequence > (2 * (position + 1)))
+			{
+				// We fell more than a lap behind, so skip to the oldest frame that may still be there
+				position = std::max(position + 1, ourChannel->writeIndex.load(std::memory_order_relaxed) - RING_SIZE);
+			}
+			else if ((nullptr == slot.destination) ?
+			           (receiveOwnMessages || (this != slot.source)) :
+			           (this == slot.destination))
+			{
+				retVal = true;
+			}
+			else
+			{
+				position++;
+			}
+		}
+		readIndex.store(position, std::memory_order_relaxed);
+		return retVal;
+	}
+
+	std::size_t VirtualCANPlugin::receive_frames(isobus::CANMessageFrame *canFrames, std::size_t maxFrames) const
+	{
+		std::size_t retVal = 0;
+
+		while ((retVal < maxFrames) && get_frame_available())
+		{
+			const std::uint64_t position = readIndex.load(std::memory_order_relaxed);
+			const Slot &slot = ourChannel->slots[position & (RING_SIZE - 1)];
+
+			canFrames[retVal] = slot.frame;
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			// If a writer lapped us while copying, the copy is discarded and the next check skips ahead
+			if ((2 * (position + 1)) == slot.sequence.load(std::memory_order_relaxed))
+			{
+				readIndex.store(position + 1, std::memory_order_relaxed);
+				retVal++;
+			}
+		}
+		return retVal;
+	}
+
+	void VirtualCANPlugin::wait_for_frame(std::uint32_t timeout) const
+	{
+		if (running && !get_frame_available())
+		{
+			std::unique_lock<std::mutex> lock(ourChannel->waitMutex);
+			ourChannel->numberOfWaitingReaders.fetch_add(1);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			ourChannel->condition.wait_for(lock, std::chrono::milliseconds(timeout), [this] { return get_frame_available() || !running; });
+			ourChannel->numberOfWaitingReaders.fetch_sub(1);
+		}
+	}
+
+	void VirtualCANPlugin::wake_readers() const
+	{
+		const std::lock_guard<std::mutex> lock(ourChannel->waitMutex);
+		ourChannel->condition.notify_all();
 	}
 }
@@ -16,6 +16,7 @@
 namespace isobus
 {
 	class CANMessage; ///< Forward declare CANMessage
+	class CANNetworkManager; ///< Forward declare CANNetworkManager
 
 	//================================================================================================
 	/// @class AddressClaimStateMachine
@@ -47,7 +48,8 @@ namespace isobus
 		/// @param[in] preferredAddressValue The address you prefer to claim
 		/// @param[in] ControlFunctionNAME The NAME you want to claim
 		/// @param[in] portIndex The CAN channel index to claim on
-		AddressClaimStateMachine(std::uint8_t preferredAddressValue, NAME ControlFunctionNAME, std::uint8_t portIndex);
+		/// @param[in] networkManager The network manager to claim through
+		AddressClaimStateMachine(std::uint8_t preferredAddressValue, NAME ControlFunctionNAME, std::uint8_t portIndex, CANNetworkManager &networkManager);
 
 		/// @brief The destructor for the address claim state machine
 		~AddressClaimStateMachine();
@@ -82,7 +84,12 @@ namespace isobus
 		/// @brief Updates the state machine, should be called periodically
 		void update();
 
+		/// @brief Returns how long the state machine can go without being updated
+		/// @returns The time until the state machine next needs to be updated in milliseconds, or `0` if it has work to do right away
+		std::uint32_t get_time_until_next_update_ms() const;
+
 	private:
+		static constexpr std::uint32_t ADDRESS_CONTENTION_TIME_MS = 250; ///< The time to wait for other CFs to respond to a request for address claim
 		/// @brief Processes a CAN message
 		/// @param[in] message The CAN message being received
 		/// @param[in] parentPointer A context variable to find the relevant address claimer
@@ -101,6 +108,7 @@ namespace isobus
 		/// @returns true if the message was sent, otherwise false
 		bool send_address_claim(std::uint8_t address);
 
+		CANNetworkManager &m_networkManager; ///< The network manager to claim through
 		NAME m_isoname; ///< The ISO NAME to claim as
 		State m_currentState = State::None; ///< The address claim state machine state
 		std::uint32_t m_timestamp_ms = 0; ///< A generic timestamp in milliseconds used to find timeouts
@@ -11,10 +11,16 @@
 #define CAN_CALLBACKS_HPP
 
 #include "isobus/isobus/can_message.hpp"
+#include "isobus/isobus/can_message_frame.hpp"
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace isobus
 {
 	// Forward declare some classes
+	class CallbackExecutor;
 	class InternalControlFunction;
 	class ControlFunction;
 
@@ -62,6 +68,8 @@ namespace isobus
 	                                                     std::shared_ptr<ControlFunction> requestingControlFunction,
 	                                                     std::uint32_t repetitionRate,
 	                                                     void *parentPointer);
+	/// @brief A callback for sending a frame out of a network manager that isn't connected to the hardware layer
+	using CANFrameTransmitCallback = bool (*)(const CANMessageFrame &frame, void *parentPointer);
 
 	//================================================================================================
 	/// @class ParameterGroupNumberCallbackData
@@ -76,7 +84,8 @@ namespace isobus
 		/// @param[in] callback The function you want the stack to call when it gets receives a message with a matching PGN
 		/// @param[in] parentPointer A generic variable that can provide context to which object the callback was meant for
 		/// @param[in] internalControlFunction An internal control function to use as an additional filter for the callback
-		ParameterGroupNumberCallbackData(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parentPointer, std::shared_ptr<InternalControlFunction> internalControlFunction);
+		/// @param[in] executor An executor to run the callback on, or `nullptr` to run it on the thread that processes the message
+		ParameterGroupNumberCallbackData(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parentPointer, std::shared_ptr<InternalControlFunction> internalControlFunction, CallbackExecutor *executor = nullptr);
 
 		/// @brief A copy constructor for holding callback data
 		/// @param[in] oldObj The object to copy from
@@ -108,11 +117,100 @@ namespace isobus
 		/// @returns A pointer to the ICF being used as a filter, or nullptr
 		std::shared_ptr<InternalControlFunction> get_internal_control_function() const;
 
+		/// @brief Returns the executor the callback is run on
+		/// @returns The executor the callback is run on, or `nullptr` if it is run on the thread that processes the message
+		CallbackExecutor *get_executor() const;
+
+		/// @brief Calls the callback with a message, or posts a copy of the message to the callback's executor
+		/// @details Callbacks with the same parent that share an executor run in the order their messages were received.
+		/// @param[in] message The message to give to the callback
+		/// @returns `true` if the callback was called or posted, `false` if the executor's queue was full
+		bool invoke(const CANMessage &message) const;
+
 	private:
 		CANLibCallback mCallback; ///< The callback that will get called when a matching PGN is received
 		std::uint32_t mParameterGroupNumber; ///< The PGN assocuiated with this callback
 		void *mParent; ///< A generic variable that can provide context to which object the callback was meant for
 		std::shared_ptr<InternalControlFunction> mInternalControlFunctionFilter; ///< An optional way to filter callbacks based on the destination of messages from the partner
+		CallbackExecutor *mExecutor; ///< The executor the callback is run on, or `nullptr` to run it inline
+	};
+
+	//================================================================================================
+	/// @class ParameterGroupNumberCallbackTable
+	///
+	/// @brief A collection of PGN callbacks that is indexed by PGN for fast dispatch
+	/// @details Callbacks are kept in the order they were added, and a copy of them is
+	/// kept grouped by PGN along with a hash map from each PGN to its group. The index is rebuilt
+	/// whenever a callback is added or removed, which keeps looking up the callbacks for a
+	/// received message constant time regardless of how many callbacks are registered.
+	//================================================================================================
+	class ParameterGroupNumberCallbackTable
+	{
+	public:
+		/// @brief Adds a callback to the table
+		/// @param[in] callback The callback to add
+		void add(const ParameterGroupNumberCallbackData &callback);
+
+		/// @brief Removes the first callback from the table that is equal to the one passed in
+		/// @param[in] callback The callback to remove
+		/// @returns `true` if a callback was removed, otherwise `false`
+		bool remove(const ParameterGroupNumberCallbackData &callback);
+
+		/// @brief Checks if a callback equal to the one passed in is in the table
+		/// @param[in] callback The callback to look for
+		/// @returns `true` if a matching callback is in the table, otherwise `false`
+		bool contains(const ParameterGroupNumberCallbackData &callback) const;
+
+		/// @brief Returns the number of callbacks in the table
+		/// @returns The number of callbacks in the table
+		std::size_t size() const;
+
+		/// @brief Returns a callback by the order in which it was added
+		/// @param[in] index The index of the callback to get, must be less than size()
+		/// @returns The callback at the specified index
+		ParameterGroupNumberCallbackData &operator[](std::size_t index);
+
+		/// @brief Returns a callback by the order in which it was added
+		/// @param[in] index The index of the callback to get, must be less than size()
+		/// @returns The callback at the specified index
+		const ParameterGroupNumberCallbackData &operator[](std::size_t index) const;
+
+		/// @brief Calls a handler for each callback registered for a PGN, in the order they were added
+		/// @details It is safe for the handler to add or remove callbacks, though doing so may cause
+		/// callbacks for the PGN being processed to be skipped or visited twice for this call.
+		/// The handler is given a reference into the table, which changing the table invalidates, so a handler
+		/// that may change the table (by running the callback) must not use the reference after doing so.
+		/// @param[in] parameterGroupNumber The PGN to find callbacks for
+		/// @param[in] handler A callable that accepts a `const ParameterGroupNumberCallbackData &`
+		template<typename Handler>
+		void for_each_matching(std::uint32_t parameterGroupNumber, Handler &&handler) const
+		{
+			auto range = parameterGroupNumberRanges.find(parameterGroupNumber);
+
+			if (parameterGroupNumberRanges.end() != range)
+			{
+				const std::size_t end = range->second.second;
+
+				for (std::size_t i = range->second.first; (i < end) && (i < callbacksByParameterGroupNumber.size()); i++)
+				{
+					const ParameterGroupNumberCallbackData &callback = callbacksByParameterGroupNumber[i];
+
+					// A handler that changed the table may have moved other PGNs' callbacks into this range
+					if (parameterGroupNumber == callback.get_parameter_group_number())
+					{
+						handler(callback);
+					}
+				}
+			}
+		}
+
+	private:
+		/// @brief Rebuilds the PGN index after the list of callbacks has changed
+		void rebuild_index();
+
+		std::vector<ParameterGroupNumberCallbackData> callbacks; ///< The callbacks in the order they were added
+		std::vector<ParameterGroupNumberCallbackData> callbacksByParameterGroupNumber; ///< The callbacks grouped by PGN, preserving the order they were added within each PGN
+		std::unordered_map<std::uint32_t, std::pair<std::size_t, std::size_t>> parameterGroupNumberRanges; ///< Maps a PGN to its [begin, end) range in callbacksByParameterGroupNumber
 	};
 } // namespace isobus
 
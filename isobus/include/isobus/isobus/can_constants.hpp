@@ -18,6 +18,7 @@ namespace isobus
 	constexpr std::uint8_t NULL_CAN_ADDRESS = 0xFE; ///< The NULL CAN address defined by J1939 and ISO11783
 	constexpr std::uint8_t BROADCAST_CAN_ADDRESS = 0xFF; ///< The global/broadcast CAN address
 	constexpr std::uint8_t CAN_DATA_LENGTH = 8; ///< The length of a classical CAN frame
+	constexpr std::uint8_t CAN_FD_DATA_LENGTH = 64; ///< The maximum length of a CAN FD frame
 	constexpr std::uint32_t CAN_PORT_MAXIMUM = 4; ///< An arbitrary limit for memory consumption
 
 }
@@ -15,12 +15,10 @@
 
 #include <memory>
 
-#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-#include <mutex>
-#endif
-
 namespace isobus
 {
+	class CANNetworkManager;
+
 	//================================================================================================
 	/// @class ControlFunction
 	///
@@ -46,6 +44,14 @@ namespace isobus
 		/// @returns A shared pointer to a ControlFunction object created with the parameters passed in
 		static std::shared_ptr<ControlFunction> create(NAME NAMEValue, std::uint8_t addressValue, std::uint8_t CANPort);
 
+		/// @brief The factory function to construct a control function that belongs to a specific network manager
+		/// @param[in] NAMEValue The NAME of the control function
+		/// @param[in] addressValue The current address of the control function
+		/// @param[in] CANPort The CAN channel index that the control function communicates on
+		/// @param[in] networkManager The network manager that tracks the control function
+		/// @returns A shared pointer to a ControlFunction object created with the parameters passed in
+		static std::shared_ptr<ControlFunction> create(NAME NAMEValue, std::uint8_t addressValue, std::uint8_t CANPort, CANNetworkManager &networkManager);
+
 		/// @brief Destroys this control function, by removing it from the network manager
 		/// @param[in] expectedRefCount The expected number of shared pointers to this control function after removal
 		/// @returns true if the control function was successfully removed from everywhere in the stack, otherwise false
@@ -75,18 +81,28 @@ namespace isobus
 		///@returns The control function type as a string
 		std::string get_type_string() const;
 
+		/// @brief Returns the network manager that this control function belongs to
+		/// @returns The network manager that tracks this control function
+		CANNetworkManager &get_network_manager() const;
+
 	protected:
-		/// @brief The protected constructor for the control function, which is called by the (inherited) factory function
+		/// @brief The protected constructor for a control function tracked by the default network manager
 		/// @param[in] NAMEValue The NAME of the control function
 		/// @param[in] addressValue The current address of the control function
 		/// @param[in] CANPort The CAN channel index that the control function communicates on
 		/// @param[in] type The 'Type' of control function to create
 		ControlFunction(NAME NAMEValue, std::uint8_t addressValue, std::uint8_t CANPort, Type type = Type::External);
 
+		/// @brief The protected constructor for the control function, which is called by the (inherited) factory function
+		/// @param[in] NAMEValue The NAME of the control function
+		/// @param[in] addressValue The current address of the control function
+		/// @param[in] CANPort The CAN channel index that the control function communicates on
+		/// @param[in] networkManager The network manager that tracks the control function
+		/// @param[in] type The 'Type' of control function to create
+		ControlFunction(NAME NAMEValue, std::uint8_t addressValue, std::uint8_t CANPort, CANNetworkManager &networkManager, Type type = Type::External);
+
 		friend class CANNetworkManager; ///< The network manager needs access to the control function's internals
-#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		static std::mutex controlFunctionProcessingMutex; ///< Protects the control function tables
-#endif
+		CANNetworkManager &networkManager; ///< The network manager that tracks this control function
 		const Type controlFunctionType; ///< The Type of the control function
 		NAME controlFunctionNAME; ///< The NAME of the control function
 		bool claimedAddressSinceLastAddressClaimRequest = false; ///< Used to mark CFs as stale if they don't claim within a certain time
@@ -11,16 +11,42 @@
 #define CAN_HARDWARE_ABSTRACTION_HPP
 
 #include "isobus/isobus/can_message_frame.hpp"
+#include "isobus/utility/event_dispatcher.hpp"
 
 #include <cstdint>
+#include <vector>
 
 namespace isobus
 {
+	/// @brief The possible outcomes of handing a frame to the hardware layer
+	enum class CANTransmitResult : std::uint8_t
+	{
+		Queued, ///< The frame was accepted and will be sent
+		WouldBlock, ///< The channel's Tx queue is full, the frame can be retried once the hardware reports space is available
+		Failed ///< The frame can't be sent, for example because the channel isn't valid
+	};
+
+	/// @brief An acceptance filter for received frames, that drivers which support filtering can apply before frames reach the stack
+	/// @details A frame passes the filter if `(frame.identifier & mask) == (identifier & mask)` and its frame format matches.
+	struct CANReceiveFilter
+	{
+		std::uint32_t identifier; ///< The identifier bits to compare against
+		std::uint32_t mask; ///< The identifier bits that have to match, the rest are ignored
+		bool isExtendedFrame; ///< `true` to match 29 bit identifiers, `false` for 11 bit identifiers
+	};
+
 	/// @brief The sending abstraction layer between the hardware and the stack
 	/// @param[in] frame The frame to transmit from the hardware
 	/// @returns true if the frame was successfully sent, false otherwise
 	bool send_can_message_frame_to_hardware(const CANMessageFrame &frame);
 
+	/// @brief The non-blocking sending abstraction layer between the hardware and the stack
+	/// @details When this returns `WouldBlock`, the hardware calls `on_transmit_space_available_from_hardware`
+	/// for the frame's channel once it has sent some of what it has queued.
+	/// @param[in] frame The frame to transmit from the hardware
+	/// @returns Whether the frame was queued, or why it wasn't
+	CANTransmitResult try_send_can_message_frame_to_hardware(const CANMessageFrame &frame);
+
 	/// @brief The receiving abstraction layer between the hardware and the stack
 	/// @param[in] frame The frame to receive from the hardware
 	void receive_can_message_frame_from_hardware(const CANMessageFrame &frame);
@@ -29,9 +55,32 @@ namespace isobus
 	/// @param[in] txFrame The CAN frame that was just emitted
 	void on_transmit_can_message_frame_from_hardware(const CANMessageFrame &txFrame);
 
+	/// @brief Informs the network manager that a channel which rejected a frame has room in its Tx queue again
+	/// @param[in] channelIndex The CAN channel that has Tx space available
+	void on_transmit_space_available_from_hardware(std::uint8_t channelIndex);
+
+	/// @brief Returns the frames the stack needs to receive on a channel, for drivers that can filter frames
+	/// @param[in] channelIndex The CAN channel to get the filters for
+	/// @param[out] filters The frames the stack needs, any frame that passes one of these should be received
+	/// @returns `true` if only frames that pass `filters` are needed, `false` if every frame is needed
+	bool get_receive_filters_from_hardware(std::uint8_t channelIndex, std::vector<CANReceiveFilter> &filters);
+
+	/// @brief Returns an event dispatcher that the stack invokes with a channel index when that channel's receive filters change
+	/// @returns The event dispatcher for receive filter changes
+	EventDispatcher<std::uint8_t> &get_receive_filters_changed_event_dispatcher_from_hardware();
+
 	/// @brief The periodic update abstraction layer between the hardware and the stack
 	void periodic_update_from_hardware();
 
+	/// @brief Returns how long the hardware can wait before calling `periodic_update_from_hardware` again
+	/// @returns The time until the stack next needs to be updated in milliseconds
+	std::uint32_t get_time_until_periodic_update_from_hardware();
+
+	/// @brief Returns an event dispatcher that the stack invokes when it has new work that can't wait
+	/// for the time returned by `get_time_until_periodic_update_from_hardware`
+	/// @returns The event dispatcher for stack update requests
+	EventDispatcher<> &get_periodic_update_requested_event_dispatcher_from_hardware();
+
 } // namespace isobus
 
 #endif // CAN_HARDWARE_ABSTRACTION_HPP
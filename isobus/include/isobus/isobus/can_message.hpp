@@ -13,6 +13,7 @@
 
 #include "isobus/isobus/can_control_function.hpp"
 #include "isobus/isobus/can_identifier.hpp"
+#include "isobus/isobus/can_message_data.hpp"
 
 #include <vector>
 
@@ -22,6 +23,8 @@ namespace isobus
 	/// @class CANMessage
 	///
 	/// @brief A class that represents a generic CAN message of arbitrary length.
+	/// @details Single frame payloads are stored inline, so these messages can be created
+	/// and moved through the stack's queues without any heap allocations.
 	//================================================================================================
 	class CANMessage
 	{
@@ -51,6 +54,24 @@ namespace isobus
 		/// @param[in] CANPort The can channel index the message uses
 		explicit CANMessage(std::uint8_t CANPort);
 
+		/// @brief Copy constructor for a CAN message
+		/// @param[in] other The message to copy from
+		CANMessage(const CANMessage &other) = default;
+
+		/// @brief Move constructor for a CAN message
+		/// @param[in] other The message to move from
+		CANMessage(CANMessage &&other) = default;
+
+		/// @brief Copy assignment operator for a CAN message
+		/// @param[in] other The message to copy from
+		/// @returns A reference to this message
+		CANMessage &operator=(const CANMessage &other) = default;
+
+		/// @brief Move assignment operator for a CAN message
+		/// @param[in] other The message to move from
+		/// @returns A reference to this message
+		CANMessage &operator=(CANMessage &&other) = default;
+
 		/// @brief Destructor for a CAN message
 		virtual ~CANMessage() = default;
 
@@ -60,7 +81,7 @@ namespace isobus
 
 		/// @brief Gets a reference to the data in the CAN message
 		/// @returns A reference to the data in the CAN message
-		const std::vector<std::uint8_t> &get_data() const;
+		const CANMessageData &get_data() const;
 
 		/// @brief Returns the length of the data in the CAN message
 		/// @returns The message data payload length
@@ -103,16 +124,43 @@ namespace isobus
 		/// @returns The CAN channel index associated with the message
 		std::uint8_t get_can_port_index() const;
 
+		/// @brief Returns the time the message was received, in the same time base as SystemTiming::get_timestamp_us
+		/// @details For messages received from hardware this is derived from the driver's frame timestamp,
+		/// so it reflects when the frame was on the bus rather than when the stack got around to processing it.
+		/// For multi-frame messages it is the time of the last frame received. If the message was never
+		/// given a timestamp, the current time is returned.
+		/// @returns The time the message was received in microseconds
+		std::uint64_t get_timestamp_us() const;
+
+		/// @brief Returns the time the message was received, in the same time base as SystemTiming::get_timestamp_ms
+		/// @details This is get_timestamp_us() in milliseconds, and is meant to be used with SystemTiming::time_expired_ms
+		/// @returns The time the message was received in milliseconds
+		std::uint32_t get_timestamp_ms() const;
+
 		/// @brief Sets the message data to the value supplied. Creates a copy.
 		/// @param[in] dataBuffer The data payload
 		/// @param[in] length the length of the data payload in bytes
 		void set_data(const std::uint8_t *dataBuffer, std::uint32_t length);
 
+		/// @brief Sets the message data to bytes in a shared buffer, without copying them
+		/// @details The message keeps the buffer alive for as long as it needs it. The bytes must not be
+		/// changed by anyone else during that time.
+		/// @param[in] dataBuffer The data payload
+		/// @param[in] length The length of the data payload in bytes
+		void set_shared_data(std::shared_ptr<const std::uint8_t> dataBuffer, std::uint32_t length);
+
 		/// @brief Sets one byte of data in the message data payload
 		/// @param[in] dataByte One byte of data
 		/// @param[in] insertPosition The position in the message at which to insert the data byte
 		void set_data(std::uint8_t dataByte, const std::uint32_t insertPosition);
 
+		/// @brief Overwrites a block of the message data payload, without changing its size
+		/// @details Use set_data_size first to make room for the data. Bytes past the end of the payload are dropped.
+		/// @param[in] dataBuffer The bytes to copy into the payload
+		/// @param[in] length The number of bytes to copy
+		/// @param[in] insertPosition The position in the message at which to start copying the data
+		void set_data(const std::uint8_t *dataBuffer, std::uint32_t length, std::uint32_t insertPosition);
+
 		/// @brief Sets the size of the data payload
 		/// @param[in] length The desired length of the data payload
 		void set_data_size(std::uint32_t length);
@@ -129,6 +177,10 @@ namespace isobus
 		/// @param[in] value The CAN ID for the message
 		void set_identifier(const CANIdentifier &value);
 
+		/// @brief Sets the time the message was received
+		/// @param[in] value The receive time in microseconds, in the same time base as SystemTiming::get_timestamp_us
+		void set_timestamp_us(std::uint64_t value);
+
 		/// @brief Get a 8-bit unsigned byte from the buffer at a specific index.
 		/// A 8-bit unsigned byte can hold a value between 0 and 255.
 		/// @details This function will return the byte at the specified index in the buffer.
@@ -218,10 +270,11 @@ namespace isobus
 	private:
 		Type messageType = Type::Receive; ///< The internal message type associated with the message
 		CANIdentifier identifier = CANIdentifier(0); ///< The CAN ID of the message
-		std::vector<std::uint8_t> data; ///< A data buffer for the message, used when not using data chunk callbacks
+		CANMessageData data; ///< A data buffer for the message, used when not using data chunk callbacks
 		std::shared_ptr<ControlFunction> source = nullptr; ///< The source control function of the message
 		std::shared_ptr<ControlFunction> destination = nullptr; ///< The destination control function of the message
-		const std::uint8_t CANPortIndex; ///< The CAN channel index associated with the message
+		std::uint64_t timestamp_us = 0; ///< The time the message was received in microseconds, or zero if not set
+		std::uint8_t CANPortIndex; ///< The CAN channel index associated with the message
 	};
 
 } // namespace isobus
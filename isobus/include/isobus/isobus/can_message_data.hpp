@@ -0,0 +1,160 @@
+//================================================================================================
+/// @file can_message_data.hpp
+///
+/// @brief A byte buffer for CAN message payloads that stores short payloads inline.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+
+#ifndef CAN_MESSAGE_DATA_HPP
+#define CAN_MESSAGE_DATA_HPP
+
+#include "isobus/isobus/can_constants.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace isobus
+{
+	//================================================================================================
+	/// @class CANMessageData
+	///
+	/// @brief A contiguous byte buffer for the payload of a CAN message.
+	/// @details Payloads that fit in a single CAN or CAN FD frame are stored inside the object itself, so
+	/// creating, copying and moving single frame messages never allocates. Only payloads that are longer
+	/// than that, like messages reassembled by a transport protocol, spill over to the heap.
+	/// A buffer can also refer to bytes owned by someone else through a shared pointer, which lets large
+	/// outgoing messages be sent without copying them. The shared bytes are never modified, the buffer
+	/// makes its own copy the first time it is written to.
+	//================================================================================================
+	class CANMessageData
+	{
+	public:
+		static constexpr std::uint32_t INLINE_CAPACITY = CAN_FD_DATA_LENGTH; ///< The number of bytes that can be stored without allocating
+
+		/// @brief Constructs an empty buffer
+		CANMessageData() = default;
+
+		/// @brief Copy constructor
+		/// @param[in] other The buffer to copy from
+		CANMessageData(const CANMessageData &other) = default;
+
+		/// @brief Move constructor, leaves the other buffer empty
+		/// @param[in] other The buffer to move from
+		CANMessageData(CANMessageData &&other) noexcept;
+
+		/// @brief Copy assignment operator
+		/// @param[in] other The buffer to copy from
+		/// @returns A reference to this buffer
+		CANMessageData &operator=(const CANMessageData &other) = default;
+
+		/// @brief Move assignment operator, leaves the other buffer empty
+		/// @param[in] other The buffer to move from
+		/// @returns A reference to this buffer
+		CANMessageData &operator=(CANMessageData &&other) noexcept;
+
+		/// @brief Returns a pointer to the first byte in the buffer
+		/// @details Borrowed bytes are returned as they are, this never copies.
+		/// @returns A pointer to the first byte in the buffer
+		const std::uint8_t *data() const;
+
+		/// @brief Returns a pointer to the first byte in the buffer that can be written through
+		/// @details If the bytes are borrowed from a shared buffer, they are copied into this object first.
+		/// Use data() to read the bytes without copying them.
+		/// @returns A pointer to the first byte in the buffer
+		std::uint8_t *mutable_data();
+
+		/// @brief Returns the number of bytes in the buffer
+		/// @returns The number of bytes in the buffer
+		std::uint32_t size() const;
+
+		/// @brief Returns if the buffer has no bytes in it
+		/// @returns `true` if the buffer is empty, otherwise `false`
+		bool empty() const;
+
+		/// @brief Returns if the bytes are stored inside this object rather than on the heap
+		/// @returns `true` if the bytes are stored inline, otherwise `false`
+		bool is_inline() const;
+
+		/// @brief Returns if the bytes are borrowed from a shared buffer rather than owned by this object
+		/// @returns `true` if the bytes are in a shared buffer, otherwise `false`
+		bool is_shared() const;
+
+		/// @brief Makes this buffer refer to bytes in a shared buffer instead of holding a copy of them
+		/// @details The shared buffer is kept alive until this buffer is cleared, written to, or destroyed.
+		/// The caller must not change the shared bytes while they are borrowed.
+		/// @param[in] sharedBuffer The bytes to refer to
+		/// @param[in] length The number of bytes in the shared buffer
+		void share(std::shared_ptr<const std::uint8_t> sharedBuffer, std::uint32_t length);
+
+		/// @brief Returns an iterator to the first byte in the buffer
+		/// @returns An iterator to the first byte in the buffer
+		const std::uint8_t *begin() const;
+
+		/// @brief Returns an iterator to one past the last byte in the buffer
+		/// @returns An iterator to one past the last byte in the buffer
+		const std::uint8_t *end() const;
+
+		/// @brief Returns a byte in the buffer without bounds checking
+		/// @param[in] index The index of the byte to get
+		/// @returns The byte at the specified index
+		const std::uint8_t &operator[](std::uint32_t index) const;
+
+		/// @brief Returns a byte in the buffer, with bounds checking
+		/// @details Throws `std::out_of_range` if the index is not less than size()
+		/// @param[in] index The index of the byte to get
+		/// @returns The byte at the specified index
+		std::uint8_t at(std::uint32_t index) const;
+
+		/// @brief Changes the number of bytes in the buffer. New bytes are set to zero.
+		/// @param[in] length The new number of bytes in the buffer
+		void resize(std::uint32_t length);
+
+		/// @brief Adds bytes to the end of the buffer
+		/// @param[in] dataBuffer The bytes to add
+		/// @param[in] length The number of bytes to add
+		void append(const std::uint8_t *dataBuffer, std::uint32_t length);
+
+		/// @brief Overwrites a range of bytes in the buffer without changing its size
+		/// @details Bytes that would land past the end of the buffer are not written
+		/// @param[in] offset The index of the first byte to overwrite
+		/// @param[in] dataBuffer The bytes to write
+		/// @param[in] length The number of bytes to write
+		/// @returns The number of bytes that were written
+		std::uint32_t write(std::uint32_t offset, const std::uint8_t *dataBuffer, std::uint32_t length);
+
+		/// @brief Copies a range of bytes out of the buffer
+		/// @details Bytes past the end of the buffer are not copied
+		/// @param[in] offset The index of the first byte to copy
+		/// @param[out] dataBuffer Where to copy the bytes to
+		/// @param[in] length The number of bytes to copy
+		/// @returns The number of bytes that were copied
+		std::uint32_t read(std::uint32_t offset, std::uint8_t *dataBuffer, std::uint32_t length) const;
+
+		/// @brief Removes all bytes from the buffer
+		void clear();
+
+		/// @brief Copies the bytes into a vector
+		/// @returns A vector containing a copy of the bytes in the buffer
+		std::vector<std::uint8_t> to_vector() const;
+
+		/// @brief Copies the bytes into a vector, for code written against the old `std::vector` based API
+		/// @returns A vector containing a copy of the bytes in the buffer
+		operator std::vector<std::uint8_t>() const;
+
+	private:
+		/// @brief Copies borrowed bytes into storage owned by this object, so that they can be modified
+		void make_owned();
+
+		std::shared_ptr<const std::uint8_t> sharedData; ///< Borrowed bytes, used instead of the other storage when not null
+		std::vector<std::uint8_t> heapData; ///< Storage used once the payload no longer fits inline
+		std::array<std::uint8_t, INLINE_CAPACITY> inlineData = { 0 }; ///< Storage used for short payloads
+		std::uint32_t dataLength = 0; ///< The number of bytes in the buffer
+		bool inlineStorage = true; ///< Tracks if the bytes are in inlineData or heapData
+	};
+} // namespace isobus
+
+#endif // CAN_MESSAGE_DATA_HPP
@@ -1,7 +1,7 @@
 //================================================================================================
 /// @file can_message_frame.hpp
 ///
-/// @brief A classical CAN frame, with 8 data bytes
+/// @brief A classical CAN or CAN FD frame, with up to 64 data bytes
 /// @author Adrian Del Grosso
 /// @author Daan Steenbergen
 ///
@@ -11,6 +11,8 @@
 #ifndef CAN_MESSAGE_FRAME_HPP
 #define CAN_MESSAGE_FRAME_HPP
 
+#include "isobus/isobus/can_constants.hpp"
+
 #include <cstdint>
 
 namespace isobus
@@ -25,14 +27,24 @@ namespace isobus
 	public:
 		/// Returns the number of bits in a CAN message with averaged bit stuffing
 		/// @returns The number of bits in the message (with average bit stuffing)
+		/// @note For frames that use bit rate switching, the data phase is still counted in
+		/// nominal bits, so the result is an upper bound on the time the frame occupies the bus.
 		std::uint32_t get_number_bits_in_message() const;
 
-		std::uint64_t timestamp_us; ///< A microsecond timestamp
+		/// @brief Returns the smallest payload length that a CAN FD frame can carry which fits the requested length
+		/// @details CAN FD only supports lengths of 0 to 8, 12, 16, 20, 24, 32, 48 and 64 bytes.
+		/// @param[in] length The number of bytes that need to be sent
+		/// @returns The padded frame length, or 0 if the length is more than 64 bytes
+		static std::uint8_t get_fd_frame_length(std::uint32_t length);
+
+		std::uint64_t timestamp_us; ///< A microsecond timestamp in the driver's own time base. Zero or `UINT64_MAX` if the driver doesn't provide one
 		std::uint32_t identifier; ///< The 32 bit identifier of the frame
 		std::uint8_t channel; ///< The CAN channel index associated with the frame
-		std::uint8_t data[8]; ///< The data payload of the frame
+		std::uint8_t data[CAN_FD_DATA_LENGTH]; ///< The data payload of the frame
 		std::uint8_t dataLength; ///< The length of the data used in the frame
 		bool isExtendedFrame; ///< Denotes if the frame is extended format
+		bool isFDFrame; ///< Denotes if the frame is a CAN FD frame, which is required for lengths over 8 bytes
+		bool isBitRateSwitch; ///< Denotes if a CAN FD frame sends its data phase at the faster data bit rate
 	};
 
 } // namespace isobus
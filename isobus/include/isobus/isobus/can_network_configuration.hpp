@@ -29,12 +29,12 @@ namespace isobus
 		/// @brief The destructor for the configuration object
 		~CANNetworkConfiguration() = default;
 
-		/// @brief Configures the max number of concurrent TP sessions to provide a RAM limit for TP sessions
-		/// @param[in] value The max allowable number of TP sessions
+		/// @brief Configures the max number of concurrent TP sessions on each CAN channel to provide a RAM limit for TP sessions
+		/// @param[in] value The max allowable number of TP sessions per channel
 		void set_max_number_transport_protocol_sessions(std::uint32_t value);
 
-		/// @brief Returns the max number of concurrent TP sessions
-		/// @returns The max number of concurrent TP sessions
+		/// @brief Returns the max number of concurrent TP sessions on each CAN channel
+		/// @returns The max number of concurrent TP sessions per channel
 		std::uint32_t get_max_number_transport_protocol_sessions() const;
 
 		/// @brief Sets the minimum time to wait between sending BAM frames
@@ -73,12 +73,55 @@ namespace isobus
 		/// @returns The max number of frames to use in transport protocols in each network manager update
 		std::uint8_t get_max_number_of_network_manager_protocol_frames_per_update() const;
 
+		/// @brief Sets the number of received CAN messages that can be buffered on each CAN channel
+		/// between network manager updates. Messages received while the buffer is full are dropped.
+		/// The value is rounded up to the next power of two.
+		/// @note This must be set before the network manager is first updated to have any effect.
+		/// @param[in] depth The number of messages to buffer per channel
+		void set_receive_queue_depth(std::uint32_t depth);
+
+		/// @brief Returns the number of received CAN messages that can be buffered on each CAN channel
+		/// between network manager updates
+		/// @returns The number of messages that will be buffered per channel
+		std::uint32_t get_receive_queue_depth() const;
+
+		/// @brief Sets if a CAN channel is connected to a CAN FD bus
+		/// @details When enabled, messages of up to 64 bytes are sent on that channel as a single
+		/// CAN FD frame with bit rate switching instead of using a transport protocol.
+		/// Messages of 8 bytes or less are still sent as classical CAN frames.
+		/// Your hardware interface must also be configured for CAN FD.
+		/// @param[in] channelIndex The CAN channel to configure
+		/// @param[in] enabled `true` to send CAN FD frames on the channel, `false` to only send classical CAN frames
+		void set_can_fd_enabled(std::uint8_t channelIndex, bool enabled);
+
+		/// @brief Returns if a CAN channel is configured to send CAN FD frames
+		/// @param[in] channelIndex The CAN channel to check
+		/// @returns `true` if CAN FD frames will be sent on the channel, otherwise `false`
+		bool get_can_fd_enabled(std::uint8_t channelIndex) const;
+
+		/// @brief Sets the number of threads the network manager uses to update its CAN channels
+		/// @details Each CAN channel has its own receive queue, address table and transport layer sessions,
+		/// so channels can be updated in parallel. With more than one thread, callbacks for messages
+		/// on different channels may run at the same time. The default is 1, which updates every channel
+		/// on the thread that calls the network manager's update function.
+		/// @param[in] numberOfThreads The number of threads to use, including the one that calls update
+		void set_number_of_update_threads(std::uint8_t numberOfThreads);
+
+		/// @brief Returns the number of threads the network manager uses to update its CAN channels
+		/// @returns The number of threads used to update the CAN channels, including the one that calls update
+		std::uint8_t get_number_of_update_threads() const;
+
 	private:
 		static constexpr std::uint8_t DEFAULT_BAM_PACKET_DELAY_TIME_MS = 50; ///< The default time between BAM frames, as defined by J1939
 
+		static constexpr std::uint32_t DEFAULT_RECEIVE_QUEUE_DEPTH = 256; ///< The default number of messages buffered per channel between updates
+
 		std::uint32_t maxNumberTransportProtocolSessions = 4; ///< The max number of TP sessions allowed
+		std::uint32_t receiveQueueDepth = DEFAULT_RECEIVE_QUEUE_DEPTH; ///< The number of received messages buffered per channel
 		std::uint32_t minimumTimeBetweenTransportProtocolBAMFrames = DEFAULT_BAM_PACKET_DELAY_TIME_MS; ///< The configurable time between BAM frames
 		std::uint8_t extendedTransportProtocolMaxNumberOfFramesPerEDPO = 0xFF; ///< Used to control throttling of ETP sessions.
+		std::uint8_t canFDEnabledChannels = 0; ///< Bit field of the channels that are configured for CAN FD
+		std::uint8_t numberOfUpdateThreads = 1; ///< The number of threads that update the CAN channels
 		std::uint8_t networkManagerMaxFramesToSendPerUpdate = 0xFF; ///< Used to control the max number of transport layer frames added to the driver queue per network manager update
 	};
 } // namespace isobus
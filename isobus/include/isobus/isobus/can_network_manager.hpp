@@ -17,19 +17,29 @@
 #include "isobus/isobus/can_callbacks.hpp"
 #include "isobus/isobus/can_constants.hpp"
 #include "isobus/isobus/can_extended_transport_protocol.hpp"
+#include "isobus/isobus/can_hardware_abstraction.hpp"
 #include "isobus/isobus/can_identifier.hpp"
 #include "isobus/isobus/can_internal_control_function.hpp"
 #include "isobus/isobus/can_message.hpp"
 #include "isobus/isobus/can_message_frame.hpp"
 #include "isobus/isobus/can_network_configuration.hpp"
+#include "isobus/isobus/can_stack_instrumentation.hpp"
+#include "isobus/isobus/can_traffic_statistics.hpp"
 #include "isobus/isobus/can_transport_protocol.hpp"
 #include "isobus/isobus/nmea2000_fast_packet_protocol.hpp"
+#include "isobus/utility/callback_executor.hpp"
 #include "isobus/utility/event_dispatcher.hpp"
+#include "isobus/utility/spsc_ring_buffer.hpp"
+#include "isobus/utility/thread_pool.hpp"
 
 #include <array>
+#include <atomic>
+#include <bitset>
 #include <deque>
 #include <list>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
 #include <mutex>
@@ -45,11 +55,27 @@ namespace isobus
 	///
 	/// @brief The main CAN network manager object, handles protocol management and updating other
 	/// stack components. Provides an interface for sending CAN messages.
+	/// @details Most applications only need the default instance, `CANNetwork`, which is connected to the
+	/// hardware layer. Additional instances are fully independent stacks, with their own control functions,
+	/// protocols and callbacks. They are not connected to the hardware layer, instead they are fed frames
+	/// with on_can_frame_received and send frames through the callback given to set_can_frame_transmit_callback.
+	/// This allows simulating many ECUs in one process, each on its own thread.
+	/// Control functions refer back to the instance that created them, so destroy them before the instance.
 	//================================================================================================
 	class CANNetworkManager
 	{
 	public:
-		static CANNetworkManager CANNetwork; ///< Static singleton of the one network manager. Use this to access stack functionality.
+		static CANNetworkManager CANNetwork; ///< The default network manager, which is connected to the hardware layer. Use this to access stack functionality.
+
+		/// @brief Constructor for a network manager. Sets default values for members
+		CANNetworkManager();
+
+		/// @brief Deleted copy constructor, protocols and control functions refer back to their network manager
+		CANNetworkManager(const CANNetworkManager &) = delete;
+
+		/// @brief Deleted copy assignment operator
+		/// @returns Nothing, this is deleted
+		CANNetworkManager &operator=(const CANNetworkManager &) = delete;
 
 		/// @brief Initializer function for the network manager
 		void initialize();
@@ -64,7 +90,8 @@ namespace isobus
 		/// @param[in] parameterGroupNumber The PGN you want to register for
 		/// @param[in] callback The callback that will be called when parameterGroupNumber is received from the global address (0xFF)
 		/// @param[in] parent A generic context variable that helps identify what object the callback is destined for. Can be nullptr if you don't want to use it.
-		void add_global_parameter_group_number_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent);
+		/// @param[in] executor An executor to run the callback on instead of the thread that updates the network manager, or `nullptr` to run it inline. Must outlive the callback.
+		void add_global_parameter_group_number_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent, CallbackExecutor *executor = nullptr);
 
 		/// @brief This is how you remove a callback for any PGN destined for the global address (0xFF)
 		/// @param[in] parameterGroupNumber The PGN of the callback to remove
@@ -80,7 +107,8 @@ namespace isobus
 		/// @param[in] parameterGroupNumber The PGN you want to register for
 		/// @param[in] callback The callback that will be called when parameterGroupNumber is received from any control function
 		/// @param[in] parent A generic context variable that helps identify what object the callback is destined for. Can be nullptr if you don't want to use it.
-		void add_any_control_function_parameter_group_number_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent);
+		/// @param[in] executor An executor to run the callback on instead of the thread that updates the network manager, or `nullptr` to run it inline. Must outlive the callback.
+		void add_any_control_function_parameter_group_number_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent, CallbackExecutor *executor = nullptr);
 
 		/// @brief This is how you remove a callback added with add_any_control_function_parameter_group_number_callback
 		/// @param[in] parameterGroupNumber The PGN of the callback to remove
@@ -102,6 +130,29 @@ namespace isobus
 		/// @returns Estimated busload over the last 1 second
 		float get_estimated_busload(std::uint8_t canChannel);
 
+		/// @brief Returns the per-PGN, per-source traffic statistics for every channel of this network manager
+		/// @details The statistics are off by default, turn them on with `CANTrafficStatistics::set_enabled`.
+		/// Once enabled, every frame this network manager receives or transmits is counted, and rates are
+		/// updated once per second while the network manager is updated.
+		/// @returns The traffic statistics of this network manager
+		CANTrafficStatistics &get_traffic_statistics();
+
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+		/// @brief Returns the latency histograms and queue high-water marks of this network manager and its protocols
+		/// @note This is only available when the stack is compiled with `CAN_STACK_ENABLE_INSTRUMENTATION`
+		/// @returns The instrumentation of this network manager
+		CANStackInstrumentation &get_instrumentation();
+#endif
+
+		/// @brief Returns the number of received CAN messages that were dropped on a channel
+		/// because its receive queue was full
+		/// @details Each channel buffers received messages between calls to update(). If this
+		/// is non-zero, update the stack more often or increase the receive queue depth in
+		/// the network configuration.
+		/// @param[in] canChannel The channel to get the count for
+		/// @returns The number of dropped messages on the channel, or zero for an invalid channel
+		std::uint32_t get_number_rx_messages_dropped(std::uint8_t canChannel) const;
+
 		/// @brief This is the main way to send a CAN message of any length.
 		/// @details This function will automatically choose an appropriate transport protocol if needed.
 		/// If you don't specify a destination (or use nullptr) you message will be sent as a broadcast
@@ -127,23 +178,85 @@ namespace isobus
 		                      void *parentPointer = nullptr,
 		                      DataChunkCallback frameChunkCallback = nullptr);
 
+		/// @brief Sends a CAN message of any length straight out of a shared buffer, without copying it
+		/// @details Use this for large messages, like object pools, that are already in memory. Transport
+		/// protocols keep a reference to the buffer until the session ends, and read each packet from it as
+		/// it is sent. The bytes in the buffer must not be changed until the tx complete callback is called.
+		/// Messages that fit in a single frame are sent right away like any other message.
+		/// @param[in] parameterGroupNumber The PGN to use when sending the message
+		/// @param[in] dataBuffer The shared buffer to send from
+		/// @param[in] dataLength The size of the message to send
+		/// @param[in] sourceControlFunction The control function that is sending the message
+		/// @param[in] destinationControlFunction The control function that the message is destined for or nullptr if broadcast
+		/// @param[in] priority The CAN priority of the message being sent
+		/// @param[in] txCompleteCallback A callback to be called when the message is sent or fails to send
+		/// @param[in] parentPointer A generic context variable that helps identify what object the callback is destined for
+		/// @returns `true` if the message was sent, otherwise `false`
+		bool send_can_message(std::uint32_t parameterGroupNumber,
+		                      std::shared_ptr<const std::uint8_t> dataBuffer,
+		                      std::uint32_t dataLength,
+		                      std::shared_ptr<InternalControlFunction> sourceControlFunction,
+		                      std::shared_ptr<ControlFunction> destinationControlFunction = nullptr,
+		                      CANIdentifier::CANPriority priority = CANIdentifier::CANPriority::PriorityDefault6,
+		                      TransmitCompleteCallback txCompleteCallback = nullptr,
+		                      void *parentPointer = nullptr);
+
 		/// @brief This is the main function used by the stack to receive CAN messages and add them to a queue.
 		/// @details This function is called by the stack itself when you call can_lib_process_rx_message.
+		/// Each CAN channel has a lock-free queue that the update thread consumes without locking.
+		/// Messages can be received from any thread, producers on the same channel only wait for each other.
 		/// @param[in] message The message to be received
 		void receive_can_message(const CANMessage &message);
 
+		/// @brief Receives a CAN message by moving it into the receive queue, avoiding a copy
+		/// @details The same threading rules apply as for the overload that takes a const reference.
+		/// @param[in] message The message to be received
+		void receive_can_message(CANMessage &&message);
+
 		/// @brief The main update function for the network manager. Updates all protocols.
+		/// @details Each CAN channel has its own receive queue, address table and protocol sessions, so the
+		/// channels are updated independently of each other, spread across the number of threads set with
+		/// CANNetworkConfiguration::set_number_of_update_threads. When more than one thread is used,
+		/// callbacks for messages on different channels may run at the same time.
 		void update();
 
-		/// @brief Process the CAN Rx queue
+		/// @brief Process the CAN Rx queue of the default network manager
 		/// @param[in] rxFrame Frame to process
 		static void process_receive_can_message_frame(const CANMessageFrame &rxFrame);
 
-		/// @brief Used to tell the network manager when frames are emitted on the bus, so that they can be
+		/// @brief Used to tell the default network manager when frames are emitted on the bus, so that they can be
 		/// added to the internal bus load calculations.
 		/// @param[in] txFrame The frame that was just emitted onto the bus
 		static void process_transmitted_can_message_frame(const CANMessageFrame &txFrame);
 
+		/// @brief Gives this network manager a frame that was received from its bus
+		/// @details The same threading rules apply as for receive_can_message.
+		/// @param[in] rxFrame The frame that was received
+		void on_can_frame_received(const CANMessageFrame &rxFrame);
+
+		/// @brief Tells this network manager that one of its frames was emitted on the bus, for the bus load calculations
+		/// @param[in] txFrame The frame that was just emitted onto the bus
+		void on_can_frame_transmitted(const CANMessageFrame &txFrame);
+
+		/// @brief Tells this network manager that a channel which rejected a frame because its Tx queue was full has room again
+		/// @details This requests an update, so protocol sessions that were holding back frames on the channel can carry on.
+		/// @param[in] channelIndex The CAN channel that has Tx space available
+		void on_transmit_space_available(std::uint8_t channelIndex);
+
+		/// @brief Returns if the last frame sent on a channel was rejected because the hardware's Tx queue was full
+		/// @details Protocols use this to pace themselves to the bus. While a channel is blocked, sessions that only
+		/// have frames to send wait for on_transmit_space_available instead of asking to be updated right away.
+		/// @param[in] channelIndex The CAN channel to check
+		/// @returns `true` if the channel is waiting for Tx space, otherwise `false`
+		bool get_is_transmit_blocked(std::uint8_t channelIndex) const;
+
+		/// @brief Sets where this network manager sends its frames
+		/// @details By default frames go to the hardware layer. Set this on additional network managers to
+		/// connect them to a simulated bus instead.
+		/// @param[in] callback The function to call with each frame to send, or `nullptr` to send to the hardware layer
+		/// @param[in] parentPointer A generic context variable that is passed to the callback
+		void set_can_frame_transmit_callback(CANFrameTransmitCallback callback, void *parentPointer);
+
 		/// @brief Informs the network manager that a control function object has been destroyed, so that it can be purged from the network manager
 		/// @param[in] controlFunction The control function that was destroyed
 		void on_control_function_destroyed(std::shared_ptr<ControlFunction> controlFunction, CANLibBadge<ControlFunction>);
@@ -196,6 +309,47 @@ namespace isobus
 		/// @returns An event dispatcher which can be used to get notified about address violations
 		EventDispatcher<std::shared_ptr<InternalControlFunction>> &get_address_violation_event_dispatcher();
 
+		/// @brief Returns how long the network manager can go without being updated
+		/// @details This is based on the timers of the protocols, address claiming, and bus load tracking.
+		/// Hardware layers can use this to sleep between updates rather than updating on a fixed interval.
+		/// The network manager should still be updated whenever a frame is received, or an update is requested through
+		/// `get_update_requested_event_dispatcher`.
+		/// @returns The time until the network manager next needs to be updated in milliseconds, or `0` if it has work to do right away
+		std::uint32_t get_time_until_next_update_ms();
+
+		/// @brief Returns the network manager's event dispatcher for notifying the hardware layer that the network manager
+		/// has new work to do, which can't wait for the time returned by `get_time_until_next_update_ms`.
+		/// @details This happens when a protocol accepts a message to transmit, or a new internal or partnered control function is created.
+		/// @returns An event dispatcher which can be used to get notified when the network manager should be updated
+		EventDispatcher<> &get_update_requested_event_dispatcher();
+
+		/// @brief Sets if this network manager tells the hardware layer which frames it needs, so drivers that support
+		/// filtering can drop the rest before they reach the stack
+		/// @details The filters pass every frame sent to one of our internal control functions' addresses or to the
+		/// global address, every frame sent from one of our addresses so address violations are still detected,
+		/// and broadcast (PDU2) frames with a PGN that has a global, any control function or protocol callback registered.
+		/// Filtering is off by default. While traffic statistics are enabled every frame is needed, so nothing is filtered.
+		/// @note With filtering enabled, the bus load estimate only counts frames that pass the filters, and 11 bit frames are not received.
+		/// @param[in] enabled `true` to filter received frames in drivers that support it, `false` to receive every frame
+		void set_receive_filtering_enabled(bool enabled);
+
+		/// @brief Returns if this network manager tells the hardware layer which frames it needs
+		/// @returns `true` if receive filtering is enabled, otherwise `false`
+		bool get_receive_filtering_enabled() const;
+
+		/// @brief Returns the frames this network manager needs to receive on a channel
+		/// @param[in] channelIndex The CAN channel to get the filters for
+		/// @param[out] filters The frames that are needed, any frame that passes one of these should be received
+		/// @returns `true` if only frames that pass `filters` are needed, `false` if every frame is needed
+		bool get_receive_filters(std::uint8_t channelIndex, std::vector<CANReceiveFilter> &filters);
+
+		/// @brief Returns the network manager's event dispatcher for notifying the hardware layer that a channel's
+		/// receive filters have changed, and should be fetched again with `get_receive_filters`
+		/// @details This happens when a callback is added or removed, an internal control function's address changes,
+		/// or filtering or traffic statistics are turned on or off. It is invoked from the update function.
+		/// @returns An event dispatcher which is invoked with the index of the channel whose filters changed
+		EventDispatcher<std::uint8_t> &get_receive_filters_changed_event_dispatcher();
+
 	protected:
 		// Using protected region to allow protocols use of special functions from the network manager
 		friend class AddressClaimStateMachine; ///< Allows the network manager to work closely with the address claiming process
@@ -245,15 +399,17 @@ namespace isobus
 		std::vector<CANLibProtocol *> protocolList; ///< A list of all created protocol classes
 
 	private:
-		/// @brief Constructor for the network manager. Sets default values for members
-		CANNetworkManager();
-
 		/// @brief Updates the internal address table based on a received CAN message
 		/// @param[in] message A message being received by the stack
 		void update_address_table(const CANMessage &message);
 
+		/// @brief Updates one CAN channel's address table, receive queue and protocol sessions
+		/// @param[in] channelIndex The CAN channel to update
+		void update_channel(std::uint8_t channelIndex);
+
 		/// @brief Updates the internal address table based on updates to internal cfs addresses
-		void update_internal_cfs();
+		/// @param[in] channelIndex The CAN channel whose internal control functions should be updated
+		void update_internal_cfs(std::uint8_t channelIndex);
 
 		/// @brief Processes a CAN message's contribution to the current busload
 		/// @param[in] channelIndex The CAN channel index associated to the message being processed
@@ -267,8 +423,50 @@ namespace isobus
 		/// @param[in] rxFrame Raw frames coming in from the bus
 		void update_control_functions(const CANMessageFrame &rxFrame);
 
+		/// @brief Finds a known control function on a channel by its NAME
+		/// @param[in] channelIndex The CAN channel to search
+		/// @param[in] NAME The full NAME to look for
+		/// @returns The control function with that NAME, or `nullptr` if none is in the address table or the inactive list
+		std::shared_ptr<ControlFunction> find_control_function_by_name(std::uint8_t channelIndex, std::uint64_t NAME) const;
+
+		/// @brief Puts a control function into the address table, replacing whatever was in that slot
+		/// @details All writes to the address table go through this so the NAME index stays in sync with it
+		/// @param[in] channelIndex The CAN channel of the slot
+		/// @param[in] address The address of the slot
+		/// @param[in] controlFunction The control function to put in the slot, or `nullptr` to clear it
+		void set_control_function_table_entry(std::uint8_t channelIndex, std::uint8_t address, std::shared_ptr<ControlFunction> controlFunction);
+
+		/// @brief Adds a control function to the inactive list
+		/// @param[in] controlFunction The control function to add
+		void add_inactive_control_function(std::shared_ptr<ControlFunction> controlFunction);
+
+		/// @brief Removes a control function from the inactive list
+		/// @param[in] position The position in the inactive list to remove
+		/// @returns The position after the removed one
+		std::list<std::shared_ptr<ControlFunction>>::iterator remove_inactive_control_function(std::list<std::shared_ptr<ControlFunction>>::iterator position);
+
+		/// @brief Records that a control function was added to the address table or the inactive list
+		/// @param[in] controlFunction The control function that was added
+		/// @param[in] inactive `true` if it was added to the inactive list, `false` for the address table
+		void add_control_function_name_reference(const std::shared_ptr<ControlFunction> &controlFunction, bool inactive);
+
+		/// @brief Records that a control function was removed from the address table or the inactive list
+		/// @param[in] controlFunction The control function that was removed
+		/// @param[in] inactive `true` if it was removed from the inactive list, `false` for the address table
+		void remove_control_function_name_reference(const std::shared_ptr<ControlFunction> &controlFunction, bool inactive);
+
+		/// @brief Converts a frame's hardware timestamp into the stack's time base
+		/// @details Drivers timestamp frames using their own clock, so the offset between that clock
+		/// and SystemTiming is estimated per channel. The smallest offset seen recently is used, because that is the
+		/// frame that waited the least amount of time between being received and being processed.
+		/// Falls back to the current time if the frame has no usable timestamp.
+		/// @param[in] rxFrame The frame to get the receive time of
+		/// @returns The time the frame was received in microseconds, in the same time base as SystemTiming::get_timestamp_us
+		std::uint64_t get_receive_timestamp_us(const CANMessageFrame &rxFrame);
+
 		/// @brief Checks if new partners have been created and matches them to existing control functions
-		void update_new_partners();
+		/// @param[in] channelIndex The CAN channel whose partners should be checked
+		void update_new_partners(std::uint8_t channelIndex);
 
 		/// @brief Builds a CAN frame from a frame's discrete components
 		/// @param[in] portIndex The CAN channel index of the CAN message being processed
@@ -293,14 +491,9 @@ namespace isobus
 		/// @returns A control function matching the address and CAN port passed in
 		std::shared_ptr<ControlFunction> get_control_function(std::uint8_t channelIndex, std::uint8_t address) const;
 
-		/// @brief Gets a message from the Rx Queue.
-		/// @note This will only ever get an 8 byte message. Long messages are handled elsewhere.
-		/// @returns The can message that was at the front of the buffer
-		CANMessage get_next_can_message_from_rx_queue();
-
-		/// @brief Returns the number of messages in the rx queue that need to be processed
-		/// @returns The number of messages in the rx queue that need to be processed
-		std::size_t get_number_can_messages_in_rx_queue();
+		/// @brief Runs a received message through address management and all matching callbacks
+		/// @param[in] currentMessage The message to process
+		void process_rx_message(const CANMessage &currentMessage);
 
 		/// @brief Informs the network manager that a control function object has been created
 		/// @param[in] controlFunction The control function that was created
@@ -338,12 +531,31 @@ namespace isobus
 		/// @param[in] message The message to process
 		void process_can_message_for_commanded_address(const CANMessage &message);
 
-		/// @brief Processes the internal receive message queue
-		void process_rx_messages();
+		/// @brief Marks every channel's receive filters as changed, so the hardware layer is told on the next update
+		void on_receive_filters_changed();
+
+		/// @brief Checks if the addresses of the internal control functions on a channel have changed since the receive filters were last made
+		/// @param[in] channelIndex The CAN channel to check
+		void update_receive_filter_addresses(std::uint8_t channelIndex);
+
+		/// @brief Tells the hardware layer about every channel whose receive filters have changed
+		void update_receive_filters();
+
+		/// @brief Processes the internal receive message queue of a CAN channel
+		/// @param[in] channelIndex The CAN channel whose receive queue should be processed
+		void process_rx_messages(std::uint8_t channelIndex);
 
 		/// @brief Checks to see if any control function didn't claim during a round of
 		/// address claiming and removes it if needed.
-		void prune_inactive_control_functions();
+		/// @param[in] channelIndex The CAN channel to check
+		void prune_inactive_control_functions(std::uint8_t channelIndex);
+
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		/// @brief Locks every CAN channel, for the few operations that touch state shared between channels
+		/// @details Channels are always locked in index order, so this can't deadlock against a channel being updated
+		/// @returns The locks on every channel, which are released when they go out of scope
+		std::array<std::unique_lock<std::mutex>, CAN_PORT_MAXIMUM> lock_all_channels();
+#endif
 
 		/// @brief Sends a CAN message using raw addresses. Used only by the stack.
 		/// @param[in] portIndex The CAN channel index to send the message from
@@ -369,6 +581,7 @@ namespace isobus
 
 		static constexpr std::uint32_t BUSLOAD_SAMPLE_WINDOW_MS = 1000; ///< Using a 1s window to average the bus load, otherwise it's very erratic
 		static constexpr std::uint32_t BUSLOAD_UPDATE_FREQUENCY_MS = 100; ///< Bus load bit accumulation happens over a 100ms window
+		static constexpr std::uint32_t MAX_ADDRESS_CLAIM_RESOLUTION_TIME_MS = 755; ///< The time to wait for CFs to respond to a request for address claim, this is 250ms + RTxD + 250ms
 
 		CANNetworkConfiguration configuration; ///< The configuration for this network manager
 		ExtendedTransportProtocolManager extendedTransportProtocol; ///< Static instance of the protocol manager
@@ -380,26 +593,69 @@ namespace isobus
 		std::array<std::uint32_t, CAN_PORT_MAXIMUM> lastAddressClaimRequestTimestamp_ms; ///< Stores timestamps for when the last request for the address claim PGN was received. Used to prune stale CFs.
 
 		std::array<std::array<std::shared_ptr<ControlFunction>, NULL_CAN_ADDRESS>, CAN_PORT_MAXIMUM> controlFunctionTable; ///< Table to maintain address to NAME mappings
-		std::list<std::shared_ptr<ControlFunction>> inactiveControlFunctions; ///< A list of the control function that currently don't have a valid address
+		std::array<std::list<std::shared_ptr<ControlFunction>>, CAN_PORT_MAXIMUM> inactiveControlFunctions; ///< The control functions on each channel that currently don't have a valid address
+
+		/// @brief Tracks where a known control function is referenced from, so it can be dropped from the NAME index once nothing refers to it
+		struct ControlFunctionNameIndexEntry
+		{
+			std::shared_ptr<ControlFunction> controlFunction; ///< The control function with this NAME
+			std::uint32_t tableReferences = 0; ///< The number of address table slots holding the control function
+			std::uint32_t inactiveReferences = 0; ///< The number of times the control function is in the inactive list
+		};
+
+		std::array<std::unordered_map<std::uint64_t, ControlFunctionNameIndexEntry>, CAN_PORT_MAXIMUM> controlFunctionNameIndex; ///< Every control function in the address table or inactive list, by channel and NAME
+		std::array<std::array<std::shared_ptr<ControlFunction>, NULL_CAN_ADDRESS>, CAN_PORT_MAXIMUM> inactiveControlFunctionClaims; ///< Inactive control functions that claimed an address but haven't been moved back into the address table yet
 		std::list<std::shared_ptr<InternalControlFunction>> internalControlFunctions; ///< A list of the internal control functions
 		std::list<std::shared_ptr<PartneredControlFunction>> partneredControlFunctions; ///< A list of the partnered control functions
 
-		std::list<ParameterGroupNumberCallbackData> protocolPGNCallbacks; ///< A list of PGN callback registered by CAN protocols
-		std::list<CANMessage> receiveMessageList; ///< A queue of Rx messages to process
+		ParameterGroupNumberCallbackTable protocolPGNCallbacks; ///< A table of PGN callback registered by CAN protocols
+		std::array<std::unique_ptr<SPSCRingBuffer<CANMessage>>, CAN_PORT_MAXIMUM> receiveMessageQueues; ///< A queue of Rx messages to process for each channel
 		std::list<ControlFunctionStateCallback> controlFunctionStateCallbacks; ///< List of all control function state callbacks
-		std::vector<ParameterGroupNumberCallbackData> globalParameterGroupNumberCallbacks; ///< A list of all global PGN callbacks
-		std::vector<ParameterGroupNumberCallbackData> anyControlFunctionParameterGroupNumberCallbacks; ///< A list of all global PGN callbacks
+		ParameterGroupNumberCallbackTable globalParameterGroupNumberCallbacks; ///< A table of all global PGN callbacks
+		ParameterGroupNumberCallbackTable anyControlFunctionParameterGroupNumberCallbacks; ///< A table of all "any control function" PGN callbacks
 		EventDispatcher<std::shared_ptr<InternalControlFunction>> addressViolationEventDispatcher; ///< An event dispatcher for notifying consumers about address violations
+		EventDispatcher<> updateRequestedEventDispatcher; ///< An event dispatcher for notifying the hardware layer that the network manager should be updated
+		EventDispatcher<std::uint8_t> receiveFiltersChangedEventDispatcher; ///< An event dispatcher for notifying the hardware layer that a channel's receive filters changed
 #if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		std::mutex receiveMessageMutex; ///< A mutex for receive messages thread safety
-		std::mutex protocolPGNCallbacksMutex; ///< A mutex for PGN callback thread safety
-		std::mutex anyControlFunctionCallbacksMutex; ///< Mutex to protect the "any CF" callbacks
+		std::array<std::mutex, CAN_PORT_MAXIMUM> protocolPGNCallbacksMutexes; ///< Protect the protocol PGN callbacks. Dispatch locks its own channel's mutex, changes lock every channel's
+		std::array<std::mutex, CAN_PORT_MAXIMUM> anyControlFunctionCallbacksMutexes; ///< Protect the "any CF" callbacks. Dispatch locks its own channel's mutex, changes lock every channel's
 		std::mutex busloadUpdateMutex; ///< A mutex that protects the busload metrics since we calculate it on our own thread
 		std::mutex controlFunctionStatusCallbacksMutex; ///< A Mutex that protects access to the control function status callback list
+		std::array<std::mutex, CAN_PORT_MAXIMUM> receiveQueueProducerMutexes; ///< Lets more than one thread receive messages on a channel, since each receive queue has a single producer side. Also protects the channel's receive timestamp sync
+		std::array<std::mutex, CAN_PORT_MAXIMUM> channelMutexes; ///< Protects each channel's control function tables and protocol sessions
+		std::mutex updateMutex; ///< Makes sure only one thread runs the update function at a time
+#endif
+		ThreadPool updateThreadPool; ///< Threads used to update the CAN channels in parallel
+		CANTrafficStatistics trafficStatistics; ///< Per-PGN, per-source counters of the frames received and transmitted on every channel
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+		CANStackInstrumentation instrumentation; ///< Latency histograms and queue high-water marks for this network manager and its protocols
 #endif
+		CANFrameTransmitCallback frameTransmitCallback = nullptr; ///< Where frames are sent, or `nullptr` to send them to the hardware layer
+		void *frameTransmitParent = nullptr; ///< The context variable passed to the frame transmit callback
+		mutable std::array<std::atomic_bool, CAN_PORT_MAXIMUM> transmitBlocked = {}; ///< Stores if each channel's last frame was rejected because the hardware's Tx queue was full
+		std::array<std::atomic<std::uint32_t>, CAN_PORT_MAXIMUM> transmitSpaceAvailableCounts = {}; ///< Counts the times each channel reported Tx space, so a send can tell if it raced with a report
+		std::array<std::atomic_bool, CAN_PORT_MAXIMUM> channelsInUse = {}; ///< Stores if each channel has received a message or has an internal or partnered control function, and so needs updating
+		std::array<std::atomic_bool, CAN_PORT_MAXIMUM> receiveFiltersChanged = {}; ///< Stores if each channel's receive filters have changed since the hardware layer was last told
+		std::array<std::bitset<NULL_CAN_ADDRESS>, CAN_PORT_MAXIMUM> receiveFilterAddresses; ///< The internal control function addresses on each channel the last time the receive filters were checked
+		std::atomic_bool receiveFilteringEnabled = { false }; ///< Stores if the hardware layer is told which frames are needed
+		bool receiveFiltersIncludeTrafficStatistics = false; ///< Stores if traffic statistics were enabled the last time the receive filters were checked
+		/// @brief Tracks the offset between a channel's hardware clock and SystemTiming
+		struct ReceiveTimestampSync
+		{
+			std::uint64_t windowStart_us = 0; ///< The time the current estimation window started
+			std::int64_t currentWindowMinimumOffset_us = 0; ///< The smallest offset seen in the current window
+			std::int64_t previousWindowMinimumOffset_us = 0; ///< The smallest offset seen in the previous window
+			bool currentWindowValid = false; ///< Tracks if any timestamped frames have been seen in the current window
+			bool previousWindowValid = false; ///< Tracks if any timestamped frames were seen in the previous window
+		};
+
+		static constexpr std::uint64_t RECEIVE_TIMESTAMP_WINDOW_US = 1000000; ///< How long each hardware clock offset estimation window lasts
+		static constexpr std::uint64_t MAX_RECEIVE_TIMESTAMP_AGE_US = 500000; ///< Converted timestamps older than this are assumed to be bad and are replaced with the current time
+
+		std::array<ReceiveTimestampSync, CAN_PORT_MAXIMUM> receiveTimestampSync; ///< Hardware clock offset estimates for each channel, protected by the channel's receive queue producer mutex
 		std::uint32_t busloadUpdateTimestamp_ms = 0; ///< Tracks a time window for determining approximate busload
 		std::uint32_t updateTimestamp_ms = 0; ///< Keeps track of the last time the CAN stack was update in milliseconds
-		bool initialized = false; ///< True if the network manager has been initialized by the update function
+		std::atomic_bool initialized = { false }; ///< True if the network manager has been initialized, and its receive queues are ready for producers
 	};
 
 } // namespace isobus
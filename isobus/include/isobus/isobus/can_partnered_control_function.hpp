@@ -44,10 +44,18 @@ namespace isobus
 		/// @returns A shared pointer to a PartneredControlFunction object created with the parameters passed in
 		static std::shared_ptr<PartneredControlFunction> create(std::uint8_t CANPort, const std::vector<NAMEFilter> NAMEFilters);
 
+		/// @brief The factory function to construct a partnered control function on a specific network manager
+		/// @param[in] CANPort The CAN channel associated with this control function definition
+		/// @param[in] NAMEFilters A list of filters that describe the identity of the CF based on NAME components
+		/// @param[in] networkManager The network manager to look for the partner on
+		/// @returns A shared pointer to a PartneredControlFunction object created with the parameters passed in
+		static std::shared_ptr<PartneredControlFunction> create(std::uint8_t CANPort, const std::vector<NAMEFilter> NAMEFilters, CANNetworkManager &networkManager);
+
 		/// @brief the constructor for a PartneredControlFunction, which is called by the factory function
 		/// @param[in] CANPort The CAN channel associated with this control function definition
 		/// @param[in] NAMEFilters A list of filters that describe the identity of the CF based on NAME components
-		PartneredControlFunction(std::uint8_t CANPort, const std::vector<NAMEFilter> NAMEFilters, CANLibBadge<PartneredControlFunction>);
+		/// @param[in] networkManager The network manager to look for the partner on
+		PartneredControlFunction(std::uint8_t CANPort, const std::vector<NAMEFilter> NAMEFilters, CANNetworkManager &networkManager, CANLibBadge<PartneredControlFunction>);
 
 		/// @brief Deleted copy constructor for PartneredControlFunction to avoid slicing
 		PartneredControlFunction(PartneredControlFunction &) = delete;
@@ -65,7 +73,8 @@ namespace isobus
 		/// @param[in] internalControlFunction An internal control function to filter based on. If you supply this
 		/// parameter the callback will only be called when messages from the partner are received with the
 		/// specified ICF as the destination.
-		void add_parameter_group_number_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent, std::shared_ptr<InternalControlFunction> internalControlFunction = nullptr);
+		/// @param[in] executor An executor to run the callback on instead of the thread that updates the network manager, or `nullptr` to run it inline. Must outlive the callback.
+		void add_parameter_group_number_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent, std::shared_ptr<InternalControlFunction> internalControlFunction = nullptr, CallbackExecutor *executor = nullptr);
 
 		/// @brief Removes a callback matching *exactly* the parameters passed in
 		/// @param[in] parameterGroupNumber The PGN associated with the callback being removed
@@ -100,18 +109,13 @@ namespace isobus
 		bool check_matches_name(NAME NAMEToCheck) const;
 
 	private:
-		friend class CANNetworkManager; ///< Allows the network manager to use get_parameter_group_number_callback
+		friend class CANNetworkManager; ///< Allows the network manager to dispatch this control function's PGN callbacks
 
 		/// @brief Make inherited factory function private so that it can't be called
 		static std::shared_ptr<ControlFunction> create(NAME, std::uint8_t, std::uint8_t) = delete;
 
-		/// @brief Returns a parameter group number associated with this control function by index
-		/// @param[in] index The index from which to get the PGN callback data object
-		/// @returns A reference to the PGN callback data object at the index specified
-		ParameterGroupNumberCallbackData &get_parameter_group_number_callback(std::size_t index);
-
 		const std::vector<NAMEFilter> NAMEFilterList; ///< A list of NAME parameters that describe this control function's identity
-		std::vector<ParameterGroupNumberCallbackData> parameterGroupNumberCallbacks; ///< A list of all parameter group number callbacks associated with this control function
+		ParameterGroupNumberCallbackTable parameterGroupNumberCallbacks; ///< A table of all parameter group number callbacks associated with this control function
 		bool initialized = false; ///< A way to track if the network manager has processed this CF against existing CFs
 	};
 
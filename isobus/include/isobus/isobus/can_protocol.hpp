@@ -16,6 +16,7 @@
 #include "isobus/isobus/can_control_function.hpp"
 #include "isobus/isobus/can_message.hpp"
 
+#include <cstddef>
 #include <vector>
 
 namespace isobus
@@ -32,9 +33,13 @@ namespace isobus
 	class CANLibProtocol
 	{
 	public:
-		/// @brief The base class constructor for a CANLibProtocol
+		/// @brief The base class constructor for a CANLibProtocol, which registers it with the default network manager
 		CANLibProtocol();
 
+		/// @brief The base class constructor for a CANLibProtocol
+		/// @param[in] networkManager The network manager to register the protocol with
+		explicit CANLibProtocol(CANNetworkManager &networkManager);
+
 		/// @brief Deleted copy constructor for a CANLibProtocol
 		CANLibProtocol(CANLibProtocol &) = delete;
 
@@ -45,14 +50,14 @@ namespace isobus
 		/// @returns true if the protocol has been initialized by the network manager
 		bool get_is_initialized() const;
 
-		/// @brief Gets a CAN protocol by index from the list of all protocols
+		/// @brief Gets a CAN protocol by index from the list of the default network manager's protocols
 		/// @param[in] index The index of the protocol to get from the list of protocols
 		/// @param[out] returnedProtocol The returned protocol
 		/// @returns true if a protocol was successfully returned, false if index was out of range
 		static bool get_protocol(std::uint32_t index, CANLibProtocol *&returnedProtocol);
 
-		/// @brief Returns the number of all created protocols
-		/// @returns The number of all created protocols
+		/// @brief Returns the number of protocols registered with the default network manager
+		/// @returns The number of protocols registered with the default network manager
 		static std::uint32_t get_number_protocols();
 
 		/// @brief A generic way to initialize a protocol
@@ -83,13 +88,103 @@ namespace isobus
 		                                       void *parentPointer,
 		                                       DataChunkCallback frameChunkCallback) = 0;
 
+		/// @brief The network manager calls this to see if the protocol can send a message out of a shared buffer
+		/// @details Protocols that can send straight from the shared buffer override this, to avoid copying
+		/// large payloads. By default the data is passed to protocol_transmit_message, which copies it.
+		/// @param[in] parameterGroupNumber The PGN of the message
+		/// @param[in] data The data to be sent, which must not change until the transmit complete callback is called
+		/// @param[in] messageLength The length of the data to be sent
+		/// @param[in] source The source control function
+		/// @param[in] destination The destination control function
+		/// @param[in] transmitCompleteCallback A callback for when the protocol completes its work
+		/// @param[in] parentPointer A generic context object for the tx complete callback
+		/// @returns true if the message was accepted by the protocol for processing
+		virtual bool protocol_transmit_shared_message(std::uint32_t parameterGroupNumber,
+		                                              std::shared_ptr<const std::uint8_t> data,
+		                                              std::uint32_t messageLength,
+		                                              std::shared_ptr<ControlFunction> source,
+		                                              std::shared_ptr<ControlFunction> destination,
+		                                              TransmitCompleteCallback transmitCompleteCallback,
+		                                              void *parentPointer);
+
 		/// @brief This will be called by the network manager on every cyclic update of the stack
-		virtual void update(CANLibBadge<CANNetworkManager>) = 0;
+		/// @details This is called before any of the channels are updated with update_channel.
+		virtual void update(CANLibBadge<CANNetworkManager>);
+
+		/// @brief This will be called by the network manager on every cyclic update of the stack, once for each CAN channel
+		/// @details Channels can be updated in parallel, so only state that belongs to that channel
+		/// may be touched here. Messages received on the channel are processed on the same thread beforehand.
+		/// @param[in] channelIndex The CAN channel to update
+		virtual void update_channel(std::uint8_t channelIndex, CANLibBadge<CANNetworkManager>);
+
+		/// @brief Returns how long the protocol can go without being updated, based on its active timers
+		/// @details The network manager uses this to let the hardware layer sleep between updates.
+		/// Protocols that don't override this will be updated as often as the hardware layer allows.
+		/// @returns The time until the protocol next needs to be updated in milliseconds, or `0` if it has work to do right away
+		virtual std::uint32_t get_time_until_next_update_ms() const;
 
 	protected:
+		CANNetworkManager &networkManager; ///< The network manager this protocol is registered with
 		bool initialized; ///< Keeps track of if the protocol has been initialized by the network manager
 	};
 
+	//================================================================================================
+	/// @class ProtocolSessionKey
+	///
+	/// @brief Identifies a transport layer session by the control functions and PGN involved
+	/// @details Control functions only exist on a single CAN channel, so sessions on different
+	/// channels never share a key. Protocols that only allow one session between a pair of control
+	/// functions can leave the PGN out of the key, so that data frames, which don't carry the PGN,
+	/// can still find their session directly.
+	//================================================================================================
+	class ProtocolSessionKey
+	{
+	public:
+		/// @brief Constructs a key that doesn't match any session
+		ProtocolSessionKey() = default;
+
+		/// @brief Constructs a key for the session between two control functions
+		/// @param[in] source The source control function of the session
+		/// @param[in] destination The destination control function of the session, or `nullptr` for broadcast sessions
+		ProtocolSessionKey(std::shared_ptr<ControlFunction> source, std::shared_ptr<ControlFunction> destination);
+
+		/// @brief Constructs a key for the session between two control functions for a specific PGN
+		/// @param[in] source The source control function of the session
+		/// @param[in] destination The destination control function of the session, or `nullptr` for broadcast sessions
+		/// @param[in] parameterGroupNumber The PGN of the message being transferred by the session
+		ProtocolSessionKey(std::shared_ptr<ControlFunction> source, std::shared_ptr<ControlFunction> destination, std::uint32_t parameterGroupNumber);
+
+		/// @brief Compares two keys for equality
+		/// @param[in] other The key to compare to
+		/// @returns `true` if both keys identify the same session, otherwise `false`
+		bool operator==(const ProtocolSessionKey &other) const;
+
+		/// @brief Returns a hash of the key, for use in hash tables
+		/// @returns A hash of the key
+		std::size_t get_hash() const;
+
+	private:
+		static constexpr std::uint32_t NO_PARAMETER_GROUP_NUMBER = 0xFFFFFFFF; ///< Used when the PGN is not part of the key
+
+		const ControlFunction *source = nullptr; ///< The source control function of the session
+		const ControlFunction *destination = nullptr; ///< The destination control function of the session
+		std::uint32_t parameterGroupNumber = NO_PARAMETER_GROUP_NUMBER; ///< The PGN of the session, if it is part of the key
+	};
+
+	//================================================================================================
+	/// @class ProtocolSessionKeyHash
+	///
+	/// @brief A hash function object for ProtocolSessionKey
+	//================================================================================================
+	class ProtocolSessionKeyHash
+	{
+	public:
+		/// @brief Returns the hash of a key
+		/// @param[in] key The key to hash
+		/// @returns The hash of the key
+		std::size_t operator()(const ProtocolSessionKey &key) const;
+	};
+
 } // namespace isobus
 
 #endif // CAN_PROTOCOL_HPP
@@ -0,0 +1,90 @@
+//================================================================================================
+/// @file can_stack_instrumentation.hpp
+///
+/// @brief Latency histograms and queue high-water marks for the inside of the CAN stack.
+/// @details The network manager and transport protocols only record into this when the stack is
+/// compiled with `CAN_STACK_ENABLE_INSTRUMENTATION` defined, which the `CAN_STACK_ENABLE_INSTRUMENTATION`
+/// CMake option does.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+
+#ifndef CAN_STACK_INSTRUMENTATION_HPP
+#define CAN_STACK_INSTRUMENTATION_HPP
+
+#include "isobus/isobus/can_constants.hpp"
+#include "isobus/utility/latency_histogram.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace isobus
+{
+	//================================================================================================
+	/// @class CANStackInstrumentation
+	///
+	/// @brief Collects timing and queue depth measurements from one network manager
+	/// @details All durations are in microseconds. Everything can be recorded and read from any thread.
+	//================================================================================================
+	class CANStackInstrumentation
+	{
+	public:
+		/// @brief The internal queues that high-water marks are kept for
+		enum class Queue : std::uint8_t
+		{
+			ReceivedMessages, ///< Messages received from the hardware layer, waiting for the network manager to process them
+			TransportProtocolSessions, ///< Active TP sessions
+			ExtendedTransportProtocolSessions, ///< Active ETP sessions
+			FastPacketProtocolSessions, ///< Active NMEA2000 fast packet sessions
+			NumberOfQueues ///< The number of queues, not a valid queue
+		};
+
+		/// @brief Constructs the instrumentation with nothing recorded
+		CANStackInstrumentation() = default;
+
+		/// @brief Deleted copy constructor
+		CANStackInstrumentation(const CANStackInstrumentation &) = delete;
+
+		/// @brief Deleted copy assignment operator
+		/// @returns Nothing, this is deleted
+		CANStackInstrumentation &operator=(const CANStackInstrumentation &) = delete;
+
+		/// @brief Returns the time between a message being received, by its timestamp, and the network manager starting to dispatch it
+		/// @returns The receive to dispatch latency histogram
+		LatencyHistogram &get_receive_to_dispatch_latency();
+
+		/// @brief Returns the time each call to the network manager's update function takes
+		/// @returns The update duration histogram
+		LatencyHistogram &get_update_duration();
+
+		/// @brief Returns the time between a TP or ETP session starting and it completing successfully
+		/// @returns The transport session duration histogram
+		LatencyHistogram &get_transport_session_duration();
+
+		/// @brief Raises a queue's high-water mark if it is deeper than it has been before
+		/// @param[in] queue The queue that was measured
+		/// @param[in] channelIndex The CAN channel the queue belongs to
+		/// @param[in] depth The number of items in the queue
+		void record_queue_depth(Queue queue, std::uint8_t channelIndex, std::size_t depth);
+
+		/// @brief Returns the most items a queue has held since the instrumentation was last reset
+		/// @param[in] queue The queue to get the high-water mark of
+		/// @param[in] channelIndex The CAN channel the queue belongs to
+		/// @returns The queue's high-water mark, or `0` if the queue or channel is invalid
+		std::size_t get_queue_high_water_mark(Queue queue, std::uint8_t channelIndex) const;
+
+		/// @brief Clears all of the histograms and high-water marks
+		void reset();
+
+	private:
+		LatencyHistogram receiveToDispatchLatency; ///< Time from a message's receive timestamp to dispatch, in microseconds
+		LatencyHistogram updateDuration; ///< Time taken by each network manager update, in microseconds
+		LatencyHistogram transportSessionDuration; ///< Time taken by each successful TP or ETP session, in microseconds
+		std::array<std::array<std::atomic<std::size_t>, CAN_PORT_MAXIMUM>, static_cast<std::size_t>(Queue::NumberOfQueues)> queueHighWaterMarks = {}; ///< The deepest each queue has been on each channel
+	};
+} // namespace isobus
+
+#endif // CAN_STACK_INSTRUMENTATION_HPP
@@ -0,0 +1,157 @@
+//================================================================================================
+/// @file can_traffic_statistics.hpp
+///
+/// @brief Tracks how much bus traffic each source address sends with each PGN.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+
+#ifndef CAN_TRAFFIC_STATISTICS_HPP
+#define CAN_TRAFFIC_STATISTICS_HPP
+
+#include "isobus/isobus/can_message_frame.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace isobus
+{
+	//================================================================================================
+	/// @class CANTrafficStatistics
+	///
+	/// @brief Counts frames, bytes and bits per (channel, PGN, source address)
+	/// @details Frames are counted in a fixed-size table of atomic counters, so recording a frame never
+	/// allocates or takes a lock, and frames can be recorded from any number of threads.
+	/// Rates are calculated over one second windows by `update`, which must only be called from one thread at a time.
+	/// Once the table is full, frames from new combinations are counted as untracked instead.
+	//================================================================================================
+	class CANTrafficStatistics
+	{
+	public:
+		/// @brief The traffic of one (channel, PGN, source address) combination
+		struct Entry
+		{
+			std::uint8_t channel; ///< The CAN channel the traffic was seen on
+			std::uint32_t parameterGroupNumber; ///< The PGN of the traffic
+			std::uint8_t sourceAddress; ///< The source address of the traffic
+			std::uint64_t totalFrames; ///< The number of frames since the statistics were last reset
+			std::uint64_t totalBytes; ///< The number of data bytes since the statistics were last reset
+			std::uint64_t totalBits; ///< The approximate number of bits on the bus since the statistics were last reset
+			std::uint32_t framesPerSecond; ///< The number of frames in the last complete one second window
+			std::uint32_t bytesPerSecond; ///< The number of data bytes in the last complete one second window
+			std::uint32_t bitsPerSecond; ///< The approximate number of bits on the bus in the last complete one second window
+		};
+
+		/// @brief The values that entries can be ranked by
+		enum class Metric : std::uint8_t
+		{
+			FramesPerSecond, ///< Rank by `Entry::framesPerSecond`
+			BytesPerSecond, ///< Rank by `Entry::bytesPerSecond`
+			BitsPerSecond ///< Rank by `Entry::bitsPerSecond`, which is the closest to each entry's share of the busload
+		};
+
+		/// @brief The default number of (channel, PGN, source address) combinations that can be tracked
+		static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+
+		/// @brief Constructs the statistics with a fixed capacity
+		/// @param[in] capacity The number of combinations to track, which is rounded up to the next power of two
+		explicit CANTrafficStatistics(std::size_t capacity = DEFAULT_CAPACITY);
+
+		/// @brief Deleted copy constructor
+		CANTrafficStatistics(const CANTrafficStatistics &) = delete;
+
+		/// @brief Deleted copy assignment operator
+		/// @returns Nothing, this is deleted
+		CANTrafficStatistics &operator=(const CANTrafficStatistics &) = delete;
+
+		/// @brief Turns recording on or off. Statistics are off by default.
+		/// @param[in] enabled `true` to record frames, `false` to ignore them
+		void set_enabled(bool enabled);
+
+		/// @brief Returns if frames are being recorded
+		/// @returns `true` if frames are being recorded, otherwise `false`
+		bool get_enabled() const;
+
+		/// @brief Counts a frame, if recording is enabled
+		/// @param[in] frame The frame that was received or transmitted
+		void record_frame(const CANMessageFrame &frame);
+
+		/// @brief Closes the current rate window if it has lasted at least a second
+		void update();
+
+		/// @brief Returns the time until `update` next needs to be called to close the current rate window
+		/// @returns The time until the current rate window should be closed in milliseconds, or the max value if recording is disabled
+		std::uint32_t get_time_until_next_update_ms() const;
+
+		/// @brief Returns the traffic of every combination that has been seen
+		/// @details Each entry's counters are read one at a time, so they may be slightly out of step with each other if frames are still being recorded.
+		/// @returns The traffic of every combination that has been seen, in no particular order
+		std::vector<Entry> get_snapshot() const;
+
+		/// @brief Returns the combinations that send the most traffic
+		/// @param[in] numberOfEntries The maximum number of entries to return
+		/// @param[in] metric The value to rank the entries by
+		/// @returns The busiest combinations, busiest first
+		std::vector<Entry> get_top_entries(std::size_t numberOfEntries, Metric metric = Metric::BitsPerSecond) const;
+
+		/// @brief Returns the number of frames that weren't counted because the table was full
+		/// @returns The number of untracked frames since the statistics were last reset
+		std::uint64_t get_number_untracked_frames() const;
+
+		/// @brief Clears all of the counters, but keeps tracking the combinations that have been seen
+		/// @note This must not be called at the same time as `update`
+		void reset();
+
+	private:
+		/// @brief The counters for one (channel, PGN, source address) combination
+		struct Slot
+		{
+			std::atomic<std::uint64_t> key; ///< The combination this slot counts, or `0` if the slot is free
+			std::atomic<std::uint64_t> totalFrames; ///< The number of frames counted
+			std::atomic<std::uint64_t> totalBytes; ///< The number of data bytes counted
+			std::atomic<std::uint64_t> totalBits; ///< The approximate number of bits counted
+			std::atomic<std::uint32_t> framesPerSecond; ///< The frame rate over the last complete window
+			std::atomic<std::uint32_t> bytesPerSecond; ///< The data byte rate over the last complete window
+			std::atomic<std::uint32_t> bitsPerSecond; ///< The bit rate over the last complete window
+			std::uint64_t windowStartFrames; ///< The number of frames counted when the current window started, only used by `update`
+			std::uint64_t windowStartBytes; ///< The number of data bytes counted when the current window started, only used by `update`
+			std::uint64_t windowStartBits; ///< The number of bits counted when the current window started, only used by `update`
+		};
+
+		/// @brief The length of each rate window in milliseconds
+		static constexpr std::uint32_t RATE_WINDOW_MS = 1000;
+
+		/// @brief Marks a key as used, so that channel 0, PGN 0 and address 0 don't look like a free slot
+		static constexpr std::uint64_t KEY_IN_USE_BIT = (static_cast<std::uint64_t>(1) << 63);
+
+		/// @brief Packs a (channel, PGN, source address) combination into a slot key
+		/// @param[in] channel The CAN channel
+		/// @param[in] parameterGroupNumber The PGN
+		/// @param[in] sourceAddress The source address
+		/// @returns The slot key for the combination
+		static std::uint64_t make_key(std::uint8_t channel, std::uint32_t parameterGroupNumber, std::uint8_t sourceAddress);
+
+		/// @brief Finds the slot for a key, claiming a free one if the key hasn't been seen before
+		/// @param[in] key The slot key to find
+		/// @returns The slot for the key, or `nullptr` if the table is full
+		Slot *find_or_claim_slot(std::uint64_t key);
+
+		/// @brief Reads a slot into an entry
+		/// @param[in] slot The slot to read
+		/// @param[in] key The key the slot was claimed with
+		/// @returns The slot's traffic
+		static Entry read_slot(const Slot &slot, std::uint64_t key);
+
+		std::unique_ptr<Slot[]> slots; ///< The table of counters, indexed by a hash of the key with linear probing
+		std::size_t capacityMask; ///< The number of slots minus one, used to wrap probe indices
+		std::atomic<std::uint64_t> untrackedFrames = { 0 }; ///< The number of frames that didn't fit in the table
+		std::atomic_bool recordingEnabled = { false }; ///< Stores if frames are being recorded
+		std::atomic<std::uint32_t> windowStartTimestamp_ms = { 0 }; ///< The time the current rate window started
+	};
+} // namespace isobus
+
+#endif // CAN_TRAFFIC_STATISTICS_HPP
@@ -14,6 +14,9 @@
 #include "isobus/isobus/can_badge.hpp"
 #include "isobus/isobus/can_control_function.hpp"
 #include "isobus/isobus/can_protocol.hpp"
+#include "isobus/utility/keyed_object_pool.hpp"
+
+#include <array>
 
 namespace isobus
 {
@@ -72,6 +75,8 @@ namespace isobus
 
 		private:
 			friend class TransportProtocolManager; ///< Allows the TP manager full access
+			template<typename, typename, typename>
+			friend class KeyedObjectPool; ///< Allows sessions to be created in the session pool
 
 			/// @brief The constructor for a TP session
 			/// @param[in] sessionDirection Tx or Rx
@@ -88,6 +93,9 @@ namespace isobus
 			std::uint32_t frameChunkCallbackMessageLength = 0; ///< The length of the message that is being sent in chunks
 			void *parent = nullptr; ///< A generic context variable that helps identify what object callbacks are destined for. Can be nullptr
 			std::uint32_t timestamp_ms = 0; ///< A timestamp used to track session timeouts
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+			std::uint64_t startTimestamp_us = 0; ///< The time the session was created, used to measure how long it takes to complete
+#endif
 			std::uint16_t lastPacketNumber = 0; ///< The last processed sequence number for this set of packets
 			std::uint8_t packetCount = 0; ///< The total number of packets to receive or send in this session
 			std::uint8_t processedPacketsThisSession = 0; ///< The total processed packet count for the whole session so far
@@ -125,7 +133,8 @@ namespace isobus
 		static constexpr std::uint8_t PROTOCOL_BYTES_PER_FRAME = 7; ///< The number of payload bytes per frame minus overhead of sequence number
 
 		/// @brief The constructor for the TransportProtocolManager
-		TransportProtocolManager() = default;
+		/// @param[in] networkManager The network manager that owns this protocol
+		explicit TransportProtocolManager(CANNetworkManager &networkManager);
 
 		/// @brief The destructor for the TransportProtocolManager
 		~TransportProtocolManager() final;
@@ -161,8 +170,31 @@ namespace isobus
 		                               void *parentPointer,
 		                               DataChunkCallback frameChunkCallback) override;
 
-		/// @brief Updates the protocol cyclically
-		void update(CANLibBadge<CANNetworkManager>) override;
+		/// @brief The network manager calls this to see if the protocol can send a message out of a shared buffer
+		/// @details The session reads each packet straight out of the shared buffer, so the data is not copied.
+		/// @param[in] parameterGroupNumber The PGN of the message
+		/// @param[in] data The data to be sent, which must not change until the transmit complete callback is called
+		/// @param[in] messageLength The length of the data to be sent
+		/// @param[in] source The source control function
+		/// @param[in] destination The destination control function
+		/// @param[in] transmitCompleteCallback A callback for when the protocol completes its work
+		/// @param[in] parentPointer A generic context object for the tx complete callback
+		/// @returns true if the message was accepted by the protocol for processing
+		bool protocol_transmit_shared_message(std::uint32_t parameterGroupNumber,
+		                                      std::shared_ptr<const std::uint8_t> data,
+		                                      std::uint32_t messageLength,
+		                                      std::shared_ptr<ControlFunction> source,
+		                                      std::shared_ptr<ControlFunction> destination,
+		                                      TransmitCompleteCallback transmitCompleteCallback,
+		                                      void *parentPointer) override;
+
+		/// @brief Updates the sessions on one CAN channel
+		/// @param[in] channelIndex The CAN channel to update
+		void update_channel(std::uint8_t channelIndex, CANLibBadge<CANNetworkManager>) override;
+
+		/// @brief Returns how long the protocol can go without being updated, based on the timers of its active sessions
+		/// @returns The time until the protocol next needs to be updated in milliseconds
+		std::uint32_t get_time_until_next_update_ms() const override;
 
 	private:
 		/// @brief Aborts the session with the specified abort reason. Sends a CAN message.
@@ -209,6 +241,32 @@ namespace isobus
 		/// @returns true if the EOM was sent, false if sending was not successful
 		bool send_end_of_session_acknowledgement(TransportProtocolSession *session) const;
 
+		/// @brief Creates and sets up a session to transmit a message, if the message can be sent by this protocol
+		/// @details The caller is responsible for giving the new session its data or chunk callback.
+		/// @param[in] parameterGroupNumber The PGN of the message
+		/// @param[in] messageLength The length of the data to be sent
+		/// @param[in] source The source control function
+		/// @param[in] destination The destination control function
+		/// @param[in] sessionCompleteCallback A callback for when the session completes
+		/// @param[in] parentPointer A generic context object for the tx complete and chunk callbacks
+		/// @returns The new session, or nullptr if the message can't be sent by this protocol right now
+		TransportProtocolSession *start_transmit_session(std::uint32_t parameterGroupNumber,
+		                                                 std::uint32_t messageLength,
+		                                                 std::shared_ptr<ControlFunction> source,
+		                                                 std::shared_ptr<ControlFunction> destination,
+		                                                 TransmitCompleteCallback sessionCompleteCallback,
+		                                                 void *parentPointer);
+
+		/// @brief Creates a new session in the session pool
+		/// @details Only one session can exist between a source and destination at a time.
+		/// Received sessions are limited by CANNetworkConfiguration::get_max_number_transport_protocol_sessions,
+		/// but the pool grows past that for sessions we transmit.
+		/// @param[in] sessionDirection Tx or Rx
+		/// @param[in] source The source control function for the session
+		/// @param[in] destination The destination control function for the session
+		/// @returns The new session, or nullptr if the session could not be created
+		TransportProtocolSession *create_session(TransportProtocolSession::Direction sessionDirection, std::shared_ptr<ControlFunction> source, std::shared_ptr<ControlFunction> destination);
+
 		/// @brief Sets the state machine state of the TP session
 		/// @param[in] session The session to update
 		/// @param[in] value The state to update the session to
@@ -233,7 +291,7 @@ namespace isobus
 		/// @param[in] session The session to update
 		void update_state_machine(TransportProtocolSession *session);
 
-		std::vector<TransportProtocolSession *> activeSessions; ///< A list of all active TP sessions
+		std::array<KeyedObjectPool<TransportProtocolSession, ProtocolSessionKey, ProtocolSessionKeyHash>, CAN_PORT_MAXIMUM> activeSessions; ///< All active TP sessions on each CAN channel, indexed by source and destination
 	};
 
 } // namespace isobus
@@ -16,7 +16,11 @@
 #include "isobus/utility/processing_flags.hpp"
 
 #include <list>
+
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+#include <mutex>
 #include <thread>
+#endif
 
 namespace isobus
 {
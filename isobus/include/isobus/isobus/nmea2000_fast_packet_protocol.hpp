@@ -28,6 +28,9 @@
 
 #include "isobus/isobus/can_internal_control_function.hpp"
 #include "isobus/isobus/can_protocol.hpp"
+#include "isobus/utility/keyed_object_pool.hpp"
+
+#include <array>
 
 #if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
 #include <mutex>
@@ -39,6 +42,10 @@ namespace isobus
 	class FastPacketProtocol : public CANLibProtocol
 	{
 	public:
+		/// @brief The constructor for the FastPacketProtocol
+		/// @param[in] networkManager The network manager that owns this protocol
+		explicit FastPacketProtocol(CANNetworkManager &networkManager);
+
 		/// @brief A generic way to initialize a protocol
 		/// @details The network manager will call a protocol's initialize function
 		/// when it is first updated, if it has yet to be initialized.
@@ -83,8 +90,13 @@ namespace isobus
 		                              void *parentPointer = nullptr,
 		                              DataChunkCallback frameChunkCallback = nullptr);
 
-		/// @brief This will be called by the network manager on every cyclic update of the stack
-		void update(CANLibBadge<CANNetworkManager>) override;
+		/// @brief This will be called by the network manager on every cyclic update of each CAN channel
+		/// @param[in] channelIndex The CAN channel to update
+		void update_channel(std::uint8_t channelIndex, CANLibBadge<CANNetworkManager>) override;
+
+		/// @brief Returns how long the protocol can go without being updated, based on the timers of its active sessions
+		/// @returns The time until the protocol next needs to be updated in milliseconds
+		std::uint32_t get_time_until_next_update_ms() const override;
 
 	private:
 		/// @brief An object for tracking fast packet session state
@@ -109,6 +121,8 @@ namespace isobus
 
 		private:
 			friend class FastPacketProtocol; ///< Allows the TP manager full access
+			template<typename, typename, typename>
+			friend class KeyedObjectPool; ///< Allows sessions to be created in the session pool
 
 			/// @brief The constructor for a TP session
 			/// @param[in] sessionDirection Tx or Rx
@@ -153,6 +167,18 @@ namespace isobus
 		/// @returns The new sequence number to use
 		std::uint8_t get_new_sequence_number(FastPacketProtocolSession *session);
 
+		/// @brief Creates a new session in the session pool
+		/// @details The pool starts out sized by CANNetworkConfiguration::get_max_number_transport_protocol_sessions,
+		/// and grows if more sessions are needed at the same time.
+		/// @note The caller must hold the session mutex
+		/// @param[in] sessionDirection Tx or Rx
+		/// @param[in] canPortIndex The CAN channel the session is on
+		/// @param[in] parameterGroupNumber The PGN of the session
+		/// @param[in] source The session source control function
+		/// @param[in] destination The session destination control function
+		/// @returns The new session, or nullptr if a matching session already exists
+		FastPacketProtocolSession *create_session(FastPacketProtocolSession::Direction sessionDirection, std::uint8_t canPortIndex, std::uint32_t parameterGroupNumber, std::shared_ptr<ControlFunction> source, std::shared_ptr<ControlFunction> destination);
+
 		/// @brief Returns a session that matches the parameters, if one exists
 		/// @param[in,out] returnedSession The returned session
 		/// @param[in] parameterGroupNumber The PGN
@@ -207,11 +233,11 @@ namespace isobus
 		static constexpr std::uint8_t SEQUENCE_NUMBER_BIT_OFFSET = 0x05; ///< The bit offset into the first byte of data to get the seq number
 		static constexpr std::uint8_t PROTOCOL_BYTES_PER_FRAME = 7; ///< The number of payload bytes per frame for all but the first message, which has 6
 
-		std::vector<FastPacketProtocolSession *> activeSessions; ///< A list of all active TP sessions
-		std::vector<FastPacketHistory> sessionHistory; ///< Used to keep track of sequence numbers for future sessions
+		std::array<KeyedObjectPool<FastPacketProtocolSession, ProtocolSessionKey, ProtocolSessionKeyHash>, CAN_PORT_MAXIMUM> activeSessions; ///< All active FP sessions on each CAN channel, indexed by source, destination and PGN
+		std::array<std::vector<FastPacketHistory>, CAN_PORT_MAXIMUM> sessionHistory; ///< Used to keep track of sequence numbers for future sessions on each CAN channel
 		std::vector<ParameterGroupNumberCallbackData> parameterGroupNumberCallbacks; ///< A list of all parameter group number callbacks that will be parsed as fast packet messages
 #if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		std::mutex sessionMutex; ///< A mutex to lock the sessions list in case someone starts a Tx while the stack is processing sessions
+		mutable std::array<std::mutex, CAN_PORT_MAXIMUM> sessionMutexes; ///< Locks each channel's sessions in case someone starts a Tx while the stack is processing them
 #endif
 	};
 
@@ -18,7 +18,8 @@
 
 namespace isobus
 {
-	AddressClaimStateMachine::AddressClaimStateMachine(std::uint8_t preferredAddressValue, NAME ControlFunctionNAME, std::uint8_t portIndex) :
+	AddressClaimStateMachine::AddressClaimStateMachine(std::uint8_t preferredAddressValue, NAME ControlFunctionNAME, std::uint8_t portIndex, CANNetworkManager &networkManager) :
+	  m_networkManager(networkManager),
 	  m_isoname(ControlFunctionNAME),
 	  m_portIndex(portIndex),
 	  m_preferredAddress(preferredAddressValue)
@@ -29,14 +30,14 @@ namespace isobus
 		std::default_random_engine generator;
 		std::uniform_int_distribution<unsigned int> distribution(0, 255);
 		m_randomClaimDelay_ms = distribution(generator) * 0.6f; // Defined by ISO part 5
-		CANNetworkManager::CANNetwork.add_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ParameterGroupNumberRequest), process_rx_message, this);
-		CANNetworkManager::CANNetwork.add_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::AddressClaim), process_rx_message, this);
+		m_networkManager.add_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ParameterGroupNumberRequest), process_rx_message, this);
+		m_networkManager.add_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::AddressClaim), process_rx_message, this);
 	}
 
 	AddressClaimStateMachine ::~AddressClaimStateMachine()
 	{
-		CANNetworkManager::CANNetwork.remove_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ParameterGroupNumberRequest), process_rx_message, this);
-		CANNetworkManager::CANNetwork.remove_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::AddressClaim), process_rx_message, this);
+		m_networkManager.remove_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ParameterGroupNumberRequest), process_rx_message, this);
+		m_networkManager.remove_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::AddressClaim), process_rx_message, this);
 	}
 
 	AddressClaimStateMachine::State AddressClaimStateMachine::get_current_state() const
@@ -65,7 +66,7 @@ namespace isobus
 			}
 			else
 			{
-				std::shared_ptr<ControlFunction> deviceAtOurPreferredAddress = CANNetworkManager::CANNetwork.get_control_function(m_portIndex, commandedAddress, {});
+				std::shared_ptr<ControlFunction> deviceAtOurPreferredAddress = m_networkManager.get_control_function(m_portIndex, commandedAddress, {});
 				m_preferredAddress = commandedAddress;
 
 				if (nullptr == deviceAtOurPreferredAddress)
@@ -103,6 +104,52 @@ namespace isobus
 		return m_claimedAddress;
 	}
 
+	std::uint32_t AddressClaimStateMachine::get_time_until_next_update_ms() const
+	{
+		std::uint32_t retVal = 0;
+
+		if (get_enabled())
+		{
+			switch (get_current_state())
+			{
+				case State::WaitForClaim:
+				{
+					if (0 != m_timestamp_ms)
+					{
+						retVal = SystemTiming::get_time_remaining_ms(m_timestamp_ms, m_randomClaimDelay_ms);
+					}
+				}
+				break;
+
+				case State::WaitForRequestContentionPeriod:
+				{
+					retVal = SystemTiming::get_time_remaining_ms(m_timestamp_ms, ADDRESS_CONTENTION_TIME_MS + m_randomClaimDelay_ms);
+				}
+				break;
+
+				case State::ContendForPreferredAddress:
+				case State::UnableToClaim:
+				case State::AddressClaimingComplete:
+				{
+					// Nothing happens in these states until a message is received
+					retVal = std::numeric_limits<std::uint32_t>::max();
+				}
+				break;
+
+				default:
+				{
+					// Something needs to be sent, so update again as soon as possible
+				}
+				break;
+			}
+		}
+		else
+		{
+			retVal = std::numeric_limits<std::uint32_t>::max();
+		}
+		return retVal;
+	}
+
 	void AddressClaimStateMachine::update()
 	{
 		if (get_enabled())
@@ -139,11 +186,9 @@ namespace isobus
 
 				case State::WaitForRequestContentionPeriod:
 				{
-					const std::uint32_t addressContentionTime_ms = 250;
-
-					if (SystemTiming::time_expired_ms(m_timestamp_ms, addressContentionTime_ms + m_randomClaimDelay_ms))
+					if (SystemTiming::time_expired_ms(m_timestamp_ms, ADDRESS_CONTENTION_TIME_MS + m_randomClaimDelay_ms))
 					{
-						std::shared_ptr<ControlFunction> deviceAtOurPreferredAddress = CANNetworkManager::CANNetwork.get_control_function(m_portIndex, m_preferredAddress, {});
+						std::shared_ptr<ControlFunction> deviceAtOurPreferredAddress = m_networkManager.get_control_function(m_portIndex, m_preferredAddress, {});
 						// Time to find a free address
 						if (nullptr == deviceAtOurPreferredAddress)
 						{
@@ -201,7 +246,7 @@ namespace isobus
 
 					for (std::uint8_t i = 128; i <= 247; i++)
 					{
-						if ((nullptr == CANNetworkManager::CANNetwork.get_control_function(m_portIndex, i, {})) && (send_address_claim(i)))
+						if ((nullptr == m_networkManager.get_control_function(m_portIndex, i, {})) && (send_address_claim(i)))
 						{
 							addressFound = true;
 							CANStackLogger::debug("[AC]: Internal control function %016llx could not use the preferred address, but has claimed address %u on channel %u",
@@ -337,14 +382,14 @@ namespace isobus
 			dataBuffer[1] = ((PGN >> 8) & std::numeric_limits<std::uint8_t>::max());
 			dataBuffer[2] = ((PGN >> 16) & std::numeric_limits<std::uint8_t>::max());
 
-			retVal = CANNetworkManager::CANNetwork.send_can_message_raw(m_portIndex,
-			                                                            NULL_CAN_ADDRESS,
-			                                                            BROADCAST_CAN_ADDRESS,
-			                                                            static_cast<std::uint32_t>(CANLibParameterGroupNumber::ParameterGroupNumberRequest),
-			                                                            static_cast<std::uint8_t>(CANIdentifier::CANPriority::PriorityDefault6),
-			                                                            dataBuffer,
-			                                                            3,
-			                                                            {});
+			retVal = m_networkManager.send_can_message_raw(m_portIndex,
+			                                               NULL_CAN_ADDRESS,
+			                                               BROADCAST_CAN_ADDRESS,
+			                                               static_cast<std::uint32_t>(CANLibParameterGroupNumber::ParameterGroupNumberRequest),
+			                                               static_cast<std::uint8_t>(CANIdentifier::CANPriority::PriorityDefault6),
+			                                               dataBuffer,
+			                                               3,
+			                                               {});
 		}
 		return retVal;
 	}
@@ -368,14 +413,14 @@ namespace isobus
 			dataBuffer[5] = static_cast<uint8_t>(isoNAME >> 40);
 			dataBuffer[6] = static_cast<uint8_t>(isoNAME >> 48);
 			dataBuffer[7] = static_cast<uint8_t>(isoNAME >> 56);
-			retVal = CANNetworkManager::CANNetwork.send_can_message_raw(m_portIndex,
-			                                                            address,
-			                                                            BROADCAST_CAN_ADDRESS,
-			                                                            static_cast<std::uint32_t>(CANLibParameterGroupNumber::AddressClaim),
-			                                                            static_cast<std::uint8_t>(CANIdentifier::CANPriority::PriorityDefault6),
-			                                                            dataBuffer,
-			                                                            CAN_DATA_LENGTH,
-			                                                            {});
+			retVal = m_networkManager.send_can_message_raw(m_portIndex,
+			                                               address,
+			                                               BROADCAST_CAN_ADDRESS,
+			                                               static_cast<std::uint32_t>(CANLibParameterGroupNumber::AddressClaim),
+			                                               static_cast<std::uint8_t>(CANIdentifier::CANPriority::PriorityDefault6),
+			                                               dataBuffer,
+			                                               CAN_DATA_LENGTH,
+			                                               {});
 			if (retVal)
 			{
 				m_claimedAddress = address;
@@ -7,14 +7,19 @@
 /// @copyright 2022 Adrian Del Grosso
 //================================================================================================
 #include "isobus/isobus/can_callbacks.hpp"
+#include "isobus/isobus/can_stack_logger.hpp"
+#include "isobus/utility/callback_executor.hpp"
+
+#include <algorithm>
 
 namespace isobus
 {
-	ParameterGroupNumberCallbackData::ParameterGroupNumberCallbackData(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parentPointer, std::shared_ptr<InternalControlFunction> internalControlFunction) :
+	ParameterGroupNumberCallbackData::ParameterGroupNumberCallbackData(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parentPointer, std::shared_ptr<InternalControlFunction> internalControlFunction, CallbackExecutor *executor) :
 	  mCallback(callback),
 	  mParameterGroupNumber(parameterGroupNumber),
 	  mParent(parentPointer),
-	  mInternalControlFunctionFilter(internalControlFunction)
+	  mInternalControlFunctionFilter(internalControlFunction),
+	  mExecutor(executor)
 	{
 	}
 
@@ -22,7 +27,8 @@ namespace isobus
 	  mCallback(oldObj.mCallback),
 	  mParameterGroupNumber(oldObj.mParameterGroupNumber),
 	  mParent(oldObj.mParent),
-	  mInternalControlFunctionFilter(oldObj.mInternalControlFunctionFilter)
+	  mInternalControlFunctionFilter(oldObj.mInternalControlFunctionFilter),
+	  mExecutor(oldObj.mExecutor)
 	{
 	}
 
@@ -40,6 +46,7 @@ namespace isobus
 		mParameterGroupNumber = obj.mParameterGroupNumber;
 		mParent = obj.mParent;
 		mInternalControlFunctionFilter = obj.mInternalControlFunctionFilter;
+		mExecutor = obj.mExecutor;
 		return *this;
 	}
 
@@ -62,4 +69,93 @@ namespace isobus
 	{
 		return mInternalControlFunctionFilter;
 	}
+
+	CallbackExecutor *ParameterGroupNumberCallbackData::get_executor() const
+	{
+		return mExecutor;
+	}
+
+	bool ParameterGroupNumberCallbackData::invoke(const CANMessage &message) const
+	{
+		bool retVal = true;
+
+		if (nullptr == mExecutor)
+		{
+			// The callback may change the table this is in, so this object mustn't be used once it returns
+			mCallback(message, mParent);
+		}
+		else
+		{
+			CANLibCallback callback = mCallback;
+			void *parent = mParent;
+
+			retVal = mExecutor->post(parent, [callback, parent, message]() { callback(message, parent); });
+
+			if (!retVal)
+			{
+				CANStackLogger::warn("[NM]: Callback executor is full, dropping PGN %u for a callback", mParameterGroupNumber);
+			}
+		}
+		return retVal;
+	}
+
+	void ParameterGroupNumberCallbackTable::add(const ParameterGroupNumberCallbackData &callback)
+	{
+		callbacks.push_back(callback);
+		rebuild_index();
+	}
+
+	bool ParameterGroupNumberCallbackTable::remove(const ParameterGroupNumberCallbackData &callback)
+	{
+		bool retVal = false;
+		auto callbackLocation = std::find(callbacks.begin(), callbacks.end(), callback);
+
+		if (callbacks.end() != callbackLocation)
+		{
+			callbacks.erase(callbackLocation);
+			rebuild_index();
+			retVal = true;
+		}
+		return retVal;
+	}
+
+	bool ParameterGroupNumberCallbackTable::contains(const ParameterGroupNumberCallbackData &callback) const
+	{
+		return callbacks.end() != std::find(callbacks.begin(), callbacks.end(), callback);
+	}
+
+	std::size_t ParameterGroupNumberCallbackTable::size() const
+	{
+		return callbacks.size();
+	}
+
+	ParameterGroupNumberCallbackData &ParameterGroupNumberCallbackTable::operator[](std::size_t index)
+	{
+		return callbacks[index];
+	}
+
+	const ParameterGroupNumberCallbackData &ParameterGroupNumberCallbackTable::operator[](std::size_t index) const
+	{
+		return callbacks[index];
+	}
+
+	void ParameterGroupNumberCallbackTable::rebuild_index()
+	{
+		callbacksByParameterGroupNumber = callbacks;
+		std::stable_sort(callbacksByParameterGroupNumber.begin(), callbacksByParameterGroupNumber.end(), [](const ParameterGroupNumberCallbackData &lhs, const ParameterGroupNumberCallbackData &rhs) {
+			return lhs.get_parameter_group_number() < rhs.get_parameter_group_number();
+		});
+
+		parameterGroupNumberRanges.clear();
+		for (std::size_t i = 0; i < callbacksByParameterGroupNumber.size(); i++)
+		{
+			auto &range = parameterGroupNumberRanges[callbacksByParameterGroupNumber[i].get_parameter_group_number()];
+
+			if (range.first == range.second)
+			{
+				range.first = i;
+			}
+			range.second = i + 1;
+		}
+	}
 } // namespace isobus
@@ -17,11 +17,13 @@
 
 namespace isobus
 {
-#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-	std::mutex ControlFunction::controlFunctionProcessingMutex;
-#endif
-
 	isobus::ControlFunction::ControlFunction(NAME NAMEValue, std::uint8_t addressValue, std::uint8_t CANPort, Type type) :
+	  ControlFunction(NAMEValue, addressValue, CANPort, CANNetworkManager::CANNetwork, type)
+	{
+	}
+
+	isobus::ControlFunction::ControlFunction(NAME NAMEValue, std::uint8_t addressValue, std::uint8_t CANPort, CANNetworkManager &networkManager, Type type) :
+	  networkManager(networkManager),
 	  controlFunctionType(type),
 	  controlFunctionNAME(NAMEValue),
 	  address(addressValue),
@@ -30,20 +32,21 @@ namespace isobus
 	}
 
 	std::shared_ptr<ControlFunction> ControlFunction::create(NAME NAMEValue, std::uint8_t addressValue, std::uint8_t CANPort)
+	{
+		return create(NAMEValue, addressValue, CANPort, CANNetworkManager::CANNetwork);
+	}
+
+	std::shared_ptr<ControlFunction> ControlFunction::create(NAME NAMEValue, std::uint8_t addressValue, std::uint8_t CANPort, CANNetworkManager &networkManager)
 	{
 		// Unfortunately, we can't use `std::make_shared` here because the constructor is private
-		auto controlFunction = std::shared_ptr<ControlFunction>(new ControlFunction(NAMEValue, addressValue, CANPort));
-		CANNetworkManager::CANNetwork.on_control_function_created(controlFunction, CANLibBadge<ControlFunction>());
+		auto controlFunction = std::shared_ptr<ControlFunction>(new ControlFunction(NAMEValue, addressValue, CANPort, networkManager));
+		networkManager.on_control_function_created(controlFunction, CANLibBadge<ControlFunction>());
 		return controlFunction;
 	}
 
 	bool ControlFunction::destroy(std::uint32_t expectedRefCount)
 	{
-#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		std::lock_guard<std::mutex> lock(controlFunctionProcessingMutex);
-#endif
-
-		CANNetworkManager::CANNetwork.on_control_function_destroyed(shared_from_this(), {});
+		networkManager.on_control_function_destroyed(shared_from_this(), {});
 
 		return static_cast<std::uint32_t>(shared_from_this().use_count()) == expectedRefCount + 1;
 	}
@@ -88,4 +91,9 @@ namespace isobus
 		}
 	}
 
+	CANNetworkManager &ControlFunction::get_network_manager() const
+	{
+		return networkManager;
+	}
+
 } // namespace isobus
@@ -17,6 +17,9 @@
 #include "isobus/utility/to_string.hpp"
 
 #include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
 
 namespace isobus
 {
@@ -24,6 +27,9 @@ namespace isobus
 	  sessionMessage(canPortIndex),
 	  sessionDirection(sessionDirection)
 	{
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+		startTimestamp_us = SystemTiming::get_timestamp_us();
+#endif
 	}
 
 	bool ExtendedTransportProtocolManager::ExtendedTransportProtocolSession::operator==(const ExtendedTransportProtocolSession &obj)
@@ -46,7 +52,8 @@ namespace isobus
 	{
 	}
 
-	ExtendedTransportProtocolManager::ExtendedTransportProtocolManager()
+	ExtendedTransportProtocolManager::ExtendedTransportProtocolManager(CANNetworkManager &networkManager) :
+	  CANLibProtocol(networkManager)
 	{
 	}
 
@@ -61,14 +68,14 @@ namespace isobus
 		if (!initialized)
 		{
 			initialized = true;
-			CANNetworkManager::CANNetwork.add_protocol_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolDataTransfer), process_message, this);
-			CANNetworkManager::CANNetwork.add_protocol_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolConnectionManagement), process_message, this);
+			networkManager.add_protocol_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolDataTransfer), process_message, this);
+			networkManager.add_protocol_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolConnectionManagement), process_message, this);
 		}
 	}
 
 	void ExtendedTransportProtocolManager::process_message(const CANMessage &message)
 	{
-		if ((nullptr != CANNetworkManager::CANNetwork.get_internal_control_function(message.get_destination_control_function())))
+		if ((nullptr != networkManager.get_internal_control_function(message.get_destination_control_function())))
 		{
 			switch (message.get_identifier().get_parameter_group_number())
 			{
@@ -84,22 +91,25 @@ namespace isobus
 						{
 							case EXTENDED_REQUEST_TO_SEND_MULTIPLEXOR:
 							{
+								ExtendedTransportProtocolSession *newSession = nullptr;
+
 								if ((nullptr != message.get_destination_control_function()) &&
-								    (activeSessions.size() < CANNetworkManager::CANNetwork.get_configuration().get_max_number_transport_protocol_sessions()) &&
-								    (!get_session(session, message.get_source_control_function(), message.get_destination_control_function(), pgn)))
+								    (!get_session(session, message.get_source_control_function(), message.get_destination_control_function())))
+								{
+									newSession = create_session(ExtendedTransportProtocolSession::Direction::Receive, message.get_source_control_function(), message.get_destination_control_function());
+								}
+
+								if (nullptr != newSession)
 								{
-									ExtendedTransportProtocolSession *newSession = new ExtendedTransportProtocolSession(ExtendedTransportProtocolSession::Direction::Receive, message.get_can_port_index());
 									CANIdentifier tempIdentifierData(CANIdentifier::Type::Extended, pgn, CANIdentifier::CANPriority::PriorityLowest7, message.get_destination_control_function()->get_address(), message.get_source_control_function()->get_address());
 									newSession->sessionMessage.set_data_size(static_cast<std::uint32_t>(data[1]) | static_cast<std::uint32_t>(data[2] << 8) | static_cast<std::uint32_t>(data[3] << 16) | static_cast<std::uint32_t>(data[4] << 24));
-									newSession->sessionMessage.set_source_control_function(message.get_source_control_function());
-									newSession->sessionMessage.set_destination_control_function(message.get_destination_control_function());
 									newSession->packetCount = 0xFF;
 									newSession->sessionMessage.set_identifier(tempIdentifierData);
 									newSession->state = StateMachineState::ClearToSend;
-									newSession->timestamp_ms = SystemTiming::get_timestamp_ms();
-									activeSessions.push_back(newSession);
+									newSession->sessionMessage.set_timestamp_us(message.get_timestamp_us());
+									newSession->timestamp_ms = message.get_timestamp_ms();
 								}
-								else if ((get_session(session, message.get_source_control_function(), message.get_destination_control_function(), pgn)) &&
+								else if ((get_session(session, message.get_source_control_function(), message.get_destination_control_function())) &&
 								         (nullptr != message.get_destination_control_function()) &&
 								         (ControlFunction::Type::Internal == message.get_destination_control_function()->get_type()))
 								{
@@ -107,7 +117,7 @@ namespace isobus
 									CANStackLogger::CAN_stack_log(CANStackLogger::LoggingLevel::Error, "[ETP]: Sent abort to address " + isobus::to_string(static_cast<int>(message.get_source_control_function()->get_address())) + " RTS when already in session");
 									close_session(session, false);
 								}
-								else if ((activeSessions.size() >= CANNetworkManager::CANNetwork.get_configuration().get_max_number_transport_protocol_sessions()) &&
+								else if ((activeSessions[message.get_can_port_index()].size() >= networkManager.get_configuration().get_max_number_transport_protocol_sessions()) &&
 								         (nullptr != message.get_destination_control_function()) &&
 								         (ControlFunction::Type::Internal == message.get_destination_control_function()->get_type()))
 								{
@@ -128,11 +138,11 @@ namespace isobus
 									{
 										session->packetCount = packetsToBeSent;
 
-										if (session->packetCount > CANNetworkManager::CANNetwork.get_configuration().get_max_number_of_etp_frames_per_edpo())
+										if (session->packetCount > networkManager.get_configuration().get_max_number_of_etp_frames_per_edpo())
 										{
-											session->packetCount = CANNetworkManager::CANNetwork.get_configuration().get_max_number_of_etp_frames_per_edpo();
+											session->packetCount = networkManager.get_configuration().get_max_number_of_etp_frames_per_edpo();
 										}
-										session->timestamp_ms = SystemTiming::get_timestamp_ms();
+										session->timestamp_ms = message.get_timestamp_ms();
 										// If 0 was sent as the packet number, they want us to wait.
 										// Just sit here in this state until we get a non-zero packet count
 										if (0 != packetsToBeSent)
@@ -201,23 +211,15 @@ namespace isobus
 								}
 								else
 								{
-									bool anySessionMatched = false;
 									// Do we have any session that matches except for PGN?
-									for (auto currentSession : activeSessions)
+									if (get_session(session, message.get_source_control_function(), message.get_destination_control_function()))
 									{
-										if ((currentSession->sessionMessage.get_source_control_function() == message.get_source_control_function()) &&
-										    (currentSession->sessionMessage.get_destination_control_function() == message.get_destination_control_function()))
-										{
-											// Sending EDPO for this session with mismatched PGN is not allowed
-											CANStackLogger::CAN_stack_log(CANStackLogger::LoggingLevel::Error, "[ETP]: Sent abort to address " + isobus::to_string(static_cast<int>(message.get_source_control_function()->get_address())) + " EDPO for this session with mismatched PGN is not allowed");
-											abort_session(currentSession, ConnectionAbortReason::UnexpectedEDPOPgn);
-											close_session(session, false);
-											anySessionMatched = true;
-											break;
-										}
+										// Sending EDPO for this session with mismatched PGN is not allowed
+										CANStackLogger::CAN_stack_log(CANStackLogger::LoggingLevel::Error, "[ETP]: Sent abort to address " + isobus::to_string(static_cast<int>(message.get_source_control_function()->get_address())) + " EDPO for this session with mismatched PGN is not allowed");
+										abort_session(session, ConnectionAbortReason::UnexpectedEDPOPgn);
+										close_session(session, false);
 									}
-
-									if (!anySessionMatched)
+									else
 									{
 										abort_session(pgn, ConnectionAbortReason::UnexpectedEDPOPacket, std::static_pointer_cast<InternalControlFunction>(message.get_destination_control_function()), message.get_source_control_function());
 									}
@@ -295,24 +297,22 @@ namespace isobus
 					    (StateMachineState::RxDataSession == tempSession->state) &&
 					    (messageData[SEQUENCE_NUMBER_DATA_INDEX] == (tempSession->lastPacketNumber + 1)))
 					{
-						for (std::uint8_t i = SEQUENCE_NUMBER_DATA_INDEX; (i < PROTOCOL_BYTES_PER_FRAME) && (((PROTOCOL_BYTES_PER_FRAME * tempSession->processedPacketsThisSession) + i) < tempSession->get_message_data_length()); i++)
-						{
-							std::uint32_t currentDataIndex = (PROTOCOL_BYTES_PER_FRAME * tempSession->processedPacketsThisSession) + i;
-							tempSession->sessionMessage.set_data(messageData[1 + SEQUENCE_NUMBER_DATA_INDEX + i], currentDataIndex);
-						}
+						// Copy the whole payload at once, the message drops any padding past the end of the data
+						tempSession->sessionMessage.set_data(messageData.data() + 1 + SEQUENCE_NUMBER_DATA_INDEX, PROTOCOL_BYTES_PER_FRAME, PROTOCOL_BYTES_PER_FRAME * tempSession->processedPacketsThisSession);
 						tempSession->lastPacketNumber++;
 						tempSession->processedPacketsThisSession++;
+						tempSession->sessionMessage.set_timestamp_us(message.get_timestamp_us());
+						tempSession->timestamp_ms = message.get_timestamp_ms();
 						if ((tempSession->processedPacketsThisSession * PROTOCOL_BYTES_PER_FRAME) >= tempSession->get_message_data_length())
 						{
 							if (nullptr != tempSession->sessionMessage.get_destination_control_function())
 							{
 								send_end_of_session_acknowledgement(tempSession);
 							}
-							CANNetworkManager::CANNetwork.process_any_control_function_pgn_callbacks(tempSession->sessionMessage);
-							CANNetworkManager::CANNetwork.protocol_message_callback(tempSession->sessionMessage);
+							networkManager.process_any_control_function_pgn_callbacks(tempSession->sessionMessage);
+							networkManager.protocol_message_callback(tempSession->sessionMessage);
 							close_session(tempSession, true);
 						}
-						tempSession->timestamp_ms = SystemTiming::get_timestamp_ms();
 					}
 					else
 					{
@@ -341,65 +341,119 @@ namespace isobus
 	                                                                 void *parentPointer,
 	                                                                 DataChunkCallback frameChunkCallback)
 	{
-		ExtendedTransportProtocolSession *session;
 		bool retVal = false;
 
-		if ((messageLength < MAX_PROTOCOL_DATA_LENGTH) &&
-		    (messageLength >= MIN_PROTOCOL_DATA_LENGTH) &&
-		    (nullptr != destination) &&
-		    ((nullptr != dataBuffer) ||
-		     (nullptr != frameChunkCallback)) &&
-		    (nullptr != source) &&
-		    (true == source->get_address_valid()) &&
-		    (destination->get_address_valid()) &&
-		    (!get_session(session, source, destination, parameterGroupNumber)))
+		if ((nullptr != dataBuffer) ||
+		    (nullptr != frameChunkCallback))
 		{
-			ExtendedTransportProtocolSession *newSession = new ExtendedTransportProtocolSession(ExtendedTransportProtocolSession::Direction::Transmit,
-			                                                                                    source->get_can_port());
+			ExtendedTransportProtocolSession *newSession = start_transmit_session(parameterGroupNumber, messageLength, source, destination, sessionCompleteCallback, parentPointer);
 
-			if (dataBuffer != nullptr)
+			if (nullptr != newSession)
 			{
-				newSession->sessionMessage.set_data(dataBuffer, messageLength);
-			}
-			else
-			{
-				newSession->frameChunkCallback = frameChunkCallback;
-				newSession->frameChunkCallbackMessageLength = messageLength;
+				if (nullptr != dataBuffer)
+				{
+					newSession->sessionMessage.set_data(dataBuffer, messageLength);
+				}
+				else
+				{
+					newSession->frameChunkCallback = frameChunkCallback;
+					newSession->frameChunkCallbackMessageLength = messageLength;
+				}
+				retVal = true;
 			}
-			newSession->sessionMessage.set_source_control_function(source);
-			newSession->sessionMessage.set_destination_control_function(destination);
-			newSession->packetCount = (messageLength / PROTOCOL_BYTES_PER_FRAME);
-			newSession->lastPacketNumber = 0;
-			newSession->processedPacketsThisSession = 0;
-			newSession->sessionCompleteCallback = sessionCompleteCallback;
-			newSession->parent = parentPointer;
-			if (0 != (messageLength % PROTOCOL_BYTES_PER_FRAME))
+		}
+		return retVal;
+	}
+
+	bool ExtendedTransportProtocolManager::protocol_transmit_shared_message(std::uint32_t parameterGroupNumber,
+	                                                                        std::shared_ptr<const std::uint8_t> dataBuffer,
+	                                                                        std::uint32_t messageLength,
+	                                                                        std::shared_ptr<ControlFunction> source,
+	                                                                        std::shared_ptr<ControlFunction> destination,
+	                                                                        TransmitCompleteCallback sessionCompleteCallback,
+	                                                                        void *parentPointer)
+	{
+		bool retVal = false;
+
+		if (nullptr != dataBuffer)
+		{
+			ExtendedTransportProtocolSession *newSession = start_transmit_session(parameterGroupNumber, messageLength, source, destination, sessionCompleteCallback, parentPointer);
+
+			if (nullptr != newSession)
 			{
-				newSession->packetCount++;
+				// Packets are read straight out of the shared buffer, which the session keeps alive until it closes
+				newSession->sessionMessage.set_shared_data(std::move(dataBuffer), messageLength);
+				retVal = true;
 			}
-			CANIdentifier messageVirtualID(CANIdentifier::Type::Extended,
-			                               parameterGroupNumber,
-			                               CANIdentifier::CANPriority::PriorityDefault6,
-			                               destination->get_address(),
-			                               source->get_address());
-
-			newSession->sessionMessage.set_identifier(messageVirtualID);
-			set_state(newSession, StateMachineState::RequestToSend);
-			activeSessions.push_back(newSession);
-			CANStackLogger::CAN_stack_log(CANStackLogger::LoggingLevel::Debug, "[ETP]: New ETP Session. Dest: " + isobus::to_string(static_cast<int>(destination->get_address())));
-			retVal = true;
 		}
 		return retVal;
 	}
 
-	void ExtendedTransportProtocolManager::update(CANLibBadge<CANNetworkManager>)
+	void ExtendedTransportProtocolManager::update_channel(std::uint8_t channelIndex, CANLibBadge<CANNetworkManager>)
 	{
-		for (auto i : activeSessions)
+		if (channelIndex < CAN_PORT_MAXIMUM)
 		{
-			update_state_machine(i);
+			// Sessions can close while they are updated, which the pool allows during iteration
+			activeSessions[channelIndex].for_each([this](ExtendedTransportProtocolSession *session) {
+				update_state_machine(session);
+			});
 		}
 	}
 
+	std::uint32_t ExtendedTransportProtocolManager::get_time_until_next_update_ms() const
+	{
+		std::uint32_t retVal = std::numeric_limits<std::uint32_t>::max();
+
+		for (std::uint8_t i = 0; i < CAN_PORT_MAXIMUM; i++)
+		{
+			const bool transmitBlocked = networkManager.get_is_transmit_blocked(i);
+
+			activeSessions[i].for_each([transmitBlocked, &retVal](const ExtendedTransportProtocolSession *session) {
+				std::uint32_t sessionTime_ms = 0;
+
+				switch (session->state)
+				{
+					case StateMachineState::None:
+					{
+						sessionTime_ms = std::numeric_limits<std::uint32_t>::max();
+					}
+					break;
+
+					case StateMachineState::WaitForEndOfMessageAcknowledge:
+					case StateMachineState::WaitForExtendedDataPacketOffset:
+					case StateMachineState::WaitForClearToSend:
+					{
+						sessionTime_ms = SystemTiming::get_time_remaining_ms(session->timestamp_ms, T2_3_TIMEOUT_MS);
+					}
+					break;
+
+					case StateMachineState::RxDataSession:
+					{
+						if (session->packetCount != session->lastPacketNumber)
+						{
+							sessionTime_ms = SystemTiming::get_time_remaining_ms(session->timestamp_ms, T1_TIMEOUT_MS);
+						}
+					}
+					break;
+
+					default:
+					{
+						// Something needs to be sent, so update again as soon as possible
+					}
+					break;
+				}
+
+				if ((0 == sessionTime_ms) && (transmitBlocked))
+				{
+					// Sending can't make progress until the channel reports it has Tx space again, which requests an update
+					sessionTime_ms = std::numeric_limits<std::uint32_t>::max();
+				}
+				retVal = std::min(retVal, sessionTime_ms);
+			});
+		}
+		return retVal;
+	}
+
 	bool ExtendedTransportProtocolManager::abort_session(ExtendedTransportProtocolSession *session, ConnectionAbortReason reason)
 	{
 		bool retVal = false;
@@ -413,12 +467,12 @@ namespace isobus
 
 			if (ExtendedTransportProtocolSession::Direction::Transmit == session->sessionDirection)
 			{
-				myControlFunction = CANNetworkManager::CANNetwork.get_internal_control_function(session->sessionMessage.get_source_control_function());
+				myControlFunction = networkManager.get_internal_control_function(session->sessionMessage.get_source_control_function());
 				partnerControlFunction = session->sessionMessage.get_destination_control_function();
 			}
 			else
 			{
-				myControlFunction = CANNetworkManager::CANNetwork.get_internal_control_function(session->sessionMessage.get_destination_control_function());
+				myControlFunction = networkManager.get_internal_control_function(session->sessionMessage.get_destination_control_function());
 				partnerControlFunction = session->sessionMessage.get_source_control_function();
 			}
 
@@ -430,12 +484,12 @@ namespace isobus
 			data[5] = static_cast<std::uint8_t>(pgn & 0xFF);
 			data[6] = static_cast<std::uint8_t>((pgn >> 8) & 0xFF);
 			data[7] = static_cast<std::uint8_t>((pgn >> 16) & 0xFF);
-			retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolConnectionManagement),
-			                                                        data.data(),
-			                                                        CAN_DATA_LENGTH,
-			                                                        myControlFunction,
-			                                                        partnerControlFunction,
-			                                                        CANIdentifier::CANPriority::PriorityLowest7);
+			retVal = networkManager.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolConnectionManagement),
+			                                         data.data(),
+			                                         CAN_DATA_LENGTH,
+			                                         myControlFunction,
+			                                         partnerControlFunction,
+			                                         CANIdentifier::CANPriority::PriorityLowest7);
 		}
 		return retVal;
 	}
@@ -452,24 +506,27 @@ namespace isobus
 		data[5] = static_cast<std::uint8_t>(parameterGroupNumber & 0xFF);
 		data[6] = static_cast<std::uint8_t>((parameterGroupNumber >> 8) & 0xFF);
 		data[7] = static_cast<std::uint8_t>((parameterGroupNumber >> 16) & 0xFF);
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolConnectionManagement),
-		                                                      data.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      source,
-		                                                      destination,
-		                                                      CANIdentifier::CANPriority::PriorityLowest7);
+		return networkManager.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolConnectionManagement),
+		                                       data.data(),
+		                                       CAN_DATA_LENGTH,
+		                                       source,
+		                                       destination,
+		                                       CANIdentifier::CANPriority::PriorityLowest7);
 	}
 
 	void ExtendedTransportProtocolManager::close_session(ExtendedTransportProtocolSession *session, bool successfull)
 	{
 		if (nullptr != session)
 		{
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+			if (successfull)
+			{
+				networkManager.get_instrumentation().get_transport_session_duration().record(SystemTiming::get_timestamp_us() - session->startTimestamp_us);
+			}
+#endif
 			process_session_complete_callback(session, successfull);
-			auto sessionLocation = std::find(activeSessions.begin(), activeSessions.end(), session);
-			if (activeSessions.end() != sessionLocation)
+			if (activeSessions[session->sessionMessage.get_can_port_index()].destroy(session))
 			{
-				activeSessions.erase(sessionLocation);
-				delete session;
 				CANStackLogger::CAN_stack_log(CANStackLogger::LoggingLevel::Debug, "[ETP]: Session Closed");
 			}
 		}
@@ -479,14 +536,9 @@ namespace isobus
 	{
 		session = nullptr;
 
-		for (auto i : activeSessions)
+		if ((nullptr != source) && (source->get_can_port() < CAN_PORT_MAXIMUM))
 		{
-			if ((i->sessionMessage.get_source_control_function() == source) &&
-			    (i->sessionMessage.get_destination_control_function() == destination))
-			{
-				session = i;
-				break;
-			}
+			session = activeSessions[source->get_can_port()].find(ProtocolSessionKey(source, destination));
 		}
 		return (nullptr != session);
 	}
@@ -535,12 +587,12 @@ namespace isobus
 				                                                 static_cast<std::uint8_t>(session->sessionMessage.get_identifier().get_parameter_group_number() & 0xFF),
 				                                                 static_cast<std::uint8_t>((session->sessionMessage.get_identifier().get_parameter_group_number() >> 8) & 0xFF),
 				                                                 static_cast<std::uint8_t>((session->sessionMessage.get_identifier().get_parameter_group_number() >> 16) & 0xFF) };
-			retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolConnectionManagement),
-			                                                        dataBuffer,
-			                                                        CAN_DATA_LENGTH,
-			                                                        std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_destination_control_function()),
-			                                                        session->sessionMessage.get_source_control_function(),
-			                                                        CANIdentifier::CANPriority::PriorityDefault6);
+			retVal = networkManager.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolConnectionManagement),
+			                                         dataBuffer,
+			                                         CAN_DATA_LENGTH,
+			                                         std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_destination_control_function()),
+			                                         session->sessionMessage.get_source_control_function(),
+			                                         CANIdentifier::CANPriority::PriorityDefault6);
 		}
 		return retVal;
 	}
@@ -571,12 +623,12 @@ namespace isobus
 				                                                 static_cast<std::uint8_t>(session->sessionMessage.get_identifier().get_parameter_group_number() & 0xFF),
 				                                                 static_cast<std::uint8_t>((session->sessionMessage.get_identifier().get_parameter_group_number() >> 8) & 0xFF),
 				                                                 static_cast<std::uint8_t>((session->sessionMessage.get_identifier().get_parameter_group_number() >> 16) & 0xFF) };
-			retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolConnectionManagement),
-			                                                        dataBuffer,
-			                                                        CAN_DATA_LENGTH,
-			                                                        std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_destination_control_function()),
-			                                                        session->sessionMessage.get_source_control_function(),
-			                                                        CANIdentifier::CANPriority::PriorityDefault6);
+			retVal = networkManager.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolConnectionManagement),
+			                                         dataBuffer,
+			                                         CAN_DATA_LENGTH,
+			                                         std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_destination_control_function()),
+			                                         session->sessionMessage.get_source_control_function(),
+			                                         CANIdentifier::CANPriority::PriorityDefault6);
 		}
 		return retVal;
 	}
@@ -595,12 +647,12 @@ namespace isobus
 				                                                 static_cast<std::uint8_t>(session->sessionMessage.get_identifier().get_parameter_group_number() & 0xFF),
 				                                                 static_cast<std::uint8_t>((session->sessionMessage.get_identifier().get_parameter_group_number() >> 8) & 0xFF),
 				                                                 static_cast<std::uint8_t>((session->sessionMessage.get_identifier().get_parameter_group_number() >> 16) & 0xFF) };
-			retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolConnectionManagement),
-			                                                        dataBuffer,
-			                                                        CAN_DATA_LENGTH,
-			                                                        std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_source_control_function()),
-			                                                        session->sessionMessage.get_destination_control_function(),
-			                                                        CANIdentifier::CANPriority::PriorityDefault6);
+			retVal = networkManager.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolConnectionManagement),
+			                                         dataBuffer,
+			                                         CAN_DATA_LENGTH,
+			                                         std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_source_control_function()),
+			                                         session->sessionMessage.get_destination_control_function(),
+			                                         CANIdentifier::CANPriority::PriorityDefault6);
 		}
 		return retVal;
 	}
@@ -619,12 +671,92 @@ namespace isobus
 				                                                 static_cast<std::uint8_t>(session->sessionMessage.get_identifier().get_parameter_group_number() & 0xFF),
 				                                                 static_cast<std::uint8_t>((session->sessionMessage.get_identifier().get_parameter_group_number() >> 8) & 0xFF),
 				                                                 static_cast<std::uint8_t>((session->sessionMessage.get_identifier().get_parameter_group_number() >> 16) & 0xFF) };
-			retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolConnectionManagement),
-			                                                        dataBuffer,
-			                                                        CAN_DATA_LENGTH,
-			                                                        std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_source_control_function()),
-			                                                        session->sessionMessage.get_destination_control_function(),
-			                                                        CANIdentifier::CANPriority::PriorityDefault6);
+			retVal = networkManager.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolConnectionManagement),
+			                                         dataBuffer,
+			                                         CAN_DATA_LENGTH,
+			                                         std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_source_control_function()),
+			                                         session->sessionMessage.get_destination_control_function(),
+			                                         CANIdentifier::CANPriority::PriorityDefault6);
+		}
+		return retVal;
+	}
+
+	ExtendedTransportProtocolManager::ExtendedTransportProtocolSession *ExtendedTransportProtocolManager::start_transmit_session(std::uint32_t parameterGroupNumber,
+	                                                                                                                             std::uint32_t messageLength,
+	                                                                                                                             std::shared_ptr<ControlFunction> source,
+	                                                                                                                             std::shared_ptr<ControlFunction> destination,
+	                                                                                                                             TransmitCompleteCallback sessionCompleteCallback,
+	                                                                                                                             void *parentPointer)
+	{
+		ExtendedTransportProtocolSession *session;
+		ExtendedTransportProtocolSession *retVal = nullptr;
+
+		if ((messageLength < MAX_PROTOCOL_DATA_LENGTH) &&
+		    (messageLength >= MIN_PROTOCOL_DATA_LENGTH) &&
+		    (nullptr != destination) &&
+		    (nullptr != source) &&
+		    (true == source->get_address_valid()) &&
+		    (destination->get_address_valid()) &&
+		    (!get_session(session, source, destination)))
+		{
+			ExtendedTransportProtocolSession *newSession = create_session(ExtendedTransportProtocolSession::Direction::Transmit, source, destination);
+
+			newSession->packetCount = (messageLength / PROTOCOL_BYTES_PER_FRAME);
+			newSession->lastPacketNumber = 0;
+			newSession->processedPacketsThisSession = 0;
+			newSession->sessionCompleteCallback = sessionCompleteCallback;
+			newSession->parent = parentPointer;
+			if (0 != (messageLength % PROTOCOL_BYTES_PER_FRAME))
+			{
+				newSession->packetCount++;
+			}
+			CANIdentifier messageVirtualID(CANIdentifier::Type::Extended,
+			                               parameterGroupNumber,
+			                               CANIdentifier::CANPriority::PriorityDefault6,
+			                               destination->get_address(),
+			                               source->get_address());
+
+			newSession->sessionMessage.set_identifier(messageVirtualID);
+			set_state(newSession, StateMachineState::RequestToSend);
+			CANStackLogger::CAN_stack_log(CANStackLogger::LoggingLevel::Debug, "[ETP]: New ETP Session. Dest: " + isobus::to_string(static_cast<int>(destination->get_address())));
+			retVal = newSession;
+		}
+		return retVal;
+	}
+
+	ExtendedTransportProtocolManager::ExtendedTransportProtocolSession *ExtendedTransportProtocolManager::create_session(ExtendedTransportProtocolSession::Direction sessionDirection, std::shared_ptr<ControlFunction> source, std::shared_ptr<ControlFunction> destination)
+	{
+		const std::uint32_t maxSessions = networkManager.get_configuration().get_max_number_transport_protocol_sessions();
+		ExtendedTransportProtocolSession *retVal = nullptr;
+
+		if (source->get_can_port() < CAN_PORT_MAXIMUM)
+		{
+			auto &channelSessions = activeSessions[source->get_can_port()];
+
+			if (ExtendedTransportProtocolSession::Direction::Transmit == sessionDirection)
+			{
+				// Only received sessions are limited, the application decides how much it wants to send
+				channelSessions.reserve_for_one_more(maxSessions);
+			}
+			else
+			{
+				channelSessions.reserve(maxSessions);
+			}
+
+			if ((ExtendedTransportProtocolSession::Direction::Transmit == sessionDirection) ||
+			    (channelSessions.size() < maxSessions))
+			{
+				retVal = channelSessions.create(ProtocolSessionKey(source, destination), sessionDirection, source->get_can_port());
+
+				if (nullptr != retVal)
+				{
+					retVal->sessionMessage.set_source_control_function(source);
+					retVal->sessionMessage.set_destination_control_function(destination);
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+					networkManager.get_instrumentation().record_queue_depth(CANStackInstrumentation::Queue::ExtendedTransportProtocolSessions, source->get_can_port(), channelSessions.size());
+#endif
+				}
+			}
 		}
 		return retVal;
 	}
@@ -719,10 +851,7 @@ namespace isobus
 
 									if (callbackSuccessful)
 									{
-										for (std::uint8_t j = 0; j < PROTOCOL_BYTES_PER_FRAME; j++)
-										{
-											dataBuffer[1 + j] = callbackBuffer[j];
-										}
+										memcpy(&dataBuffer[1], callbackBuffer, PROTOCOL_BYTES_PER_FRAME);
 									}
 									else
 									{
@@ -735,34 +864,24 @@ namespace isobus
 								}
 								else
 								{
-									// Use the data buffer to get the data for this frame
-									for (std::uint8_t j = 0; j < PROTOCOL_BYTES_PER_FRAME; j++)
-									{
-										std::uint32_t index = (j + (PROTOCOL_BYTES_PER_FRAME * session->processedPacketsThisSession));
-										if (index < session->get_message_data_length())
-										{
-											dataBuffer[1 + j] = session->sessionMessage.get_data()[j + (PROTOCOL_BYTES_PER_FRAME * session->processedPacketsThisSession)];
-										}
-										else
-										{
-											dataBuffer[1 + j] = 0xFF;
-										}
-									}
+									// Use the data buffer to get the data for this frame, and pad the last frame with 0xFF
+									std::uint32_t bytesCopied = session->sessionMessage.get_data().read(PROTOCOL_BYTES_PER_FRAME * session->processedPacketsThisSession, &dataBuffer[1], PROTOCOL_BYTES_PER_FRAME);
+									memset(&dataBuffer[1 + bytesCopied], 0xFF, PROTOCOL_BYTES_PER_FRAME - bytesCopied);
 								}
 
-								if (CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolDataTransfer),
-								                                                   dataBuffer,
-								                                                   CAN_DATA_LENGTH,
-								                                                   std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_source_control_function()),
-								                                                   session->sessionMessage.get_destination_control_function(),
-								                                                   CANIdentifier::CANPriority::PriorityLowest7))
+								if (networkManager.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolDataTransfer),
+								                                    dataBuffer,
+								                                    CAN_DATA_LENGTH,
+								                                    std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_source_control_function()),
+								                                    session->sessionMessage.get_destination_control_function(),
+								                                    CANIdentifier::CANPriority::PriorityLowest7))
 								{
 									framesSentThisUpdate++;
 									session->lastPacketNumber++;
 									session->processedPacketsThisSession++;
 									session->timestamp_ms = SystemTiming::get_timestamp_ms();
 
-									if (framesSentThisUpdate >= CANNetworkManager::CANNetwork.get_configuration().get_max_number_of_network_manager_protocol_frames_per_update())
+									if (framesSentThisUpdate >= networkManager.get_configuration().get_max_number_of_network_manager_protocol_frames_per_update())
 									{
 										break; // Throttle the session
 									}
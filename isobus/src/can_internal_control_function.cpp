@@ -18,19 +18,24 @@
 
 namespace isobus
 {
-	InternalControlFunction::InternalControlFunction(NAME desiredName, std::uint8_t preferredAddress, std::uint8_t CANPort, CANLibBadge<InternalControlFunction>) :
-	  ControlFunction(desiredName, NULL_CAN_ADDRESS, CANPort, Type::Internal),
-	  stateMachine(preferredAddress, desiredName, CANPort)
+	InternalControlFunction::InternalControlFunction(NAME desiredName, std::uint8_t preferredAddress, std::uint8_t CANPort, CANNetworkManager &networkManager, CANLibBadge<InternalControlFunction>) :
+	  ControlFunction(desiredName, NULL_CAN_ADDRESS, CANPort, networkManager, Type::Internal),
+	  stateMachine(preferredAddress, desiredName, CANPort, networkManager)
 	{
 	}
 
 	std::shared_ptr<InternalControlFunction> InternalControlFunction::create(NAME desiredName, std::uint8_t preferredAddress, std::uint8_t CANPort)
+	{
+		return create(desiredName, preferredAddress, CANPort, CANNetworkManager::CANNetwork);
+	}
+
+	std::shared_ptr<InternalControlFunction> InternalControlFunction::create(NAME desiredName, std::uint8_t preferredAddress, std::uint8_t CANPort, CANNetworkManager &networkManager)
 	{
 		// Unfortunately, we can't use `std::make_shared` here because the constructor is private
 		CANLibBadge<InternalControlFunction> badge; // This badge is used to allow creation of the PGN request protocol only from within this class
-		auto controlFunction = std::shared_ptr<InternalControlFunction>(new InternalControlFunction(desiredName, preferredAddress, CANPort, badge));
+		auto controlFunction = std::shared_ptr<InternalControlFunction>(new InternalControlFunction(desiredName, preferredAddress, CANPort, networkManager, badge));
 		controlFunction->pgnRequestProtocol.reset(new ParameterGroupNumberRequestProtocol(controlFunction, badge));
-		CANNetworkManager::CANNetwork.on_control_function_created(controlFunction, badge);
+		networkManager.on_control_function_created(controlFunction, badge);
 		return controlFunction;
 	}
 
@@ -61,6 +66,11 @@ namespace isobus
 		return previousAddress != address;
 	}
 
+	std::uint32_t InternalControlFunction::get_time_until_address_claiming_update_ms(CANLibBadge<CANNetworkManager>) const
+	{
+		return stateMachine.get_time_until_next_update_ms();
+	}
+
 	std::weak_ptr<ParameterGroupNumberRequestProtocol> InternalControlFunction::get_pgn_request_protocol() const
 	{
 		return pgnRequestProtocol;
@@ -9,8 +9,10 @@
 //================================================================================================
 #include "isobus/isobus/can_message.hpp"
 #include "isobus/isobus/can_stack_logger.hpp"
+#include "isobus/utility/system_timing.hpp"
 
 #include <cassert>
+#include <utility>
 
 namespace isobus
 {
@@ -24,7 +26,7 @@ namespace isobus
 		return messageType;
 	}
 
-	const std::vector<std::uint8_t> &CANMessage::get_data() const
+	const CANMessageData &CANMessage::get_data() const
 	{
 		return data;
 	}
@@ -79,19 +81,44 @@ namespace isobus
 		return CANPortIndex;
 	}
 
+	std::uint64_t CANMessage::get_timestamp_us() const
+	{
+		return (0 != timestamp_us) ? timestamp_us : SystemTiming::get_timestamp_us();
+	}
+
+	std::uint32_t CANMessage::get_timestamp_ms() const
+	{
+		return static_cast<std::uint32_t>(get_timestamp_us() / 1000);
+	}
+
 	void CANMessage::set_data(const std::uint8_t *dataBuffer, std::uint32_t length)
 	{
 		assert(length <= ABSOLUTE_MAX_MESSAGE_LENGTH && "CANMessage::set_data() called with length greater than maximum supported");
 		assert(nullptr != dataBuffer && "CANMessage::set_data() called with nullptr dataBuffer");
 
-		data.insert(data.end(), dataBuffer, dataBuffer + length);
+		data.append(dataBuffer, length);
+	}
+
+	void CANMessage::set_shared_data(std::shared_ptr<const std::uint8_t> dataBuffer, std::uint32_t length)
+	{
+		assert(length <= ABSOLUTE_MAX_MESSAGE_LENGTH && "CANMessage::set_shared_data() called with length greater than maximum supported");
+		assert(nullptr != dataBuffer && "CANMessage::set_shared_data() called with nullptr dataBuffer");
+
+		data.share(std::move(dataBuffer), length);
 	}
 
 	void CANMessage::set_data(std::uint8_t dataByte, const std::uint32_t insertPosition)
 	{
 		assert(insertPosition <= ABSOLUTE_MAX_MESSAGE_LENGTH && "CANMessage::set_data() called with insertPosition greater than maximum supported");
 
-		data[insertPosition] = dataByte;
+		data.mutable_data()[insertPosition] = dataByte;
+	}
+
+	void CANMessage::set_data(const std::uint8_t *dataBuffer, std::uint32_t length, std::uint32_t insertPosition)
+	{
+		assert(nullptr != dataBuffer && "CANMessage::set_data() called with nullptr dataBuffer");
+
+		data.write(insertPosition, dataBuffer, length);
 	}
 
 	void CANMessage::set_data_size(std::uint32_t length)
@@ -114,6 +141,11 @@ namespace isobus
 		identifier = value;
 	}
 
+	void CANMessage::set_timestamp_us(std::uint64_t value)
+	{
+		timestamp_us = value;
+	}
+
 	std::uint8_t CANMessage::get_uint8_at(const std::uint32_t index) const
 	{
 		return data.at(index);
@@ -0,0 +1,209 @@
+//================================================================================================
+/// @file can_message_data.cpp
+///
+/// @brief A byte buffer for CAN message payloads that stores short payloads inline.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#include "isobus/isobus/can_message_data.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+namespace isobus
+{
+	CANMessageData::CANMessageData(CANMessageData &&other) noexcept :
+	  sharedData(std::move(other.sharedData)),
+	  heapData(std::move(other.heapData)),
+	  inlineData(other.inlineData),
+	  dataLength(other.dataLength),
+	  inlineStorage(other.inlineStorage)
+	{
+		other.dataLength = 0;
+		other.inlineStorage = true;
+	}
+
+	CANMessageData &CANMessageData::operator=(CANMessageData &&other) noexcept
+	{
+		if (this != &other)
+		{
+			sharedData = std::move(other.sharedData);
+			heapData = std::move(other.heapData);
+			inlineData = other.inlineData;
+			dataLength = other.dataLength;
+			inlineStorage = other.inlineStorage;
+			other.sharedData.reset();
+			other.heapData.clear();
+			other.dataLength = 0;
+			other.inlineStorage = true;
+		}
+		return *this;
+	}
+
+	const std::uint8_t *CANMessageData::data() const
+	{
+		if (nullptr != sharedData)
+		{
+			return sharedData.get();
+		}
+		return inlineStorage ? inlineData.data() : heapData.data();
+	}
+
+	std::uint8_t *CANMessageData::mutable_data()
+	{
+		make_owned();
+		return inlineStorage ? inlineData.data() : heapData.data();
+	}
+
+	std::uint32_t CANMessageData::size() const
+	{
+		return dataLength;
+	}
+
+	bool CANMessageData::empty() const
+	{
+		return 0 == dataLength;
+	}
+
+	bool CANMessageData::is_inline() const
+	{
+		return (nullptr == sharedData) && inlineStorage;
+	}
+
+	bool CANMessageData::is_shared() const
+	{
+		return nullptr != sharedData;
+	}
+
+	void CANMessageData::share(std::shared_ptr<const std::uint8_t> sharedBuffer, std::uint32_t length)
+	{
+		clear();
+		if (nullptr != sharedBuffer)
+		{
+			sharedData = std::move(sharedBuffer);
+			dataLength = length;
+		}
+	}
+
+	const std::uint8_t *CANMessageData::begin() const
+	{
+		return data();
+	}
+
+	const std::uint8_t *CANMessageData::end() const
+	{
+		return data() + dataLength;
+	}
+
+	const std::uint8_t &CANMessageData::operator[](std::uint32_t index) const
+	{
+		return data()[index];
+	}
+
+	std::uint8_t CANMessageData::at(std::uint32_t index) const
+	{
+		if (index >= dataLength)
+		{
+			throw std::out_of_range("CANMessageData::at() index out of range");
+		}
+		return data()[index];
+	}
+
+	void CANMessageData::resize(std::uint32_t length)
+	{
+		make_owned();
+		if (inlineStorage)
+		{
+			if (length <= INLINE_CAPACITY)
+			{
+				if (length > dataLength)
+				{
+					std::fill(inlineData.begin() + dataLength, inlineData.begin() + length, 0);
+				}
+			}
+			else
+			{
+				// Spill over to the heap, this is only expected for multi-frame messages
+				heapData.reserve(length);
+				heapData.assign(inlineData.begin(), inlineData.begin() + dataLength);
+				heapData.resize(length, 0);
+				inlineStorage = false;
+			}
+		}
+		else
+		{
+			heapData.resize(length, 0);
+		}
+		dataLength = length;
+	}
+
+	void CANMessageData::append(const std::uint8_t *dataBuffer, std::uint32_t length)
+	{
+		if (0 != length)
+		{
+			std::uint32_t oldLength = dataLength;
+			resize(dataLength + length);
+			memcpy(mutable_data() + oldLength, dataBuffer, length);
+		}
+	}
+
+	std::uint32_t CANMessageData::write(std::uint32_t offset, const std::uint8_t *dataBuffer, std::uint32_t length)
+	{
+		std::uint32_t retVal = 0;
+
+		if (offset < dataLength)
+		{
+			retVal = std::min(length, dataLength - offset);
+			memcpy(mutable_data() + offset, dataBuffer, retVal);
+		}
+		return retVal;
+	}
+
+	std::uint32_t CANMessageData::read(std::uint32_t offset, std::uint8_t *dataBuffer, std::uint32_t length) const
+	{
+		std::uint32_t retVal = 0;
+
+		if (offset < dataLength)
+		{
+			retVal = std::min(length, dataLength - offset);
+			memcpy(dataBuffer, data() + offset, retVal);
+		}
+		return retVal;
+	}
+
+	void CANMessageData::clear()
+	{
+		sharedData.reset();
+		heapData.clear();
+		heapData.shrink_to_fit();
+		dataLength = 0;
+		inlineStorage = true;
+	}
+
+	void CANMessageData::make_owned()
+	{
+		if (nullptr != sharedData)
+		{
+			std::shared_ptr<const std::uint8_t> borrowedData = std::move(sharedData);
+			const std::uint32_t borrowedLength = dataLength;
+
+			dataLength = 0;
+			inlineStorage = true;
+			resize(borrowedLength);
+			memcpy(mutable_data(), borrowedData.get(), borrowedLength);
+		}
+	}
+
+	std::vector<std::uint8_t> CANMessageData::to_vector() const
+	{
+		return std::vector<std::uint8_t>(begin(), end());
+	}
+
+	CANMessageData::operator std::vector<std::uint8_t>() const
+	{
+		return to_vector();
+	}
+} // namespace isobus
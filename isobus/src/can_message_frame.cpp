@@ -15,21 +15,63 @@ namespace isobus
 	std::uint32_t CANMessageFrame::get_number_bits_in_message() const
 	{
 		constexpr std::uint32_t MAX_CONSECUTIVE_SAME_BITS = 5; // After 5 consecutive bits, 6th will be opposite
-		const std::uint32_t dataLengthBits = CAN_DATA_LENGTH * dataLength;
+		constexpr std::uint32_t BITS_PER_BYTE = 8;
+		const std::uint32_t dataLengthBits = BITS_PER_BYTE * dataLength;
 		std::uint32_t retVal = 0;
 
-		if (isExtendedFrame)
+		if (isFDFrame)
+		{
+			constexpr std::uint32_t STANDARD_ID_HEADER_LENGTH = 22; // SOF, ID, RRS, IDE, FDF, res, BRS, ESI, and DLC
+			constexpr std::uint32_t EXTENDED_ID_HEADER_LENGTH = 41; // SOF, ID, SRR, IDE, ID extension, RRS, FDF, res, BRS, ESI, and DLC
+			constexpr std::uint32_t STUFF_COUNT_LENGTH = 4;
+			constexpr std::uint32_t SHORT_CRC_LENGTH = 17; // Used for payloads up to 16 bytes
+			constexpr std::uint32_t LONG_CRC_LENGTH = 21;
+			constexpr std::uint32_t SHORT_CRC_FIXED_STUFF_BITS = 6;
+			constexpr std::uint32_t LONG_CRC_FIXED_STUFF_BITS = 7;
+			constexpr std::uint32_t TRAILER_LENGTH = 13; // CRC delimiter, ACK, EOF, and interframe space
+			const std::uint32_t headerAndDataBits = (isExtendedFrame ? EXTENDED_ID_HEADER_LENGTH : STANDARD_ID_HEADER_LENGTH) + dataLengthBits;
+			const bool isLongCRC = (dataLength > 16);
+
+			// Only the header and data are dynamically stuffed, so average between no stuffing and the worst case
+			retVal = headerAndDataBits + (headerAndDataBits / (2 * MAX_CONSECUTIVE_SAME_BITS));
+			retVal += STUFF_COUNT_LENGTH + TRAILER_LENGTH;
+			retVal += isLongCRC ? (LONG_CRC_LENGTH + LONG_CRC_FIXED_STUFF_BITS) : (SHORT_CRC_LENGTH + SHORT_CRC_FIXED_STUFF_BITS);
+		}
+		else if (isExtendedFrame)
 		{
 			constexpr std::uint32_t EXTENDED_ID_BEST_NON_DATA_LENGTH = 67; // SOF, ID, Control, CRC, ACK, EOF, and interframe space
 			constexpr std::uint32_t EXTENDED_ID_WORST_NON_DATA_LENGTH = 78;
-			retVal = ((dataLengthBits + EXTENDED_ID_BEST_NON_DATA_LENGTH) + (dataLengthBits + (dataLengthBits / MAX_CONSECUTIVE_SAME_BITS) + EXTENDED_ID_WORST_NON_DATA_LENGTH));
+			retVal = ((dataLengthBits + EXTENDED_ID_BEST_NON_DATA_LENGTH) + (dataLengthBits + (dataLengthBits / MAX_CONSECUTIVE_SAME_BITS) + EXTENDED_ID_WORST_NON_DATA_LENGTH)) / 2;
 		}
 		else
 		{
 			constexpr std::uint32_t STANDARD_ID_BEST_NON_DATA_LENGTH = 47; // SOF, ID, Control, CRC, ACK, EOF, and interframe space
 			constexpr std::uint32_t STANDARD_ID_WORST_NON_DATA_LENGTH = 54;
-			retVal = ((dataLengthBits + STANDARD_ID_BEST_NON_DATA_LENGTH) + (dataLengthBits + (dataLengthBits / MAX_CONSECUTIVE_SAME_BITS) + STANDARD_ID_WORST_NON_DATA_LENGTH));
+			retVal = ((dataLengthBits + STANDARD_ID_BEST_NON_DATA_LENGTH) + (dataLengthBits + (dataLengthBits / MAX_CONSECUTIVE_SAME_BITS) + STANDARD_ID_WORST_NON_DATA_LENGTH)) / 2;
+		}
+		return retVal;
+	}
+
+	std::uint8_t CANMessageFrame::get_fd_frame_length(std::uint32_t length)
+	{
+		constexpr std::uint8_t VALID_FD_LENGTHS[] = { 12, 16, 20, 24, 32, 48, 64 };
+		std::uint8_t retVal = 0;
+
+		if (length <= CAN_DATA_LENGTH)
+		{
+			retVal = static_cast<std::uint8_t>(length);
+		}
+		else
+		{
+			for (std::uint8_t validLength : VALID_FD_LENGTHS)
+			{
+				if (length <= validLength)
+				{
+					retVal = validLength;
+					break;
+				}
+			}
 		}
-		return retVal / 2;
+		return retVal;
 	}
 } // namespace isobus
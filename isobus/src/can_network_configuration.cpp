@@ -8,6 +8,9 @@
 //================================================================================================
 
 #include "isobus/isobus/can_network_configuration.hpp"
+#include "isobus/isobus/can_constants.hpp"
+
+#include <algorithm>
 
 namespace isobus
 {
@@ -57,4 +60,44 @@ namespace isobus
 	{
 		return networkManagerMaxFramesToSendPerUpdate;
 	}
+
+	void CANNetworkConfiguration::set_receive_queue_depth(std::uint32_t depth)
+	{
+		receiveQueueDepth = depth;
+	}
+
+	std::uint32_t CANNetworkConfiguration::get_receive_queue_depth() const
+	{
+		return receiveQueueDepth;
+	}
+
+	void CANNetworkConfiguration::set_can_fd_enabled(std::uint8_t channelIndex, bool enabled)
+	{
+		if (channelIndex < CAN_PORT_MAXIMUM)
+		{
+			if (enabled)
+			{
+				canFDEnabledChannels |= (1 << channelIndex);
+			}
+			else
+			{
+				canFDEnabledChannels &= ~(1 << channelIndex);
+			}
+		}
+	}
+
+	bool CANNetworkConfiguration::get_can_fd_enabled(std::uint8_t channelIndex) const
+	{
+		return (channelIndex < CAN_PORT_MAXIMUM) && (0 != (canFDEnabledChannels & (1 << channelIndex)));
+	}
+
+	void CANNetworkConfiguration::set_number_of_update_threads(std::uint8_t numberOfThreads)
+	{
+		numberOfUpdateThreads = std::max<std::uint8_t>(1, numberOfThreads);
+	}
+
+	std::uint8_t CANNetworkConfiguration::get_number_of_update_threads() const
+	{
+		return numberOfUpdateThreads;
+	}
 }
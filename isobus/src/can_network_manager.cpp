@@ -23,16 +23,69 @@
 #include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <limits>
 #include <numeric>
+#include <utility>
 
 namespace isobus
 {
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+	namespace
+	{
+		/// @brief Locks every channel's mutex in a per-channel array, always in index order so it can't deadlock with another of its kind
+		class ChannelMutexesLock
+		{
+		public:
+			/// @brief Locks all the mutexes
+			/// @param[in] mutexesToLock The per-channel mutexes to lock
+			explicit ChannelMutexesLock(std::array<std::mutex, CAN_PORT_MAXIMUM> &mutexesToLock) :
+			  mutexes(mutexesToLock)
+			{
+				for (auto &mutex : mutexes)
+				{
+					mutex.lock();
+				}
+			}
+
+			/// @brief Unlocks all the mutexes in reverse order
+			~ChannelMutexesLock()
+			{
+				for (auto mutex = mutexes.rbegin(); mutex != mutexes.rend(); mutex++)
+				{
+					mutex->unlock();
+				}
+			}
+
+			ChannelMutexesLock(const ChannelMutexesLock &) = delete;
+			ChannelMutexesLock &operator=(const ChannelMutexesLock &) = delete;
+
+		private:
+			std::array<std::mutex, CAN_PORT_MAXIMUM> &mutexes; ///< The mutexes that are locked
+		};
+	} // namespace
+#endif
+
 	CANNetworkManager CANNetworkManager::CANNetwork;
 
 	void CANNetworkManager::initialize()
 	{
-		receiveMessageList.clear();
-		initialized = true;
+		for (std::uint8_t i = 0; i < CAN_PORT_MAXIMUM; i++)
+		{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+			const std::lock_guard<std::mutex> lock(receiveQueueProducerMutexes[i]);
+#endif
+			auto &queue = receiveMessageQueues[i];
+
+			if ((nullptr == queue) || (queue->capacity() < configuration.get_receive_queue_depth()))
+			{
+				queue.reset(new SPSCRingBuffer<CANMessage>(configuration.get_receive_queue_depth()));
+			}
+			else
+			{
+				queue->clear();
+			}
+		}
+		initialized.store(true, std::memory_order_release);
 		transportProtocol.initialize({});
 		extendedTransportProtocol.initialize({});
 	}
@@ -42,19 +95,16 @@ namespace isobus
 		return get_control_function(channelIndex, address);
 	}
 
-	void CANNetworkManager::add_global_parameter_group_number_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent)
+	void CANNetworkManager::add_global_parameter_group_number_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent, CallbackExecutor *executor)
 	{
-		globalParameterGroupNumberCallbacks.emplace_back(parameterGroupNumber, callback, parent, nullptr);
+		globalParameterGroupNumberCallbacks.add(ParameterGroupNumberCallbackData(parameterGroupNumber, callback, parent, nullptr, executor));
+		on_receive_filters_changed();
 	}
 
 	void CANNetworkManager::remove_global_parameter_group_number_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent)
 	{
-		ParameterGroupNumberCallbackData tempObject(parameterGroupNumber, callback, parent, nullptr);
-		auto callbackLocation = std::find(globalParameterGroupNumberCallbacks.begin(), globalParameterGroupNumberCallbacks.end(), tempObject);
-		if (globalParameterGroupNumberCallbacks.end() != callbackLocation)
-		{
-			globalParameterGroupNumberCallbacks.erase(callbackLocation);
-		}
+		globalParameterGroupNumberCallbacks.remove(ParameterGroupNumberCallbackData(parameterGroupNumber, callback, parent, nullptr));
+		on_receive_filters_changed();
 	}
 
 	std::size_t CANNetworkManager::get_number_global_parameter_group_number_callbacks() const
@@ -62,25 +112,23 @@ namespace isobus
 		return globalParameterGroupNumberCallbacks.size();
 	}
 
-	void CANNetworkManager::add_any_control_function_parameter_group_number_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent)
+	void CANNetworkManager::add_any_control_function_parameter_group_number_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent, CallbackExecutor *executor)
 	{
 #if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		std::lock_guard<std::mutex> lock(anyControlFunctionCallbacksMutex);
+		const ChannelMutexesLock lock(anyControlFunctionCallbacksMutexes);
 #endif
-		anyControlFunctionParameterGroupNumberCallbacks.emplace_back(parameterGroupNumber, callback, parent, nullptr);
+		anyControlFunctionParameterGroupNumberCallbacks.add(ParameterGroupNumberCallbackData(parameterGroupNumber, callback, parent, nullptr, executor));
+		on_receive_filters_changed();
 	}
 
 	void CANNetworkManager::remove_any_control_function_parameter_group_number_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent)
 	{
 		ParameterGroupNumberCallbackData tempObject(parameterGroupNumber, callback, parent, nullptr);
 #if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		std::lock_guard<std::mutex> lock(anyControlFunctionCallbacksMutex);
+		const ChannelMutexesLock lock(anyControlFunctionCallbacksMutexes);
 #endif
-		auto callbackLocation = std::find(anyControlFunctionParameterGroupNumberCallbacks.begin(), anyControlFunctionParameterGroupNumberCallbacks.end(), tempObject);
-		if (anyControlFunctionParameterGroupNumberCallbacks.end() != callbackLocation)
-		{
-			anyControlFunctionParameterGroupNumberCallbacks.erase(callbackLocation);
-		}
+		anyControlFunctionParameterGroupNumberCallbacks.remove(tempObject);
+		on_receive_filters_changed();
 	}
 
 	std::shared_ptr<InternalControlFunction> CANNetworkManager::get_internal_control_function(std::shared_ptr<ControlFunction> controlFunction)
@@ -95,6 +143,17 @@ namespace isobus
 		return retVal;
 	}
 
+	std::uint32_t CANNetworkManager::get_number_rx_messages_dropped(std::uint8_t canChannel) const
+	{
+		std::uint32_t retVal = 0;
+
+		if ((canChannel < CAN_PORT_MAXIMUM) && (nullptr != receiveMessageQueues[canChannel]))
+		{
+			retVal = receiveMessageQueues[canChannel]->get_overflow_count();
+		}
+		return retVal;
+	}
+
 	float CANNetworkManager::get_estimated_busload(std::uint8_t canChannel)
 	{
 #if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
@@ -112,6 +171,18 @@ namespace isobus
 		return retVal;
 	}
 
+	CANTrafficStatistics &CANNetworkManager::get_traffic_statistics()
+	{
+		return trafficStatistics;
+	}
+
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+	CANStackInstrumentation &CANNetworkManager::get_instrumentation()
+	{
+		return instrumentation;
+	}
+#endif
+
 	bool CANNetworkManager::send_can_message(std::uint32_t parameterGroupNumber,
 	                                         const std::uint8_t *dataBuffer,
 	                                         std::uint32_t dataLength,
@@ -132,26 +203,28 @@ namespace isobus
 		    ((parameterGroupNumber == static_cast<std::uint32_t>(CANLibParameterGroupNumber::AddressClaim)) ||
 		     (sourceControlFunction->get_address_valid())))
 		{
-			CANLibProtocol *currentProtocol;
+			const bool sendAsFDFrame = ((nullptr != dataBuffer) &&
+			                            (dataLength > CAN_DATA_LENGTH) &&
+			                            (dataLength <= CAN_FD_DATA_LENGTH) &&
+			                            (configuration.get_can_fd_enabled(sourceControlFunction->get_can_port())));
 
-			// See if any transport layer protocol can handle this message
-			for (std::uint32_t i = 0; i < CANLibProtocol::get_number_protocols(); i++)
+			// See if any transport layer protocol can handle this message, unless it fits in a single CAN FD frame
+			for (std::size_t i = 0; (!sendAsFDFrame) && (i < protocolList.size()); i++)
 			{
-				if (CANLibProtocol::get_protocol(i, currentProtocol))
+				retVal = protocolList[i]->protocol_transmit_message(parameterGroupNumber,
+				                                                    dataBuffer,
+				                                                    dataLength,
+				                                                    sourceControlFunction,
+				                                                    destinationControlFunction,
+				                                                    transmitCompleteCallback,
+				                                                    parentPointer,
+				                                                    frameChunkCallback);
+
+				if (retVal)
 				{
-					retVal = currentProtocol->protocol_transmit_message(parameterGroupNumber,
-					                                                    dataBuffer,
-					                                                    dataLength,
-					                                                    sourceControlFunction,
-					                                                    destinationControlFunction,
-					                                                    transmitCompleteCallback,
-					                                                    parentPointer,
-					                                                    frameChunkCallback);
-
-					if (retVal)
-					{
-						break;
-					}
+					// The protocol will start sending on its next update, so don't wait for a timer to get there
+					updateRequestedEventDispatcher.invoke();
+					break;
 				}
 			}
 
@@ -180,22 +253,84 @@ namespace isobus
 		return retVal;
 	}
 
+	bool CANNetworkManager::send_can_message(std::uint32_t parameterGroupNumber,
+	                                         std::shared_ptr<const std::uint8_t> dataBuffer,
+	                                         std::uint32_t dataLength,
+	                                         std::shared_ptr<InternalControlFunction> sourceControlFunction,
+	                                         std::shared_ptr<ControlFunction> destinationControlFunction,
+	                                         CANIdentifier::CANPriority priority,
+	                                         TransmitCompleteCallback transmitCompleteCallback,
+	                                         void *parentPointer)
+	{
+		bool retVal = false;
+		const bool needsTransportProtocol = ((dataLength > CAN_DATA_LENGTH) &&
+		                                     (nullptr != sourceControlFunction) &&
+		                                     ((dataLength > CAN_FD_DATA_LENGTH) ||
+		                                      (!configuration.get_can_fd_enabled(sourceControlFunction->get_can_port()))));
+
+		if (!needsTransportProtocol)
+		{
+			// The message fits in one frame, which is copied into the frame anyways, so there is nothing to gain by sharing the buffer
+			retVal = send_can_message(parameterGroupNumber, dataBuffer.get(), dataLength, sourceControlFunction, destinationControlFunction, priority, transmitCompleteCallback, parentPointer);
+		}
+		else if ((nullptr != dataBuffer) &&
+		         (dataLength <= CANMessage::ABSOLUTE_MAX_MESSAGE_LENGTH) &&
+		         (sourceControlFunction->get_address_valid()))
+		{
+			for (CANLibProtocol *currentProtocol : protocolList)
+			{
+				retVal = currentProtocol->protocol_transmit_shared_message(parameterGroupNumber,
+				                                                           dataBuffer,
+				                                                           dataLength,
+				                                                           sourceControlFunction,
+				                                                           destinationControlFunction,
+				                                                           transmitCompleteCallback,
+				                                                           parentPointer);
+
+				if (retVal)
+				{
+					// The protocol will start sending on its next update, so don't wait for a timer to get there
+					updateRequestedEventDispatcher.invoke();
+					break;
+				}
+			}
+		}
+		return retVal;
+	}
+
 	void CANNetworkManager::receive_can_message(const CANMessage &message)
 	{
-		if (initialized)
+		receive_can_message(CANMessage(message));
+	}
+
+	void CANNetworkManager::receive_can_message(CANMessage &&message)
+	{
+		if ((initialized.load(std::memory_order_acquire)) && (message.get_can_port_index() < CAN_PORT_MAXIMUM))
 		{
+			const std::uint8_t channelIndex = message.get_can_port_index();
 #if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-			std::lock_guard<std::mutex> lock(receiveMessageMutex);
+			// The queue only supports one producer, so producers on the same channel take turns. The consumer never waits on this.
+			const std::lock_guard<std::mutex> lock(receiveQueueProducerMutexes[channelIndex]);
 #endif
+			receiveMessageQueues[channelIndex]->push(std::move(message));
 
-			receiveMessageList.push_back(message);
+			if (!channelsInUse[channelIndex].load(std::memory_order_relaxed))
+			{
+				channelsInUse[channelIndex].store(true, std::memory_order_relaxed);
+			}
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+			instrumentation.record_queue_depth(CANStackInstrumentation::Queue::ReceivedMessages, channelIndex, receiveMessageQueues[channelIndex]->size());
+#endif
 		}
 	}
 
 	void CANNetworkManager::update()
 	{
 #if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		const std::lock_guard<std::mutex> lock(ControlFunction::controlFunctionProcessingMutex);
+		const std::lock_guard<std::mutex> lock(updateMutex);
+#endif
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+		const std::uint64_t updateStartTimestamp_us = SystemTiming::get_timestamp_us();
 #endif
 
 		if (!initialized)
@@ -203,29 +338,61 @@ namespace isobus
 			initialize();
 		}
 
-		update_new_partners();
-
-		process_rx_messages();
-
-		update_internal_cfs();
-
-		prune_inactive_control_functions();
-
-		for (std::size_t i = 0; i < CANLibProtocol::get_number_protocols(); i++)
+		for (CANLibProtocol *currentProtocol : protocolList)
 		{
-			CANLibProtocol *currentProtocol = nullptr;
+			if (!currentProtocol->get_is_initialized())
+			{
+				currentProtocol->initialize({});
+			}
+			currentProtocol->update({});
+		}
 
-			if (CANLibProtocol::get_protocol(i, currentProtocol))
+		// The calling thread is one of the update threads
+		updateThreadPool.set_number_of_threads(configuration.get_number_of_update_threads() - 1);
+		// Channels that have never been used have nothing to do, so don't spend a task on each of them
+		std::array<std::uint8_t, CAN_PORT_MAXIMUM> activeChannels;
+		std::size_t numberOfActiveChannels = 0;
+		for (std::uint8_t i = 0; i < CAN_PORT_MAXIMUM; i++)
+		{
+			if (channelsInUse[i].load(std::memory_order_relaxed))
 			{
-				if (!currentProtocol->get_is_initialized())
-				{
-					currentProtocol->initialize({});
-				}
-				currentProtocol->update({});
+				activeChannels[numberOfActiveChannels] = i;
+				numberOfActiveChannels++;
 			}
 		}
+		updateThreadPool.run_parallel(numberOfActiveChannels, [this, &activeChannels](std::size_t taskIndex) {
+			update_channel(activeChannels[taskIndex]);
+		});
+
 		update_busload_history();
+		trafficStatistics.update();
+		update_receive_filters();
 		updateTimestamp_ms = SystemTiming::get_timestamp_ms();
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+		instrumentation.get_update_duration().record(SystemTiming::get_timestamp_us() - updateStartTimestamp_us);
+#endif
+	}
+
+	void CANNetworkManager::update_channel(std::uint8_t channelIndex)
+	{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		const std::lock_guard<std::mutex> lock(channelMutexes[channelIndex]);
+#endif
+
+		update_new_partners(channelIndex);
+
+		process_rx_messages(channelIndex);
+
+		update_internal_cfs(channelIndex);
+
+		update_receive_filter_addresses(channelIndex);
+
+		prune_inactive_control_functions(channelIndex);
+
+		for (CANLibProtocol *currentProtocol : protocolList)
+		{
+			currentProtocol->update_channel(channelIndex, {});
+		}
 	}
 
 	bool CANNetworkManager::send_can_message_raw(std::uint32_t portIndex,
@@ -261,35 +428,153 @@ namespace isobus
 		CANNetworkManager::process_transmitted_can_message_frame(txFrame);
 	}
 
+	void on_transmit_space_available_from_hardware(std::uint8_t channelIndex)
+	{
+		CANNetworkManager::CANNetwork.on_transmit_space_available(channelIndex);
+	}
+
 	void periodic_update_from_hardware()
 	{
 		CANNetworkManager::CANNetwork.update();
 	}
 
+	std::uint32_t get_time_until_periodic_update_from_hardware()
+	{
+		return CANNetworkManager::CANNetwork.get_time_until_next_update_ms();
+	}
+
+	EventDispatcher<> &get_periodic_update_requested_event_dispatcher_from_hardware()
+	{
+		return CANNetworkManager::CANNetwork.get_update_requested_event_dispatcher();
+	}
+
+	bool get_receive_filters_from_hardware(std::uint8_t channelIndex, std::vector<CANReceiveFilter> &filters)
+	{
+		return CANNetworkManager::CANNetwork.get_receive_filters(channelIndex, filters);
+	}
+
+	EventDispatcher<std::uint8_t> &get_receive_filters_changed_event_dispatcher_from_hardware()
+	{
+		return CANNetworkManager::CANNetwork.get_receive_filters_changed_event_dispatcher();
+	}
+
 	void CANNetworkManager::process_receive_can_message_frame(const CANMessageFrame &rxFrame)
+	{
+		CANNetworkManager::CANNetwork.on_can_frame_received(rxFrame);
+	}
+
+	void CANNetworkManager::on_can_frame_received(const CANMessageFrame &rxFrame)
 	{
 		CANMessage tempCANMessage(rxFrame.channel);
 
-		CANNetworkManager::CANNetwork.update_control_functions(rxFrame);
+		update_control_functions(rxFrame);
 
 		tempCANMessage.set_identifier(CANIdentifier(rxFrame.identifier));
 
-		tempCANMessage.set_source_control_function(CANNetworkManager::CANNetwork.get_control_function(rxFrame.channel, tempCANMessage.get_identifier().get_source_address()));
-		tempCANMessage.set_destination_control_function(CANNetworkManager::CANNetwork.get_control_function(rxFrame.channel, tempCANMessage.get_identifier().get_destination_address()));
+		tempCANMessage.set_source_control_function(get_control_function(rxFrame.channel, tempCANMessage.get_identifier().get_source_address()));
+		tempCANMessage.set_destination_control_function(get_control_function(rxFrame.channel, tempCANMessage.get_identifier().get_destination_address()));
 		tempCANMessage.set_data(rxFrame.data, rxFrame.dataLength);
+		tempCANMessage.set_timestamp_us(get_receive_timestamp_us(rxFrame));
 
-		CANNetworkManager::CANNetwork.update_busload(rxFrame.channel, rxFrame.get_number_bits_in_message());
+		update_busload(rxFrame.channel, rxFrame.get_number_bits_in_message());
+		trafficStatistics.record_frame(rxFrame);
 
-		CANNetworkManager::CANNetwork.receive_can_message(tempCANMessage);
+		receive_can_message(std::move(tempCANMessage));
+	}
+
+	std::uint64_t CANNetworkManager::get_receive_timestamp_us(const CANMessageFrame &rxFrame)
+	{
+		std::uint64_t retVal = SystemTiming::get_timestamp_us();
+
+		if ((0 != rxFrame.timestamp_us) &&
+		    (std::numeric_limits<std::uint64_t>::max() != rxFrame.timestamp_us) &&
+		    (rxFrame.channel < CAN_PORT_MAXIMUM))
+		{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+			// Frames for a channel can arrive from several threads, the same as for its receive queue
+			const std::lock_guard<std::mutex> lock(receiveQueueProducerMutexes[rxFrame.channel]);
+#endif
+			ReceiveTimestampSync &sync = receiveTimestampSync[rxFrame.channel];
+			const std::int64_t offset_us = static_cast<std::int64_t>(retVal - rxFrame.timestamp_us);
+
+			if ((retVal - sync.windowStart_us) >= RECEIVE_TIMESTAMP_WINDOW_US)
+			{
+				sync.previousWindowMinimumOffset_us = sync.currentWindowMinimumOffset_us;
+				sync.previousWindowValid = sync.currentWindowValid;
+				sync.currentWindowValid = false;
+				sync.windowStart_us = retVal;
+			}
+
+			if ((!sync.currentWindowValid) || (offset_us < sync.currentWindowMinimumOffset_us))
+			{
+				sync.currentWindowMinimumOffset_us = offset_us;
+				sync.currentWindowValid = true;
+			}
+
+			std::int64_t estimatedOffset_us = sync.currentWindowMinimumOffset_us;
+			if ((sync.previousWindowValid) && (sync.previousWindowMinimumOffset_us < estimatedOffset_us))
+			{
+				estimatedOffset_us = sync.previousWindowMinimumOffset_us;
+			}
+
+			const std::uint64_t convertedTimestamp_us = rxFrame.timestamp_us + static_cast<std::uint64_t>(estimatedOffset_us);
+
+			// Don't trust the conversion if it lands in the future or too far in the past, which can happen if the driver's clock jumps
+			if ((convertedTimestamp_us <= retVal) && ((retVal - convertedTimestamp_us) <= MAX_RECEIVE_TIMESTAMP_AGE_US))
+			{
+				retVal = convertedTimestamp_us;
+			}
+		}
+		return retVal;
 	}
 
 	void CANNetworkManager::process_transmitted_can_message_frame(const CANMessageFrame &txFrame)
 	{
-		CANNetworkManager::CANNetwork.update_busload(txFrame.channel, txFrame.get_number_bits_in_message());
+		CANNetworkManager::CANNetwork.on_can_frame_transmitted(txFrame);
+	}
+
+	void CANNetworkManager::on_can_frame_transmitted(const CANMessageFrame &txFrame)
+	{
+		update_busload(txFrame.channel, txFrame.get_number_bits_in_message());
+		trafficStatistics.record_frame(txFrame);
+	}
+
+	void CANNetworkManager::on_transmit_space_available(std::uint8_t channelIndex)
+	{
+		if (channelIndex < CAN_PORT_MAXIMUM)
+		{
+			// Counted before the flag is cleared, so a send that sets the flag afterwards sees the count change
+			transmitSpaceAvailableCounts[channelIndex]++;
+
+			if (transmitBlocked[channelIndex].exchange(false))
+			{
+				updateRequestedEventDispatcher.invoke();
+			}
+		}
+	}
+
+	bool CANNetworkManager::get_is_transmit_blocked(std::uint8_t channelIndex) const
+	{
+		bool retVal = false;
+
+		if (channelIndex < CAN_PORT_MAXIMUM)
+		{
+			retVal = transmitBlocked[channelIndex];
+		}
+		return retVal;
+	}
+
+	void CANNetworkManager::set_can_frame_transmit_callback(CANFrameTransmitCallback callback, void *parentPointer)
+	{
+		frameTransmitCallback = callback;
+		frameTransmitParent = parentPointer;
 	}
 
 	void CANNetworkManager::on_control_function_destroyed(std::shared_ptr<ControlFunction> controlFunction, CANLibBadge<ControlFunction>)
 	{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		const auto channelLocks = lock_all_channels();
+#endif
 		if (ControlFunction::Type::Internal == controlFunction->get_type())
 		{
 			internalControlFunctions.erase(std::remove(internalControlFunctions.begin(), internalControlFunctions.end(), controlFunction), internalControlFunctions.end());
@@ -299,10 +584,14 @@ namespace isobus
 			partneredControlFunctions.erase(std::remove(partneredControlFunctions.begin(), partneredControlFunctions.end(), controlFunction), partneredControlFunctions.end());
 		}
 
-		auto result = std::find(inactiveControlFunctions.begin(), inactiveControlFunctions.end(), controlFunction);
-		if (result != inactiveControlFunctions.end())
+		if (controlFunction->get_can_port() < CAN_PORT_MAXIMUM)
 		{
-			inactiveControlFunctions.erase(result);
+			auto &channelInactiveControlFunctions = inactiveControlFunctions[controlFunction->get_can_port()];
+			auto result = std::find(channelInactiveControlFunctions.begin(), channelInactiveControlFunctions.end(), controlFunction);
+			if (result != channelInactiveControlFunctions.end())
+			{
+				remove_inactive_control_function(result);
+			}
 		}
 
 		for (std::uint8_t i = 0; i < NULL_CAN_ADDRESS; i++)
@@ -319,12 +608,12 @@ namespace isobus
 					if (initialized)
 					{
 						// The control function was active, replace it with an new external control function
-						controlFunctionTable[controlFunction->get_can_port()][controlFunction->address] = ControlFunction::create(controlFunction->get_NAME(), controlFunction->get_address(), controlFunction->get_can_port());
+						set_control_function_table_entry(controlFunction->get_can_port(), controlFunction->address, ControlFunction::create(controlFunction->get_NAME(), controlFunction->get_address(), controlFunction->get_can_port(), *this));
 					}
 					else
 					{
 						// The network manager is not initialized yet, just remove the control function from the table
-						controlFunctionTable[controlFunction->get_can_port()][i] = nullptr;
+						set_control_function_table_entry(controlFunction->get_can_port(), i, nullptr);
 					}
 				}
 			}
@@ -339,11 +628,17 @@ namespace isobus
 
 	void CANNetworkManager::on_control_function_created(std::shared_ptr<ControlFunction> controlFunction, CANLibBadge<InternalControlFunction>)
 	{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		const auto channelLocks = lock_all_channels();
+#endif
 		on_control_function_created(controlFunction);
 	}
 
 	void CANNetworkManager::on_control_function_created(std::shared_ptr<ControlFunction> controlFunction, CANLibBadge<PartneredControlFunction>)
 	{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		const auto channelLocks = lock_all_channels();
+#endif
 		on_control_function_created(controlFunction);
 	}
 
@@ -402,7 +697,10 @@ namespace isobus
 
 		if (includingOffline)
 		{
-			retVal.insert(retVal.end(), inactiveControlFunctions.begin(), inactiveControlFunctions.end());
+			for (const auto &channelInactiveControlFunctions : inactiveControlFunctions)
+			{
+				retVal.insert(retVal.end(), channelInactiveControlFunctions.begin(), channelInactiveControlFunctions.end());
+			}
 		}
 
 		return retVal;
@@ -423,16 +721,197 @@ namespace isobus
 		return addressViolationEventDispatcher;
 	}
 
+	std::uint32_t CANNetworkManager::get_time_until_next_update_ms()
+	{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		const auto channelLocks = lock_all_channels();
+#endif
+		std::uint32_t retVal = std::numeric_limits<std::uint32_t>::max();
+
+		if (!initialized)
+		{
+			retVal = 0;
+		}
+
+		for (const auto &queue : receiveMessageQueues)
+		{
+			if ((nullptr != queue) && (!queue->empty()))
+			{
+				retVal = 0;
+			}
+		}
+
+		for (const auto &partner : partneredControlFunctions)
+		{
+			if (!partner->initialized)
+			{
+				retVal = 0;
+			}
+		}
+
+		for (const auto &internalControlFunction : internalControlFunctions)
+		{
+			retVal = std::min(retVal, internalControlFunction->get_time_until_address_claiming_update_ms({}));
+		}
+
+		for (const auto &timestamp_ms : lastAddressClaimRequestTimestamp_ms)
+		{
+			if (0 != timestamp_ms)
+			{
+				retVal = std::min(retVal, SystemTiming::get_time_remaining_ms(timestamp_ms, MAX_ADDRESS_CLAIM_RESOLUTION_TIME_MS));
+			}
+		}
+
+		for (const CANLibProtocol *currentProtocol : protocolList)
+		{
+			retVal = std::min(retVal, currentProtocol->get_time_until_next_update_ms());
+		}
+		retVal = std::min(retVal, trafficStatistics.get_time_until_next_update_ms());
+
+		// Keep the bus load history rolling until it has decayed back to zero, after that it only changes when frames are received
+		bool busloadHistoryActive = false;
+		{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+			const std::lock_guard<std::mutex> busloadLock(busloadUpdateMutex);
+#endif
+			for (std::size_t i = 0; i < CAN_PORT_MAXIMUM; i++)
+			{
+				if ((0 != currentBusloadBitAccumulator.at(i)) ||
+				    (std::any_of(busloadMessageBitsHistory.at(i).begin(), busloadMessageBitsHistory.at(i).end(), [](std::uint32_t bits) { return 0 != bits; })))
+				{
+					busloadHistoryActive = true;
+					break;
+				}
+			}
+		}
+
+		if (busloadHistoryActive)
+		{
+			retVal = std::min(retVal, SystemTiming::get_time_remaining_ms(busloadUpdateTimestamp_ms, BUSLOAD_UPDATE_FREQUENCY_MS));
+		}
+		return retVal;
+	}
+
+	EventDispatcher<> &CANNetworkManager::get_update_requested_event_dispatcher()
+	{
+		return updateRequestedEventDispatcher;
+	}
+
+	void CANNetworkManager::set_receive_filtering_enabled(bool enabled)
+	{
+		if (enabled != receiveFilteringEnabled.exchange(enabled))
+		{
+			for (auto &channelFiltersChanged : receiveFiltersChanged)
+			{
+				channelFiltersChanged = true;
+			}
+			updateRequestedEventDispatcher.invoke();
+		}
+	}
+
+	bool CANNetworkManager::get_receive_filtering_enabled() const
+	{
+		return receiveFilteringEnabled;
+	}
+
+	bool CANNetworkManager::get_receive_filters(std::uint8_t channelIndex, std::vector<CANReceiveFilter> &filters)
+	{
+		constexpr std::uint32_t PARAMETER_GROUP_NUMBER_MASK = 0x03FFFF00;
+		constexpr std::uint32_t DESTINATION_ADDRESS_MASK = 0x0000FF00;
+		constexpr std::uint32_t SOURCE_ADDRESS_MASK = 0x000000FF;
+		constexpr std::uint8_t PDU2_FORMAT_THRESHOLD = 0xF0;
+		bool retVal = false;
+
+		filters.clear();
+		if ((receiveFilteringEnabled) &&
+		    (!trafficStatistics.get_enabled()) &&
+		    (channelIndex < CAN_PORT_MAXIMUM))
+		{
+			std::vector<std::uint32_t> broadcastParameterGroupNumbers;
+			auto add_broadcast_parameter_group_numbers = [&broadcastParameterGroupNumbers](const ParameterGroupNumberCallbackTable &callbacks) {
+				for (std::size_t i = 0; i < callbacks.size(); i++)
+				{
+					const std::uint32_t parameterGroupNumber = callbacks[i].get_parameter_group_number();
+
+					if (((parameterGroupNumber >> 8) & 0xFF) >= PDU2_FORMAT_THRESHOLD)
+					{
+						broadcastParameterGroupNumbers.push_back(parameterGroupNumber);
+					}
+				}
+			};
+			// PDU1 PDU formats are 0x00 to 0xEF, which this covers with as few prefixes as possible
+			auto add_destination_filters = [&filters](std::uint8_t destinationAddress) {
+				constexpr std::array<std::pair<std::uint8_t, std::uint8_t>, 4> PDU1_FORMAT_PREFIXES = { { { 0x00, 0x80 }, { 0x80, 0xC0 }, { 0xC0, 0xE0 }, { 0xE0, 0xF0 } } };
+
+				for (const auto &prefix : PDU1_FORMAT_PREFIXES)
+				{
+					filters.push_back({ (static_cast<std::uint32_t>(prefix.first) << 16) | (static_cast<std::uint32_t>(destinationAddress) << 8),
+					                    (static_cast<std::uint32_t>(prefix.second) << 16) | DESTINATION_ADDRESS_MASK,
+					                    true });
+				}
+			};
+
+			{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+				const std::lock_guard<std::mutex> lock(protocolPGNCallbacksMutexes[channelIndex]);
+#endif
+				add_broadcast_parameter_group_numbers(protocolPGNCallbacks);
+			}
+			{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+				const std::lock_guard<std::mutex> lock(anyControlFunctionCallbacksMutexes[channelIndex]);
+#endif
+				add_broadcast_parameter_group_numbers(anyControlFunctionParameterGroupNumberCallbacks);
+			}
+			add_broadcast_parameter_group_numbers(globalParameterGroupNumberCallbacks);
+			std::sort(broadcastParameterGroupNumbers.begin(), broadcastParameterGroupNumbers.end());
+			broadcastParameterGroupNumbers.erase(std::unique(broadcastParameterGroupNumbers.begin(), broadcastParameterGroupNumbers.end()), broadcastParameterGroupNumbers.end());
+
+			// Everything sent to everyone covers address claiming, requests, and BAM sessions
+			add_destination_filters(BROADCAST_CAN_ADDRESS);
+			{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+				const std::lock_guard<std::mutex> lock(channelMutexes[channelIndex]);
+#endif
+				for (const auto &internalControlFunction : internalControlFunctions)
+				{
+					const std::uint8_t address = internalControlFunction->get_address();
+
+					if ((channelIndex == internalControlFunction->get_can_port()) &&
+					    (address < NULL_CAN_ADDRESS))
+					{
+						// Everything sent to us, and anything else sent from our address so we can spot address violations
+						add_destination_filters(address);
+						filters.push_back({ address, SOURCE_ADDRESS_MASK, true });
+					}
+				}
+			}
+
+			for (const auto parameterGroupNumber : broadcastParameterGroupNumbers)
+			{
+				filters.push_back({ parameterGroupNumber << 8, PARAMETER_GROUP_NUMBER_MASK, true });
+			}
+			retVal = true;
+		}
+		return retVal;
+	}
+
+	EventDispatcher<std::uint8_t> &CANNetworkManager::get_receive_filters_changed_event_dispatcher()
+	{
+		return receiveFiltersChangedEventDispatcher;
+	}
+
 	bool CANNetworkManager::add_protocol_parameter_group_number_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parentPointer)
 	{
 		bool retVal = false;
 		ParameterGroupNumberCallbackData callbackInfo(parameterGroupNumber, callback, parentPointer, nullptr);
 #if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		const std::lock_guard<std::mutex> lock(protocolPGNCallbacksMutex);
+		const ChannelMutexesLock lock(protocolPGNCallbacksMutexes);
 #endif
-		if ((nullptr != callback) && (protocolPGNCallbacks.end() == find(protocolPGNCallbacks.begin(), protocolPGNCallbacks.end(), callbackInfo)))
+		if ((nullptr != callback) && (!protocolPGNCallbacks.contains(callbackInfo)))
 		{
-			protocolPGNCallbacks.push_back(callbackInfo);
+			protocolPGNCallbacks.add(callbackInfo);
+			on_receive_filters_changed();
 			retVal = true;
 		}
 		return retVal;
@@ -443,27 +922,25 @@ namespace isobus
 		bool retVal = false;
 		ParameterGroupNumberCallbackData callbackInfo(parameterGroupNumber, callback, parentPointer, nullptr);
 #if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		const std::lock_guard<std::mutex> lock(protocolPGNCallbacksMutex);
+		const ChannelMutexesLock lock(protocolPGNCallbacksMutexes);
 #endif
 		if (nullptr != callback)
 		{
-			std::list<ParameterGroupNumberCallbackData>::iterator callbackLocation;
-			callbackLocation = find(protocolPGNCallbacks.begin(), protocolPGNCallbacks.end(), callbackInfo);
-
-			if (protocolPGNCallbacks.end() != callbackLocation)
-			{
-				protocolPGNCallbacks.erase(callbackLocation);
-				retVal = true;
-			}
+			retVal = protocolPGNCallbacks.remove(callbackInfo);
+			on_receive_filters_changed();
 		}
 		return retVal;
 	}
 
-	CANNetworkManager::CANNetworkManager()
+	CANNetworkManager::CANNetworkManager() :
+	  extendedTransportProtocol(*this),
+	  fastPacketProtocol(*this),
+	  transportProtocol(*this)
 	{
 		currentBusloadBitAccumulator.fill(0);
 		lastAddressClaimRequestTimestamp_ms.fill(0);
 		controlFunctionTable.fill({ nullptr });
+		inactiveControlFunctionClaims.fill({ nullptr });
 	}
 
 	void CANNetworkManager::update_address_table(const CANMessage &message)
@@ -481,7 +958,7 @@ namespace isobus
 				// Someone is at that spot in the table, but their address was stolen
 				// Need to evict them from the table and move them to the inactive list
 				targetControlFunction->address = NULL_CAN_ADDRESS;
-				inactiveControlFunctions.push_back(targetControlFunction);
+				add_inactive_control_function(targetControlFunction);
 				CANStackLogger::info("[NM]: %s CF '%016llx' is evicted from address '%d' on channel '%d', as their address is probably stolen.",
 				                     targetControlFunction->get_type_string().c_str(),
 				                     targetControlFunction->get_NAME().get_full_name(),
@@ -496,21 +973,19 @@ namespace isobus
 			}
 			else
 			{
-				// Look through all inactive CFs, maybe one of them has freshly claimed the address
-				for (auto currentControlFunction : inactiveControlFunctions)
+				// Maybe one of the inactive CFs has freshly claimed the address
+				auto claimingControlFunction = inactiveControlFunctionClaims[channelIndex][claimedAddress];
+				if ((nullptr != claimingControlFunction) &&
+				    (claimingControlFunction->get_address() == claimedAddress))
 				{
-					if ((currentControlFunction->get_address() == claimedAddress) &&
-					    (currentControlFunction->get_can_port() == channelIndex))
-					{
-						controlFunctionTable[channelIndex][claimedAddress] = currentControlFunction;
-						CANStackLogger::debug("[NM]: %s CF '%016llx' is now active at address '%d' on channel '%d'.",
-						                      currentControlFunction->get_type_string().c_str(),
-						                      currentControlFunction->get_NAME().get_full_name(),
-						                      claimedAddress,
-						                      channelIndex);
-						process_control_function_state_change_callback(currentControlFunction, ControlFunctionState::Online);
-						break;
-					}
+					inactiveControlFunctionClaims[channelIndex][claimedAddress] = nullptr;
+					set_control_function_table_entry(channelIndex, claimedAddress, claimingControlFunction);
+					CANStackLogger::debug("[NM]: %s CF '%016llx' is now active at address '%d' on channel '%d'.",
+					                      claimingControlFunction->get_type_string().c_str(),
+					                      claimingControlFunction->get_NAME().get_full_name(),
+					                      claimedAddress,
+					                      channelIndex);
+					process_control_function_state_change_callback(claimingControlFunction, ControlFunctionState::Online);
 				}
 			}
 		}
@@ -524,12 +999,9 @@ namespace isobus
 				lastAddressClaimRequestTimestamp_ms.at(channelIndex) = SystemTiming::get_timestamp_ms();
 
 				// Reset the claimedAddressSinceLastAddressClaimRequest flag for all control functions on the port
-				auto result = std::find_if(inactiveControlFunctions.begin(), inactiveControlFunctions.end(), [channelIndex](std::shared_ptr<ControlFunction> controlFunction) {
-					return (channelIndex == controlFunction->get_can_port());
-				});
-				if (result != inactiveControlFunctions.end())
+				if (!inactiveControlFunctions[channelIndex].empty())
 				{
-					(*result)->claimedAddressSinceLastAddressClaimRequest = true;
+					inactiveControlFunctions[channelIndex].front()->claimedAddressSinceLastAddressClaimRequest = true;
 				}
 				std::for_each(controlFunctionTable[channelIndex].begin(), controlFunctionTable[channelIndex].end(), [](std::shared_ptr<ControlFunction> controlFunction) {
 					if (nullptr != controlFunction)
@@ -541,13 +1013,13 @@ namespace isobus
 		}
 	}
 
-	void CANNetworkManager::update_internal_cfs()
+	void CANNetworkManager::update_internal_cfs(std::uint8_t channelIndex)
 	{
 		for (const auto &currentInternalControlFunction : internalControlFunctions)
 		{
-			if (currentInternalControlFunction->update_address_claiming({}))
+			if ((channelIndex == currentInternalControlFunction->get_can_port()) &&
+			    (currentInternalControlFunction->update_address_claiming({})))
 			{
-				std::uint8_t channelIndex = currentInternalControlFunction->get_can_port();
 				std::uint8_t claimedAddress = currentInternalControlFunction->get_address();
 
 				// Check if the internal control function switched addresses, and therefore needs to be moved in the table
@@ -555,7 +1027,7 @@ namespace isobus
 				{
 					if (controlFunctionTable[channelIndex][address] == currentInternalControlFunction)
 					{
-						controlFunctionTable[channelIndex][address] = nullptr;
+						set_control_function_table_entry(channelIndex, address, nullptr);
 						break;
 					}
 				}
@@ -565,11 +1037,11 @@ namespace isobus
 					// Someone is at that spot in the table, but their address was stolen by an internal control function
 					// Need to evict them from the table
 					controlFunctionTable[channelIndex][claimedAddress]->address = NULL_CAN_ADDRESS;
-					controlFunctionTable[channelIndex][claimedAddress] = nullptr;
+					set_control_function_table_entry(channelIndex, claimedAddress, nullptr);
 				}
 
 				// ECU has claimed since the last update, add it to the table
-				controlFunctionTable[channelIndex][claimedAddress] = currentInternalControlFunction;
+				set_control_function_table_entry(channelIndex, claimedAddress, currentInternalControlFunction);
 			}
 		}
 	}
@@ -577,7 +1049,7 @@ namespace isobus
 	void CANNetworkManager::update_busload(std::uint8_t channelIndex, std::uint32_t numberOfBitsProcessed)
 	{
 #if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		const std::lock_guard<std::mutex> lock(CANNetworkManager::CANNetwork.busloadUpdateMutex);
+		const std::lock_guard<std::mutex> lock(busloadUpdateMutex);
 #endif
 		currentBusloadBitAccumulator.at(channelIndex) += numberOfBitsProcessed;
 	}
@@ -609,6 +1081,9 @@ namespace isobus
 		    (CAN_DATA_LENGTH == rxFrame.dataLength) &&
 		    (rxFrame.channel < CAN_PORT_MAXIMUM))
 		{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+			const std::lock_guard<std::mutex> lock(channelMutexes[rxFrame.channel]);
+#endif
 			std::uint64_t claimedNAME;
 			std::shared_ptr<ControlFunction> foundControlFunction = nullptr;
 			uint8_t claimedAddress = CANIdentifier(rxFrame.identifier).get_source_address();
@@ -623,27 +1098,7 @@ namespace isobus
 			claimedNAME |= (static_cast<std::uint64_t>(rxFrame.data[7]) << 56);
 
 			// Check if the claimed NAME is someone we already know about
-			auto activeResult = std::find_if(controlFunctionTable[rxFrame.channel].begin(),
-			                                 controlFunctionTable[rxFrame.channel].end(),
-			                                 [claimedNAME](const std::shared_ptr<ControlFunction> &cf) {
-				                                 return (nullptr != cf) && (cf->controlFunctionNAME.get_full_name() == claimedNAME);
-			                                 });
-			if (activeResult != controlFunctionTable[rxFrame.channel].end())
-			{
-				foundControlFunction = *activeResult;
-			}
-			else
-			{
-				auto inActiveResult = std::find_if(inactiveControlFunctions.begin(),
-				                                   inactiveControlFunctions.end(),
-				                                   [claimedNAME, &rxFrame](const std::shared_ptr<ControlFunction> &cf) {
-					                                   return (cf->controlFunctionNAME.get_full_name() == claimedNAME) && (cf->get_can_port() == rxFrame.channel);
-				                                   });
-				if (inActiveResult != inactiveControlFunctions.end())
-				{
-					foundControlFunction = *inActiveResult;
-				}
-			}
+			foundControlFunction = find_control_function_by_name(rxFrame.channel, claimedNAME);
 
 			if (nullptr == foundControlFunction)
 			{
@@ -656,40 +1111,47 @@ namespace isobus
 					{
 						partner->controlFunctionNAME = NAME(claimedNAME);
 						foundControlFunction = partner;
-						controlFunctionTable[rxFrame.channel][claimedAddress] = foundControlFunction;
+						set_control_function_table_entry(rxFrame.channel, claimedAddress, foundControlFunction);
 						break;
 					}
 				}
 			}
 
-			// Remove any CF that has the same address as the one claiming
-			std::for_each(controlFunctionTable[rxFrame.channel].begin(),
-			              controlFunctionTable[rxFrame.channel].end(),
-			              [&foundControlFunction, &claimedAddress](const std::shared_ptr<ControlFunction> &cf) {
-				              if ((nullptr != cf) && (foundControlFunction != cf) && (cf->address == claimedAddress))
-					              cf->address = CANIdentifier::NULL_ADDRESS;
-			              });
-
-			std::for_each(inactiveControlFunctions.begin(),
-			              inactiveControlFunctions.end(),
-			              [&rxFrame, &foundControlFunction, &claimedAddress](const std::shared_ptr<ControlFunction> &cf) {
-				              if ((foundControlFunction != cf) && (cf->address == claimedAddress) && (cf->get_can_port() == rxFrame.channel))
-					              cf->address = CANIdentifier::NULL_ADDRESS;
-			              });
+			// Remove any CF that has the same address as the one claiming.
+			// Only the CF in that slot of the table, or an inactive CF waiting to be moved into it, can be holding the address.
+			auto currentHolder = controlFunctionTable[rxFrame.channel][claimedAddress];
+			if ((nullptr != currentHolder) && (foundControlFunction != currentHolder) && (currentHolder->address == claimedAddress))
+			{
+				currentHolder->address = CANIdentifier::NULL_ADDRESS;
+			}
+
+			currentHolder = inactiveControlFunctionClaims[rxFrame.channel][claimedAddress];
+			if ((nullptr != currentHolder) && (foundControlFunction != currentHolder))
+			{
+				if (currentHolder->address == claimedAddress)
+				{
+					currentHolder->address = CANIdentifier::NULL_ADDRESS;
+				}
+				inactiveControlFunctionClaims[rxFrame.channel][claimedAddress] = nullptr;
+			}
 
 			if (nullptr == foundControlFunction)
 			{
 				// New device, need to start keeping track of it
-				foundControlFunction = ControlFunction::create(NAME(claimedNAME), claimedAddress, rxFrame.channel);
-				controlFunctionTable[rxFrame.channel][foundControlFunction->get_address()] = foundControlFunction;
+				foundControlFunction = ControlFunction::create(NAME(claimedNAME), claimedAddress, rxFrame.channel, *this);
+				set_control_function_table_entry(rxFrame.channel, foundControlFunction->get_address(), foundControlFunction);
 				CANStackLogger::debug("[NM]: A control function claimed address %u on channel %u", foundControlFunction->get_address(), foundControlFunction->get_can_port());
 			}
 			else if (foundControlFunction->address != claimedAddress)
 			{
 				if (foundControlFunction->get_address_valid())
 				{
-					controlFunctionTable[rxFrame.channel][claimedAddress] = foundControlFunction;
-					controlFunctionTable[rxFrame.channel][foundControlFunction->get_address()] = nullptr;
+					if (foundControlFunction == inactiveControlFunctionClaims[rxFrame.channel][foundControlFunction->get_address()])
+					{
+						inactiveControlFunctionClaims[rxFrame.channel][foundControlFunction->get_address()] = nullptr;
+					}
+					set_control_function_table_entry(rxFrame.channel, claimedAddress, foundControlFunction);
+					set_control_function_table_entry(rxFrame.channel, foundControlFunction->get_address(), nullptr);
 					CANStackLogger::info("[NM]: The %s control function at address %d changed it's address to %d on channel %u.",
 					                     foundControlFunction->get_type_string().c_str(),
 					                     foundControlFunction->get_address(),
@@ -704,31 +1166,151 @@ namespace isobus
 					                     claimedAddress,
 					                     foundControlFunction->get_can_port());
 					process_control_function_state_change_callback(foundControlFunction, ControlFunctionState::Online);
+
+					auto indexEntry = controlFunctionNameIndex[rxFrame.channel].find(claimedNAME);
+					if ((indexEntry != controlFunctionNameIndex[rxFrame.channel].end()) &&
+					    (indexEntry->second.inactiveReferences > 0))
+					{
+						// The address table will pick it up from here once the claim is processed
+						inactiveControlFunctionClaims[rxFrame.channel][claimedAddress] = foundControlFunction;
+					}
 				}
 				foundControlFunction->address = claimedAddress;
 			}
 		}
 	}
 
-	void CANNetworkManager::update_new_partners()
+	std::shared_ptr<ControlFunction> CANNetworkManager::find_control_function_by_name(std::uint8_t channelIndex, std::uint64_t NAME) const
+	{
+		std::shared_ptr<ControlFunction> retVal = nullptr;
+
+		if (channelIndex < CAN_PORT_MAXIMUM)
+		{
+			auto result = controlFunctionNameIndex[channelIndex].find(NAME);
+			if (result != controlFunctionNameIndex[channelIndex].end())
+			{
+				retVal = result->second.controlFunction;
+			}
+		}
+		return retVal;
+	}
+
+	void CANNetworkManager::set_control_function_table_entry(std::uint8_t channelIndex, std::uint8_t address, std::shared_ptr<ControlFunction> controlFunction)
+	{
+		if ((channelIndex < CAN_PORT_MAXIMUM) && (address < NULL_CAN_ADDRESS))
+		{
+			std::shared_ptr<ControlFunction> &tableEntry = controlFunctionTable[channelIndex][address];
+
+			if (tableEntry != controlFunction)
+			{
+				if (nullptr != tableEntry)
+				{
+					remove_control_function_name_reference(tableEntry, false);
+				}
+				if (nullptr != controlFunction)
+				{
+					add_control_function_name_reference(controlFunction, false);
+				}
+				tableEntry = std::move(controlFunction);
+			}
+		}
+	}
+
+	void CANNetworkManager::add_inactive_control_function(std::shared_ptr<ControlFunction> controlFunction)
+	{
+		if (controlFunction->get_can_port() < CAN_PORT_MAXIMUM)
+		{
+			add_control_function_name_reference(controlFunction, true);
+			inactiveControlFunctions[controlFunction->get_can_port()].push_back(std::move(controlFunction));
+		}
+	}
+
+	std::list<std::shared_ptr<ControlFunction>>::iterator CANNetworkManager::remove_inactive_control_function(std::list<std::shared_ptr<ControlFunction>>::iterator position)
+	{
+		const std::shared_ptr<ControlFunction> &controlFunction = *position;
+		const std::uint8_t channelIndex = controlFunction->get_can_port();
+
+		// Only control functions on a valid channel are ever added to the inactive list
+		if ((controlFunction->get_address_valid()) &&
+		    (controlFunction == inactiveControlFunctionClaims[channelIndex][controlFunction->get_address()]))
+		{
+			inactiveControlFunctionClaims[channelIndex][controlFunction->get_address()] = nullptr;
+		}
+		remove_control_function_name_reference(controlFunction, true);
+		return inactiveControlFunctions[channelIndex].erase(position);
+	}
+
+	void CANNetworkManager::add_control_function_name_reference(const std::shared_ptr<ControlFunction> &controlFunction, bool inactive)
+	{
+		if (controlFunction->get_can_port() < CAN_PORT_MAXIMUM)
+		{
+			ControlFunctionNameIndexEntry &entry = controlFunctionNameIndex[controlFunction->get_can_port()][controlFunction->get_NAME().get_full_name()];
+
+			if (entry.controlFunction != controlFunction)
+			{
+				// A different CF with the same NAME is replaced, the newest one is the one that will be found
+				entry = ControlFunctionNameIndexEntry();
+				entry.controlFunction = controlFunction;
+			}
+
+			if (inactive)
+			{
+				entry.inactiveReferences++;
+			}
+			else
+			{
+				entry.tableReferences++;
+			}
+		}
+	}
+
+	void CANNetworkManager::remove_control_function_name_reference(const std::shared_ptr<ControlFunction> &controlFunction, bool inactive)
+	{
+		if (controlFunction->get_can_port() < CAN_PORT_MAXIMUM)
+		{
+			auto &nameIndex = controlFunctionNameIndex[controlFunction->get_can_port()];
+			auto result = nameIndex.find(controlFunction->get_NAME().get_full_name());
+
+			if ((result != nameIndex.end()) &&
+			    (result->second.controlFunction == controlFunction))
+			{
+				if ((inactive) && (result->second.inactiveReferences > 0))
+				{
+					result->second.inactiveReferences--;
+				}
+				else if ((!inactive) && (result->second.tableReferences > 0))
+				{
+					result->second.tableReferences--;
+				}
+
+				if ((0 == result->second.inactiveReferences) &&
+				    (0 == result->second.tableReferences))
+				{
+					nameIndex.erase(result);
+				}
+			}
+		}
+	}
+
+	void CANNetworkManager::update_new_partners(std::uint8_t channelIndex)
 	{
 		for (const auto &partner : partneredControlFunctions)
 		{
-			if (!partner->initialized)
+			if ((!partner->initialized) &&
+			    (channelIndex == partner->get_can_port()))
 			{
 				// Remove any inactive CF that matches the partner's name
-				for (auto currentInactiveControlFunction = inactiveControlFunctions.begin(); currentInactiveControlFunction != inactiveControlFunctions.end(); currentInactiveControlFunction++)
+				for (auto currentInactiveControlFunction = inactiveControlFunctions[channelIndex].begin(); currentInactiveControlFunction != inactiveControlFunctions[channelIndex].end(); currentInactiveControlFunction++)
 				{
 					if ((partner->check_matches_name((*currentInactiveControlFunction)->get_NAME())) &&
-					    (partner->get_can_port() == (*currentInactiveControlFunction)->get_can_port()) &&
 					    (ControlFunction::Type::External == (*currentInactiveControlFunction)->get_type()))
 					{
-						inactiveControlFunctions.erase(currentInactiveControlFunction);
+						remove_inactive_control_function(currentInactiveControlFunction);
 						break;
 					}
 				}
 
-				for (const auto &currentActiveControlFunction : controlFunctionTable[partner->get_can_port()])
+				for (const auto &currentActiveControlFunction : controlFunctionTable[channelIndex])
 				{
 					if ((nullptr != currentActiveControlFunction) &&
 					    (partner->check_matches_name(currentActiveControlFunction->get_NAME())) &&
@@ -744,7 +1326,7 @@ namespace isobus
 						partner->address = currentActiveControlFunction->get_address();
 						partner->controlFunctionNAME = currentActiveControlFunction->get_NAME();
 						partner->initialized = true;
-						controlFunctionTable[partner->get_can_port()][partner->address] = std::shared_ptr<ControlFunction>(partner);
+						set_control_function_table_entry(partner->get_can_port(), partner->address, std::shared_ptr<ControlFunction>(partner));
 						process_control_function_state_change_callback(partner, ControlFunctionState::Online);
 						break;
 					}
@@ -762,10 +1344,12 @@ namespace isobus
 	                                                   const void *data,
 	                                                   std::uint32_t size) const
 	{
-		CANMessageFrame txFrame;
+		CANMessageFrame txFrame = {};
 		txFrame.identifier = DEFAULT_IDENTIFIER;
+		const bool canFDEnabled = ((portIndex < CAN_PORT_MAXIMUM) && (configuration.get_can_fd_enabled(static_cast<std::uint8_t>(portIndex))));
+		const std::uint32_t maxFrameLength = canFDEnabled ? CAN_FD_DATA_LENGTH : CAN_DATA_LENGTH;
 
-		if ((NULL_CAN_ADDRESS != destAddress) && (priority <= static_cast<std::uint8_t>(CANIdentifier::CANPriority::PriorityLowest7)) && (size <= CAN_DATA_LENGTH) && (nullptr != data))
+		if ((NULL_CAN_ADDRESS != destAddress) && (priority <= static_cast<std::uint8_t>(CANIdentifier::CANPriority::PriorityLowest7)) && (size <= maxFrameLength) && (nullptr != data))
 		{
 			std::uint32_t identifier = 0;
 
@@ -808,6 +1392,17 @@ namespace isobus
 				memcpy(reinterpret_cast<void *>(txFrame.data), data, size);
 				txFrame.dataLength = size;
 				txFrame.isExtendedFrame = true;
+				txFrame.isFDFrame = false;
+				txFrame.isBitRateSwitch = false;
+
+				if (size > CAN_DATA_LENGTH)
+				{
+					// CAN FD only supports some lengths above 8 bytes, so pad up to the next one
+					txFrame.dataLength = CANMessageFrame::get_fd_frame_length(size);
+					memset(txFrame.data + size, 0xFF, txFrame.dataLength - size);
+					txFrame.isFDFrame = true;
+					txFrame.isBitRateSwitch = true;
+				}
 				txFrame.identifier = identifier & 0x1FFFFFFF;
 			}
 		}
@@ -825,24 +1420,6 @@ namespace isobus
 		return retVal;
 	}
 
-	CANMessage CANNetworkManager::get_next_can_message_from_rx_queue()
-	{
-#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		std::lock_guard<std::mutex> lock(receiveMessageMutex);
-#endif
-		CANMessage retVal = receiveMessageList.front();
-		receiveMessageList.pop_front();
-		return retVal;
-	}
-
-	std::size_t CANNetworkManager::get_number_can_messages_in_rx_queue()
-	{
-#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		std::lock_guard<std::mutex> lock(receiveMessageMutex);
-#endif
-		return receiveMessageList.size();
-	}
-
 	void CANNetworkManager::on_control_function_created(std::shared_ptr<ControlFunction> controlFunction)
 	{
 		if (ControlFunction::Type::Internal == controlFunction->get_type())
@@ -853,21 +1430,32 @@ namespace isobus
 		{
 			partneredControlFunctions.push_back(std::static_pointer_cast<PartneredControlFunction>(controlFunction));
 		}
+
+		if (ControlFunction::Type::External != controlFunction->get_type())
+		{
+			// Address claiming and partner matching run on the channel even if nothing has been received on it
+			if (controlFunction->get_can_port() < CAN_PORT_MAXIMUM)
+			{
+				channelsInUse[controlFunction->get_can_port()].store(true, std::memory_order_relaxed);
+			}
+
+			// Address claiming and partner matching should start right away
+			updateRequestedEventDispatcher.invoke();
+		}
 	}
 
 	void CANNetworkManager::process_any_control_function_pgn_callbacks(const CANMessage &currentMessage)
 	{
 #if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		const std::lock_guard<std::mutex> lock(anyControlFunctionCallbacksMutex);
+		// Messages on other channels can be dispatched at the same time, adding or removing a callback waits for all of them
+		const std::lock_guard<std::mutex> lock(anyControlFunctionCallbacksMutexes[currentMessage.get_can_port_index()]);
 #endif
-		for (const auto &currentCallback : anyControlFunctionParameterGroupNumberCallbacks)
+		if ((nullptr == currentMessage.get_destination_control_function()) ||
+		    (ControlFunction::Type::Internal == currentMessage.get_destination_control_function()->get_type()))
 		{
-			if ((currentCallback.get_parameter_group_number() == currentMessage.get_identifier().get_parameter_group_number()) &&
-			    ((nullptr == currentMessage.get_destination_control_function()) ||
-			     (ControlFunction::Type::Internal == currentMessage.get_destination_control_function()->get_type())))
-			{
-				currentCallback.get_callback()(currentMessage, currentCallback.get_parent());
-			}
+			anyControlFunctionParameterGroupNumberCallbacks.for_each_matching(currentMessage.get_identifier().get_parameter_group_number(), [&currentMessage](const ParameterGroupNumberCallbackData &currentCallback) {
+				currentCallback.invoke(currentMessage);
+			});
 		}
 	}
 
@@ -905,15 +1493,12 @@ namespace isobus
 	void CANNetworkManager::process_protocol_pgn_callbacks(const CANMessage &currentMessage)
 	{
 #if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		const std::lock_guard<std::mutex> lock(protocolPGNCallbacksMutex);
+		// Same as the "any CF" callbacks, only this channel's dispatch is blocked
+		const std::lock_guard<std::mutex> lock(protocolPGNCallbacksMutexes[currentMessage.get_can_port_index()]);
 #endif
-		for (const auto &currentCallback : protocolPGNCallbacks)
-		{
-			if (currentCallback.get_parameter_group_number() == currentMessage.get_identifier().get_parameter_group_number())
-			{
-				currentCallback.get_callback()(currentMessage, currentCallback.get_parent());
-			}
-		}
+		protocolPGNCallbacks.for_each_matching(currentMessage.get_identifier().get_parameter_group_number(), [&currentMessage](const ParameterGroupNumberCallbackData &currentCallback) {
+			currentCallback.get_callback()(currentMessage, currentCallback.get_parent());
+		});
 	}
 
 	void CANNetworkManager::process_can_message_for_global_and_partner_callbacks(const CANMessage &message)
@@ -925,15 +1510,13 @@ namespace isobus
 		      (NULL_CAN_ADDRESS == message.get_identifier().get_source_address()))))
 		{
 			// Message destined to global
-			for (std::size_t i = 0; i < get_number_global_parameter_group_number_callbacks(); i++)
-			{
-				if ((message.get_identifier().get_parameter_group_number() == get_global_parameter_group_number_callback(i).get_parameter_group_number()) &&
-				    (nullptr != get_global_parameter_group_number_callback(i).get_callback()))
+			globalParameterGroupNumberCallbacks.for_each_matching(message.get_identifier().get_parameter_group_number(), [&message](const ParameterGroupNumberCallbackData &callback) {
+				if (nullptr != callback.get_callback())
 				{
 					// We have a callback that matches this PGN
-					get_global_parameter_group_number_callback(i).get_callback()(message, get_global_parameter_group_number_callback(i).get_parent());
+					callback.invoke(message);
 				}
-			}
+			});
 		}
 		else if ((messageDestination != nullptr) && (messageDestination->get_type() == ControlFunction::Type::Internal))
 		{
@@ -944,17 +1527,15 @@ namespace isobus
 				    (partner->get_can_port() == message.get_can_port_index()))
 				{
 					// Message matches CAN port for a partnered control function
-					for (std::size_t k = 0; k < partner->get_number_parameter_group_number_callbacks(); k++)
-					{
-						if ((message.get_identifier().get_parameter_group_number() == partner->get_parameter_group_number_callback(k).get_parameter_group_number()) &&
-						    (nullptr != partner->get_parameter_group_number_callback(k).get_callback()) &&
-						    ((nullptr == partner->get_parameter_group_number_callback(k).get_internal_control_function()) ||
-						     (partner->get_parameter_group_number_callback(k).get_internal_control_function()->get_address() == message.get_identifier().get_destination_address())))
+					partner->parameterGroupNumberCallbacks.for_each_matching(message.get_identifier().get_parameter_group_number(), [&message](const ParameterGroupNumberCallbackData &callback) {
+						if ((nullptr != callback.get_callback()) &&
+						    ((nullptr == callback.get_internal_control_function()) ||
+						     (callback.get_internal_control_function()->get_address() == message.get_identifier().get_destination_address())))
 						{
 							// We have a callback matching this message
-							partner->get_parameter_group_number_callback(k).get_callback()(message, partner->get_parameter_group_number_callback(k).get_parent());
+							callback.invoke(message);
 						}
-					}
+					});
 				}
 			}
 		}
@@ -981,53 +1562,118 @@ namespace isobus
 		}
 	}
 
-	void CANNetworkManager::process_rx_messages()
+	void CANNetworkManager::process_rx_message(const CANMessage &currentMessage)
+	{
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+		const std::uint64_t dispatchTimestamp_us = SystemTiming::get_timestamp_us();
+		if (dispatchTimestamp_us >= currentMessage.get_timestamp_us())
+		{
+			instrumentation.get_receive_to_dispatch_latency().record(dispatchTimestamp_us - currentMessage.get_timestamp_us());
+		}
+#endif
+		update_address_table(currentMessage);
+		process_can_message_for_address_violations(currentMessage);
+
+		// Update Special Callbacks, like protocols and non-cf specific ones
+		process_protocol_pgn_callbacks(currentMessage);
+		process_any_control_function_pgn_callbacks(currentMessage);
+
+		// Update Others
+		process_can_message_for_global_and_partner_callbacks(currentMessage);
+	}
+
+	void CANNetworkManager::on_receive_filters_changed()
+	{
+		if (receiveFilteringEnabled)
+		{
+			for (auto &channelFiltersChanged : receiveFiltersChanged)
+			{
+				channelFiltersChanged = true;
+			}
+		}
+	}
+
+	void CANNetworkManager::update_receive_filter_addresses(std::uint8_t channelIndex)
+	{
+		if (receiveFilteringEnabled)
+		{
+			std::bitset<NULL_CAN_ADDRESS> addresses;
+
+			for (const auto &internalControlFunction : internalControlFunctions)
+			{
+				if ((channelIndex == internalControlFunction->get_can_port()) &&
+				    (internalControlFunction->get_address() < NULL_CAN_ADDRESS))
+				{
+					addresses.set(internalControlFunction->get_address());
+				}
+			}
+
+			if (addresses != receiveFilterAddresses[channelIndex])
+			{
+				receiveFilterAddresses[channelIndex] = addresses;
+				receiveFiltersChanged[channelIndex] = true;
+			}
+		}
+	}
+
+	void CANNetworkManager::update_receive_filters()
 	{
-		while (0 != get_number_can_messages_in_rx_queue())
+		const bool trafficStatisticsEnabled = trafficStatistics.get_enabled();
+
+		if (trafficStatisticsEnabled != receiveFiltersIncludeTrafficStatistics)
 		{
-			CANMessage currentMessage = get_next_can_message_from_rx_queue();
+			receiveFiltersIncludeTrafficStatistics = trafficStatisticsEnabled;
+			on_receive_filters_changed();
+		}
 
-			update_address_table(currentMessage);
-			process_can_message_for_address_violations(currentMessage);
+		for (std::uint8_t i = 0; i < CAN_PORT_MAXIMUM; i++)
+		{
+			if (receiveFiltersChanged[i].exchange(false))
+			{
+				receiveFiltersChangedEventDispatcher.call(i);
+			}
+		}
+	}
 
-			// Update Special Callbacks, like protocols and non-cf specific ones
-			process_protocol_pgn_callbacks(currentMessage);
-			process_any_control_function_pgn_callbacks(currentMessage);
+	void CANNetworkManager::process_rx_messages(std::uint8_t channelIndex)
+	{
+		// Only process what was queued when we started, so that a busy bus can't keep us here forever.
+		// Messages are processed in place, with queue space only released once per batch.
+		constexpr std::size_t MAX_MESSAGES_PER_BATCH = 32;
+		std::size_t messagesRemaining = (nullptr != receiveMessageQueues[channelIndex]) ? receiveMessageQueues[channelIndex]->size() : 0;
 
-			// Update Others
-			process_can_message_for_global_and_partner_callbacks(currentMessage);
+		while (0 != messagesRemaining)
+		{
+			messagesRemaining -= receiveMessageQueues[channelIndex]->consume([this](const CANMessage &currentMessage) { process_rx_message(currentMessage); },
+			                                                                 std::min(messagesRemaining, MAX_MESSAGES_PER_BATCH));
 		}
 	}
 
-	void CANNetworkManager::prune_inactive_control_functions()
+	void CANNetworkManager::prune_inactive_control_functions(std::uint8_t channelIndex)
 	{
-		for (std::uint_fast8_t channelIndex = 0; channelIndex < CAN_PORT_MAXIMUM; channelIndex++)
+		if ((0 != lastAddressClaimRequestTimestamp_ms.at(channelIndex)) &&
+		    (SystemTiming::time_expired_ms(lastAddressClaimRequestTimestamp_ms.at(channelIndex), MAX_ADDRESS_CLAIM_RESOLUTION_TIME_MS)))
 		{
-			constexpr std::uint32_t MAX_ADDRESS_CLAIM_RESOLUTION_TIME = 755; // This is 250ms + RTxD + 250ms
-			if ((0 != lastAddressClaimRequestTimestamp_ms.at(channelIndex)) &&
-			    (SystemTiming::time_expired_ms(lastAddressClaimRequestTimestamp_ms.at(channelIndex), MAX_ADDRESS_CLAIM_RESOLUTION_TIME)))
+			for (std::uint_fast8_t i = 0; i < NULL_CAN_ADDRESS; i++)
 			{
-				for (std::uint_fast8_t i = 0; i < NULL_CAN_ADDRESS; i++)
+				auto controlFunction = controlFunctionTable[channelIndex][i];
+				if ((nullptr != controlFunction) &&
+				    (!controlFunction->claimedAddressSinceLastAddressClaimRequest) &&
+				    (ControlFunction::Type::Internal != controlFunction->get_type()))
 				{
-					auto controlFunction = controlFunctionTable[channelIndex][i];
-					if ((nullptr != controlFunction) &&
-					    (!controlFunction->claimedAddressSinceLastAddressClaimRequest) &&
-					    (ControlFunction::Type::Internal != controlFunction->get_type()))
-					{
-						inactiveControlFunctions.push_back(controlFunction);
-						CANStackLogger::info("[NM]: Control function with address %u and NAME %016llx is now offline on channel %u.", controlFunction->get_address(), controlFunction->get_NAME(), channelIndex);
-						controlFunctionTable[channelIndex][i] = nullptr;
-						controlFunction->address = NULL_CAN_ADDRESS;
-						process_control_function_state_change_callback(controlFunction, ControlFunctionState::Offline);
-					}
-					else if ((nullptr != controlFunction) &&
-					         (!controlFunction->claimedAddressSinceLastAddressClaimRequest))
-					{
-						process_control_function_state_change_callback(controlFunction, ControlFunctionState::Offline);
-					}
+					add_inactive_control_function(controlFunction);
+					CANStackLogger::info("[NM]: Control function with address %u and NAME %016llx is now offline on channel %u.", controlFunction->get_address(), controlFunction->get_NAME(), channelIndex);
+					set_control_function_table_entry(channelIndex, i, nullptr);
+					controlFunction->address = NULL_CAN_ADDRESS;
+					process_control_function_state_change_callback(controlFunction, ControlFunctionState::Offline);
+				}
+				else if ((nullptr != controlFunction) &&
+				         (!controlFunction->claimedAddressSinceLastAddressClaimRequest))
+				{
+					process_control_function_state_change_callback(controlFunction, ControlFunctionState::Offline);
 				}
-				lastAddressClaimRequestTimestamp_ms.at(channelIndex) = 0;
 			}
+			lastAddressClaimRequestTimestamp_ms.at(channelIndex) = 0;
 		}
 	}
 
@@ -1039,10 +1685,42 @@ namespace isobus
 		if ((DEFAULT_IDENTIFIER != tempFrame.identifier) &&
 		    (portIndex < CAN_PORT_MAXIMUM))
 		{
-			retVal = send_can_message_frame_to_hardware(tempFrame);
+			if (nullptr != frameTransmitCallback)
+			{
+				retVal = frameTransmitCallback(tempFrame, frameTransmitParent);
+			}
+			else
+			{
+				const std::uint32_t spaceAvailableCount = transmitSpaceAvailableCounts[portIndex];
+				const CANTransmitResult result = try_send_can_message_frame_to_hardware(tempFrame);
+
+				// Remember a full queue so protocols can wait to be told about free space instead of retrying right away
+				transmitBlocked[portIndex] = (CANTransmitResult::WouldBlock == result);
+
+				// The hardware may have reported free space before the flag was set, in which case nobody would clear it
+				if ((CANTransmitResult::WouldBlock == result) &&
+				    (spaceAvailableCount != transmitSpaceAvailableCounts[portIndex]))
+				{
+					transmitBlocked[portIndex] = false;
+				}
+				retVal = (CANTransmitResult::Queued == result);
+			}
+		}
+		return retVal;
+	}
+
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+	std::array<std::unique_lock<std::mutex>, CAN_PORT_MAXIMUM> CANNetworkManager::lock_all_channels()
+	{
+		std::array<std::unique_lock<std::mutex>, CAN_PORT_MAXIMUM> retVal;
+
+		for (std::uint8_t i = 0; i < CAN_PORT_MAXIMUM; i++)
+		{
+			retVal[i] = std::unique_lock<std::mutex>(channelMutexes[i]);
 		}
 		return retVal;
 	}
+#endif
 
 	void CANNetworkManager::protocol_message_callback(const CANMessage &message)
 	{
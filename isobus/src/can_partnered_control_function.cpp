@@ -14,40 +14,36 @@
 #include "isobus/isobus/can_network_manager.hpp"
 
 #include <algorithm>
-#include <cassert>
 
 namespace isobus
 {
-	PartneredControlFunction::PartneredControlFunction(std::uint8_t CANPort, const std::vector<NAMEFilter> NAMEFilters, CANLibBadge<PartneredControlFunction>) :
-	  ControlFunction(NAME(0), NULL_CAN_ADDRESS, CANPort, Type::Partnered),
+	PartneredControlFunction::PartneredControlFunction(std::uint8_t CANPort, const std::vector<NAMEFilter> NAMEFilters, CANNetworkManager &networkManager, CANLibBadge<PartneredControlFunction>) :
+	  ControlFunction(NAME(0), NULL_CAN_ADDRESS, CANPort, networkManager, Type::Partnered),
 	  NAMEFilterList(NAMEFilters)
 	{
-#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		const std::lock_guard<std::mutex> lock(ControlFunction::controlFunctionProcessingMutex);
-#endif
 	}
 
 	std::shared_ptr<PartneredControlFunction> PartneredControlFunction::create(std::uint8_t CANPort, const std::vector<NAMEFilter> NAMEFilters)
+	{
+		return create(CANPort, NAMEFilters, CANNetworkManager::CANNetwork);
+	}
+
+	std::shared_ptr<PartneredControlFunction> PartneredControlFunction::create(std::uint8_t CANPort, const std::vector<NAMEFilter> NAMEFilters, CANNetworkManager &networkManager)
 	{
 		// Unfortunately, we can't use `std::make_shared` here because the constructor is meant to be protected
-		auto controlFunction = std::shared_ptr<PartneredControlFunction>(new PartneredControlFunction(CANPort, NAMEFilters, {}));
-		CANNetworkManager::CANNetwork.on_control_function_created(controlFunction, CANLibBadge<PartneredControlFunction>());
+		auto controlFunction = std::shared_ptr<PartneredControlFunction>(new PartneredControlFunction(CANPort, NAMEFilters, networkManager, {}));
+		networkManager.on_control_function_created(controlFunction, CANLibBadge<PartneredControlFunction>());
 		return controlFunction;
 	}
 
-	void PartneredControlFunction::add_parameter_group_number_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent, std::shared_ptr<InternalControlFunction> internalControlFunction)
+	void PartneredControlFunction::add_parameter_group_number_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent, std::shared_ptr<InternalControlFunction> internalControlFunction, CallbackExecutor *executor)
 	{
-		parameterGroupNumberCallbacks.emplace_back(parameterGroupNumber, callback, parent, internalControlFunction);
+		parameterGroupNumberCallbacks.add(ParameterGroupNumberCallbackData(parameterGroupNumber, callback, parent, internalControlFunction, executor));
 	}
 
 	void PartneredControlFunction::remove_parameter_group_number_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent, std::shared_ptr<InternalControlFunction> internalControlFunction)
 	{
-		ParameterGroupNumberCallbackData tempObject(parameterGroupNumber, callback, parent, internalControlFunction);
-		auto callbackLocation = std::find(parameterGroupNumberCallbacks.begin(), parameterGroupNumberCallbacks.end(), tempObject);
-		if (parameterGroupNumberCallbacks.end() != callbackLocation)
-		{
-			parameterGroupNumberCallbacks.erase(callbackLocation);
-		}
+		parameterGroupNumberCallbacks.remove(ParameterGroupNumberCallbackData(parameterGroupNumber, callback, parent, internalControlFunction));
 	}
 
 	std::size_t PartneredControlFunction::get_number_parameter_group_number_callbacks() const
@@ -173,10 +169,4 @@ namespace isobus
 		return retVal;
 	}
 
-	ParameterGroupNumberCallbackData &PartneredControlFunction::get_parameter_group_number_callback(std::size_t index)
-	{
-		assert(index < get_number_parameter_group_number_callbacks());
-		return parameterGroupNumberCallbacks[index];
-	}
-
 } // namespace isobus
@@ -16,18 +16,24 @@
 namespace isobus
 {
 	CANLibProtocol::CANLibProtocol() :
+	  CANLibProtocol(CANNetworkManager::CANNetwork)
+	{
+	}
+
+	CANLibProtocol::CANLibProtocol(CANNetworkManager &networkManager) :
+	  networkManager(networkManager),
 	  initialized(false)
 	{
-		CANNetworkManager::CANNetwork.protocolList.push_back(this);
+		networkManager.protocolList.push_back(this);
 	}
 
 	CANLibProtocol::~CANLibProtocol()
 	{
-		auto protocolLocation = find(CANNetworkManager::CANNetwork.protocolList.begin(), CANNetworkManager::CANNetwork.protocolList.end(), this);
+		auto protocolLocation = find(networkManager.protocolList.begin(), networkManager.protocolList.end(), this);
 
-		if (CANNetworkManager::CANNetwork.protocolList.end() != protocolLocation)
+		if (networkManager.protocolList.end() != protocolLocation)
 		{
-			CANNetworkManager::CANNetwork.protocolList.erase(protocolLocation);
+			networkManager.protocolList.erase(protocolLocation);
 		}
 	}
 
@@ -52,9 +58,72 @@ namespace isobus
 		return CANNetworkManager::CANNetwork.protocolList.size();
 	}
 
+	bool CANLibProtocol::protocol_transmit_shared_message(std::uint32_t parameterGroupNumber,
+	                                                      std::shared_ptr<const std::uint8_t> data,
+	                                                      std::uint32_t messageLength,
+	                                                      std::shared_ptr<ControlFunction> source,
+	                                                      std::shared_ptr<ControlFunction> destination,
+	                                                      TransmitCompleteCallback transmitCompleteCallback,
+	                                                      void *parentPointer)
+	{
+		return protocol_transmit_message(parameterGroupNumber, data.get(), messageLength, source, destination, transmitCompleteCallback, parentPointer, nullptr);
+	}
+
+	std::uint32_t CANLibProtocol::get_time_until_next_update_ms() const
+	{
+		return 0;
+	}
+
 	void CANLibProtocol::initialize(CANLibBadge<CANNetworkManager>)
 	{
 		initialized = true;
 	}
 
+	void CANLibProtocol::update(CANLibBadge<CANNetworkManager>)
+	{
+	}
+
+	void CANLibProtocol::update_channel(std::uint8_t, CANLibBadge<CANNetworkManager>)
+	{
+	}
+
+	ProtocolSessionKey::ProtocolSessionKey(std::shared_ptr<ControlFunction> source, std::shared_ptr<ControlFunction> destination) :
+	  source(source.get()),
+	  destination(destination.get())
+	{
+	}
+
+	ProtocolSessionKey::ProtocolSessionKey(std::shared_ptr<ControlFunction> source, std::shared_ptr<ControlFunction> destination, std::uint32_t parameterGroupNumber) :
+	  source(source.get()),
+	  destination(destination.get()),
+	  parameterGroupNumber(parameterGroupNumber)
+	{
+	}
+
+	bool ProtocolSessionKey::operator==(const ProtocolSessionKey &other) const
+	{
+		return ((source == other.source) &&
+		        (destination == other.destination) &&
+		        (parameterGroupNumber == other.parameterGroupNumber));
+	}
+
+	std::size_t ProtocolSessionKey::get_hash() const
+	{
+		std::size_t retVal = reinterpret_cast<std::uintptr_t>(source);
+
+		retVal = (retVal * 31) ^ reinterpret_cast<std::uintptr_t>(destination);
+		retVal = (retVal * 31) ^ parameterGroupNumber;
+
+		// Pointers are aligned, so mix the upper bits into the lower bits that pick a hash table bucket
+		retVal ^= (retVal >> 16);
+		retVal *= 0x45D9F3B;
+		retVal ^= (retVal >> 16);
+		return retVal;
+	}
+
+	std::size_t ProtocolSessionKeyHash::operator()(const ProtocolSessionKey &key) const
+	{
+		return key.get_hash();
+	}
+
 } // namespace isobus
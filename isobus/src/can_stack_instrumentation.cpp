@@ -0,0 +1,68 @@
+//================================================================================================
+/// @file can_stack_instrumentation.cpp
+///
+/// @brief Latency histograms and queue high-water marks for the inside of the CAN stack.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+
+#include "isobus/isobus/can_stack_instrumentation.hpp"
+
+namespace isobus
+{
+	LatencyHistogram &CANStackInstrumentation::get_receive_to_dispatch_latency()
+	{
+		return receiveToDispatchLatency;
+	}
+
+	LatencyHistogram &CANStackInstrumentation::get_update_duration()
+	{
+		return updateDuration;
+	}
+
+	LatencyHistogram &CANStackInstrumentation::get_transport_session_duration()
+	{
+		return transportSessionDuration;
+	}
+
+	void CANStackInstrumentation::record_queue_depth(Queue queue, std::uint8_t channelIndex, std::size_t depth)
+	{
+		if ((queue < Queue::NumberOfQueues) && (channelIndex < CAN_PORT_MAXIMUM))
+		{
+			std::atomic<std::size_t> &highWaterMark = queueHighWaterMarks[static_cast<std::size_t>(queue)][channelIndex];
+			std::size_t currentHighWaterMark = highWaterMark.load(std::memory_order_relaxed);
+
+			while ((depth > currentHighWaterMark) &&
+			       (!highWaterMark.compare_exchange_weak(currentHighWaterMark, depth, std::memory_order_relaxed)))
+			{
+			}
+		}
+	}
+
+	std::size_t CANStackInstrumentation::get_queue_high_water_mark(Queue queue, std::uint8_t channelIndex) const
+	{
+		std::size_t retVal = 0;
+
+		if ((queue < Queue::NumberOfQueues) && (channelIndex < CAN_PORT_MAXIMUM))
+		{
+			retVal = queueHighWaterMarks[static_cast<std::size_t>(queue)][channelIndex].load(std::memory_order_relaxed);
+		}
+		return retVal;
+	}
+
+	void CANStackInstrumentation::reset()
+	{
+		receiveToDispatchLatency.reset();
+		updateDuration.reset();
+		transportSessionDuration.reset();
+
+		for (auto &channelHighWaterMarks : queueHighWaterMarks)
+		{
+			for (auto &highWaterMark : channelHighWaterMarks)
+			{
+				highWaterMark = 0;
+			}
+		}
+	}
+} // namespace isobus
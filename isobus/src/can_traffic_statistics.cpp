@@ -0,0 +1,238 @@
+//================================================================================================
+/// @file can_traffic_statistics.cpp
+///
+/// @brief Tracks how much bus traffic each source address sends with each PGN.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+
+#include "isobus/isobus/can_traffic_statistics.hpp"
+#include "isobus/isobus/can_identifier.hpp"
+#include "isobus/utility/system_timing.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace isobus
+{
+	CANTrafficStatistics::CANTrafficStatistics(std::size_t capacity)
+	{
+		std::size_t numberOfSlots = 1;
+
+		while (numberOfSlots < capacity)
+		{
+			numberOfSlots <<= 1;
+		}
+		slots.reset(new Slot[numberOfSlots]());
+		capacityMask = numberOfSlots - 1;
+	}
+
+	void CANTrafficStatistics::set_enabled(bool enabled)
+	{
+		if ((enabled) && (!recordingEnabled))
+		{
+			windowStartTimestamp_ms = SystemTiming::get_timestamp_ms();
+		}
+		recordingEnabled = enabled;
+	}
+
+	bool CANTrafficStatistics::get_enabled() const
+	{
+		return recordingEnabled;
+	}
+
+	void CANTrafficStatistics::record_frame(const CANMessageFrame &frame)
+	{
+		if (recordingEnabled.load(std::memory_order_relaxed))
+		{
+			const CANIdentifier identifier(frame.identifier);
+			Slot *slot = find_or_claim_slot(make_key(frame.channel, identifier.get_parameter_group_number(), identifier.get_source_address()));
+
+			if (nullptr != slot)
+			{
+				slot->totalFrames.fetch_add(1, std::memory_order_relaxed);
+				slot->totalBytes.fetch_add(frame.dataLength, std::memory_order_relaxed);
+				slot->totalBits.fetch_add(frame.get_number_bits_in_message(), std::memory_order_relaxed);
+			}
+			else
+			{
+				untrackedFrames.fetch_add(1, std::memory_order_relaxed);
+			}
+		}
+	}
+
+	void CANTrafficStatistics::update()
+	{
+		if (recordingEnabled)
+		{
+			const std::uint32_t currentTimestamp_ms = SystemTiming::get_timestamp_ms();
+			const std::uint32_t windowLength_ms = currentTimestamp_ms - windowStartTimestamp_ms;
+
+			if (windowLength_ms >= RATE_WINDOW_MS)
+			{
+				const auto get_rate = [windowLength_ms](std::uint64_t count) {
+					const std::uint64_t rate = (count * 1000) / windowLength_ms;
+					return static_cast<std::uint32_t>(std::min<std::uint64_t>(rate, std::numeric_limits<std::uint32_t>::max()));
+				};
+
+				for (std::size_t i = 0; i <= capacityMask; i++)
+				{
+					Slot &slot = slots[i];
+
+					if (0 != slot.key.load(std::memory_order_acquire))
+					{
+						const std::uint64_t frames = slot.totalFrames.load(std::memory_order_relaxed);
+						const std::uint64_t bytes = slot.totalBytes.load(std::memory_order_relaxed);
+						const std::uint64_t bits = slot.totalBits.load(std::memory_order_relaxed);
+
+						slot.framesPerSecond.store(get_rate(frames - slot.windowStartFrames), std::memory_order_relaxed);
+						slot.bytesPerSecond.store(get_rate(bytes - slot.windowStartBytes), std::memory_order_relaxed);
+						slot.bitsPerSecond.store(get_rate(bits - slot.windowStartBits), std::memory_order_relaxed);
+						slot.windowStartFrames = frames;
+						slot.windowStartBytes = bytes;
+						slot.windowStartBits = bits;
+					}
+				}
+				windowStartTimestamp_ms = currentTimestamp_ms;
+			}
+		}
+	}
+
+	std::uint32_t CANTrafficStatistics::get_time_until_next_update_ms() const
+	{
+		std::uint32_t retVal = std::numeric_limits<std::uint32_t>::max();
+
+		if (recordingEnabled)
+		{
+			retVal = SystemTiming::get_time_remaining_ms(windowStartTimestamp_ms, RATE_WINDOW_MS);
+		}
+		return retVal;
+	}
+
+	std::vector<CANTrafficStatistics::Entry> CANTrafficStatistics::get_snapshot() const
+	{
+		std::vector<Entry> retVal;
+
+		for (std::size_t i = 0; i <= capacityMask; i++)
+		{
+			const std::uint64_t key = slots[i].key.load(std::memory_order_acquire);
+
+			if (0 != key)
+			{
+				retVal.push_back(read_slot(slots[i], key));
+			}
+		}
+		return retVal;
+	}
+
+	std::vector<CANTrafficStatistics::Entry> CANTrafficStatistics::get_top_entries(std::size_t numberOfEntries, Metric metric) const
+	{
+		std::vector<Entry> retVal = get_snapshot();
+		const auto get_value = [metric](const Entry &entry) {
+			std::uint32_t value = 0;
+
+			switch (metric)
+			{
+				case Metric::FramesPerSecond:
+				{
+					value = entry.framesPerSecond;
+				}
+				break;
+
+				case Metric::BytesPerSecond:
+				{
+					value = entry.bytesPerSecond;
+				}
+				break;
+
+				case Metric::BitsPerSecond:
+				{
+					value = entry.bitsPerSecond;
+				}
+				break;
+			}
+			return value;
+		};
+
+		numberOfEntries = std::min(numberOfEntries, retVal.size());
+		std::partial_sort(retVal.begin(), retVal.begin() + numberOfEntries, retVal.end(), [&get_value](const Entry &first, const Entry &second) {
+			return get_value(first) > get_value(second);
+		});
+		retVal.resize(numberOfEntries);
+		return retVal;
+	}
+
+	std::uint64_t CANTrafficStatistics::get_number_untracked_frames() const
+	{
+		return untrackedFrames;
+	}
+
+	void CANTrafficStatistics::reset()
+	{
+		for (std::size_t i = 0; i <= capacityMask; i++)
+		{
+			Slot &slot = slots[i];
+			slot.totalFrames = 0;
+			slot.totalBytes = 0;
+			slot.totalBits = 0;
+			slot.framesPerSecond = 0;
+			slot.bytesPerSecond = 0;
+			slot.bitsPerSecond = 0;
+			slot.windowStartFrames = 0;
+			slot.windowStartBytes = 0;
+			slot.windowStartBits = 0;
+		}
+		untrackedFrames = 0;
+		windowStartTimestamp_ms = SystemTiming::get_timestamp_ms();
+	}
+
+	std::uint64_t CANTrafficStatistics::make_key(std::uint8_t channel, std::uint32_t parameterGroupNumber, std::uint8_t sourceAddress)
+	{
+		return (KEY_IN_USE_BIT |
+		        (static_cast<std::uint64_t>(channel) << 32) |
+		        (static_cast<std::uint64_t>(parameterGroupNumber) << 8) |
+		        sourceAddress);
+	}
+
+	CANTrafficStatistics::Slot *CANTrafficStatistics::find_or_claim_slot(std::uint64_t key)
+	{
+		// Multiplicative hashing spreads out keys that only differ in the source address or low PGN bits
+		std::size_t index = static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32) & capacityMask;
+
+		for (std::size_t probes = 0; probes <= capacityMask; probes++)
+		{
+			Slot &slot = slots[index];
+			std::uint64_t slotKey = slot.key.load(std::memory_order_acquire);
+
+			// If another thread claims the free slot first, slotKey is updated to the key it claimed it with
+			if ((0 == slotKey) &&
+			    (slot.key.compare_exchange_strong(slotKey, key, std::memory_order_acq_rel)))
+			{
+				return &slot;
+			}
+
+			if (key == slotKey)
+			{
+				return &slot;
+			}
+			index = (index + 1) & capacityMask;
+		}
+		return nullptr;
+	}
+
+	CANTrafficStatistics::Entry CANTrafficStatistics::read_slot(const Slot &slot, std::uint64_t key)
+	{
+		Entry retVal;
+		retVal.channel = static_cast<std::uint8_t>((key >> 32) & 0xFF);
+		retVal.parameterGroupNumber = static_cast<std::uint32_t>((key >> 8) & 0x3FFFF);
+		retVal.sourceAddress = static_cast<std::uint8_t>(key & 0xFF);
+		retVal.totalFrames = slot.totalFrames.load(std::memory_order_relaxed);
+		retVal.totalBytes = slot.totalBytes.load(std::memory_order_relaxed);
+		retVal.totalBits = slot.totalBits.load(std::memory_order_relaxed);
+		retVal.framesPerSecond = slot.framesPerSecond.load(std::memory_order_relaxed);
+		retVal.bytesPerSecond = slot.bytesPerSecond.load(std::memory_order_relaxed);
+		retVal.bitsPerSecond = slot.bitsPerSecond.load(std::memory_order_relaxed);
+		return retVal;
+	}
+} // namespace isobus
@@ -18,6 +18,9 @@
 #include "isobus/utility/to_string.hpp"
 
 #include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
 
 namespace isobus
 {
@@ -25,6 +28,9 @@ namespace isobus
 	  sessionMessage(canPortIndex),
 	  sessionDirection(sessionDirection)
 	{
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+		startTimestamp_us = SystemTiming::get_timestamp_us();
+#endif
 	}
 
 	bool TransportProtocolManager::TransportProtocolSession::operator==(const TransportProtocolSession &obj)
@@ -43,6 +49,11 @@ namespace isobus
 		return sessionMessage.get_data_length();
 	}
 
+	TransportProtocolManager::TransportProtocolManager(CANNetworkManager &networkManager) :
+	  CANLibProtocol(networkManager)
+	{
+	}
+
 	TransportProtocolManager::~TransportProtocolManager()
 	{
 		// No need to clean up, as this object is a member of the network manager
@@ -54,8 +65,8 @@ namespace isobus
 		if (!initialized)
 		{
 			initialized = true;
-			CANNetworkManager::CANNetwork.add_protocol_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolCommand), process_message, this);
-			CANNetworkManager::CANNetwork.add_protocol_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolData), process_message, this);
+			networkManager.add_protocol_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolCommand), process_message, this);
+			networkManager.add_protocol_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolData), process_message, this);
 		}
 	}
 
@@ -63,7 +74,7 @@ namespace isobus
 	{
 		if ((nullptr != message.get_source_control_function()) &&
 		    ((nullptr == message.get_destination_control_function()) ||
-		     (nullptr != CANNetworkManager::CANNetwork.get_internal_control_function(message.get_destination_control_function()))))
+		     (nullptr != networkManager.get_internal_control_function(message.get_destination_control_function()))))
 		{
 			switch (message.get_identifier().get_parameter_group_number())
 			{
@@ -78,20 +89,23 @@ namespace isobus
 						{
 							if (CAN_DATA_LENGTH == message.get_data_length())
 							{
+								TransportProtocolSession *newSession = nullptr;
+
 								if ((nullptr == message.get_destination_control_function()) &&
-								    (activeSessions.size() < CANNetworkManager::CANNetwork.get_configuration().get_max_number_transport_protocol_sessions()) &&
-								    (!get_session(session, message.get_source_control_function(), message.get_destination_control_function(), pgn)))
+								    (!get_session(session, message.get_source_control_function(), message.get_destination_control_function())))
+								{
+									newSession = create_session(TransportProtocolSession::Direction::Receive, message.get_source_control_function(), nullptr);
+								}
+
+								if (nullptr != newSession)
 								{
-									TransportProtocolSession *newSession = new TransportProtocolSession(TransportProtocolSession::Direction::Receive, message.get_can_port_index());
 									CANIdentifier tempIdentifierData(CANIdentifier::Type::Extended, pgn, CANIdentifier::CANPriority::PriorityLowest7, BROADCAST_CAN_ADDRESS, message.get_source_control_function()->get_address());
 									newSession->sessionMessage.set_data_size(static_cast<std::uint16_t>(data[1]) | static_cast<std::uint16_t>(data[2] << 8));
-									newSession->sessionMessage.set_source_control_function(message.get_source_control_function());
-									newSession->sessionMessage.set_destination_control_function(nullptr);
 									newSession->packetCount = data[3];
 									newSession->sessionMessage.set_identifier(tempIdentifierData);
 									newSession->state = StateMachineState::RxDataSession;
-									newSession->timestamp_ms = SystemTiming::get_timestamp_ms();
-									activeSessions.push_back(newSession);
+									newSession->sessionMessage.set_timestamp_us(message.get_timestamp_us());
+									newSession->timestamp_ms = message.get_timestamp_ms();
 									CANStackLogger::CAN_stack_log(CANStackLogger::LoggingLevel::Debug,
 									                              "[TP]: New Rx BAM Session. Source: " +
 									                                isobus::to_string(static_cast<int>(newSession->sessionMessage.get_source_control_function()->get_address())));
@@ -114,30 +128,33 @@ namespace isobus
 						{
 							if (CAN_DATA_LENGTH == message.get_data_length())
 							{
+								TransportProtocolSession *newSession = nullptr;
+
 								if ((nullptr != message.get_destination_control_function()) &&
-								    (activeSessions.size() < CANNetworkManager::CANNetwork.get_configuration().get_max_number_transport_protocol_sessions()) &&
-								    (!get_session(session, message.get_source_control_function(), message.get_destination_control_function(), pgn)))
+								    (!get_session(session, message.get_source_control_function(), message.get_destination_control_function())))
+								{
+									newSession = create_session(TransportProtocolSession::Direction::Receive, message.get_source_control_function(), message.get_destination_control_function());
+								}
+
+								if (nullptr != newSession)
 								{
-									TransportProtocolSession *newSession = new TransportProtocolSession(TransportProtocolSession::Direction::Receive, message.get_can_port_index());
 									CANIdentifier tempIdentifierData(CANIdentifier::Type::Extended, pgn, CANIdentifier::CANPriority::PriorityLowest7, message.get_destination_control_function()->get_address(), message.get_source_control_function()->get_address());
 									newSession->sessionMessage.set_data_size(static_cast<std::uint16_t>(data[1]) | static_cast<std::uint16_t>(data[2] << 8));
-									newSession->sessionMessage.set_source_control_function(message.get_source_control_function());
-									newSession->sessionMessage.set_destination_control_function(message.get_destination_control_function());
 									newSession->packetCount = data[3];
 									newSession->clearToSendPacketMax = data[4];
 									newSession->sessionMessage.set_identifier(tempIdentifierData);
 									newSession->state = StateMachineState::ClearToSend;
-									newSession->timestamp_ms = SystemTiming::get_timestamp_ms();
-									activeSessions.push_back(newSession);
+									newSession->sessionMessage.set_timestamp_us(message.get_timestamp_us());
+									newSession->timestamp_ms = message.get_timestamp_ms();
 								}
-								else if ((get_session(session, message.get_source_control_function(), message.get_destination_control_function(), pgn)) &&
+								else if ((get_session(session, message.get_source_control_function(), message.get_destination_control_function())) &&
 								         (nullptr != message.get_destination_control_function()) &&
 								         (ControlFunction::Type::Internal == message.get_destination_control_function()->get_type()))
 								{
 									abort_session(pgn, ConnectionAbortReason::AlreadyInCMSession, std::static_pointer_cast<InternalControlFunction>(message.get_destination_control_function()), message.get_source_control_function());
 									CANStackLogger::CAN_stack_log(CANStackLogger::LoggingLevel::Error, "[TP]: Sent abort, RTS when already in CM session");
 								}
-								else if ((activeSessions.size() >= CANNetworkManager::CANNetwork.get_configuration().get_max_number_transport_protocol_sessions()) &&
+								else if ((activeSessions[message.get_can_port_index()].size() >= networkManager.get_configuration().get_max_number_transport_protocol_sessions()) &&
 								         (nullptr != message.get_destination_control_function()) &&
 								         (ControlFunction::Type::Internal == message.get_destination_control_function()->get_type()))
 								{
@@ -167,7 +184,7 @@ namespace isobus
 									if (StateMachineState::WaitForClearToSend == session->state)
 									{
 										session->packetCount = packetsToBeSent;
-										session->timestamp_ms = SystemTiming::get_timestamp_ms();
+										session->timestamp_ms = message.get_timestamp_ms();
 										// If 0 was sent as the packet number, they want us to wait.
 										// Just sit here in this state until we get a non-zero packet count
 										if (0 != packetsToBeSent)
@@ -268,13 +285,12 @@ namespace isobus
 						// Check for valid sequence number
 						if (message.get_data()[SEQUENCE_NUMBER_DATA_INDEX] == (tempSession->lastPacketNumber + 1))
 						{
-							for (std::uint8_t i = SEQUENCE_NUMBER_DATA_INDEX; (i < PROTOCOL_BYTES_PER_FRAME) && (static_cast<std::uint32_t>((PROTOCOL_BYTES_PER_FRAME * tempSession->lastPacketNumber) + i) < tempSession->get_message_data_length()); i++)
-							{
-								std::uint16_t currentDataIndex = (PROTOCOL_BYTES_PER_FRAME * tempSession->lastPacketNumber) + i;
-								tempSession->sessionMessage.set_data(message.get_data()[1 + SEQUENCE_NUMBER_DATA_INDEX + i], currentDataIndex);
-							}
+							// Copy the whole payload at once, the message drops any padding past the end of the data
+							tempSession->sessionMessage.set_data(message.get_data().data() + 1 + SEQUENCE_NUMBER_DATA_INDEX, PROTOCOL_BYTES_PER_FRAME, PROTOCOL_BYTES_PER_FRAME * tempSession->lastPacketNumber);
 							tempSession->lastPacketNumber++;
 							tempSession->processedPacketsThisSession++;
+							tempSession->sessionMessage.set_timestamp_us(message.get_timestamp_us());
+							tempSession->timestamp_ms = message.get_timestamp_ms();
 							if ((tempSession->lastPacketNumber * PROTOCOL_BYTES_PER_FRAME) >= tempSession->get_message_data_length())
 							{
 								// Send EOM Ack for CM sessions only
@@ -282,11 +298,10 @@ namespace isobus
 								{
 									send_end_of_session_acknowledgement(tempSession);
 								}
-								CANNetworkManager::CANNetwork.process_any_control_function_pgn_callbacks(tempSession->sessionMessage);
-								CANNetworkManager::CANNetwork.protocol_message_callback(tempSession->sessionMessage);
+								networkManager.process_any_control_function_pgn_callbacks(tempSession->sessionMessage);
+								networkManager.protocol_message_callback(tempSession->sessionMessage);
 								close_session(tempSession, true);
 							}
-							tempSession->timestamp_ms = SystemTiming::get_timestamp_ms();
 						}
 						else if (message.get_data()[SEQUENCE_NUMBER_DATA_INDEX] == (tempSession->lastPacketNumber))
 						{
@@ -342,82 +357,131 @@ namespace isobus
 	                                                         void *parentPointer,
 	                                                         DataChunkCallback frameChunkCallback)
 	{
-		TransportProtocolSession *session;
 		bool retVal = false;
 
-		if ((messageLength <= MAX_PROTOCOL_DATA_LENGTH) &&
-		    (messageLength > CAN_DATA_LENGTH) &&
-		    ((nullptr != dataBuffer) ||
-		     (nullptr != frameChunkCallback)) &&
-		    (nullptr != source) &&
-		    (true == source->get_address_valid()) &&
-		    ((nullptr == destination) ||
-		     (destination->get_address_valid())) &&
-		    (!get_session(session, source, destination, parameterGroupNumber)) &&
-		    ((nullptr != destination) ||
-		     ((nullptr == destination) &&
-		      (!get_session(session, source, destination)))))
+		if ((nullptr != dataBuffer) ||
+		    (nullptr != frameChunkCallback))
 		{
-			TransportProtocolSession *newSession = new TransportProtocolSession(TransportProtocolSession::Direction::Transmit,
-			                                                                    source->get_can_port());
-			std::uint8_t destinationAddress;
+			TransportProtocolSession *newSession = start_transmit_session(parameterGroupNumber, messageLength, source, destination, sessionCompleteCallback, parentPointer);
 
-			if (dataBuffer != nullptr)
+			if (nullptr != newSession)
 			{
-				newSession->sessionMessage.set_data(dataBuffer, messageLength);
-			}
-			else
-			{
-				newSession->frameChunkCallback = frameChunkCallback;
-				newSession->frameChunkCallbackMessageLength = messageLength;
-			}
-			newSession->sessionMessage.set_source_control_function(source);
-			newSession->sessionMessage.set_destination_control_function(destination);
-			newSession->packetCount = (messageLength / PROTOCOL_BYTES_PER_FRAME);
-			newSession->lastPacketNumber = 0;
-			newSession->processedPacketsThisSession = 0;
-			newSession->sessionCompleteCallback = sessionCompleteCallback;
-			newSession->parent = parentPointer;
-			if (0 != (messageLength % PROTOCOL_BYTES_PER_FRAME))
-			{
-				newSession->packetCount++;
-			}
-
-			if (nullptr != destination)
-			{
-				// CM Message
-				destinationAddress = destination->get_address();
-				set_state(newSession, StateMachineState::RequestToSend);
-			}
-			else
-			{
-				// BAM message
-				destinationAddress = BROADCAST_CAN_ADDRESS;
-				set_state(newSession, StateMachineState::BroadcastAnnounce);
+				if (nullptr != dataBuffer)
+				{
+					newSession->sessionMessage.set_data(dataBuffer, messageLength);
+				}
+				else
+				{
+					newSession->frameChunkCallback = frameChunkCallback;
+					newSession->frameChunkCallbackMessageLength = messageLength;
+				}
+				retVal = true;
 			}
+		}
+		return retVal;
+	}
 
-			CANIdentifier messageVirtualID(CANIdentifier::Type::Extended,
-			                               parameterGroupNumber,
-			                               CANIdentifier::CANPriority::PriorityDefault6,
-			                               destinationAddress,
-			                               source->get_address());
+	bool TransportProtocolManager::protocol_transmit_shared_message(std::uint32_t parameterGroupNumber,
+	                                                                std::shared_ptr<const std::uint8_t> dataBuffer,
+	                                                                std::uint32_t messageLength,
+	                                                                std::shared_ptr<ControlFunction> source,
+	                                                                std::shared_ptr<ControlFunction> destination,
+	                                                                TransmitCompleteCallback sessionCompleteCallback,
+	                                                                void *parentPointer)
+	{
+		bool retVal = false;
 
-			newSession->sessionMessage.set_identifier(messageVirtualID);
+		if (nullptr != dataBuffer)
+		{
+			TransportProtocolSession *newSession = start_transmit_session(parameterGroupNumber, messageLength, source, destination, sessionCompleteCallback, parentPointer);
 
-			activeSessions.push_back(newSession);
-			retVal = true;
+			if (nullptr != newSession)
+			{
+				// Packets are read straight out of the shared buffer, which the session keeps alive until it closes
+				newSession->sessionMessage.set_shared_data(std::move(dataBuffer), messageLength);
+				retVal = true;
+			}
 		}
 		return retVal;
 	}
 
-	void TransportProtocolManager::update(CANLibBadge<CANNetworkManager>)
+	void TransportProtocolManager::update_channel(std::uint8_t channelIndex, CANLibBadge<CANNetworkManager>)
 	{
-		for (auto i : activeSessions)
+		if (channelIndex < CAN_PORT_MAXIMUM)
 		{
-			update_state_machine(i);
+			// Sessions can close while they are updated, which the pool allows during iteration
+			activeSessions[channelIndex].for_each([this](TransportProtocolSession *session) {
+				update_state_machine(session);
+			});
 		}
 	}
 
+	std::uint32_t TransportProtocolManager::get_time_until_next_update_ms() const
+	{
+		std::uint32_t retVal = std::numeric_limits<std::uint32_t>::max();
+
+		for (std::uint8_t i = 0; i < CAN_PORT_MAXIMUM; i++)
+		{
+			const bool transmitBlocked = networkManager.get_is_transmit_blocked(i);
+
+			activeSessions[i].for_each([this, transmitBlocked, &retVal](const TransportProtocolSession *session) {
+				std::uint32_t sessionTime_ms = 0;
+
+				switch (session->state)
+				{
+					case StateMachineState::None:
+					{
+						sessionTime_ms = std::numeric_limits<std::uint32_t>::max();
+					}
+					break;
+
+					case StateMachineState::WaitForClearToSend:
+					case StateMachineState::WaitForEndOfMessageAcknowledge:
+					{
+						sessionTime_ms = SystemTiming::get_time_remaining_ms(session->timestamp_ms, T2_T3_TIMEOUT_MS);
+					}
+					break;
+
+					case StateMachineState::TxDataSession:
+					{
+						if (nullptr == session->sessionMessage.get_destination_control_function())
+						{
+							sessionTime_ms = SystemTiming::get_time_remaining_ms(session->timestamp_ms, networkManager.get_configuration().get_minimum_time_between_transport_protocol_bam_frames());
+						}
+					}
+					break;
+
+					case StateMachineState::RxDataSession:
+					{
+						if (nullptr == session->sessionMessage.get_destination_control_function())
+						{
+							sessionTime_ms = SystemTiming::get_time_remaining_ms(session->timestamp_ms, T1_TIMEOUT_MS);
+						}
+						else
+						{
+							sessionTime_ms = SystemTiming::get_time_remaining_ms(session->timestamp_ms, MESSAGE_TR_TIMEOUT_MS);
+						}
+					}
+					break;
+
+					default:
+					{
+						// Something needs to be sent, so update again as soon as possible
+					}
+					break;
+				}
+
+				if ((0 == sessionTime_ms) && (transmitBlocked))
+				{
+					// Sending can't make progress until the channel reports it has Tx space again, which requests an update
+					sessionTime_ms = std::numeric_limits<std::uint32_t>::max();
+				}
+				retVal = std::min(retVal, sessionTime_ms);
+			});
+		}
+		return retVal;
+	}
+
 	bool TransportProtocolManager::abort_session(TransportProtocolSession *session, ConnectionAbortReason reason)
 	{
 		bool retVal = false;
@@ -431,12 +495,12 @@ namespace isobus
 
 			if (TransportProtocolSession::Direction::Transmit == session->sessionDirection)
 			{
-				myControlFunction = CANNetworkManager::CANNetwork.get_internal_control_function(session->sessionMessage.get_source_control_function());
+				myControlFunction = networkManager.get_internal_control_function(session->sessionMessage.get_source_control_function());
 				partnerControlFunction = session->sessionMessage.get_destination_control_function();
 			}
 			else
 			{
-				myControlFunction = CANNetworkManager::CANNetwork.get_internal_control_function(session->sessionMessage.get_destination_control_function());
+				myControlFunction = networkManager.get_internal_control_function(session->sessionMessage.get_destination_control_function());
 				partnerControlFunction = session->sessionMessage.get_source_control_function();
 			}
 
@@ -448,12 +512,12 @@ namespace isobus
 			data[5] = static_cast<std::uint8_t>(pgn & 0xFF);
 			data[6] = static_cast<std::uint8_t>((pgn >> 8) & 0xFF);
 			data[7] = static_cast<std::uint8_t>((pgn >> 16) & 0xFF);
-			retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolCommand),
-			                                                        data.data(),
-			                                                        8,
-			                                                        myControlFunction,
-			                                                        partnerControlFunction,
-			                                                        CANIdentifier::CANPriority::PriorityDefault6);
+			retVal = networkManager.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolCommand),
+			                                         data.data(),
+			                                         8,
+			                                         myControlFunction,
+			                                         partnerControlFunction,
+			                                         CANIdentifier::CANPriority::PriorityDefault6);
 		}
 		return retVal;
 	}
@@ -470,24 +534,27 @@ namespace isobus
 		data[5] = static_cast<std::uint8_t>(parameterGroupNumber & 0xFF);
 		data[6] = static_cast<std::uint8_t>((parameterGroupNumber >> 8) & 0xFF);
 		data[7] = static_cast<std::uint8_t>((parameterGroupNumber >> 16) & 0xFF);
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolCommand),
-		                                                      data.data(),
-		                                                      8,
-		                                                      source,
-		                                                      destination,
-		                                                      CANIdentifier::CANPriority::PriorityDefault6);
+		return networkManager.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolCommand),
+		                                       data.data(),
+		                                       8,
+		                                       source,
+		                                       destination,
+		                                       CANIdentifier::CANPriority::PriorityDefault6);
 	}
 
 	void TransportProtocolManager::close_session(TransportProtocolSession *session, bool successfull)
 	{
 		if (nullptr != session)
 		{
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+			if (successfull)
+			{
+				networkManager.get_instrumentation().get_transport_session_duration().record(SystemTiming::get_timestamp_us() - session->startTimestamp_us);
+			}
+#endif
 			process_session_complete_callback(session, successfull);
-			auto sessionLocation = std::find(activeSessions.begin(), activeSessions.end(), session);
-			if (activeSessions.end() != sessionLocation)
+			if (activeSessions[session->sessionMessage.get_can_port_index()].destroy(session))
 			{
-				activeSessions.erase(sessionLocation);
-				delete session;
 				CANStackLogger::CAN_stack_log(CANStackLogger::LoggingLevel::Debug, "[TP]: Session Closed");
 			}
 		}
@@ -523,12 +590,12 @@ namespace isobus
 				                                                 static_cast<std::uint8_t>(session->sessionMessage.get_identifier().get_parameter_group_number() & 0xFF),
 				                                                 static_cast<std::uint8_t>((session->sessionMessage.get_identifier().get_parameter_group_number() >> 8) & 0xFF),
 				                                                 static_cast<std::uint8_t>((session->sessionMessage.get_identifier().get_parameter_group_number() >> 16) & 0xFF) };
-			retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolCommand),
-			                                                        dataBuffer,
-			                                                        CAN_DATA_LENGTH,
-			                                                        std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_source_control_function()),
-			                                                        nullptr,
-			                                                        CANIdentifier::CANPriority::PriorityDefault6);
+			retVal = networkManager.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolCommand),
+			                                         dataBuffer,
+			                                         CAN_DATA_LENGTH,
+			                                         std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_source_control_function()),
+			                                         nullptr,
+			                                         CANIdentifier::CANPriority::PriorityDefault6);
 		}
 		return retVal;
 	}
@@ -559,12 +626,12 @@ namespace isobus
 				                                                 static_cast<std::uint8_t>(session->sessionMessage.get_identifier().get_parameter_group_number() & 0xFF),
 				                                                 static_cast<std::uint8_t>((session->sessionMessage.get_identifier().get_parameter_group_number() >> 8) & 0xFF),
 				                                                 static_cast<std::uint8_t>((session->sessionMessage.get_identifier().get_parameter_group_number() >> 16) & 0xFF) };
-			retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolCommand),
-			                                                        dataBuffer,
-			                                                        CAN_DATA_LENGTH,
-			                                                        std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_destination_control_function()),
-			                                                        session->sessionMessage.get_source_control_function(),
-			                                                        CANIdentifier::CANPriority::PriorityDefault6);
+			retVal = networkManager.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolCommand),
+			                                         dataBuffer,
+			                                         CAN_DATA_LENGTH,
+			                                         std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_destination_control_function()),
+			                                         session->sessionMessage.get_source_control_function(),
+			                                         CANIdentifier::CANPriority::PriorityDefault6);
 		}
 		return retVal;
 	}
@@ -583,12 +650,12 @@ namespace isobus
 				                                                 static_cast<std::uint8_t>(session->sessionMessage.get_identifier().get_parameter_group_number() & 0xFF),
 				                                                 static_cast<std::uint8_t>((session->sessionMessage.get_identifier().get_parameter_group_number() >> 8) & 0xFF),
 				                                                 static_cast<std::uint8_t>((session->sessionMessage.get_identifier().get_parameter_group_number() >> 16) & 0xFF) };
-			retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolCommand),
-			                                                        dataBuffer,
-			                                                        CAN_DATA_LENGTH,
-			                                                        std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_source_control_function()),
-			                                                        session->sessionMessage.get_destination_control_function(),
-			                                                        CANIdentifier::CANPriority::PriorityDefault6);
+			retVal = networkManager.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolCommand),
+			                                         dataBuffer,
+			                                         CAN_DATA_LENGTH,
+			                                         std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_source_control_function()),
+			                                         session->sessionMessage.get_destination_control_function(),
+			                                         CANIdentifier::CANPriority::PriorityDefault6);
 		}
 		return retVal;
 	}
@@ -615,12 +682,12 @@ namespace isobus
 			// This message only needs to be sent if we're the recipient. Sanity check the destination is us
 			if (ControlFunction::Type::Internal == session->sessionMessage.get_destination_control_function()->get_type())
 			{
-				retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolCommand),
-				                                                        dataBuffer,
-				                                                        CAN_DATA_LENGTH,
-				                                                        std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_destination_control_function()),
-				                                                        session->sessionMessage.get_source_control_function(),
-				                                                        CANIdentifier::CANPriority::PriorityDefault6);
+				retVal = networkManager.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolCommand),
+				                                         dataBuffer,
+				                                         CAN_DATA_LENGTH,
+				                                         std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_destination_control_function()),
+				                                         session->sessionMessage.get_source_control_function(),
+				                                         CANIdentifier::CANPriority::PriorityDefault6);
 			}
 		}
 		else
@@ -630,6 +697,99 @@ namespace isobus
 		return retVal;
 	}
 
+	TransportProtocolManager::TransportProtocolSession *TransportProtocolManager::start_transmit_session(std::uint32_t parameterGroupNumber,
+	                                                                                                     std::uint32_t messageLength,
+	                                                                                                     std::shared_ptr<ControlFunction> source,
+	                                                                                                     std::shared_ptr<ControlFunction> destination,
+	                                                                                                     TransmitCompleteCallback sessionCompleteCallback,
+	                                                                                                     void *parentPointer)
+	{
+		TransportProtocolSession *session;
+		TransportProtocolSession *retVal = nullptr;
+
+		if ((messageLength <= MAX_PROTOCOL_DATA_LENGTH) &&
+		    (messageLength > CAN_DATA_LENGTH) &&
+		    (nullptr != source) &&
+		    (true == source->get_address_valid()) &&
+		    ((nullptr == destination) ||
+		     (destination->get_address_valid())) &&
+		    (!get_session(session, source, destination)))
+		{
+			TransportProtocolSession *newSession = create_session(TransportProtocolSession::Direction::Transmit, source, destination);
+			std::uint8_t destinationAddress;
+
+			newSession->packetCount = (messageLength / PROTOCOL_BYTES_PER_FRAME);
+			newSession->lastPacketNumber = 0;
+			newSession->processedPacketsThisSession = 0;
+			newSession->sessionCompleteCallback = sessionCompleteCallback;
+			newSession->parent = parentPointer;
+			if (0 != (messageLength % PROTOCOL_BYTES_PER_FRAME))
+			{
+				newSession->packetCount++;
+			}
+
+			if (nullptr != destination)
+			{
+				// CM Message
+				destinationAddress = destination->get_address();
+				set_state(newSession, StateMachineState::RequestToSend);
+			}
+			else
+			{
+				// BAM message
+				destinationAddress = BROADCAST_CAN_ADDRESS;
+				set_state(newSession, StateMachineState::BroadcastAnnounce);
+			}
+
+			CANIdentifier messageVirtualID(CANIdentifier::Type::Extended,
+			                               parameterGroupNumber,
+			                               CANIdentifier::CANPriority::PriorityDefault6,
+			                               destinationAddress,
+			                               source->get_address());
+
+			newSession->sessionMessage.set_identifier(messageVirtualID);
+			retVal = newSession;
+		}
+		return retVal;
+	}
+
+	TransportProtocolManager::TransportProtocolSession *TransportProtocolManager::create_session(TransportProtocolSession::Direction sessionDirection, std::shared_ptr<ControlFunction> source, std::shared_ptr<ControlFunction> destination)
+	{
+		const std::uint32_t maxSessions = networkManager.get_configuration().get_max_number_transport_protocol_sessions();
+		TransportProtocolSession *retVal = nullptr;
+
+		if (source->get_can_port() < CAN_PORT_MAXIMUM)
+		{
+			auto &channelSessions = activeSessions[source->get_can_port()];
+
+			if (TransportProtocolSession::Direction::Transmit == sessionDirection)
+			{
+				// Only received sessions are limited, the application decides how much it wants to send
+				channelSessions.reserve_for_one_more(maxSessions);
+			}
+			else
+			{
+				channelSessions.reserve(maxSessions);
+			}
+
+			if ((TransportProtocolSession::Direction::Transmit == sessionDirection) ||
+			    (channelSessions.size() < maxSessions))
+			{
+				retVal = channelSessions.create(ProtocolSessionKey(source, destination), sessionDirection, source->get_can_port());
+
+				if (nullptr != retVal)
+				{
+					retVal->sessionMessage.set_source_control_function(source);
+					retVal->sessionMessage.set_destination_control_function(destination);
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+					networkManager.get_instrumentation().record_queue_depth(CANStackInstrumentation::Queue::TransportProtocolSessions, source->get_can_port(), channelSessions.size());
+#endif
+				}
+			}
+		}
+		return retVal;
+	}
+
 	void TransportProtocolManager::set_state(TransportProtocolSession *session, StateMachineState value)
 	{
 		if (nullptr != session)
@@ -643,14 +803,9 @@ namespace isobus
 	{
 		session = nullptr;
 
-		for (auto i : activeSessions)
+		if ((nullptr != source) && (source->get_can_port() < CAN_PORT_MAXIMUM))
 		{
-			if ((i->sessionMessage.get_source_control_function() == source) &&
-			    (i->sessionMessage.get_destination_control_function() == destination))
-			{
-				session = i;
-				break;
-			}
+			session = activeSessions[source->get_can_port()].find(ProtocolSessionKey(source, destination));
 		}
 		return (nullptr != session);
 	}
@@ -722,7 +877,7 @@ namespace isobus
 				{
 					bool sessionStillValid = true;
 
-					if ((nullptr != session->sessionMessage.get_destination_control_function()) || (SystemTiming::time_expired_ms(session->timestamp_ms, CANNetworkManager::CANNetwork.get_configuration().get_minimum_time_between_transport_protocol_bam_frames())))
+					if ((nullptr != session->sessionMessage.get_destination_control_function()) || (SystemTiming::time_expired_ms(session->timestamp_ms, networkManager.get_configuration().get_minimum_time_between_transport_protocol_bam_frames())))
 					{
 						std::uint8_t dataBuffer[CAN_DATA_LENGTH];
 						std::uint32_t framesSentThisUpdate = 0;
@@ -755,10 +910,7 @@ namespace isobus
 
 								if (callbackSuccessful)
 								{
-									for (std::uint8_t j = 0; j < PROTOCOL_BYTES_PER_FRAME; j++)
-									{
-										dataBuffer[1 + j] = callbackBuffer[j];
-									}
+									memcpy(&dataBuffer[1], callbackBuffer, PROTOCOL_BYTES_PER_FRAME);
 								}
 								else
 								{
@@ -770,27 +922,17 @@ namespace isobus
 							}
 							else
 							{
-								// Use the data buffer to get the data for this frame
-								for (std::uint8_t j = 0; j < PROTOCOL_BYTES_PER_FRAME; j++)
-								{
-									std::uint32_t index = (j + (PROTOCOL_BYTES_PER_FRAME * session->processedPacketsThisSession));
-									if (index < session->get_message_data_length())
-									{
-										dataBuffer[1 + j] = session->sessionMessage.get_data()[j + (PROTOCOL_BYTES_PER_FRAME * session->processedPacketsThisSession)];
-									}
-									else
-									{
-										dataBuffer[1 + j] = 0xFF;
-									}
-								}
+								// Use the data buffer to get the data for this frame, and pad the last frame with 0xFF
+								std::uint32_t bytesCopied = session->sessionMessage.get_data().read(PROTOCOL_BYTES_PER_FRAME * session->processedPacketsThisSession, &dataBuffer[1], PROTOCOL_BYTES_PER_FRAME);
+								memset(&dataBuffer[1 + bytesCopied], 0xFF, PROTOCOL_BYTES_PER_FRAME - bytesCopied);
 							}
 
-							if (CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolData),
-							                                                   dataBuffer,
-							                                                   CAN_DATA_LENGTH,
-							                                                   std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_source_control_function()),
-							                                                   session->sessionMessage.get_destination_control_function(),
-							                                                   CANIdentifier::CANPriority::PriorityLowest7))
+							if (networkManager.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::TransportProtocolData),
+							                                    dataBuffer,
+							                                    CAN_DATA_LENGTH,
+							                                    std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_source_control_function()),
+							                                    session->sessionMessage.get_destination_control_function(),
+							                                    CANIdentifier::CANPriority::PriorityLowest7))
 							{
 								framesSentThisUpdate++;
 								session->lastPacketNumber++;
@@ -802,7 +944,7 @@ namespace isobus
 									// Need to wait for the frame delay time before continuing BAM session
 									break;
 								}
-								else if (framesSentThisUpdate >= CANNetworkManager::CANNetwork.get_configuration().get_max_number_of_network_manager_protocol_frames_per_update())
+								else if (framesSentThisUpdate >= networkManager.get_configuration().get_max_number_of_network_manager_protocol_frames_per_update())
 								{
 									break; // Throttle the session
 								}
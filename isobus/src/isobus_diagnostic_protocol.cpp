@@ -99,10 +99,10 @@ namespace isobus
 		if (!initialized)
 		{
 			initialized = true;
-			CANNetworkManager::CANNetwork.add_protocol_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage22), process_message, this);
-			CANNetworkManager::CANNetwork.add_protocol_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage13), process_message, this);
-			CANNetworkManager::CANNetwork.add_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage13), process_message, this);
-			addressViolationEventHandle = CANNetworkManager::CANNetwork.get_address_violation_event_dispatcher().add_listener([this](std::shared_ptr<InternalControlFunction> affectedCF) { this->on_address_violation(affectedCF); });
+			myControlFunction->get_network_manager().add_protocol_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage22), process_message, this);
+			myControlFunction->get_network_manager().add_protocol_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage13), process_message, this);
+			myControlFunction->get_network_manager().add_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage13), process_message, this);
+			addressViolationEventHandle = myControlFunction->get_network_manager().get_address_violation_event_dispatcher().add_listener([this](std::shared_ptr<InternalControlFunction> affectedCF) { this->on_address_violation(affectedCF); });
 
 			if (auto requestProtocol = myControlFunction->get_pgn_request_protocol().lock())
 			{
@@ -146,9 +146,9 @@ namespace isobus
 				requestProtocol->remove_pgn_request_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::SoftwareIdentification), process_parameter_group_number_request, this);
 				requestProtocol->remove_pgn_request_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUIdentificationInformation), process_parameter_group_number_request, this);
 			}
-			CANNetworkManager::CANNetwork.remove_protocol_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage22), process_message, this);
-			CANNetworkManager::CANNetwork.remove_protocol_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage13), process_message, this);
-			CANNetworkManager::CANNetwork.remove_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage13), process_message, this);
+			myControlFunction->get_network_manager().remove_protocol_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage22), process_message, this);
+			myControlFunction->get_network_manager().remove_protocol_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage13), process_message, this);
+			myControlFunction->get_network_manager().remove_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage13), process_message, this);
 			addressViolationEventHandle.reset();
 		}
 	}
@@ -679,10 +679,10 @@ namespace isobus
 					buffer[5] = 0x00;
 					buffer[6] = 0xFF;
 					buffer[7] = 0xFF;
-					retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage1),
-					                                                        buffer.data(),
-					                                                        CAN_DATA_LENGTH,
-					                                                        myControlFunction);
+					retVal = myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage1),
+					                                                                   buffer.data(),
+					                                                                   CAN_DATA_LENGTH,
+					                                                                   myControlFunction);
 				}
 				else
 				{
@@ -701,10 +701,10 @@ namespace isobus
 						payloadSize = CAN_DATA_LENGTH;
 					}
 
-					retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage1),
-					                                                        buffer.data(),
-					                                                        payloadSize,
-					                                                        myControlFunction);
+					retVal = myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage1),
+					                                                                   buffer.data(),
+					                                                                   payloadSize,
+					                                                                   myControlFunction);
 				}
 			}
 		}
@@ -767,10 +767,10 @@ namespace isobus
 					buffer[5] = 0x00;
 					buffer[6] = 0xFF;
 					buffer[7] = 0xFF;
-					retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage2),
-					                                                        buffer.data(),
-					                                                        CAN_DATA_LENGTH,
-					                                                        myControlFunction);
+					retVal = myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage2),
+					                                                                   buffer.data(),
+					                                                                   CAN_DATA_LENGTH,
+					                                                                   myControlFunction);
 				}
 				else
 				{
@@ -789,10 +789,10 @@ namespace isobus
 						payloadSize = CAN_DATA_LENGTH;
 					}
 
-					retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage2),
-					                                                        buffer.data(),
-					                                                        payloadSize,
-					                                                        myControlFunction);
+					retVal = myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage2),
+					                                                                   buffer.data(),
+					                                                                   payloadSize,
+					                                                                   myControlFunction);
 				}
 			}
 		}
@@ -811,10 +811,10 @@ namespace isobus
 
 			buffer.fill(0xFF); // Reserved bytes
 			buffer[0] = SUPPORTED_DIAGNOSTIC_PROTOCOLS_BITFIELD;
-			retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticProtocolIdentification),
-			                                                        buffer.data(),
-			                                                        CAN_DATA_LENGTH,
-			                                                        myControlFunction);
+			retVal = myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticProtocolIdentification),
+			                                                                   buffer.data(),
+			                                                                   CAN_DATA_LENGTH,
+			                                                                   myControlFunction);
 		}
 		return retVal;
 	}
@@ -831,10 +831,10 @@ namespace isobus
 			0xFF,
 			0xFF
 		};
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage13),
-		                                                      buffer.data(),
-		                                                      buffer.size(),
-		                                                      myControlFunction);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage13),
+		                                                                 buffer.data(),
+		                                                                 buffer.size(),
+		                                                                 myControlFunction);
 	}
 
 	bool DiagnosticProtocol::send_ecu_identification() const
@@ -848,10 +848,10 @@ namespace isobus
 		}
 
 		std::vector<std::uint8_t> buffer(ecuIdString.begin(), ecuIdString.end());
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUIdentificationInformation),
-		                                                      buffer.data(),
-		                                                      buffer.size(),
-		                                                      myControlFunction);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUIdentificationInformation),
+		                                                                 buffer.data(),
+		                                                                 buffer.size(),
+		                                                                 myControlFunction);
 	}
 
 	bool DiagnosticProtocol::send_product_identification() const
@@ -859,10 +859,10 @@ namespace isobus
 		std::string productIdString = productIdentificationCode + "*" + productIdentificationBrand + "*" + productIdentificationModel + "*";
 		std::vector<std::uint8_t> buffer(productIdString.begin(), productIdString.end());
 
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProductIdentification),
-		                                                      buffer.data(),
-		                                                      buffer.size(),
-		                                                      myControlFunction);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProductIdentification),
+		                                                                 buffer.data(),
+		                                                                 buffer.size(),
+		                                                                 myControlFunction);
 	}
 
 	bool DiagnosticProtocol::send_software_identification() const
@@ -881,10 +881,10 @@ namespace isobus
 			              });
 
 			std::vector<std::uint8_t> buffer(softIDString.begin(), softIDString.end());
-			retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::SoftwareIdentification),
-			                                                        buffer.data(),
-			                                                        buffer.size(),
-			                                                        myControlFunction);
+			retVal = myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::SoftwareIdentification),
+			                                                                   buffer.data(),
+			                                                                   buffer.size(),
+			                                                                   myControlFunction);
 		}
 		return retVal;
 	}
@@ -937,11 +937,11 @@ namespace isobus
 				buffer[7] = static_cast<std::uint8_t>(((currentMessageData.suspectParameterNumber >> 16) << 5) & 0xE0);
 				buffer[7] |= (currentMessageData.failureModeIdentifier & 0x1F);
 
-				retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage22),
-				                                                        buffer.data(),
-				                                                        buffer.size(),
-				                                                        myControlFunction,
-				                                                        currentMessageData.destination);
+				retVal = myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::DiagnosticMessage22),
+				                                                                   buffer.data(),
+				                                                                   buffer.size(),
+				                                                                   myControlFunction,
+				                                                                   currentMessageData.destination);
 				if (retVal)
 				{
 					dm22ResponseQueue.pop_back();
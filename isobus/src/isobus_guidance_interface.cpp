@@ -498,7 +498,7 @@ namespace isobus
 
 						changed |= guidanceCommand->set_curvature((message.get_uint16_at(0) * CURVATURE_COMMAND_RESOLUTION_PER_BIT) - CURVATURE_COMMAND_OFFSET_INVERSE_KM);
 						changed |= guidanceCommand->set_status(static_cast<GuidanceSystemCommand::CurvatureCommandStatus>(message.get_uint8_at(2) & 0x03));
-						guidanceCommand->set_timestamp_ms(SystemTiming::get_timestamp_ms());
+						guidanceCommand->set_timestamp_ms(message.get_timestamp_ms());
 
 						targetInterface->guidanceSystemCommandEventPublisher.call(guidanceCommand, changed);
 					}
@@ -540,7 +540,7 @@ namespace isobus
 						changed |= machineInfo->set_guidance_limit_status(static_cast<GuidanceMachineInfo::GuidanceLimitStatus>(message.get_uint8_at(3) >> 5));
 						changed |= machineInfo->set_guidance_system_command_exit_reason_code(message.get_uint8_at(4) & 0x3F);
 						changed |= machineInfo->set_guidance_system_remote_engage_switch_status(static_cast<GuidanceMachineInfo::GenericSAEbs02SlotValue>((message.get_uint8_at(4) >> 6) & 0x03));
-						machineInfo->set_timestamp_ms(SystemTiming::get_timestamp_ms());
+						machineInfo->set_timestamp_ms(message.get_timestamp_ms());
 
 						targetInterface->guidanceMachineInfoEventPublisher.call(machineInfo, changed);
 					}
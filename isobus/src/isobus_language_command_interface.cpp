@@ -38,7 +38,7 @@ namespace isobus
 	{
 		if (initialized)
 		{
-			CANNetworkManager::CANNetwork.remove_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::LanguageCommand), process_rx_message, this);
+			myControlFunction->get_network_manager().remove_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::LanguageCommand), process_rx_message, this);
 
 			if (respondToRequests && (!myControlFunction->get_pgn_request_protocol().expired()))
 			{
@@ -53,7 +53,7 @@ namespace isobus
 		{
 			if (nullptr != myControlFunction)
 			{
-				CANNetworkManager::CANNetwork.add_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::LanguageCommand), process_rx_message, this);
+				myControlFunction->get_network_manager().add_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::LanguageCommand), process_rx_message, this);
 
 				if (respondToRequests && (!myControlFunction->get_pgn_request_protocol().expired()))
 				{
@@ -117,11 +117,17 @@ namespace isobus
 			static_cast<std::uint8_t>(countryCode[0]),
 			static_cast<std::uint8_t>(countryCode[1])
 		};
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::LanguageCommand),
-		                                                      buffer.data(),
-		                                                      buffer.size(),
-		                                                      myControlFunction,
-		                                                      nullptr);
+		bool retVal = false;
+
+		if (nullptr != myControlFunction)
+		{
+			retVal = myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::LanguageCommand),
+			                                                                   buffer.data(),
+			                                                                   buffer.size(),
+			                                                                   myControlFunction,
+			                                                                   nullptr);
+		}
+		return retVal;
 	}
 
 	std::string LanguageCommandInterface::get_country_code() const
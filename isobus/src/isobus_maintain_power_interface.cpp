@@ -336,7 +336,7 @@ namespace isobus
 					changed |= mpMessage->set_implement_ready_to_work_state(static_cast<MaintainPowerData::ImplementReadyToWorkState>((message.get_uint8_at(1) >> 2) & 0x03));
 					changed |= mpMessage->set_implement_park_state(static_cast<MaintainPowerData::ImplementParkState>((message.get_uint8_at(1) >> 4) & 0x03));
 					changed |= mpMessage->set_implement_transport_state(static_cast<MaintainPowerData::ImplementTransportState>((message.get_uint8_at(1) >> 6) & 0x03));
-					mpMessage->set_timestamp_ms(SystemTiming::get_timestamp_ms());
+					mpMessage->set_timestamp_ms(message.get_timestamp_ms());
 
 					targetInterface->maintainPowerDataEventPublisher.call(mpMessage, changed);
 				}
@@ -31,7 +31,7 @@ namespace isobus
 	{
 		if (initialized)
 		{
-			CANNetworkManager::CANNetwork.remove_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::AllImplementsStopOperationsSwitchState), process_rx_message, this);
+			sourceControlFunction->get_network_manager().remove_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::AllImplementsStopOperationsSwitchState), process_rx_message, this);
 		}
 	}
 
@@ -39,9 +39,9 @@ namespace isobus
 	{
 		if (!initialized)
 		{
-			CANNetworkManager::CANNetwork.add_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::AllImplementsStopOperationsSwitchState),
-			                                                                         process_rx_message,
-			                                                                         this);
+			sourceControlFunction->get_network_manager().add_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::AllImplementsStopOperationsSwitchState),
+			                                                                                        process_rx_message,
+			                                                                                        this);
 			initialized = true;
 		}
 	}
@@ -226,11 +226,11 @@ namespace isobus
 			static_cast<std::uint8_t>(0xFC | static_cast<std::uint8_t>(commandedState))
 		};
 
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::AllImplementsStopOperationsSwitchState),
-		                                                      buffer.data(),
-		                                                      buffer.size(),
-		                                                      sourceControlFunction,
-		                                                      nullptr,
-		                                                      CANIdentifier::CANPriority::Priority3);
+		return sourceControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::AllImplementsStopOperationsSwitchState),
+		                                                                     buffer.data(),
+		                                                                     buffer.size(),
+		                                                                     sourceControlFunction,
+		                                                                     nullptr,
+		                                                                     CANIdentifier::CANPriority::Priority3);
 	}
 }
@@ -658,7 +658,7 @@ namespace isobus
 						changed |= mssMessage->set_machine_direction_of_travel(static_cast<MachineDirection>(message.get_uint8_at(7) & 0x03));
 						changed |= mssMessage->set_speed_source(static_cast<MachineSelectedSpeedData::SpeedSource>((message.get_uint8_at(7) >> 2) & 0x07));
 						changed |= mssMessage->set_limit_status(static_cast<MachineSelectedSpeedData::LimitStatus>((message.get_uint8_at(7) >> 5) & 0x03));
-						mssMessage->set_timestamp_ms(SystemTiming::get_timestamp_ms());
+						mssMessage->set_timestamp_ms(message.get_timestamp_ms());
 
 						targetInterface->machineSelectedSpeedDataEventPublisher.call(mssMessage, changed);
 					}
@@ -699,7 +699,7 @@ namespace isobus
 						changed |= wheelSpeedMessage->set_key_switch_state(static_cast<WheelBasedMachineSpeedData::KeySwitchState>((message.get_uint8_at(7) >> 2) & 0x03));
 						changed |= wheelSpeedMessage->set_implement_start_stop_operations_state(static_cast<WheelBasedMachineSpeedData::ImplementStartStopOperations>((message.get_uint8_at(7) >> 4) & 0x03));
 						changed |= wheelSpeedMessage->set_operator_direction_reversed_state(static_cast<WheelBasedMachineSpeedData::OperatorDirectionReversed>((message.get_uint8_at(7) >> 6) & 0x03));
-						wheelSpeedMessage->set_timestamp_ms(SystemTiming::get_timestamp_ms());
+						wheelSpeedMessage->set_timestamp_ms(message.get_timestamp_ms());
 
 						targetInterface->wheelBasedMachineSpeedDataEventPublisher.call(wheelSpeedMessage, changed);
 					}
@@ -736,7 +736,7 @@ namespace isobus
 						changed |= groundSpeedMessage->set_machine_speed(message.get_uint16_at(0));
 						changed |= groundSpeedMessage->set_machine_distance(message.get_uint32_at(2));
 						changed |= groundSpeedMessage->set_machine_direction_of_travel(static_cast<MachineDirection>(message.get_uint8_at(7) & 0x03));
-						groundSpeedMessage->set_timestamp_ms(SystemTiming::get_timestamp_ms());
+						groundSpeedMessage->set_timestamp_ms(message.get_timestamp_ms());
 
 						targetInterface->groundBasedSpeedDataEventPublisher.call(groundSpeedMessage, changed);
 					}
@@ -773,7 +773,7 @@ namespace isobus
 						commandMessage->set_machine_speed_setpoint_command(message.get_uint16_at(0));
 						commandMessage->set_machine_selected_speed_setpoint_limit(message.get_uint16_at(2));
 						commandMessage->set_machine_direction_of_travel(static_cast<MachineDirection>(message.get_uint8_at(7) & 0x03));
-						commandMessage->set_timestamp_ms(SystemTiming::get_timestamp_ms());
+						commandMessage->set_timestamp_ms(message.get_timestamp_ms());
 
 						targetInterface->machineSelectedSpeedCommandDataEventPublisher.call(commandMessage, changed);
 					}
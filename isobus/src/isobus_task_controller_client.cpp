@@ -44,7 +44,7 @@ namespace isobus
 
 		partnerControlFunction->add_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData), process_rx_message, this);
 		partnerControlFunction->add_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::Acknowledge), process_rx_message, this);
-		CANNetworkManager::CANNetwork.add_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData), process_rx_message, this);
+		myControlFunction->get_network_manager().add_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData), process_rx_message, this);
 
 		if (!languageCommandInterface.get_initialized())
 		{
@@ -249,7 +249,7 @@ namespace isobus
 			{
 				partnerControlFunction->remove_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData), process_rx_message, this);
 				partnerControlFunction->remove_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::Acknowledge), process_rx_message, this);
-				CANNetworkManager::CANNetwork.remove_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData), process_rx_message, this);
+				myControlFunction->get_network_manager().remove_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData), process_rx_message, this);
 			}
 
 			shouldTerminate = true;
@@ -744,15 +744,15 @@ namespace isobus
 				}
 
 				assert(0 != dataLength);
-				transmitSuccessful = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
-				                                                                    nullptr,
-				                                                                    dataLength,
-				                                                                    myControlFunction,
-				                                                                    partnerControlFunction,
-				                                                                    CANIdentifier::CANPriority::PriorityLowest7,
-				                                                                    process_tx_callback,
-				                                                                    this,
-				                                                                    process_internal_object_pool_upload_callback);
+				transmitSuccessful = myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
+				                                                                               nullptr,
+				                                                                               dataLength,
+				                                                                               myControlFunction,
+				                                                                               partnerControlFunction,
+				                                                                               CANIdentifier::CANPriority::PriorityLowest7,
+				                                                                               process_tx_callback,
+				                                                                               this,
+				                                                                               process_internal_object_pool_upload_callback);
 				if (transmitSuccessful)
 				{
 					set_state(StateMachineState::WaitForDDOPTransfer);
@@ -1888,11 +1888,11 @@ namespace isobus
 			                                                         0xFF,
 			                                                         0xFF };
 
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction);
 	}
 
 	bool TaskControllerClient::send_object_pool_activate() const
@@ -1913,11 +1913,11 @@ namespace isobus
 			                                                         0xFF,
 			                                                         0xFF };
 
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction);
 	}
 
 	bool TaskControllerClient::send_pdack(std::uint16_t elementNumber, std::uint16_t ddi) const
@@ -1931,11 +1931,11 @@ namespace isobus
 			                                                         0xFF,
 			                                                         0xFF,
 			                                                         0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction);
 	}
 
 	bool TaskControllerClient::send_request_localization_label() const
@@ -1963,11 +1963,11 @@ namespace isobus
 			                                                         0xFF,
 			                                                         0xFF };
 
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction);
 	}
 
 	bool TaskControllerClient::send_request_structure_label() const
@@ -1992,11 +1992,11 @@ namespace isobus
 			                                                         numberSectionsSupported,
 			                                                         numberChannelsSupportedForPositionBasedControl };
 
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction);
 	}
 
 	bool TaskControllerClient::send_status() const
@@ -2010,11 +2010,11 @@ namespace isobus
 			                                                         0x00, // Reserved (0)
 			                                                         0x00 }; // Reserved (0)
 
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction);
 	}
 
 	bool TaskControllerClient::send_value_command(std::uint16_t elementNumber, std::uint16_t ddi, std::uint32_t value) const
@@ -2028,11 +2028,11 @@ namespace isobus
 			                                                         static_cast<std::uint8_t>(value >> 8),
 			                                                         static_cast<std::uint8_t>(value >> 16),
 			                                                         static_cast<std::uint8_t>(value >> 24) };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction);
 	}
 
 	bool TaskControllerClient::send_version_request() const
@@ -2044,11 +2044,11 @@ namespace isobus
 	{
 		const std::array<std::uint8_t, CAN_DATA_LENGTH> buffer = { numberOfWorkingSetMembers, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
 
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::WorkingSetMaster),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      nullptr);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::WorkingSetMaster),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 nullptr);
 	}
 
 	void TaskControllerClient::set_common_config_items(std::uint8_t maxNumberBoomsSupported,
@@ -2171,11 +2171,11 @@ namespace isobus
 			                                                             0xFF,
 			                                                             0xFF,
 			                                                             0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      nullptr);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ProcessData),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 nullptr);
 	}
 
 } // namespace isobus
@@ -52,8 +52,8 @@ namespace isobus
 			{
 				partnerControlFunction->add_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::VirtualTerminalToECU), process_rx_message, this);
 				partnerControlFunction->add_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::Acknowledge), process_rx_message, this);
-				CANNetworkManager::CANNetwork.add_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::VirtualTerminalToECU), process_rx_message, this);
-				CANNetworkManager::CANNetwork.add_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal), process_rx_message, this);
+				myControlFunction->get_network_manager().add_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::VirtualTerminalToECU), process_rx_message, this);
+				myControlFunction->get_network_manager().add_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal), process_rx_message, this);
 			}
 
 			if (!languageCommandInterface.get_initialized())
@@ -93,8 +93,8 @@ namespace isobus
 				}
 				partnerControlFunction->remove_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::VirtualTerminalToECU), process_rx_message, this);
 				partnerControlFunction->remove_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::Acknowledge), process_rx_message, this);
-				CANNetworkManager::CANNetwork.remove_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::VirtualTerminalToECU), process_rx_message, this);
-				CANNetworkManager::CANNetwork.remove_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal), process_rx_message, this);
+				myControlFunction->get_network_manager().remove_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::VirtualTerminalToECU), process_rx_message, this);
+				myControlFunction->get_network_manager().remove_global_parameter_group_number_callback(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal), process_rx_message, this);
 			}
 
 			shouldTerminate = true;
@@ -1604,15 +1604,15 @@ namespace isobus
 							{
 								if (!objectPools[i].uploaded)
 								{
-									bool transmitSuccessful = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-									                                                                         nullptr,
-									                                                                         objectPools[i].objectPoolSize + 1, // Account for Mux byte
-									                                                                         myControlFunction,
-									                                                                         partnerControlFunction,
-									                                                                         CANIdentifier::CANPriority::Priority5,
-									                                                                         process_callback,
-									                                                                         this,
-									                                                                         process_internal_object_pool_upload_callback);
+									bool transmitSuccessful = myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+									                                                                                    nullptr,
+									                                                                                    objectPools[i].objectPoolSize + 1, // Account for Mux byte
+									                                                                                    myControlFunction,
+									                                                                                    partnerControlFunction,
+									                                                                                    CANIdentifier::CANPriority::Priority5,
+									                                                                                    process_callback,
+									                                                                                    this,
+									                                                                                    process_internal_object_pool_upload_callback);
 
 									if (transmitSuccessful)
 									{
@@ -1748,12 +1748,12 @@ namespace isobus
 			                                                             0xFF,
 			                                                             0xFF,
 			                                                             0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_working_set_maintenance(bool initializing) const
@@ -1770,12 +1770,12 @@ namespace isobus
 			                                                         0xFF,
 			                                                         0xFF,
 			                                                         0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_get_memory(std::uint32_t requiredMemory) const
@@ -1788,12 +1788,12 @@ namespace isobus
 			                                                         static_cast<std::uint8_t>((requiredMemory >> 24) & 0xFF),
 			                                                         0xFF,
 			                                                         0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_get_number_of_softkeys() const
@@ -1806,12 +1806,12 @@ namespace isobus
 			                                                             0xFF,
 			                                                             0xFF,
 			                                                             0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_get_text_font_data() const
@@ -1824,12 +1824,12 @@ namespace isobus
 			                                                             0xFF,
 			                                                             0xFF,
 			                                                             0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_get_hardware() const
@@ -1842,12 +1842,12 @@ namespace isobus
 			                                                             0xFF,
 			                                                             0xFF,
 			                                                             0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_get_supported_widechars() const
@@ -1860,12 +1860,12 @@ namespace isobus
 			                                                             0xFF,
 			                                                             0xFF,
 			                                                             0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_get_window_mask_data() const
@@ -1878,12 +1878,12 @@ namespace isobus
 			                                                             0xFF,
 			                                                             0xFF,
 			                                                             0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_get_supported_objects() const
@@ -1896,12 +1896,12 @@ namespace isobus
 			                                                             0xFF,
 			                                                             0xFF,
 			                                                             0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_get_versions() const
@@ -1914,12 +1914,12 @@ namespace isobus
 			                                                             0xFF,
 			                                                             0xFF,
 			                                                             0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_store_version(std::array<std::uint8_t, 7> versionLabel) const
@@ -1932,12 +1932,12 @@ namespace isobus
 			                                                         versionLabel[4],
 			                                                         versionLabel[5],
 			                                                         versionLabel[6] };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_load_version(std::array<std::uint8_t, 7> versionLabel) const
@@ -1950,12 +1950,12 @@ namespace isobus
 			                                                         versionLabel[4],
 			                                                         versionLabel[5],
 			                                                         versionLabel[6] };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_delete_version(std::array<std::uint8_t, 7> versionLabel) const
@@ -1968,12 +1968,12 @@ namespace isobus
 			                                                         versionLabel[4],
 			                                                         versionLabel[5],
 			                                                         versionLabel[6] };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_extended_get_versions() const
@@ -1986,12 +1986,12 @@ namespace isobus
 			                                                             0xFF,
 			                                                             0xFF,
 			                                                             0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_extended_store_version(std::array<std::uint8_t, 32> versionLabel) const
@@ -1999,12 +1999,12 @@ namespace isobus
 		std::array<std::uint8_t, 33> buffer;
 		buffer[0] = static_cast<std::uint8_t>(Function::ExtendedStoreVersionCommand);
 		memcpy(&buffer[1], versionLabel.data(), 32);
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      buffer.size(),
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 buffer.size(),
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_extended_load_version(std::array<std::uint8_t, 32> versionLabel) const
@@ -2012,12 +2012,12 @@ namespace isobus
 		std::array<std::uint8_t, 33> buffer;
 		buffer[0] = static_cast<std::uint8_t>(Function::ExtendedLoadVersionCommand);
 		memcpy(&buffer[1], versionLabel.data(), 32);
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      buffer.size(),
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 buffer.size(),
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_extended_delete_version(std::array<std::uint8_t, 32> versionLabel) const
@@ -2025,12 +2025,12 @@ namespace isobus
 		std::array<std::uint8_t, 33> buffer;
 		buffer[0] = static_cast<std::uint8_t>(Function::ExtendedDeleteVersionCommand);
 		memcpy(&buffer[1], versionLabel.data(), 32);
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      buffer.size(),
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 buffer.size(),
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_end_of_object_pool() const
@@ -2043,12 +2043,12 @@ namespace isobus
 			                                                             0xFF,
 			                                                             0xFF,
 			                                                             0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_working_set_master() const
@@ -2061,12 +2061,12 @@ namespace isobus
 			                                                             0xFF,
 			                                                             0xFF,
 			                                                             0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::WorkingSetMaster),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      nullptr,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::WorkingSetMaster),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 nullptr,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_auxiliary_functions_preferred_assignment() const
@@ -2077,12 +2077,12 @@ namespace isobus
 		{
 			buffer.resize(CAN_DATA_LENGTH);
 		}
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      buffer.size(),
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 buffer.size(),
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_auxiliary_function_assignment_response(std::uint16_t functionObjectID, bool hasError, bool isAlreadyAssigned) const
@@ -2104,12 +2104,12 @@ namespace isobus
 			                                                         0xFF,
 			                                                         0xFF,
 			                                                         0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	bool VirtualTerminalClient::send_auxiliary_input_maintenance() const
@@ -2122,12 +2122,12 @@ namespace isobus
 			                                                         0xFF,
 			                                                         0xFF,
 			                                                         0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      nullptr,
-		                                                      CANIdentifier::CANPriority::Priority3);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 nullptr,
+		                                                                 CANIdentifier::CANPriority::Priority3);
 	}
 
 	bool VirtualTerminalClient::send_auxiliary_input_status_enable_response(std::uint16_t objectID, bool isEnabled, bool invalidObjectID) const
@@ -2140,12 +2140,12 @@ namespace isobus
 			                                                         0xFF,
 			                                                         0xFF,
 			                                                         0xFF };
-		return CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                      buffer.data(),
-		                                                      CAN_DATA_LENGTH,
-		                                                      myControlFunction,
-		                                                      partnerControlFunction,
-		                                                      CANIdentifier::CANPriority::Priority5);
+		return myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                 buffer.data(),
+		                                                                 CAN_DATA_LENGTH,
+		                                                                 myControlFunction,
+		                                                                 partnerControlFunction,
+		                                                                 CANIdentifier::CANPriority::Priority5);
 	}
 
 	void VirtualTerminalClient::update_auxiliary_input_status()
@@ -2198,21 +2198,21 @@ namespace isobus
 				                                                         operatingState };
 			if (get_auxiliary_input_learn_mode_enabled())
 			{
-				retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-				                                                        buffer.data(),
-				                                                        CAN_DATA_LENGTH,
-				                                                        myControlFunction,
-				                                                        partnerControlFunction,
-				                                                        CANIdentifier::CANPriority::Priority3);
+				retVal = myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+				                                                                   buffer.data(),
+				                                                                   CAN_DATA_LENGTH,
+				                                                                   myControlFunction,
+				                                                                   partnerControlFunction,
+				                                                                   CANIdentifier::CANPriority::Priority3);
 			}
 			else
 			{
-				retVal = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::VirtualTerminalToECU),
-				                                                        buffer.data(),
-				                                                        CAN_DATA_LENGTH,
-				                                                        myControlFunction,
-				                                                        nullptr,
-				                                                        CANIdentifier::CANPriority::Priority3);
+				retVal = myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::VirtualTerminalToECU),
+				                                                                   buffer.data(),
+				                                                                   CAN_DATA_LENGTH,
+				                                                                   myControlFunction,
+				                                                                   nullptr,
+				                                                                   CANIdentifier::CANPriority::Priority3);
 			}
 		}
 		return retVal;
@@ -2348,12 +2348,12 @@ namespace isobus
 								{
 									buffer[7] = static_cast<std::uint8_t>(transactionNumber << 4 | 0x0F);
 								}
-								CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-								                                               buffer.data(),
-								                                               CAN_DATA_LENGTH,
-								                                               parentVT->myControlFunction,
-								                                               parentVT->partnerControlFunction,
-								                                               CANIdentifier::CANPriority::Priority5);
+								parentVT->myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+								                                                                    buffer.data(),
+								                                                                    CAN_DATA_LENGTH,
+								                                                                    parentVT->myControlFunction,
+								                                                                    parentVT->partnerControlFunction,
+								                                                                    CANIdentifier::CANPriority::Priority5);
 							}
 						}
 						break;
@@ -2389,12 +2389,12 @@ namespace isobus
 								{
 									buffer[7] = static_cast<std::uint8_t>(transactionNumber << 4 | 0x0F);
 								}
-								CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-								                                               buffer.data(),
-								                                               CAN_DATA_LENGTH,
-								                                               parentVT->myControlFunction,
-								                                               parentVT->partnerControlFunction,
-								                                               CANIdentifier::CANPriority::Priority5);
+								parentVT->myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+								                                                                    buffer.data(),
+								                                                                    CAN_DATA_LENGTH,
+								                                                                    parentVT->myControlFunction,
+								                                                                    parentVT->partnerControlFunction,
+								                                                                    CANIdentifier::CANPriority::Priority5);
 							}
 						}
 						break;
@@ -2446,12 +2446,12 @@ namespace isobus
 								// VT version is either 4 or 5
 								buffer[5] = touchState;
 							}
-							CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-							                                               buffer.data(),
-							                                               CAN_DATA_LENGTH,
-							                                               parentVT->myControlFunction,
-							                                               parentVT->partnerControlFunction,
-							                                               CANIdentifier::CANPriority::Priority5);
+							parentVT->myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+							                                                                    buffer.data(),
+							                                                                    CAN_DATA_LENGTH,
+							                                                                    parentVT->myControlFunction,
+							                                                                    parentVT->partnerControlFunction,
+							                                                                    CANIdentifier::CANPriority::Priority5);
 						}
 						break;
 
@@ -2495,12 +2495,12 @@ namespace isobus
 								buffer[7] = static_cast<std::uint8_t>(transactionNumber << 4 | 0x0F);
 							}
 
-							CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-							                                               buffer.data(),
-							                                               CAN_DATA_LENGTH,
-							                                               parentVT->myControlFunction,
-							                                               parentVT->partnerControlFunction,
-							                                               CANIdentifier::CANPriority::Priority5);
+							parentVT->myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+							                                                                    buffer.data(),
+							                                                                    CAN_DATA_LENGTH,
+							                                                                    parentVT->myControlFunction,
+							                                                                    parentVT->partnerControlFunction,
+							                                                                    CANIdentifier::CANPriority::Priority5);
 						}
 						break;
 
@@ -2531,12 +2531,12 @@ namespace isobus
 									0xFF,
 									static_cast<std::uint8_t>((transactionNumber << 4) | 0x0F),
 								};
-								CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-								                                               buffer.data(),
-								                                               CAN_DATA_LENGTH,
-								                                               parentVT->myControlFunction,
-								                                               parentVT->partnerControlFunction,
-								                                               CANIdentifier::CANPriority::Priority5);
+								parentVT->myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+								                                                                    buffer.data(),
+								                                                                    CAN_DATA_LENGTH,
+								                                                                    parentVT->myControlFunction,
+								                                                                    parentVT->partnerControlFunction,
+								                                                                    CANIdentifier::CANPriority::Priority5);
 							}
 						}
 						break;
@@ -2569,12 +2569,12 @@ namespace isobus
 							{
 								buffer[3] = static_cast<std::uint8_t>(transactionNumber << 4 | 0x0F);
 							}
-							CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-							                                               buffer.data(),
-							                                               CAN_DATA_LENGTH,
-							                                               parentVT->myControlFunction,
-							                                               parentVT->partnerControlFunction,
-							                                               CANIdentifier::CANPriority::Priority5);
+							parentVT->myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+							                                                                    buffer.data(),
+							                                                                    CAN_DATA_LENGTH,
+							                                                                    parentVT->myControlFunction,
+							                                                                    parentVT->partnerControlFunction,
+							                                                                    CANIdentifier::CANPriority::Priority5);
 						}
 						break;
 
@@ -2610,12 +2610,12 @@ namespace isobus
 								0xFF,
 								0xFF
 							};
-							CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-							                                               buffer.data(),
-							                                               CAN_DATA_LENGTH,
-							                                               parentVT->myControlFunction,
-							                                               parentVT->partnerControlFunction,
-							                                               CANIdentifier::CANPriority::Priority5);
+							parentVT->myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+							                                                                    buffer.data(),
+							                                                                    CAN_DATA_LENGTH,
+							                                                                    parentVT->myControlFunction,
+							                                                                    parentVT->partnerControlFunction,
+							                                                                    CANIdentifier::CANPriority::Priority5);
 						}
 						break;
 
@@ -2648,12 +2648,12 @@ namespace isobus
 								0xFF,
 								0xFF
 							};
-							CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-							                                               buffer.data(),
-							                                               CAN_DATA_LENGTH,
-							                                               parentVT->myControlFunction,
-							                                               parentVT->partnerControlFunction,
-							                                               CANIdentifier::CANPriority::Priority5);
+							parentVT->myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+							                                                                    buffer.data(),
+							                                                                    CAN_DATA_LENGTH,
+							                                                                    parentVT->myControlFunction,
+							                                                                    parentVT->partnerControlFunction,
+							                                                                    CANIdentifier::CANPriority::Priority5);
 						}
 						break;
 
@@ -2676,12 +2676,12 @@ namespace isobus
 								0xFF,
 								0xFF
 							};
-							CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-							                                               buffer.data(),
-							                                               CAN_DATA_LENGTH,
-							                                               parentVT->myControlFunction,
-							                                               parentVT->partnerControlFunction,
-							                                               CANIdentifier::CANPriority::Priority5);
+							parentVT->myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+							                                                                    buffer.data(),
+							                                                                    CAN_DATA_LENGTH,
+							                                                                    parentVT->myControlFunction,
+							                                                                    parentVT->partnerControlFunction,
+							                                                                    CANIdentifier::CANPriority::Priority5);
 						}
 						break;
 
@@ -2714,12 +2714,12 @@ namespace isobus
 								// VT version is 5 or prior
 								buffer[7] = 0xFF;
 							}
-							CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-							                                               buffer.data(),
-							                                               CAN_DATA_LENGTH,
-							                                               parentVT->myControlFunction,
-							                                               parentVT->partnerControlFunction,
-							                                               CANIdentifier::CANPriority::Priority5);
+							parentVT->myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+							                                                                    buffer.data(),
+							                                                                    CAN_DATA_LENGTH,
+							                                                                    parentVT->myControlFunction,
+							                                                                    parentVT->partnerControlFunction,
+							                                                                    CANIdentifier::CANPriority::Priority5);
 						}
 						break;
 
@@ -2744,12 +2744,12 @@ namespace isobus
 									0xFF,
 									0xFF,
 								};
-								CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-								                                               buffer.data(),
-								                                               CAN_DATA_LENGTH,
-								                                               parentVT->myControlFunction,
-								                                               parentVT->partnerControlFunction,
-								                                               CANIdentifier::CANPriority::Priority5);
+								parentVT->myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+								                                                                    buffer.data(),
+								                                                                    CAN_DATA_LENGTH,
+								                                                                    parentVT->myControlFunction,
+								                                                                    parentVT->partnerControlFunction,
+								                                                                    CANIdentifier::CANPriority::Priority5);
 							}
 						}
 						break;
@@ -4585,12 +4585,12 @@ namespace isobus
 			return false;
 		}
 
-		bool success = CANNetworkManager::CANNetwork.send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
-		                                                              data.data(),
-		                                                              data.size(),
-		                                                              myControlFunction,
-		                                                              partnerControlFunction,
-		                                                              CANIdentifier::CANPriority::Priority5);
+		bool success = myControlFunction->get_network_manager().send_can_message(static_cast<std::uint32_t>(CANLibParameterGroupNumber::ECUtoVirtualTerminal),
+		                                                                         data.data(),
+		                                                                         data.size(),
+		                                                                         myControlFunction,
+		                                                                         partnerControlFunction,
+		                                                                         CANIdentifier::CANPriority::Priority5);
 		if (success)
 		{
 			commandAwaitingResponse = true;
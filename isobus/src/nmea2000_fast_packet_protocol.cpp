@@ -16,6 +16,7 @@
 #include "isobus/utility/system_timing.hpp"
 
 #include <algorithm>
+#include <limits>
 
 namespace isobus
 {
@@ -53,6 +54,11 @@ namespace isobus
 	{
 	}
 
+	FastPacketProtocol::FastPacketProtocol(CANNetworkManager &networkManager) :
+	  CANLibProtocol(networkManager)
+	{
+	}
+
 	void FastPacketProtocol::initialize(CANLibBadge<CANNetworkManager>)
 	{
 		if (!initialized)
@@ -64,7 +70,7 @@ namespace isobus
 	void FastPacketProtocol::register_multipacket_message_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent, std::shared_ptr<InternalControlFunction> internalControlFunction)
 	{
 		parameterGroupNumberCallbacks.push_back(ParameterGroupNumberCallbackData(parameterGroupNumber, callback, parent, internalControlFunction));
-		CANNetworkManager::CANNetwork.add_protocol_parameter_group_number_callback(parameterGroupNumber, process_message, this);
+		networkManager.add_protocol_parameter_group_number_callback(parameterGroupNumber, process_message, this);
 	}
 
 	void FastPacketProtocol::remove_multipacket_message_callback(std::uint32_t parameterGroupNumber, CANLibCallback callback, void *parent, std::shared_ptr<InternalControlFunction> internalControlFunction)
@@ -75,7 +81,7 @@ namespace isobus
 		{
 			parameterGroupNumberCallbacks.erase(callbackLocation);
 		}
-		CANNetworkManager::CANNetwork.remove_protocol_parameter_group_number_callback(parameterGroupNumber, process_message, this);
+		networkManager.remove_protocol_parameter_group_number_callback(parameterGroupNumber, process_message, this);
 	}
 
 	bool FastPacketProtocol::send_multipacket_message(std::uint32_t parameterGroupNumber,
@@ -92,19 +98,20 @@ namespace isobus
 
 		if ((nullptr != source) &&
 		    (source->get_address_valid()) &&
+		    (source->get_can_port() < CAN_PORT_MAXIMUM) &&
 		    (parameterGroupNumber >= FP_MIN_PARAMETER_GROUP_NUMBER) &&
 		    (parameterGroupNumber <= FP_MAX_PARAMETER_GROUP_NUMBER) &&
 		    (messageLength <= MAX_PROTOCOL_MESSAGE_LENGTH) &&
 		    ((nullptr != data) ||
 		     (nullptr != frameChunkCallback)))
 		{
-			FastPacketProtocolSession *tempSession = nullptr;
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+			std::unique_lock<std::mutex> lock(sessionMutexes[source->get_can_port()]);
+#endif
+			FastPacketProtocolSession *tempSession = create_session(FastPacketProtocolSession::Direction::Transmit, source->get_can_port(), parameterGroupNumber, source, destination);
 
-			if (!get_session(tempSession, parameterGroupNumber, source, destination))
+			if (nullptr != tempSession)
 			{
-				tempSession = new FastPacketProtocolSession(FastPacketProtocolSession::Direction::Transmit, source->get_can_port());
-				tempSession->sessionMessage.set_source_control_function(source);
-				tempSession->sessionMessage.set_destination_control_function(destination);
 				tempSession->sessionMessage.set_identifier(CANIdentifier(CANIdentifier::Type::Extended, parameterGroupNumber, priority, (destination == nullptr ? 0xFF : destination->get_address()), source->get_address()));
 				if (data != nullptr)
 				{
@@ -127,11 +134,6 @@ namespace isobus
 				{
 					tempSession->packetCount++;
 				}
-#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-				std::unique_lock<std::mutex> lock(sessionMutex);
-#endif
-
-				activeSessions.push_back(tempSession);
 				retVal = true;
 			}
 			else
@@ -147,15 +149,44 @@ namespace isobus
 		return retVal;
 	}
 
-	void FastPacketProtocol::update(CANLibBadge<CANNetworkManager>)
+	std::uint32_t FastPacketProtocol::get_time_until_next_update_ms() const
 	{
+		std::uint32_t retVal = std::numeric_limits<std::uint32_t>::max();
+
+		for (std::uint8_t i = 0; i < CAN_PORT_MAXIMUM; i++)
+		{
 #if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		std::unique_lock<std::mutex> lock(sessionMutex);
+			std::lock_guard<std::mutex> lock(sessionMutexes[i]);
 #endif
+			const bool transmitBlocked = networkManager.get_is_transmit_blocked(i);
+
+			activeSessions[i].for_each([transmitBlocked, &retVal](const FastPacketProtocolSession *session) {
+				if (FastPacketProtocolSession::Direction::Receive == session->sessionDirection)
+				{
+					retVal = std::min(retVal, SystemTiming::get_time_remaining_ms(session->timestamp_ms, FP_TIMEOUT_MS));
+				}
+				else if (!transmitBlocked)
+				{
+					// Transmit sessions send frames on every update, unless the channel is waiting for Tx space
+					retVal = 0;
+				}
+			});
+		}
+		return retVal;
+	}
 
-		for (auto i : activeSessions)
+	void FastPacketProtocol::update_channel(std::uint8_t channelIndex, CANLibBadge<CANNetworkManager>)
+	{
+		if (channelIndex < CAN_PORT_MAXIMUM)
 		{
-			update_state_machine(i);
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+			std::unique_lock<std::mutex> lock(sessionMutexes[channelIndex]);
+#endif
+
+			// Sessions can close while they are updated, which the pool allows during iteration
+			activeSessions[channelIndex].for_each([this](FastPacketProtocolSession *session) {
+				update_state_machine(session);
+			});
 		}
 	}
 
@@ -163,14 +194,15 @@ namespace isobus
 	{
 		if (nullptr != session)
 		{
+			auto &channelHistory = sessionHistory[session->sessionMessage.get_can_port_index()];
 			bool formerSessionMatched = false;
 
-			for (std::size_t i = 0; i < sessionHistory.size(); i++)
+			for (std::size_t i = 0; i < channelHistory.size(); i++)
 			{
-				if ((sessionHistory[i].isoName == session->sessionMessage.get_source_control_function()->get_NAME()) &&
-				    (sessionHistory[i].parameterGroupNumber == session->sessionMessage.get_identifier().get_parameter_group_number()))
+				if ((channelHistory[i].isoName == session->sessionMessage.get_source_control_function()->get_NAME()) &&
+				    (channelHistory[i].parameterGroupNumber == session->sessionMessage.get_identifier().get_parameter_group_number()))
 				{
-					sessionHistory[i].sequenceNumber++;
+					channelHistory[i].sequenceNumber++;
 					formerSessionMatched = true;
 					break;
 				}
@@ -184,7 +216,7 @@ namespace isobus
 					session->sequenceNumber
 				};
 				history.sequenceNumber++;
-				sessionHistory.push_back(history);
+				channelHistory.push_back(history);
 			}
 		}
 	}
@@ -194,15 +226,7 @@ namespace isobus
 		if (nullptr != session)
 		{
 			process_session_complete_callback(session, successful);
-			for (auto currentSession = activeSessions.begin(); currentSession != activeSessions.end(); currentSession++)
-			{
-				if (session == *currentSession)
-				{
-					activeSessions.erase(currentSession);
-					delete session;
-					break;
-				}
-			}
+			activeSessions[session->sessionMessage.get_can_port_index()].destroy(session);
 		}
 	}
 
@@ -212,7 +236,7 @@ namespace isobus
 
 		if (nullptr != session)
 		{
-			for (auto &formerSessions : sessionHistory)
+			for (auto &formerSessions : sessionHistory[session->sessionMessage.get_can_port_index()])
 			{
 				if ((formerSessions.isoName == session->sessionMessage.get_source_control_function()->get_NAME()) &&
 				    (formerSessions.parameterGroupNumber == session->sessionMessage.get_identifier().get_parameter_group_number()))
@@ -225,23 +249,41 @@ namespace isobus
 		return retVal;
 	}
 
-	bool FastPacketProtocol::get_session(FastPacketProtocolSession *&returnedSession, std::uint32_t parameterGroupNumber, std::shared_ptr<ControlFunction> source, std::shared_ptr<ControlFunction> destination)
+	FastPacketProtocol::FastPacketProtocolSession *FastPacketProtocol::create_session(FastPacketProtocolSession::Direction sessionDirection, std::uint8_t canPortIndex, std::uint32_t parameterGroupNumber, std::shared_ptr<ControlFunction> source, std::shared_ptr<ControlFunction> destination)
 	{
-		returnedSession = nullptr;
-#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-		std::unique_lock<std::mutex> lock(sessionMutex);
-#endif
+		FastPacketProtocolSession *retVal = nullptr;
 
-		for (auto session : activeSessions)
+		if (canPortIndex < CAN_PORT_MAXIMUM)
 		{
-			if ((session->sessionMessage.get_identifier().get_parameter_group_number() == parameterGroupNumber) &&
-			    (session->sessionMessage.get_source_control_function() == source) &&
-			    (session->sessionMessage.get_destination_control_function() == destination))
+			auto &channelSessions = activeSessions[canPortIndex];
+
+			// Fast packet sessions are short, but a busy NMEA 2000 bus can have a lot of them at once, so grow if needed
+			channelSessions.reserve_for_one_more(networkManager.get_configuration().get_max_number_transport_protocol_sessions());
+			retVal = channelSessions.create(ProtocolSessionKey(source, destination, parameterGroupNumber), sessionDirection, canPortIndex);
+
+			if (nullptr != retVal)
 			{
-				returnedSession = session;
-				break;
+				retVal->sessionMessage.set_source_control_function(source);
+				retVal->sessionMessage.set_destination_control_function(destination);
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+				networkManager.get_instrumentation().record_queue_depth(CANStackInstrumentation::Queue::FastPacketProtocolSessions, canPortIndex, channelSessions.size());
+#endif
 			}
 		}
+		return retVal;
+	}
+
+	bool FastPacketProtocol::get_session(FastPacketProtocolSession *&returnedSession, std::uint32_t parameterGroupNumber, std::shared_ptr<ControlFunction> source, std::shared_ptr<ControlFunction> destination)
+	{
+		returnedSession = nullptr;
+
+		if ((nullptr != source) && (source->get_can_port() < CAN_PORT_MAXIMUM))
+		{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+			std::unique_lock<std::mutex> lock(sessionMutexes[source->get_can_port()]);
+#endif
+			returnedSession = activeSessions[source->get_can_port()].find(ProtocolSessionKey(source, destination, parameterGroupNumber));
+		}
 		return (nullptr != returnedSession);
 	}
 
@@ -278,7 +320,7 @@ namespace isobus
 				if (pgnNeedsParsing)
 				{
 					FastPacketProtocolSession *currentSession = nullptr;
-					std::vector<std::uint8_t> messageData = message.get_data();
+					const auto &messageData = message.get_data();
 					std::uint8_t frameCount = (messageData[0] & FRAME_COUNTER_BIT_MASK);
 
 					// Check for a valid session
@@ -300,6 +342,7 @@ namespace isobus
 								}
 							}
 							currentSession->processedPacketsThisSession++;
+							currentSession->sessionMessage.set_timestamp_us(message.get_timestamp_us());
 
 							if (static_cast<std::uint32_t>((currentSession->processedPacketsThisSession * PROTOCOL_BYTES_PER_FRAME) - 1) >= currentSession->sessionMessage.get_data_length())
 							{
@@ -329,7 +372,10 @@ namespace isobus
 							if (messageData[1] <= MAX_PROTOCOL_MESSAGE_LENGTH)
 							{
 								// This is the beginning of a new message
-								currentSession = new FastPacketProtocolSession(FastPacketProtocolSession::Direction::Receive, message.get_can_port_index());
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+								std::unique_lock<std::mutex> lock(sessionMutexes[message.get_can_port_index()]);
+#endif
+								currentSession = create_session(FastPacketProtocolSession::Direction::Receive, message.get_can_port_index(), message.get_identifier().get_parameter_group_number(), message.get_source_control_function(), message.get_destination_control_function());
 								currentSession->frameChunkCallback = nullptr;
 								if (messageData[1] >= PROTOCOL_BYTES_PER_FRAME - 1)
 								{
@@ -343,9 +389,8 @@ namespace isobus
 								currentSession->processedPacketsThisSession = 1;
 								currentSession->sessionMessage.set_data_size(messageData[1]);
 								currentSession->sessionMessage.set_identifier(message.get_identifier());
-								currentSession->sessionMessage.set_source_control_function(message.get_source_control_function());
-								currentSession->sessionMessage.set_destination_control_function(message.get_destination_control_function());
-								currentSession->timestamp_ms = SystemTiming::get_timestamp_ms();
+								currentSession->sessionMessage.set_timestamp_us(message.get_timestamp_us());
+								currentSession->timestamp_ms = message.get_timestamp_ms();
 
 								if (0 != (messageData[1] % PROTOCOL_BYTES_PER_FRAME))
 								{
@@ -357,11 +402,6 @@ namespace isobus
 								{
 									currentSession->sessionMessage.set_data(messageData[2 + i], i);
 								}
-#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
-								std::unique_lock<std::mutex> lock(sessionMutex);
-#endif
-
-								activeSessions.push_back(currentSession);
 							}
 							else
 							{
@@ -501,14 +541,14 @@ namespace isobus
 								}
 							}
 						}
-						if (CANNetworkManager::CANNetwork.send_can_message(session->sessionMessage.get_identifier().get_parameter_group_number(),
-						                                                   dataBuffer.data(),
-						                                                   CAN_DATA_LENGTH,
-						                                                   std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_source_control_function()),
-						                                                   session->sessionMessage.get_destination_control_function(),
-						                                                   session->sessionMessage.get_identifier().get_priority(),
-						                                                   nullptr,
-						                                                   nullptr))
+						if (networkManager.send_can_message(session->sessionMessage.get_identifier().get_parameter_group_number(),
+						                                    dataBuffer.data(),
+						                                    CAN_DATA_LENGTH,
+						                                    std::static_pointer_cast<InternalControlFunction>(session->sessionMessage.get_source_control_function()),
+						                                    session->sessionMessage.get_destination_control_function(),
+						                                    session->sessionMessage.get_identifier().get_priority(),
+						                                    nullptr,
+						                                    nullptr))
 						{
 							session->processedPacketsThisSession++;
 							session->timestamp_ms = SystemTiming::get_timestamp_ms();
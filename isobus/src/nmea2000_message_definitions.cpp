@@ -15,7 +15,6 @@
 #include "isobus/isobus/nmea2000_message_definitions.hpp"
 #include "isobus/isobus/can_message.hpp"
 #include "isobus/isobus/can_stack_logger.hpp"
-#include "isobus/utility/system_timing.hpp"
 
 namespace isobus
 {
@@ -143,7 +142,7 @@ namespace isobus
 				retVal |= set_magnetic_deviation(receivedMessage.get_uint16_at(3));
 				retVal |= set_magnetic_variation(receivedMessage.get_uint16_at(5));
 				retVal |= set_sensor_reference(static_cast<HeadingSensorReference>(receivedMessage.get_uint8_at(7) & 0x03));
-				set_timestamp(SystemTiming::get_timestamp_ms());
+				set_timestamp(receivedMessage.get_timestamp_ms());
 			}
 			else
 			{
@@ -234,7 +233,7 @@ namespace isobus
 				turnRate |= (static_cast<std::int32_t>(receivedMessage.get_uint8_at(4)) << 24);
 				retVal |= set_sequence_id(receivedMessage.get_uint8_at(0));
 				retVal |= set_rate_of_turn(turnRate);
-				set_timestamp(SystemTiming::get_timestamp_ms());
+				set_timestamp(receivedMessage.get_timestamp_ms());
 			}
 			else
 			{
@@ -334,7 +333,7 @@ namespace isobus
 				decodedLongitude |= (static_cast<std::int32_t>(receivedMessage.get_uint8_at(7)) << 24);
 				retVal |= set_latitude(decodedLatitude);
 				retVal |= set_longitude(decodedLongitude);
-				set_timestamp(SystemTiming::get_timestamp_ms());
+				set_timestamp(receivedMessage.get_timestamp_ms());
 			}
 			else
 			{
@@ -452,7 +451,7 @@ namespace isobus
 				retVal |= set_course_over_ground_reference(static_cast<CourseOverGroundReference>(receivedMessage.get_uint8_at(1) & 0x03));
 				retVal |= set_course_over_ground(receivedMessage.get_uint16_at(2));
 				retVal |= set_speed_over_ground(receivedMessage.get_uint16_at(4));
-				set_timestamp(SystemTiming::get_timestamp_ms());
+				set_timestamp(receivedMessage.get_timestamp_ms());
 			}
 			else
 			{
@@ -575,7 +574,7 @@ namespace isobus
 				retVal |= set_time_delta(receivedMessage.get_uint8_at(1));
 				retVal |= set_latitude_delta(receivedMessage.get_uint24_at(2));
 				retVal |= set_longitude_delta(receivedMessage.get_uint24_at(5));
-				set_timestamp(SystemTiming::get_timestamp_ms());
+				set_timestamp(receivedMessage.get_timestamp_ms());
 			}
 			else
 			{
@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+
+#include "isobus/isobus/can_network_manager.hpp"
+#include "isobus/utility/callback_executor.hpp"
+#include "isobus/utility/event_dispatcher.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace isobus;
+
+TEST(CALLBACK_EXECUTOR_TESTS, QueuesUntilRunPendingWithoutThreads)
+{
+	CallbackExecutor executor;
+	std::vector<int> results;
+	int subscriber = 0;
+
+	EXPECT_EQ(0, executor.get_number_of_threads());
+	EXPECT_FALSE(executor.set_queue_limit(0));
+	EXPECT_TRUE(executor.set_queue_limit(3));
+	EXPECT_EQ(3, executor.get_queue_limit());
+
+	for (int i = 0; i < 4; i++)
+	{
+		EXPECT_EQ(i < 3, executor.post(&subscriber, [&results, i]() { results.push_back(i); }));
+	}
+	EXPECT_TRUE(results.empty());
+	EXPECT_EQ(3, executor.get_number_pending());
+	EXPECT_EQ(1, executor.get_number_dropped());
+
+	EXPECT_EQ(3, executor.run_pending());
+	EXPECT_EQ(0, executor.get_number_pending());
+	ASSERT_EQ(3, results.size());
+	EXPECT_EQ(0, results[0]);
+	EXPECT_EQ(1, results[1]);
+	EXPECT_EQ(2, results[2]);
+}
+
+TEST(CALLBACK_EXECUTOR_TESTS, KeepsOrderForEachSubscriber)
+{
+	constexpr int NUMBER_OF_SUBSCRIBERS = 8;
+	constexpr int CALLBACKS_PER_SUBSCRIBER = 200;
+	CallbackExecutor executor;
+	std::array<std::vector<int>, NUMBER_OF_SUBSCRIBERS> results;
+	std::array<std::atomic_bool, NUMBER_OF_SUBSCRIBERS> running = {};
+	std::atomic_bool overlapped = { false };
+
+	executor.set_number_of_threads(4);
+	EXPECT_EQ(4, executor.get_number_of_threads());
+	executor.set_queue_limit(NUMBER_OF_SUBSCRIBERS * CALLBACKS_PER_SUBSCRIBER);
+
+	for (int i = 0; i < CALLBACKS_PER_SUBSCRIBER; i++)
+	{
+		for (int j = 0; j < NUMBER_OF_SUBSCRIBERS; j++)
+		{
+			ASSERT_TRUE(executor.post(&results[j], [&results, &running, &overlapped, i, j]() {
+				// Each subscriber's callbacks should never run at the same time as each other
+				if (running[j].exchange(true))
+				{
+					overlapped = true;
+				}
+				results[j].push_back(i);
+				running[j] = false;
+			}));
+		}
+	}
+	ASSERT_TRUE(executor.wait_until_idle(5000));
+	EXPECT_FALSE(overlapped);
+
+	for (const auto &subscriberResults : results)
+	{
+		ASSERT_EQ(CALLBACKS_PER_SUBSCRIBER, subscriberResults.size());
+		for (int i = 0; i < CALLBACKS_PER_SUBSCRIBER; i++)
+		{
+			EXPECT_EQ(i, subscriberResults[i]);
+		}
+	}
+	EXPECT_EQ(0, executor.get_number_dropped());
+}
+
+TEST(CALLBACK_EXECUTOR_TESTS, ChangingThreadsKeepsQueuedCallbacks)
+{
+	CallbackExecutor executor;
+	std::vector<int> results;
+	int subscriber = 0;
+
+	for (int i = 0; i < 10; i++)
+	{
+		executor.post(&subscriber, [&results, i]() { results.push_back(i); });
+	}
+	executor.set_number_of_threads(2);
+	ASSERT_TRUE(executor.wait_until_idle(5000));
+	ASSERT_EQ(10, results.size());
+	for (int i = 0; i < 10; i++)
+	{
+		EXPECT_EQ(i, results[i]);
+	}
+}
+
+TEST(CALLBACK_EXECUTOR_TESTS, ChangingThreadsWaitsForRunPending)
+{
+	CallbackExecutor executor;
+	std::array<int, 8> subscribers = {};
+	std::atomic<int> callbacksRun = { 0 };
+	std::atomic_bool firstCallbackStarted = { false };
+	std::atomic_bool releaseFirstCallback = { false };
+	std::atomic_bool threadsChanged = { false };
+
+	executor.post(&subscribers[0], [&]() {
+		firstCallbackStarted = true;
+		for (int i = 0; (i < 5000) && !releaseFirstCallback; i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		callbacksRun++;
+	});
+	for (int i = 0; i < 100; i++)
+	{
+		executor.post(&subscribers[i % subscribers.size()], [&callbacksRun]() { callbacksRun++; });
+	}
+
+	// Resize while another thread is part way through running the queued callbacks
+	std::thread runner([&executor]() { executor.run_pending(); });
+	for (int i = 0; (i < 5000) && !firstCallbackStarted; i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	ASSERT_TRUE(firstCallbackStarted);
+
+	std::thread resizer([&executor, &threadsChanged]() {
+		executor.set_number_of_threads(4);
+		threadsChanged = true;
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	EXPECT_FALSE(threadsChanged);
+
+	releaseFirstCallback = true;
+	runner.join();
+	resizer.join();
+	EXPECT_TRUE(threadsChanged);
+	EXPECT_EQ(4, executor.get_number_of_threads());
+	ASSERT_TRUE(executor.wait_until_idle(5000));
+	EXPECT_EQ(101, callbacksRun);
+}
+
+TEST(CALLBACK_EXECUTOR_TESTS, EventDispatcherListenerRunsOnExecutor)
+{
+	CallbackExecutor executor;
+	EventDispatcher<int> dispatcher;
+	std::vector<int> results;
+
+	auto listener = dispatcher.add_listener([&results](const int &value) { results.push_back(value); }, executor);
+	dispatcher.call(1);
+	dispatcher.invoke(2);
+	EXPECT_TRUE(results.empty());
+
+	executor.run_pending();
+	ASSERT_EQ(2, results.size());
+	EXPECT_EQ(1, results[0]);
+	EXPECT_EQ(2, results[1]);
+}
+
+namespace
+{
+	struct SlowSubscriber
+	{
+		std::mutex resultsMutex;
+		std::vector<std::uint8_t> firstBytes;
+	};
+
+	void slow_pgn_callback(const CANMessage &message, void *parent)
+	{
+		auto subscriber = static_cast<SlowSubscriber *>(parent);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		const std::lock_guard<std::mutex> lock(subscriber->resultsMutex);
+		subscriber->firstBytes.push_back(message.get_uint8_at(0));
+	}
+} // namespace
+
+TEST(CALLBACK_EXECUTOR_TESTS, NetworkManagerPostsApplicationCallbacks)
+{
+	constexpr std::uint8_t NUMBER_OF_MESSAGES = 5;
+	CANNetworkManager network;
+	CallbackExecutor executor;
+	SlowSubscriber subscriber;
+
+	executor.set_number_of_threads(1);
+	network.add_any_control_function_parameter_group_number_callback(0xFEF1, slow_pgn_callback, &subscriber, &executor);
+	network.update();
+
+	CANMessageFrame frame = {};
+	frame.identifier = 0x18FEF180;
+	frame.isExtendedFrame = true;
+	frame.dataLength = 8;
+	for (std::uint8_t i = 0; i < NUMBER_OF_MESSAGES; i++)
+	{
+		frame.data[0] = i;
+		network.on_can_frame_received(frame);
+	}
+
+	// The slow callback shouldn't hold up the update, it runs on the executor instead
+	const auto updateStart = std::chrono::steady_clock::now();
+	network.update();
+	EXPECT_LT(std::chrono::steady_clock::now() - updateStart, std::chrono::milliseconds(20 * NUMBER_OF_MESSAGES));
+
+	ASSERT_TRUE(executor.wait_until_idle(5000));
+	ASSERT_EQ(NUMBER_OF_MESSAGES, subscriber.firstBytes.size());
+	for (std::uint8_t i = 0; i < NUMBER_OF_MESSAGES; i++)
+	{
+		EXPECT_EQ(i, subscriber.firstBytes[i]);
+	}
+	network.remove_any_control_function_parameter_group_number_callback(0xFEF1, slow_pgn_callback, &subscriber);
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+
+#include "isobus/isobus/can_message.hpp"
+#include "isobus/utility/system_timing.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+using namespace isobus;
+
+TEST(CAN_MESSAGE_TESTS, SingleFramePayloadIsStoredInline)
+{
+	CANMessage message(0);
+	const std::uint8_t payload[] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+
+	message.set_data(payload, sizeof(payload));
+	EXPECT_EQ(8, message.get_data_length());
+	EXPECT_TRUE(message.get_data().is_inline());
+	EXPECT_EQ(0x0807060504030201, message.get_uint64_at(0));
+	EXPECT_THROW(message.get_uint8_at(8), std::out_of_range);
+
+	// Code written against the old vector-based API still works
+	std::vector<std::uint8_t> asVector = message.get_data();
+	EXPECT_EQ((std::vector<std::uint8_t>{ 1, 2, 3, 4, 5, 6, 7, 8 }), asVector);
+}
+
+TEST(CAN_MESSAGE_TESTS, LongPayloadSpillsToHeap)
+{
+	CANMessage message(0);
+	std::uint8_t payload[40];
+
+	for (std::uint8_t i = 0; i < sizeof(payload); i++)
+	{
+		payload[i] = i + 1;
+	}
+
+	// A full CAN FD frame still fits inline
+	message.set_data_size(CAN_FD_DATA_LENGTH);
+	EXPECT_TRUE(message.get_data().is_inline());
+	message.set_data_size(0);
+
+	message.set_data(payload, sizeof(payload));
+	EXPECT_TRUE(message.get_data().is_inline());
+
+	// Appending past the inline capacity keeps the existing bytes
+	message.set_data(payload, sizeof(payload));
+	EXPECT_FALSE(message.get_data().is_inline());
+	EXPECT_EQ(80, message.get_data_length());
+	EXPECT_EQ(40, message.get_uint8_at(39));
+	EXPECT_EQ(1, message.get_uint8_at(40));
+
+	message.set_data_size(1785);
+	EXPECT_EQ(1785, message.get_data_length());
+	EXPECT_EQ(0, message.get_uint8_at(1784));
+	message.set_data(0xAA, 1784);
+	EXPECT_EQ(0xAA, message.get_uint8_at(1784));
+}
+
+TEST(CAN_MESSAGE_TESTS, SharedPayloadIsBorrowedUntilWritten)
+{
+	auto pool = std::make_shared<std::vector<std::uint8_t>>(2000, 0x5A);
+	std::shared_ptr<const std::uint8_t> sharedPool(pool, pool->data());
+
+	{
+		CANMessage message(0);
+		message.set_shared_data(sharedPool, 2000);
+		EXPECT_TRUE(message.get_data().is_shared());
+		EXPECT_FALSE(message.get_data().is_inline());
+		EXPECT_EQ(pool->data(), message.get_data().data());
+		EXPECT_EQ(2000, message.get_data_length());
+		EXPECT_EQ(3, pool.use_count());
+
+		// Copies share the same bytes too
+		CANMessage copy(message);
+		EXPECT_EQ(pool->data(), copy.get_data().data());
+		EXPECT_EQ(4, pool.use_count());
+
+		// Reading through a non-const buffer doesn't copy either, only asking for mutable bytes does
+		CANMessageData borrowed;
+		borrowed.share(sharedPool, 2000);
+		EXPECT_EQ(pool->data(), borrowed.data());
+		EXPECT_EQ(0x5A, borrowed[1999]);
+		EXPECT_TRUE(borrowed.is_shared());
+		EXPECT_NE(pool->data(), borrowed.mutable_data());
+		EXPECT_FALSE(borrowed.is_shared());
+		EXPECT_EQ(0x5A, borrowed.data()[1999]);
+
+		// Writing makes a private copy and leaves the shared bytes alone
+		copy.set_data(0x01, 0);
+		EXPECT_FALSE(copy.get_data().is_shared());
+		EXPECT_EQ(0x01, copy.get_uint8_at(0));
+		EXPECT_EQ(0x5A, copy.get_uint8_at(1999));
+		EXPECT_EQ(0x5A, (*pool)[0]);
+		EXPECT_EQ(3, pool.use_count());
+
+		std::uint8_t packet[7];
+		EXPECT_EQ(3, message.get_data().read(1997, packet, sizeof(packet)));
+		EXPECT_EQ(0x5A, packet[2]);
+	}
+	EXPECT_EQ(2, pool.use_count());
+}
+
+TEST(CAN_MESSAGE_TESTS, MoveLeavesSourceEmpty)
+{
+	CANMessage shortMessage(1);
+	const std::uint8_t payload[] = { 0x11, 0x22 };
+	shortMessage.set_data(payload, sizeof(payload));
+
+	CANMessage movedShort(std::move(shortMessage));
+	EXPECT_EQ(1, movedShort.get_can_port_index());
+	EXPECT_EQ(0x2211, movedShort.get_uint16_at(0));
+	EXPECT_EQ(0, shortMessage.get_data_length());
+
+	CANMessage longMessage(2);
+	longMessage.set_data_size(100);
+	longMessage.set_data(0x55, 99);
+	const std::uint8_t *heapBuffer = longMessage.get_data().data();
+
+	CANMessage movedLong(0);
+	movedLong = std::move(longMessage);
+	EXPECT_EQ(2, movedLong.get_can_port_index());
+	EXPECT_EQ(100, movedLong.get_data_length());
+	EXPECT_EQ(0x55, movedLong.get_uint8_at(99));
+	// The heap buffer is handed over rather than copied
+	EXPECT_EQ(heapBuffer, movedLong.get_data().data());
+	EXPECT_EQ(0, longMessage.get_data_length());
+	EXPECT_TRUE(longMessage.get_data().is_inline());
+
+	// Copies are independent
+	CANMessage copy(movedLong);
+	copy.set_data(0x66, 99);
+	EXPECT_EQ(0x55, movedLong.get_uint8_at(99));
+	EXPECT_EQ(0x66, copy.get_uint8_at(99));
+}
+
+TEST(CAN_MESSAGE_TESTS, ReceiveTimestamp)
+{
+	CANMessage message(0);
+
+	// Without a receive time, the message reports the current time
+	std::uint64_t before = SystemTiming::get_timestamp_us();
+	std::uint64_t timestamp = message.get_timestamp_us();
+	EXPECT_GE(timestamp, before);
+	EXPECT_LE(timestamp, SystemTiming::get_timestamp_us());
+
+	message.set_timestamp_us(1234567);
+	EXPECT_EQ(1234567, message.get_timestamp_us());
+	EXPECT_EQ(1234, message.get_timestamp_ms());
+
+	// The receive time goes along with the message
+	CANMessage moved(std::move(message));
+	EXPECT_EQ(1234567, moved.get_timestamp_us());
+}
@@ -8,8 +8,14 @@
 #include "isobus/isobus/can_partnered_control_function.hpp"
 #include "isobus/utility/system_timing.hpp"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <thread>
+#include <type_traits>
+#include <vector>
 
 #include "helpers/control_function_helpers.hpp"
 #include "helpers/messaging_helpers.hpp"
@@ -71,7 +77,7 @@ TEST(CORE_TESTS, BusloadTest)
 	EXPECT_EQ(0.0f, CANNetworkManager::CANNetwork.get_estimated_busload(200)); // Invalid channel should return zero load
 
 	// Send a bunch of messages through the receive process
-	CANMessageFrame testFrame;
+	CANMessageFrame testFrame = {};
 	testFrame.dataLength = 8;
 	testFrame.channel = 0;
 	testFrame.isExtendedFrame = true;
@@ -290,3 +296,467 @@ TEST(CORE_TESTS, SimilarControlFunctions)
 	EXPECT_EQ(TestPartner->get_NAME().get_full_name(), 0xa0000F000425e9f8);
 	EXPECT_TRUE(TestPartner->destroy());
 }
+
+TEST(CORE_TESTS, UpdateScheduling)
+{
+	CANHardwareInterface::set_number_of_can_channels(1);
+	CANHardwareInterface::assign_can_channel_frame_handler(0, std::make_shared<VirtualCANPlugin>());
+	CANHardwareInterface::start();
+
+	std::atomic<std::uint32_t> updateRequestCount = { 0 };
+	auto listener = CANNetworkManager::CANNetwork.get_update_requested_event_dispatcher().add_listener([&updateRequestCount]() {
+		updateRequestCount++;
+	});
+
+	// Creating an internal control function should ask for an update so that address claiming starts right away
+	auto internalECU = test_helpers::claim_internal_control_function(0x46, 0);
+	EXPECT_NE(0, updateRequestCount);
+
+	// Starting a BAM session should also ask for an update, and the next one should be due within the BAM frame gap
+	updateRequestCount = 0;
+	std::uint8_t testData[9] = { 0 };
+	ASSERT_TRUE(CANNetworkManager::CANNetwork.send_can_message(0xFF00, testData, sizeof(testData), internalECU));
+	EXPECT_NE(0, updateRequestCount);
+	EXPECT_LE(CANNetworkManager::CANNetwork.get_time_until_next_update_ms(), CANNetworkManager::CANNetwork.get_configuration().get_minimum_time_between_transport_protocol_bam_frames());
+
+	// Let the session finish
+	std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+	EXPECT_TRUE(internalECU->destroy());
+	CANHardwareInterface::stop();
+}
+
+TEST(CORE_TESTS, CANFDSingleFrame)
+{
+	VirtualCANPlugin busMonitor;
+	busMonitor.open();
+	CANHardwareInterface::set_number_of_can_channels(1);
+	CANHardwareInterface::assign_can_channel_frame_handler(0, std::make_shared<VirtualCANPlugin>());
+	CANHardwareInterface::start();
+
+	auto internalECU = test_helpers::claim_internal_control_function(0x47, 0);
+	CANNetworkManager::CANNetwork.get_configuration().set_can_fd_enabled(0, true);
+	EXPECT_TRUE(CANNetworkManager::CANNetwork.get_configuration().get_can_fd_enabled(0));
+	EXPECT_FALSE(CANNetworkManager::CANNetwork.get_configuration().get_can_fd_enabled(1));
+
+	// 21 bytes fits in one CAN FD frame, so it should be sent without a transport protocol
+	std::uint8_t testData[21];
+	for (std::uint8_t i = 0; i < sizeof(testData); i++)
+	{
+		testData[i] = i;
+	}
+	ASSERT_TRUE(CANNetworkManager::CANNetwork.send_can_message(0xFF01, testData, sizeof(testData), internalECU));
+
+	CANMessageFrame sentFrame = {};
+	bool foundFrame = false;
+	for (std::uint32_t i = 0; (!foundFrame) && (i < 100); i++)
+	{
+		if (busMonitor.read_frame(sentFrame))
+		{
+			foundFrame = (0xFF01 == CANIdentifier(sentFrame.identifier).get_parameter_group_number());
+		}
+	}
+	ASSERT_TRUE(foundFrame);
+	EXPECT_TRUE(sentFrame.isFDFrame);
+	EXPECT_TRUE(sentFrame.isBitRateSwitch);
+	EXPECT_EQ(24, sentFrame.dataLength); // Padded to the next valid CAN FD length
+	EXPECT_EQ(0, memcmp(testData, sentFrame.data, sizeof(testData)));
+	EXPECT_EQ(0xFF, sentFrame.data[23]);
+
+	// A CAN FD frame carries much more data per bit on the bus than a classical frame
+	CANMessageFrame classicalFrame = {};
+	classicalFrame.isExtendedFrame = true;
+	classicalFrame.dataLength = 8;
+	EXPECT_LT(sentFrame.get_number_bits_in_message(), 3 * classicalFrame.get_number_bits_in_message());
+
+	// Drivers and applications zero frames with memset and build them with braces, so the FD fields mustn't change that
+	EXPECT_TRUE(std::is_trivial<CANMessageFrame>::value);
+
+	EXPECT_EQ(64, CANMessageFrame::get_fd_frame_length(49));
+	EXPECT_EQ(0, CANMessageFrame::get_fd_frame_length(65));
+
+	CANNetworkManager::CANNetwork.get_configuration().set_can_fd_enabled(0, false);
+	EXPECT_TRUE(internalECU->destroy());
+	CANHardwareInterface::stop();
+}
+
+static void send_address_claim(std::uint8_t address, std::uint64_t rawNAME)
+{
+	CANNetworkManager::process_receive_can_message_frame(test_helpers::create_message_frame_broadcast(
+	  6,
+	  0xEE00, // Address Claim PGN
+	  test_helpers::create_mock_control_function(address),
+	  {
+	    static_cast<std::uint8_t>(rawNAME),
+	    static_cast<std::uint8_t>(rawNAME >> 8),
+	    static_cast<std::uint8_t>(rawNAME >> 16),
+	    static_cast<std::uint8_t>(rawNAME >> 24),
+	    static_cast<std::uint8_t>(rawNAME >> 32),
+	    static_cast<std::uint8_t>(rawNAME >> 40),
+	    static_cast<std::uint8_t>(rawNAME >> 48),
+	    static_cast<std::uint8_t>(rawNAME >> 56),
+	  }));
+}
+
+static std::shared_ptr<ControlFunction> find_external_control_function(std::uint64_t rawNAME)
+{
+	std::shared_ptr<ControlFunction> retVal = nullptr;
+
+	for (const auto &controlFunction : CANNetworkManager::CANNetwork.get_control_functions(false))
+	{
+		if ((ControlFunction::Type::External == controlFunction->get_type()) &&
+		    (rawNAME == controlFunction->get_NAME().get_full_name()))
+		{
+			retVal = controlFunction;
+		}
+	}
+	return retVal;
+}
+
+TEST(CORE_TESTS, AddressClaimNameIndex)
+{
+	CANNetworkManager::CANNetwork.update();
+
+	// Using a made up manufacturer code so these don't match any partners from other tests
+	constexpr std::uint64_t BASE_NAME = 0xA00082000FFE0000;
+	constexpr std::uint8_t NUMBER_OF_ECUS = 100;
+
+	for (std::uint8_t i = 0; i < NUMBER_OF_ECUS; i++)
+	{
+		send_address_claim(0x10 + i, BASE_NAME + i);
+	}
+	CANNetworkManager::CANNetwork.update();
+
+	std::vector<std::shared_ptr<ControlFunction>> externalECUs;
+	for (std::uint8_t i = 0; i < NUMBER_OF_ECUS; i++)
+	{
+		externalECUs.push_back(find_external_control_function(BASE_NAME + i));
+		ASSERT_NE(nullptr, externalECUs.back());
+		EXPECT_EQ(0x10 + i, externalECUs.back()->get_address());
+	}
+
+	// Claiming again at the same address shouldn't create anything new
+	send_address_claim(0x10, BASE_NAME);
+	CANNetworkManager::CANNetwork.update();
+	EXPECT_EQ(externalECUs[0], find_external_control_function(BASE_NAME));
+	EXPECT_EQ(0x10, externalECUs[0]->get_address());
+
+	// A known NAME claiming a new address should be moved, not duplicated
+	send_address_claim(0xA0, BASE_NAME);
+	CANNetworkManager::CANNetwork.update();
+	EXPECT_EQ(externalECUs[0], find_external_control_function(BASE_NAME));
+	EXPECT_EQ(0xA0, externalECUs[0]->get_address());
+
+	// A new NAME taking an address that is in use should knock the old owner off of it
+	send_address_claim(0x11, BASE_NAME + NUMBER_OF_ECUS);
+	CANNetworkManager::CANNetwork.update();
+	auto newECU = find_external_control_function(BASE_NAME + NUMBER_OF_ECUS);
+	ASSERT_NE(nullptr, newECU);
+	EXPECT_EQ(0x11, newECU->get_address());
+	EXPECT_FALSE(externalECUs[1]->get_address_valid());
+
+	// A known NAME taking another known NAME's address
+	send_address_claim(0x12, BASE_NAME + 3);
+	CANNetworkManager::CANNetwork.update();
+	EXPECT_EQ(externalECUs[3], find_external_control_function(BASE_NAME + 3));
+	EXPECT_EQ(0x12, externalECUs[3]->get_address());
+	EXPECT_FALSE(externalECUs[2]->get_address_valid());
+	EXPECT_EQ(nullptr, find_external_control_function(BASE_NAME + 2));
+
+	// The rest should be untouched
+	for (std::uint8_t i = 4; i < NUMBER_OF_ECUS; i++)
+	{
+		EXPECT_EQ(externalECUs[i], find_external_control_function(BASE_NAME + i));
+		EXPECT_EQ(0x10 + i, externalECUs[i]->get_address());
+	}
+}
+
+static bool forward_frame_to_network(const CANMessageFrame &frame, void *parentPointer)
+{
+	static_cast<CANNetworkManager *>(parentPointer)->on_can_frame_received(frame);
+	return true;
+}
+
+static std::vector<std::uint8_t> independentNetworkRxData;
+static void independent_network_message_received(const CANMessage &message, void *)
+{
+	independentNetworkRxData = message.get_data().to_vector();
+}
+
+TEST(CORE_TESTS, IndependentNetworkManagers)
+{
+	// Two stacks in one process, wired back to back without the hardware layer
+	CANNetworkManager networkA;
+	CANNetworkManager networkB;
+	networkA.set_can_frame_transmit_callback(forward_frame_to_network, &networkB);
+	networkB.set_can_frame_transmit_callback(forward_frame_to_network, &networkA);
+	networkA.initialize();
+	networkB.initialize();
+
+	constexpr std::uint64_t RAW_NAME_A = 0xA00083000FE00001;
+	constexpr std::uint64_t RAW_NAME_B = 0xA00083000FE00002;
+	auto internalECUA = InternalControlFunction::create(NAME(RAW_NAME_A), 0x51, 0, networkA);
+	auto internalECUB = InternalControlFunction::create(NAME(RAW_NAME_B), 0x52, 0, networkB);
+	const std::vector<NAMEFilter> filterA = { NAMEFilter(NAME::NAMEParameters::IdentityNumber, RAW_NAME_A & 0x1FFFFF) };
+	const std::vector<NAMEFilter> filterB = { NAMEFilter(NAME::NAMEParameters::IdentityNumber, RAW_NAME_B & 0x1FFFFF) };
+	auto partnerOnA = PartneredControlFunction::create(0, filterB, networkA);
+	auto partnerOnB = PartneredControlFunction::create(0, filterA, networkB);
+
+	EXPECT_EQ(&networkA, &internalECUA->get_network_manager());
+	EXPECT_EQ(&networkB, &partnerOnB->get_network_manager());
+
+	for (std::uint32_t i = 0; (i < 200) && !(internalECUA->get_address_valid() && internalECUB->get_address_valid() && partnerOnA->get_address_valid() && partnerOnB->get_address_valid()); i++)
+	{
+		networkA.update();
+		networkB.update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+	ASSERT_TRUE(internalECUA->get_address_valid());
+	ASSERT_TRUE(internalECUB->get_address_valid());
+	ASSERT_TRUE(partnerOnA->get_address_valid());
+	ASSERT_TRUE(partnerOnB->get_address_valid());
+	EXPECT_EQ(0x51, partnerOnB->get_address());
+	EXPECT_EQ(0x52, partnerOnA->get_address());
+
+	// Neither stack should leak into the default one
+	auto &defaultInternalCFs = CANNetworkManager::CANNetwork.get_internal_control_functions();
+	EXPECT_EQ(defaultInternalCFs.end(), std::find(defaultInternalCFs.begin(), defaultInternalCFs.end(), internalECUA));
+
+	// Send a destination specific transport protocol message from A to B
+	std::vector<std::uint8_t> txData(100);
+	for (std::uint8_t i = 0; i < txData.size(); i++)
+	{
+		txData[i] = i;
+	}
+	independentNetworkRxData.clear();
+	partnerOnB->add_parameter_group_number_callback(0xEF00, independent_network_message_received, nullptr);
+	ASSERT_TRUE(networkA.send_can_message(0xEF00, txData.data(), txData.size(), internalECUA, partnerOnA));
+
+	for (std::uint32_t i = 0; (i < 200) && independentNetworkRxData.empty(); i++)
+	{
+		networkA.update();
+		networkB.update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	EXPECT_EQ(txData, independentNetworkRxData);
+
+	// Let A process the end of message acknowledgement so its session lets go of the control functions
+	networkA.update();
+	networkB.update();
+
+	partnerOnB->remove_parameter_group_number_callback(0xEF00, independent_network_message_received, nullptr);
+	EXPECT_TRUE(partnerOnA->destroy());
+	EXPECT_TRUE(partnerOnB->destroy());
+	EXPECT_TRUE(internalECUA->destroy());
+	EXPECT_TRUE(internalECUB->destroy());
+}
+
+static std::array<std::vector<std::uint8_t>, CAN_PORT_MAXIMUM> parallelChannelRxData;
+static void parallel_channel_message_received(const CANMessage &message, void *)
+{
+	// Each channel only writes its own slot, so channels updated on different threads don't interfere
+	parallelChannelRxData[message.get_can_port_index()] = message.get_data().to_vector();
+}
+
+TEST(CORE_TESTS, ParallelChannelUpdates)
+{
+	CANNetworkManager networkA;
+	CANNetworkManager networkB;
+	networkA.get_configuration().set_number_of_update_threads(CAN_PORT_MAXIMUM);
+	networkB.get_configuration().set_number_of_update_threads(CAN_PORT_MAXIMUM);
+	EXPECT_EQ(CAN_PORT_MAXIMUM, networkA.get_configuration().get_number_of_update_threads());
+	networkA.set_can_frame_transmit_callback(forward_frame_to_network, &networkB);
+	networkB.set_can_frame_transmit_callback(forward_frame_to_network, &networkA);
+	networkA.initialize();
+	networkB.initialize();
+
+	// The same pair of ECUs on every channel, each channel has its own address table so the addresses can overlap
+	constexpr std::uint64_t RAW_NAME_A = 0xA00083000FE00011;
+	constexpr std::uint64_t RAW_NAME_B = 0xA00083000FE00012;
+	const std::vector<NAMEFilter> filterA = { NAMEFilter(NAME::NAMEParameters::IdentityNumber, RAW_NAME_A & 0x1FFFFF) };
+	const std::vector<NAMEFilter> filterB = { NAMEFilter(NAME::NAMEParameters::IdentityNumber, RAW_NAME_B & 0x1FFFFF) };
+	std::vector<std::shared_ptr<InternalControlFunction>> internalECUs;
+	std::vector<std::shared_ptr<PartneredControlFunction>> partnersOnA;
+	std::vector<std::shared_ptr<PartneredControlFunction>> partnersOnB;
+
+	for (std::uint8_t channel = 0; channel < CAN_PORT_MAXIMUM; channel++)
+	{
+		internalECUs.push_back(InternalControlFunction::create(NAME(RAW_NAME_A), 0x61, channel, networkA));
+		internalECUs.push_back(InternalControlFunction::create(NAME(RAW_NAME_B), 0x62, channel, networkB));
+		partnersOnA.push_back(PartneredControlFunction::create(channel, filterB, networkA));
+		partnersOnB.push_back(PartneredControlFunction::create(channel, filterA, networkB));
+	}
+
+	auto all_addresses_valid = [&]() {
+		return std::all_of(internalECUs.begin(), internalECUs.end(), [](const std::shared_ptr<InternalControlFunction> &icf) { return icf->get_address_valid(); }) &&
+		  std::all_of(partnersOnA.begin(), partnersOnA.end(), [](const std::shared_ptr<PartneredControlFunction> &partner) { return partner->get_address_valid(); }) &&
+		  std::all_of(partnersOnB.begin(), partnersOnB.end(), [](const std::shared_ptr<PartneredControlFunction> &partner) { return partner->get_address_valid(); });
+	};
+
+	for (std::uint32_t i = 0; (i < 200) && !all_addresses_valid(); i++)
+	{
+		networkA.update();
+		networkB.update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+	ASSERT_TRUE(all_addresses_valid());
+
+	// Send a different transport protocol message on every channel at once
+	for (std::uint8_t channel = 0; channel < CAN_PORT_MAXIMUM; channel++)
+	{
+		std::vector<std::uint8_t> txData(100, channel);
+		parallelChannelRxData[channel].clear();
+		partnersOnB[channel]->add_parameter_group_number_callback(0xEF00, parallel_channel_message_received, nullptr);
+		ASSERT_TRUE(networkA.send_can_message(0xEF00, txData.data(), txData.size(), internalECUs[2 * channel], partnersOnA[channel]));
+	}
+
+	auto all_messages_received = [&]() {
+		return std::none_of(parallelChannelRxData.begin(), parallelChannelRxData.end(), [](const std::vector<std::uint8_t> &data) { return data.empty(); });
+	};
+
+	for (std::uint32_t i = 0; (i < 200) && !all_messages_received(); i++)
+	{
+		networkA.update();
+		networkB.update();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	for (std::uint8_t channel = 0; channel < CAN_PORT_MAXIMUM; channel++)
+	{
+		EXPECT_EQ(std::vector<std::uint8_t>(100, channel), parallelChannelRxData[channel]);
+	}
+
+	// Let A process the end of message acknowledgements so its sessions let go of the control functions
+	networkA.update();
+	networkB.update();
+
+	for (std::uint8_t channel = 0; channel < CAN_PORT_MAXIMUM; channel++)
+	{
+		partnersOnB[channel]->remove_parameter_group_number_callback(0xEF00, parallel_channel_message_received, nullptr);
+		EXPECT_TRUE(partnersOnA[channel]->destroy());
+		EXPECT_TRUE(partnersOnB[channel]->destroy());
+	}
+	for (const auto &internalECU : internalECUs)
+	{
+		EXPECT_TRUE(internalECU->destroy());
+	}
+}
+
+static void receive_filter_test_callback(const CANMessage &, void *)
+{
+}
+
+TEST(CORE_TESTS, ReceiveFilters)
+{
+	CANNetworkManager network;
+	std::vector<CANReceiveFilter> filters;
+	std::vector<std::uint8_t> changedChannels;
+	auto listener = network.get_receive_filters_changed_event_dispatcher().add_listener([&changedChannels](const std::uint8_t &channel) { changedChannels.push_back(channel); });
+
+	auto passes_filters = [&filters](std::uint32_t identifier) {
+		return std::any_of(filters.begin(), filters.end(), [identifier](const CANReceiveFilter &filter) {
+			return filter.isExtendedFrame && ((identifier & filter.mask) == (filter.identifier & filter.mask));
+		});
+	};
+
+	network.initialize();
+	EXPECT_FALSE(network.get_receive_filtering_enabled());
+	EXPECT_FALSE(network.get_receive_filters(0, filters));
+	EXPECT_TRUE(filters.empty());
+
+	network.set_receive_filtering_enabled(true);
+	EXPECT_TRUE(network.get_receive_filtering_enabled());
+	network.update();
+	EXPECT_EQ(CAN_PORT_MAXIMUM, changedChannels.size());
+	changedChannels.clear();
+
+	ASSERT_TRUE(network.get_receive_filters(0, filters));
+	EXPECT_FALSE(network.get_receive_filters(CAN_PORT_MAXIMUM, filters));
+	ASSERT_TRUE(network.get_receive_filters(0, filters));
+	EXPECT_TRUE(passes_filters(0x18EAFF80)); // Global request
+	EXPECT_TRUE(passes_filters(0x18EEFF80)); // Address claim
+	EXPECT_TRUE(passes_filters(0x1CECFF80)); // Broadcast TP connection management
+	EXPECT_FALSE(passes_filters(0x18EA2580)); // Request to someone else
+	EXPECT_FALSE(passes_filters(0x18FEF180)); // Nobody wants this yet
+
+	network.add_any_control_function_parameter_group_number_callback(0xFEF1, receive_filter_test_callback, nullptr);
+	network.update();
+	EXPECT_EQ(CAN_PORT_MAXIMUM, changedChannels.size());
+	changedChannels.clear();
+	ASSERT_TRUE(network.get_receive_filters(0, filters));
+	EXPECT_TRUE(passes_filters(0x18FEF180));
+	EXPECT_TRUE(passes_filters(0x0CFEF112));
+	EXPECT_FALSE(passes_filters(0x18FEF280));
+
+	// Nothing changed, so nobody should be told to fetch the filters again
+	network.update();
+	EXPECT_TRUE(changedChannels.empty());
+
+	network.remove_any_control_function_parameter_group_number_callback(0xFEF1, receive_filter_test_callback, nullptr);
+	network.update();
+	ASSERT_TRUE(network.get_receive_filters(0, filters));
+	EXPECT_FALSE(passes_filters(0x18FEF180));
+
+	// Traffic statistics need to see every frame, so they turn the filters off
+	network.get_traffic_statistics().set_enabled(true);
+	EXPECT_FALSE(network.get_receive_filters(0, filters));
+	network.get_traffic_statistics().set_enabled(false);
+	network.set_receive_filtering_enabled(false);
+	EXPECT_FALSE(network.get_receive_filters(0, filters));
+}
+
+static std::atomic<std::uint32_t> concurrentReceiveCount = { 0 };
+static void concurrent_receive_test_callback(const CANMessage &, void *)
+{
+	concurrentReceiveCount++;
+}
+
+TEST(CORE_TESTS, ConcurrentReceiveProducers)
+{
+	constexpr std::uint32_t NUMBER_OF_PRODUCERS = 4;
+	constexpr std::uint32_t FRAMES_PER_PRODUCER = 10000;
+	CANNetworkManager network;
+	network.get_configuration().set_receive_queue_depth(NUMBER_OF_PRODUCERS * FRAMES_PER_PRODUCER);
+	network.initialize();
+	network.add_any_control_function_parameter_group_number_callback(0xFEF1, concurrent_receive_test_callback, nullptr);
+	concurrentReceiveCount = 0;
+
+	// Several threads feed the same channel while it is being updated, none of their frames should be lost
+	std::atomic_bool producing = { true };
+	std::vector<std::thread> producers;
+	for (std::uint32_t i = 0; i < NUMBER_OF_PRODUCERS; i++)
+	{
+		producers.emplace_back([&network, i]() {
+			CANMessageFrame frame = {};
+			frame.identifier = 0x18FEF180 + i;
+			frame.isExtendedFrame = true;
+			frame.dataLength = 8;
+
+			for (std::uint32_t j = 0; j < FRAMES_PER_PRODUCER; j++)
+			{
+				// Hardware timestamps make every producer update the channel's clock offset estimate too
+				frame.timestamp_us = SystemTiming::get_timestamp_us() - 100;
+				network.on_can_frame_received(frame);
+			}
+		});
+	}
+
+	std::thread updater([&network, &producing]() {
+		while (producing)
+		{
+			network.update();
+		}
+	});
+
+	for (auto &producer : producers)
+	{
+		producer.join();
+	}
+	producing = false;
+	updater.join();
+	network.update();
+
+	EXPECT_EQ(NUMBER_OF_PRODUCERS * FRAMES_PER_PRODUCER, concurrentReceiveCount);
+	EXPECT_EQ(0u, network.get_number_rx_messages_dropped(0));
+	network.remove_any_control_function_parameter_group_number_callback(0xFEF1, concurrent_receive_test_callback, nullptr);
+}
@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+
+#include "isobus/hardware_integration/can_hardware_interface.hpp"
+#include "isobus/hardware_integration/virtual_can_plugin.hpp"
+#include "isobus/isobus/can_general_parameter_group_numbers.hpp"
+#include "isobus/isobus/can_network_manager.hpp"
+#include "isobus/utility/system_timing.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "helpers/control_function_helpers.hpp"
+#include "helpers/messaging_helpers.hpp"
+
+using namespace isobus;
+
+static constexpr std::uint32_t OBJECT_POOL_SIZE = 1024 * 1024;
+static constexpr std::uint32_t BYTES_PER_PACKET = 7;
+static constexpr std::uint32_t PACKETS_IN_OBJECT_POOL = ((OBJECT_POOL_SIZE - 1) / BYTES_PER_PACKET) + 1;
+static constexpr std::uint32_t ETP_CM_PGN = static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolConnectionManagement);
+static constexpr std::uint32_t ETP_DT_PGN = static_cast<std::uint32_t>(CANLibParameterGroupNumber::ExtendedTransportProtocolDataTransfer);
+
+static std::atomic_bool txSessionComplete(false);
+static std::atomic_bool txSessionSuccessful(false);
+static std::atomic_bool rxSessionComplete(false);
+static std::vector<std::uint8_t> rxObjectPool;
+
+static void object_pool_transmit_complete(std::uint32_t, std::uint32_t, std::shared_ptr<InternalControlFunction>, std::shared_ptr<ControlFunction>, bool successful, void *)
+{
+	txSessionSuccessful = successful;
+	txSessionComplete = true;
+}
+
+static void object_pool_received(const CANMessage &message, void *)
+{
+	rxObjectPool = message.get_data().to_vector();
+	rxSessionComplete = true;
+}
+
+static CANMessageFrame create_frame(std::uint32_t parameterGroupNumber, std::shared_ptr<ControlFunction> destination, std::shared_ptr<ControlFunction> source, const std::uint8_t *data)
+{
+	CANMessageFrame frame = {};
+	frame.identifier = test_helpers::create_ext_can_id(7, parameterGroupNumber, destination, source);
+	frame.isExtendedFrame = true;
+	frame.dataLength = CAN_DATA_LENGTH;
+	memcpy(frame.data, data, CAN_DATA_LENGTH);
+	return frame;
+}
+
+static CANMessageFrame create_connection_management_frame(std::uint8_t multiplexor, std::uint32_t value1, std::uint32_t value2, std::uint32_t parameterGroupNumber, std::shared_ptr<ControlFunction> destination, std::shared_ptr<ControlFunction> source)
+{
+	const std::uint8_t data[CAN_DATA_LENGTH] = {
+		multiplexor,
+		static_cast<std::uint8_t>(value1),
+		static_cast<std::uint8_t>(value2),
+		static_cast<std::uint8_t>(value2 >> 8),
+		static_cast<std::uint8_t>(value2 >> 16),
+		static_cast<std::uint8_t>(parameterGroupNumber),
+		static_cast<std::uint8_t>(parameterGroupNumber >> 8),
+		static_cast<std::uint8_t>(parameterGroupNumber >> 16)
+	};
+	return create_frame(ETP_CM_PGN, destination, source, data);
+}
+
+TEST(EXTENDED_TRANSPORT_PROTOCOL_TESTS, LargeObjectPoolTransfer)
+{
+	VirtualCANPlugin partnerBus;
+	partnerBus.open();
+	CANHardwareInterface::set_number_of_can_channels(1);
+	CANHardwareInterface::assign_can_channel_frame_handler(0, std::make_shared<VirtualCANPlugin>());
+	CANHardwareInterface::start();
+
+	auto internalECU = test_helpers::claim_internal_control_function(0x4B, 0);
+	auto partnerVT = test_helpers::force_claim_partnered_control_function(0x26, 0);
+	ASSERT_TRUE(internalECU->get_address_valid());
+	ASSERT_EQ(0x4B, internalECU->get_address());
+
+	auto objectPool = std::make_shared<std::vector<std::uint8_t>>(OBJECT_POOL_SIZE);
+	for (std::uint32_t i = 0; i < OBJECT_POOL_SIZE; i++)
+	{
+		(*objectPool)[i] = static_cast<std::uint8_t>((i * 31) + (i >> 8));
+	}
+
+	// Upload the object pool from the stack, acting as the receiving VT on the other end of the bus
+	txSessionComplete = false;
+	txSessionSuccessful = false;
+	std::vector<std::uint8_t> uploadedPool(OBJECT_POOL_SIZE);
+	std::uint32_t packetsReceived = 0;
+	std::uint32_t packetsInBlock = 0;
+	std::uint32_t blockOffset = 0;
+	bool timedOut = false;
+	std::uint32_t lastFrameTimestamp = SystemTiming::get_timestamp_ms();
+
+	// Send straight from the pool, the session should borrow it rather than copy it
+	ASSERT_TRUE(CANNetworkManager::CANNetwork.send_can_message(0xE700, std::shared_ptr<const std::uint8_t>(objectPool, objectPool->data()), OBJECT_POOL_SIZE, internalECU, partnerVT, CANIdentifier::CANPriority::PriorityLowest7, object_pool_transmit_complete));
+	EXPECT_EQ(2, objectPool.use_count());
+
+	while ((!txSessionComplete) && (!timedOut))
+	{
+		CANMessageFrame frame;
+
+		if (partnerBus.read_frame(frame, 10))
+		{
+			const std::uint32_t pgn = CANIdentifier(frame.identifier).get_parameter_group_number();
+
+			if ((ETP_CM_PGN == pgn) && (0x14 == frame.data[0]))
+			{
+				// RTS, ask for the first block
+				partnerBus.write_frame(create_connection_management_frame(0x15, 0xFF, 1, 0xE700, internalECU, partnerVT));
+			}
+			else if ((ETP_CM_PGN == pgn) && (0x16 == frame.data[0]))
+			{
+				// DPO
+				packetsInBlock = frame.data[1];
+				blockOffset = static_cast<std::uint32_t>(frame.data[2]) | (static_cast<std::uint32_t>(frame.data[3]) << 8) | (static_cast<std::uint32_t>(frame.data[4]) << 16);
+			}
+			else if (ETP_DT_PGN == pgn)
+			{
+				const std::uint32_t byteOffset = (blockOffset + frame.data[0] - 1) * BYTES_PER_PACKET;
+				memcpy(&uploadedPool[byteOffset], &frame.data[1], std::min(BYTES_PER_PACKET, OBJECT_POOL_SIZE - byteOffset));
+				packetsReceived++;
+
+				if (PACKETS_IN_OBJECT_POOL == packetsReceived)
+				{
+					partnerBus.write_frame(create_connection_management_frame(0x17, OBJECT_POOL_SIZE & 0xFF, OBJECT_POOL_SIZE >> 8, 0xE700, internalECU, partnerVT));
+				}
+				else if ((blockOffset + packetsInBlock) == packetsReceived)
+				{
+					partnerBus.write_frame(create_connection_management_frame(0x15, std::min<std::uint32_t>(0xFF, PACKETS_IN_OBJECT_POOL - packetsReceived), packetsReceived + 1, 0xE700, internalECU, partnerVT));
+				}
+			}
+		}
+		else
+		{
+			timedOut = SystemTiming::time_expired_ms(lastFrameTimestamp, 1000);
+			continue;
+		}
+		lastFrameTimestamp = SystemTiming::get_timestamp_ms();
+	}
+
+	ASSERT_FALSE(timedOut);
+	EXPECT_TRUE(txSessionSuccessful);
+	EXPECT_EQ(PACKETS_IN_OBJECT_POOL, packetsReceived);
+	EXPECT_EQ(*objectPool, uploadedPool);
+
+	// The session lets go of the pool when it is closed, right after the callback
+	for (std::uint32_t i = 0; (1 != objectPool.use_count()) && (i < 100); i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	EXPECT_EQ(1, objectPool.use_count());
+
+	// Now send the same pool to the stack, which exercises reassembly
+	rxSessionComplete = false;
+	CANNetworkManager::CANNetwork.add_any_control_function_parameter_group_number_callback(0xE700, object_pool_received, nullptr);
+	std::uint32_t packetsSent = 0;
+	timedOut = false;
+	lastFrameTimestamp = SystemTiming::get_timestamp_ms();
+
+	partnerBus.write_frame(create_connection_management_frame(0x14, OBJECT_POOL_SIZE & 0xFF, OBJECT_POOL_SIZE >> 8, 0xE700, internalECU, partnerVT));
+
+	while ((!rxSessionComplete) && (!timedOut))
+	{
+		CANMessageFrame frame;
+
+		if (partnerBus.read_frame(frame, 10))
+		{
+			if ((ETP_CM_PGN == CANIdentifier(frame.identifier).get_parameter_group_number()) && (0x15 == frame.data[0]))
+			{
+				// CTS, send the requested block
+				const std::uint8_t packetsRequested = frame.data[1];
+				partnerBus.write_frame(create_connection_management_frame(0x16, packetsRequested, packetsSent, 0xE700, internalECU, partnerVT));
+
+				for (std::uint8_t i = 0; i < packetsRequested; i++)
+				{
+					std::uint8_t data[CAN_DATA_LENGTH] = { static_cast<std::uint8_t>(i + 1), 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+					const std::uint32_t byteOffset = packetsSent * BYTES_PER_PACKET;
+					memcpy(&data[1], &(*objectPool)[byteOffset], std::min(BYTES_PER_PACKET, OBJECT_POOL_SIZE - byteOffset));
+					partnerBus.write_frame(create_frame(ETP_DT_PGN, internalECU, partnerVT, data));
+					packetsSent++;
+				}
+			}
+		}
+		else
+		{
+			timedOut = SystemTiming::time_expired_ms(lastFrameTimestamp, 1000);
+			continue;
+		}
+		lastFrameTimestamp = SystemTiming::get_timestamp_ms();
+	}
+
+	ASSERT_FALSE(timedOut);
+	EXPECT_EQ(PACKETS_IN_OBJECT_POOL, packetsSent);
+	EXPECT_EQ(*objectPool, rxObjectPool);
+	EXPECT_EQ(0, CANNetworkManager::CANNetwork.get_number_rx_messages_dropped(0));
+
+	CANNetworkManager::CANNetwork.remove_any_control_function_parameter_group_number_callback(0xE700, object_pool_received, nullptr);
+	EXPECT_TRUE(internalECU->destroy());
+	EXPECT_TRUE(partnerVT->destroy());
+	CANHardwareInterface::stop();
+}
@@ -2,14 +2,200 @@
 
 #include "isobus/hardware_integration/can_hardware_interface.hpp"
 #include "isobus/hardware_integration/virtual_can_plugin.hpp"
+#include "isobus/isobus/can_internal_control_function.hpp"
+#include "isobus/isobus/can_network_manager.hpp"
 #include "isobus/utility/system_timing.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <deque>
 #include <future>
+#include <mutex>
 #include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
 
 using namespace isobus;
 
+namespace
+{
+	/// A driver that only accepts frames when the test allows it, like a CAN controller with its mailboxes full
+	class CongestedCANPlugin : public CANHardwarePlugin
+	{
+	public:
+		bool get_is_valid() const override
+		{
+			return true;
+		}
+
+		void close() override
+		{
+		}
+
+		void open() override
+		{
+		}
+
+		bool read_frame(CANMessageFrame &) override
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			return false;
+		}
+
+		bool write_frame(const CANMessageFrame &canFrame) override
+		{
+			bool retVal = false;
+
+			if (!congested)
+			{
+				std::lock_guard<std::mutex> lock(writtenFramesMutex);
+				writtenFrames.push_back(canFrame);
+				retVal = true;
+			}
+			return retVal;
+		}
+
+		std::vector<CANMessageFrame> get_written_frames()
+		{
+			std::lock_guard<std::mutex> lock(writtenFramesMutex);
+			return writtenFrames;
+		}
+
+		std::atomic_bool congested = { true };
+
+	private:
+		std::mutex writtenFramesMutex;
+		std::vector<CANMessageFrame> writtenFrames;
+	};
+
+#ifdef __linux__
+	/// A driver with a pipe that has a byte in it for every frame waiting to be read, like a socket would
+	class PipeCANPlugin : public CANHardwarePlugin
+	{
+	public:
+		PipeCANPlugin()
+		{
+			if (0 == pipe(pipeFileDescriptors))
+			{
+				fcntl(pipeFileDescriptors[0], F_SETFL, O_NONBLOCK);
+			}
+		}
+
+		~PipeCANPlugin()
+		{
+			::close(pipeFileDescriptors[0]);
+			::close(pipeFileDescriptors[1]);
+		}
+
+		bool get_is_valid() const override
+		{
+			return opened;
+		}
+
+		void close() override
+		{
+			opened = false;
+		}
+
+		void open() override
+		{
+			opened = true;
+		}
+
+		bool read_frame(CANMessageFrame &canFrame) override
+		{
+			struct pollfd pollingFileDescriptor = { pipeFileDescriptors[0], POLLIN, 0 };
+			return (1 == poll(&pollingFileDescriptor, 1, 100)) && (1 == read_frames(&canFrame, 1));
+		}
+
+		bool write_frame(const CANMessageFrame &) override
+		{
+			return true;
+		}
+
+		std::size_t read_frames(CANMessageFrame *canFrames, std::size_t maxFrames) override
+		{
+			std::lock_guard<std::mutex> lock(framesMutex);
+			std::size_t retVal = 0;
+			std::uint8_t byte;
+
+			while ((retVal < maxFrames) && (1 == read(pipeFileDescriptors[0], &byte, 1)))
+			{
+				canFrames[retVal] = frames.front();
+				frames.pop_front();
+				retVal++;
+			}
+			readingThreads.push_back(std::this_thread::get_id());
+			return retVal;
+		}
+
+		int get_receive_file_descriptor() const override
+		{
+			std::lock_guard<std::mutex> lock(framesMutex);
+			return pipeFileDescriptors[0];
+		}
+
+		/// Closes the writing end, so the reading end reports a hang up like a socket whose interface went down
+		void hang_up()
+		{
+			std::lock_guard<std::mutex> lock(framesMutex);
+			::close(pipeFileDescriptors[1]);
+			pipeFileDescriptors[1] = -1;
+		}
+
+		/// Replaces the pipe, like a driver that reopens its socket once its interface is back up
+		void reconnect()
+		{
+			std::lock_guard<std::mutex> lock(framesMutex);
+			::close(pipeFileDescriptors[0]);
+			frames.clear();
+			if (0 == pipe(pipeFileDescriptors))
+			{
+				fcntl(pipeFileDescriptors[0], F_SETFL, O_NONBLOCK);
+			}
+		}
+
+		void receive(const CANMessageFrame &canFrame)
+		{
+			const std::uint8_t byte = 0;
+			std::lock_guard<std::mutex> lock(framesMutex);
+			frames.push_back(canFrame);
+			EXPECT_EQ(1, write(pipeFileDescriptors[1], &byte, 1));
+		}
+
+		std::vector<std::thread::id> get_reading_threads()
+		{
+			std::lock_guard<std::mutex> lock(framesMutex);
+			return readingThreads;
+		}
+
+	private:
+		int pipeFileDescriptors[2] = { -1, -1 };
+		std::atomic_bool opened = { false };
+		mutable std::mutex framesMutex;
+		std::deque<CANMessageFrame> frames;
+		std::vector<std::thread::id> readingThreads;
+	};
+#endif
+
+	CANMessageFrame create_prioritized_frame(std::uint8_t priority, std::uint8_t sequence)
+	{
+		CANMessageFrame frame = {};
+		frame.identifier = (static_cast<std::uint32_t>(priority) << 26) | 0x00EB0080;
+		frame.isExtendedFrame = true;
+		frame.dataLength = 1;
+		frame.data[0] = sequence;
+		frame.channel = 0;
+		return frame;
+	}
+}
+
 TEST(HARDWARE_INTERFACE_TESTS, SendMessageToHardware)
 {
 	auto sender = std::make_shared<VirtualCANPlugin>();
@@ -172,3 +358,226 @@ TEST(HARDWARE_INTERFACE_TESTS, PeriodicUpdateIntervalSetting)
 
 	CANHardwareInterface::stop();
 }
+
+TEST(HARDWARE_INTERFACE_TESTS, TransmitInPriorityOrder)
+{
+	auto device = std::make_shared<CongestedCANPlugin>();
+	CANHardwareInterface::set_number_of_can_channels(1);
+	CANHardwareInterface::assign_can_channel_frame_handler(0, device);
+	EXPECT_TRUE(CANHardwareInterface::set_transmit_queue_depth_limit(7, 4));
+	EXPECT_FALSE(CANHardwareInterface::set_transmit_queue_depth_limit(8, 4));
+	EXPECT_EQ(4, CANHardwareInterface::get_transmit_queue_depth_limit(7));
+	EXPECT_EQ(0, CANHardwareInterface::get_transmit_queue_depth_limit(3));
+	CANHardwareInterface::start();
+	EXPECT_FALSE(CANHardwareInterface::set_transmit_queue_depth_limit(7, 8));
+
+	// Bulk transfer frames fill up their class while the driver can't take anything
+	for (std::uint8_t i = 0; i < 4; i++)
+	{
+		EXPECT_TRUE(CANHardwareInterface::transmit_can_frame(create_prioritized_frame(7, i)));
+	}
+	EXPECT_FALSE(CANHardwareInterface::transmit_can_frame(create_prioritized_frame(7, 4)));
+
+	// Other classes still have room, and should get ahead of the bulk transfer
+	EXPECT_TRUE(CANHardwareInterface::transmit_can_frame(create_prioritized_frame(6, 5)));
+	EXPECT_TRUE(CANHardwareInterface::transmit_can_frame(create_prioritized_frame(3, 6)));
+	EXPECT_TRUE(CANHardwareInterface::transmit_can_frame(create_prioritized_frame(3, 7)));
+
+	EXPECT_TRUE(CANHardwareInterface::transmit_can_frame(create_prioritized_frame(0, 8)));
+	device->congested = false;
+
+	std::vector<CANMessageFrame> writtenFrames;
+	for (std::uint32_t i = 0; (i < 500) && (writtenFrames.size() < 8); i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		writtenFrames = device->get_written_frames();
+	}
+	ASSERT_EQ(8, writtenFrames.size());
+
+	EXPECT_EQ(0x08, writtenFrames[0].data[0]);
+	EXPECT_EQ(0x06, writtenFrames[1].data[0]);
+	EXPECT_EQ(0x07, writtenFrames[2].data[0]);
+	for (std::uint8_t i = 0; i < 4; i++)
+	{
+		EXPECT_EQ(i, writtenFrames[4 + i].data[0]);
+	}
+
+	CANHardwareInterface::stop();
+	EXPECT_TRUE(CANHardwareInterface::set_transmit_queue_depth_limit(7, 0));
+}
+
+TEST(HARDWARE_INTERFACE_TESTS, TransmitQueueBackpressure)
+{
+	auto device = std::make_shared<CongestedCANPlugin>();
+	CANHardwareInterface::set_number_of_can_channels(1);
+	CANHardwareInterface::assign_can_channel_frame_handler(0, device);
+	EXPECT_TRUE(CANHardwareInterface::set_transmit_queue_limit(0, 3));
+	EXPECT_FALSE(CANHardwareInterface::set_transmit_queue_limit(1, 3));
+	EXPECT_EQ(3, CANHardwareInterface::get_transmit_queue_limit(0));
+	EXPECT_EQ(0, CANHardwareInterface::get_transmit_queue_limit(1));
+	CANHardwareInterface::start();
+
+	NAME testName(0);
+	testName.set_arbitrary_address_capable(true);
+	testName.set_industry_group(1);
+	testName.set_function_code(static_cast<std::uint8_t>(NAME::Function::SeatControl));
+	testName.set_identity_number(15);
+	testName.set_manufacturer_code(69);
+	auto internalECU = InternalControlFunction::create(testName, 0x1C, 0);
+
+	// The address claim only needs to be queued, so it fits in the limit even though nothing reaches the bus
+	for (std::uint32_t i = 0; (i < 500) && (!internalECU->get_address_valid()); i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	ASSERT_TRUE(internalECU->get_address_valid());
+	EXPECT_FALSE(CANNetworkManager::CANNetwork.get_is_transmit_blocked(0));
+
+	// Fill the rest of the queue, after which sending reports that it would block instead of queuing more
+	const std::array<std::uint8_t, CAN_DATA_LENGTH> data = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	std::size_t messagesQueued = 0;
+	while ((messagesQueued < 10) &&
+	       (CANNetworkManager::CANNetwork.send_can_message(0xEF00, data.data(), data.size(), internalECU)))
+	{
+		messagesQueued++;
+	}
+	EXPECT_EQ(1, messagesQueued);
+	EXPECT_TRUE(CANNetworkManager::CANNetwork.get_is_transmit_blocked(0));
+
+	CANMessageFrame testFrame = {};
+	testFrame.identifier = 0x18EF1CFF;
+	testFrame.isExtendedFrame = true;
+	testFrame.dataLength = CAN_DATA_LENGTH;
+	EXPECT_EQ(CANTransmitResult::WouldBlock, try_send_can_message_frame_to_hardware(testFrame));
+	EXPECT_FALSE(CANHardwareInterface::transmit_can_frame(testFrame));
+	testFrame.channel = 1;
+	EXPECT_EQ(CANTransmitResult::Failed, try_send_can_message_frame_to_hardware(testFrame));
+
+	// Once the bus takes the backlog, the network manager should be told there is space again
+	device->congested = false;
+	for (std::uint32_t i = 0; (i < 500) && (CANNetworkManager::CANNetwork.get_is_transmit_blocked(0)); i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	EXPECT_FALSE(CANNetworkManager::CANNetwork.get_is_transmit_blocked(0));
+	EXPECT_TRUE(CANNetworkManager::CANNetwork.send_can_message(0xEF00, data.data(), data.size(), internalECU));
+
+	EXPECT_TRUE(internalECU->destroy());
+	CANHardwareInterface::stop();
+	EXPECT_TRUE(CANHardwareInterface::set_transmit_queue_limit(0, CANHardwareInterface::DEFAULT_TRANSMIT_QUEUE_LIMIT));
+}
+
+#ifdef __linux__
+TEST(HARDWARE_INTERFACE_TESTS, SharedReceiveThread)
+{
+	constexpr std::uint8_t NUMBER_OF_FRAMES = 50;
+	std::array<std::shared_ptr<PipeCANPlugin>, 2> devices = { std::make_shared<PipeCANPlugin>(), std::make_shared<PipeCANPlugin>() };
+	CANHardwareInterface::set_number_of_can_channels(2);
+	CANHardwareInterface::assign_can_channel_frame_handler(0, devices[0]);
+	CANHardwareInterface::assign_can_channel_frame_handler(1, devices[1]);
+	EXPECT_FALSE(CANHardwareInterface::get_shared_receive_thread_enabled());
+	EXPECT_TRUE(CANHardwareInterface::set_shared_receive_thread_enabled(true));
+	EXPECT_TRUE(CANHardwareInterface::get_shared_receive_thread_enabled());
+	CANHardwareInterface::start();
+	EXPECT_FALSE(CANHardwareInterface::set_shared_receive_thread_enabled(false));
+
+	std::mutex receivedFramesMutex;
+	std::array<std::vector<std::uint8_t>, 2> receivedFrames;
+	auto listener = CANHardwareInterface::get_can_frame_received_event_dispatcher().add_listener([&receivedFramesMutex, &receivedFrames](const CANMessageFrame &frame) {
+		if (frame.channel < receivedFrames.size())
+		{
+			std::lock_guard<std::mutex> lock(receivedFramesMutex);
+			receivedFrames[frame.channel].push_back(frame.data[0]);
+		}
+	});
+
+	for (std::uint8_t i = 0; i < NUMBER_OF_FRAMES; i++)
+	{
+		for (auto &device : devices)
+		{
+			CANMessageFrame frame = {};
+			frame.identifier = 0x18FEF180;
+			frame.isExtendedFrame = true;
+			frame.dataLength = 1;
+			frame.data[0] = i;
+			device->receive(frame);
+		}
+	}
+
+	auto all_frames_received = [&receivedFramesMutex, &receivedFrames]() {
+		std::lock_guard<std::mutex> lock(receivedFramesMutex);
+		return (NUMBER_OF_FRAMES == receivedFrames[0].size()) && (NUMBER_OF_FRAMES == receivedFrames[1].size());
+	};
+	for (std::uint32_t i = 0; (i < 500) && !all_frames_received(); i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	ASSERT_TRUE(all_frames_received());
+	for (const auto &channelFrames : receivedFrames)
+	{
+		for (std::uint8_t i = 0; i < NUMBER_OF_FRAMES; i++)
+		{
+			EXPECT_EQ(i, channelFrames[i]);
+		}
+	}
+	CANHardwareInterface::stop();
+
+	// Both channels should have been read by the same thread
+	const auto firstChannelThreads = devices[0]->get_reading_threads();
+	const auto secondChannelThreads = devices[1]->get_reading_threads();
+	ASSERT_FALSE(firstChannelThreads.empty());
+	ASSERT_FALSE(secondChannelThreads.empty());
+	for (const auto &thread : secondChannelThreads)
+	{
+		EXPECT_EQ(firstChannelThreads.front(), thread);
+	}
+
+	EXPECT_TRUE(CANHardwareInterface::set_shared_receive_thread_enabled(false));
+}
+
+TEST(HARDWARE_INTERFACE_TESTS, SharedReceiveThreadRecoversChannel)
+{
+	auto device = std::make_shared<PipeCANPlugin>();
+	CANHardwareInterface::set_number_of_can_channels(1);
+	CANHardwareInterface::assign_can_channel_frame_handler(0, device);
+	EXPECT_TRUE(CANHardwareInterface::set_shared_receive_thread_enabled(true));
+	CANHardwareInterface::start();
+
+	std::mutex receivedFramesMutex;
+	std::vector<std::uint8_t> receivedFrames;
+	auto listener = CANHardwareInterface::get_can_frame_received_event_dispatcher().add_listener([&receivedFramesMutex, &receivedFrames](const CANMessageFrame &frame) {
+		std::lock_guard<std::mutex> lock(receivedFramesMutex);
+		receivedFrames.push_back(frame.data[0]);
+	});
+	auto send_and_wait_for_frame = [&device, &receivedFramesMutex, &receivedFrames](std::uint8_t value) {
+		CANMessageFrame frame = {};
+		frame.identifier = 0x18FEF180;
+		frame.isExtendedFrame = true;
+		frame.dataLength = 1;
+		frame.data[0] = value;
+		device->receive(frame);
+
+		// Long enough for a few of the shared receive thread's channel checks
+		bool retVal = false;
+		for (std::uint32_t i = 0; (i < 500) && !retVal; i++)
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			std::lock_guard<std::mutex> lock(receivedFramesMutex);
+			retVal = (std::find(receivedFrames.begin(), receivedFrames.end(), value) != receivedFrames.end());
+		}
+		return retVal;
+	};
+	EXPECT_TRUE(send_and_wait_for_frame(1));
+
+	// The hang up makes the shared receive thread stop waiting on the channel
+	device->hang_up();
+	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+	// Once the driver has a working descriptor again, the channel is read again
+	device->reconnect();
+	EXPECT_TRUE(send_and_wait_for_frame(2));
+
+	CANHardwareInterface::stop();
+	EXPECT_TRUE(CANHardwareInterface::set_shared_receive_thread_enabled(false));
+}
+#endif
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+
+#include "isobus/utility/keyed_object_pool.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace isobus;
+
+namespace
+{
+	class CountedObject
+	{
+	public:
+		explicit CountedObject(int initialValue) :
+		  value(initialValue)
+		{
+			liveObjects++;
+		}
+
+		~CountedObject()
+		{
+			liveObjects--;
+		}
+
+		int value;
+		static int liveObjects;
+	};
+
+	int CountedObject::liveObjects = 0;
+}
+
+TEST(KEYED_OBJECT_POOL_TESTS, CreateFindAndDestroy)
+{
+	KeyedObjectPool<CountedObject, int> pool;
+	EXPECT_EQ(nullptr, pool.create(1, 10));
+
+	pool.reserve(4);
+	EXPECT_EQ(4, pool.capacity());
+	EXPECT_TRUE(pool.empty());
+
+	CountedObject *first = pool.create(1, 10);
+	CountedObject *second = pool.create(2, 20);
+	ASSERT_NE(nullptr, first);
+	ASSERT_NE(nullptr, second);
+	EXPECT_EQ(2, pool.size());
+	EXPECT_EQ(2, CountedObject::liveObjects);
+
+	EXPECT_EQ(first, pool.find(1));
+	EXPECT_EQ(second, pool.find(2));
+	EXPECT_EQ(nullptr, pool.find(3));
+	EXPECT_EQ(20, pool.find(2)->value);
+
+	// Keys must be unique
+	EXPECT_EQ(nullptr, pool.create(1, 30));
+	EXPECT_EQ(2, pool.size());
+
+	EXPECT_TRUE(pool.destroy(first));
+	EXPECT_FALSE(pool.destroy(first));
+	EXPECT_EQ(nullptr, pool.find(1));
+	EXPECT_EQ(second, pool.find(2));
+	EXPECT_EQ(1, CountedObject::liveObjects);
+
+	pool.clear();
+	EXPECT_TRUE(pool.empty());
+	EXPECT_EQ(0, CountedObject::liveObjects);
+	EXPECT_EQ(4, pool.capacity());
+}
+
+TEST(KEYED_OBJECT_POOL_TESTS, FullPoolAndGrowth)
+{
+	KeyedObjectPool<CountedObject, int> pool;
+	pool.reserve(2);
+
+	CountedObject *first = pool.create(100, 1);
+	CountedObject *second = pool.create(200, 2);
+	EXPECT_EQ(nullptr, pool.create(300, 3));
+
+	// Reserving less than the current capacity does nothing
+	pool.reserve(1);
+	EXPECT_EQ(2, pool.capacity());
+
+	// Growing must not move existing objects
+	pool.reserve(3);
+	EXPECT_EQ(3, pool.capacity());
+	EXPECT_EQ(first, pool.find(100));
+	EXPECT_EQ(second, pool.find(200));
+	EXPECT_EQ(1, first->value);
+
+	CountedObject *third = pool.create(300, 3);
+	ASSERT_NE(nullptr, third);
+	EXPECT_EQ(third, pool.find(300));
+	EXPECT_EQ(3, pool.size());
+
+	// Growing one object at a time doubles the capacity rather than adding a slot each time
+	for (int i = 0; i < 100; i++)
+	{
+		pool.reserve_for_one_more(2);
+		ASSERT_NE(nullptr, pool.create(1000 + i, i));
+	}
+	EXPECT_EQ(103, pool.size());
+	EXPECT_EQ(192, pool.capacity());
+	EXPECT_EQ(first, pool.find(100));
+	EXPECT_TRUE(pool.destroy(pool.find(1050)));
+	EXPECT_EQ(nullptr, pool.find(1050));
+	EXPECT_EQ(99, pool.find(1099)->value);
+}
+
+TEST(KEYED_OBJECT_POOL_TESTS, DestroyWhileIterating)
+{
+	KeyedObjectPool<CountedObject, int> pool;
+	pool.reserve(8);
+
+	for (int i = 0; i < 8; i++)
+	{
+		pool.create(i, i);
+	}
+
+	pool.for_each([&pool](CountedObject *object) {
+		if (0 == (object->value % 2))
+		{
+			pool.destroy(object);
+		}
+	});
+	EXPECT_EQ(4, pool.size());
+
+	std::vector<int> remaining;
+	const KeyedObjectPool<CountedObject, int> &constPool = pool;
+	constPool.for_each([&remaining](const CountedObject *object) { remaining.push_back(object->value); });
+	EXPECT_EQ(std::vector<int>({ 1, 3, 5, 7 }), remaining);
+}
+
+TEST(KEYED_OBJECT_POOL_TESTS, IndexSurvivesChurn)
+{
+	// A hash that puts everything in the same bucket forces long probe sequences
+	struct CollidingHash
+	{
+		std::size_t operator()(int) const
+		{
+			return 7;
+		}
+	};
+	KeyedObjectPool<CountedObject, int, CollidingHash> pool;
+	pool.reserve(16);
+
+	for (int round = 0; round < 10; round++)
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			ASSERT_NE(nullptr, pool.create(i, i + round));
+		}
+
+		// Remove every third object, then check every key still resolves correctly
+		for (int i = 0; i < 16; i += 3)
+		{
+			EXPECT_TRUE(pool.destroy(pool.find(i)));
+		}
+		for (int i = 0; i < 16; i++)
+		{
+			if (0 == (i % 3))
+			{
+				EXPECT_EQ(nullptr, pool.find(i));
+			}
+			else
+			{
+				ASSERT_NE(nullptr, pool.find(i));
+				EXPECT_EQ(i + round, pool.find(i)->value);
+			}
+		}
+		pool.clear();
+	}
+	EXPECT_EQ(0, CountedObject::liveObjects);
+}
+
+TEST(KEYED_OBJECT_POOL_TESTS, StringKeys)
+{
+	KeyedObjectPool<std::string, std::string> pool;
+	pool.reserve(2);
+
+	ASSERT_NE(nullptr, pool.create("sprayer", "boom"));
+	ASSERT_NE(nullptr, pool.create("planter", 5, 'x'));
+	EXPECT_EQ("boom", *pool.find("sprayer"));
+	EXPECT_EQ("xxxxx", *pool.find("planter"));
+}
@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+
+#include "isobus/utility/latency_histogram.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace isobus;
+
+TEST(LATENCY_HISTOGRAM_TESTS, EmptyHistogram)
+{
+	LatencyHistogram histogram;
+
+	EXPECT_EQ(0, histogram.get_count());
+	EXPECT_EQ(0, histogram.get_min());
+	EXPECT_EQ(0, histogram.get_max());
+	EXPECT_EQ(0, histogram.get_mean());
+	EXPECT_EQ(0, histogram.get_value_at_percentile(50.0));
+}
+
+TEST(LATENCY_HISTOGRAM_TESTS, SmallValuesAreExact)
+{
+	LatencyHistogram histogram;
+
+	for (std::uint64_t i = 1; i <= 10; i++)
+	{
+		histogram.record(i);
+	}
+
+	EXPECT_EQ(10, histogram.get_count());
+	EXPECT_EQ(1, histogram.get_min());
+	EXPECT_EQ(10, histogram.get_max());
+	EXPECT_EQ(5, histogram.get_mean());
+	EXPECT_EQ(5, histogram.get_value_at_percentile(50.0));
+	EXPECT_EQ(9, histogram.get_value_at_percentile(90.0));
+	EXPECT_EQ(10, histogram.get_value_at_percentile(100.0));
+	EXPECT_EQ(1, histogram.get_value_at_percentile(0.0));
+}
+
+TEST(LATENCY_HISTOGRAM_TESTS, LargeValuesStayWithinBucketError)
+{
+	LatencyHistogram histogram;
+
+	// 1 ms to 1000 ms, in microseconds
+	for (std::uint64_t i = 1; i <= 1000; i++)
+	{
+		histogram.record(i * 1000);
+	}
+
+	const std::uint64_t median = histogram.get_value_at_percentile(50.0);
+	EXPECT_GE(median, 500000);
+	EXPECT_LE(median, 500000 + (500000 / 16));
+
+	const std::uint64_t tail = histogram.get_value_at_percentile(99.0);
+	EXPECT_GE(tail, 990000);
+	EXPECT_LE(tail, 1000000);
+	EXPECT_EQ(1000000, histogram.get_value_at_percentile(100.0));
+
+	// The full 64 bit range fits
+	histogram.record(UINT64_MAX);
+	EXPECT_EQ(UINT64_MAX, histogram.get_max());
+	EXPECT_EQ(UINT64_MAX, histogram.get_value_at_percentile(100.0));
+
+	histogram.reset();
+	EXPECT_EQ(0, histogram.get_count());
+	EXPECT_EQ(0, histogram.get_max());
+}
+
+TEST(LATENCY_HISTOGRAM_TESTS, ConcurrentRecording)
+{
+	constexpr std::uint64_t VALUES_PER_THREAD = 10000;
+	LatencyHistogram histogram;
+	std::vector<std::thread> threads;
+
+	for (std::uint64_t i = 0; i < 4; i++)
+	{
+		threads.emplace_back([&histogram, i]() {
+			for (std::uint64_t j = 0; j < VALUES_PER_THREAD; j++)
+			{
+				histogram.record(i * 100 + 1);
+			}
+		});
+	}
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+
+	EXPECT_EQ(4 * VALUES_PER_THREAD, histogram.get_count());
+	EXPECT_EQ(1, histogram.get_min());
+	EXPECT_EQ(301, histogram.get_max());
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include "isobus/hardware_integration/virtual_can_plugin.hpp"
+#include "isobus/isobus/can_internal_control_function.hpp"
+#include "isobus/isobus/can_network_manager.hpp"
+#include "isobus/isobus/can_parameter_group_number_request_protocol.hpp"
+#include "isobus/load_generator/bus_load_generator.hpp"
+#include "isobus/load_generator/bus_load_monitor.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+using namespace isobus;
+
+namespace
+{
+	constexpr char CHANNEL_NAME[] = "load_generator_tests";
+	constexpr std::uint32_t STACK_IDENTITY_NUMBER = 0x1B0042;
+
+	// A stack under test with its own network manager, updated by its own thread
+	class StackUnderTest
+	{
+	public:
+		StackUnderTest() :
+		  plugin(CHANNEL_NAME)
+		{
+			network.set_can_frame_transmit_callback(transmit_frame, &plugin);
+			network.get_configuration().set_max_number_transport_protocol_sessions(16);
+			network.initialize();
+			plugin.open();
+			running = true;
+			thread = std::thread([this]() {
+				CANMessageFrame frame = {};
+				while (running)
+				{
+					for (std::size_t i = 0; (i < 64) && plugin.read_frame(frame, 1); i++)
+					{
+						frame.channel = 0;
+						network.on_can_frame_received(frame);
+					}
+					network.update();
+				}
+			});
+		}
+
+		~StackUnderTest()
+		{
+			running = false;
+			thread.join();
+			plugin.close();
+		}
+
+		CANNetworkManager network;
+
+	private:
+		static bool transmit_frame(const CANMessageFrame &frame, void *parentPointer)
+		{
+			return static_cast<VirtualCANPlugin *>(parentPointer)->write_frame(frame);
+		}
+
+		VirtualCANPlugin plugin;
+		std::thread thread;
+		std::atomic_bool running = { false };
+	};
+
+	bool wait_for(const std::function<bool()> &condition)
+	{
+		const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+		while (!condition() && (std::chrono::steady_clock::now() < timeout))
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		return condition();
+	}
+} // namespace
+
+TEST(LOAD_GENERATOR_TESTS, RejectsInvalidConfiguration)
+{
+	BusLoadGenerator generator(CHANNEL_NAME);
+
+	EXPECT_FALSE(generator.set_number_of_control_functions(0));
+	EXPECT_FALSE(generator.set_number_of_control_functions(121));
+	EXPECT_TRUE(generator.set_number_of_control_functions(120));
+	EXPECT_FALSE(generator.add_broadcast_message(0xFEF1, 0));
+	EXPECT_FALSE(generator.add_transfer(BusLoadGenerator::TransferType::BroadcastAnnounce, 0xFECA, 8, 100));
+	EXPECT_FALSE(generator.add_transfer(BusLoadGenerator::TransferType::BroadcastAnnounce, 0xFECA, 1786, 100));
+	EXPECT_FALSE(generator.add_transfer(BusLoadGenerator::TransferType::ConnectionMode, 0xFECA, 100, 100));
+	EXPECT_FALSE(generator.add_transfer(BusLoadGenerator::TransferType::ExtendedConnectionMode, 0xEF00, 1785, 100));
+	EXPECT_TRUE(generator.get_messages().empty());
+
+	// Destination specific transfers can't start without a destination
+	EXPECT_TRUE(generator.add_transfer(BusLoadGenerator::TransferType::ConnectionMode, 0xEF00, 100, 100));
+	EXPECT_FALSE(generator.start());
+	EXPECT_FALSE(generator.get_is_running());
+}
+
+TEST(LOAD_GENERATOR_TESTS, LoadsAStackUnderTest)
+{
+	StackUnderTest stack;
+	BusLoadGenerator generator(CHANNEL_NAME);
+	BusLoadMonitor monitor(stack.network);
+
+	NAME stackNAME(0);
+	stackNAME.set_arbitrary_address_capable(true);
+	stackNAME.set_industry_group(2);
+	stackNAME.set_manufacturer_code(1407);
+	stackNAME.set_identity_number(STACK_IDENTITY_NUMBER);
+	auto stackECU = InternalControlFunction::create(stackNAME, 0x1C, 0, stack.network);
+
+	ASSERT_TRUE(generator.set_number_of_control_functions(3));
+	ASSERT_TRUE(generator.add_broadcast_message(0xFEF1, 20));
+	ASSERT_TRUE(generator.add_transfer(BusLoadGenerator::TransferType::BroadcastAnnounce, 0xFECA, 20, 200));
+	ASSERT_TRUE(generator.add_transfer(BusLoadGenerator::TransferType::ConnectionMode, 0xEF00, 100, 200));
+	ASSERT_TRUE(generator.add_transfer(BusLoadGenerator::TransferType::ExtendedConnectionMode, 0xEF00, 2000, 500));
+	ASSERT_TRUE(generator.set_transfer_destination({ NAMEFilter(NAME::NAMEParameters::IdentityNumber, STACK_IDENTITY_NUMBER) }));
+	monitor.monitor(generator);
+	ASSERT_TRUE(generator.start());
+	EXPECT_TRUE(generator.get_is_running());
+	EXPECT_FALSE(generator.add_broadcast_message(0xFEF2, 20));
+
+	EXPECT_TRUE(wait_for([&generator, &stackECU]() { return (3 == generator.get_number_of_claimed_control_functions()) && stackECU->get_address_valid(); }));
+
+	// Each ECU's transfers and broadcasts should all reach the stack
+	EXPECT_TRUE(wait_for([&monitor]() { return (monitor.get_single_frame_latency().get_count() >= 30) && (monitor.get_multi_frame_latency().get_count() >= 9); }));
+	EXPECT_LT(monitor.get_single_frame_latency().get_max(), 5000000u);
+	EXPECT_EQ(0u, monitor.get_number_of_messages_dropped());
+
+	// A global request is answered by every ECU
+	ASSERT_TRUE(ParameterGroupNumberRequestProtocol::request_parameter_group_number(0xFEF1, stackECU, nullptr));
+	EXPECT_TRUE(wait_for([&generator]() { return generator.get_number_of_requests_answered() >= 3; }));
+
+	generator.stop();
+	EXPECT_FALSE(generator.get_is_running());
+	EXPECT_NE(0u, generator.get_number_of_messages_sent());
+	EXPECT_NE(0u, generator.get_number_of_frames_transmitted());
+	EXPECT_EQ(0u, generator.get_number_of_messages_failed());
+
+	monitor.stop_monitoring();
+	stackECU->destroy();
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include "isobus/isobus/can_callbacks.hpp"
+
+#include <vector>
+
+using namespace isobus;
+
+static std::uint32_t callbackHitCount = 0;
+static void count_callback(const CANMessage &, void *parent)
+{
+	callbackHitCount += static_cast<std::uint32_t>(reinterpret_cast<std::uintptr_t>(parent));
+}
+
+TEST(PGN_CALLBACK_TABLE_TESTS, AddRemoveAndDispatch)
+{
+	ParameterGroupNumberCallbackTable table;
+	const ParameterGroupNumberCallbackData first(0xEF00, count_callback, reinterpret_cast<void *>(1), nullptr);
+	const ParameterGroupNumberCallbackData second(0xFEF1, count_callback, reinterpret_cast<void *>(10), nullptr);
+	const ParameterGroupNumberCallbackData third(0xEF00, count_callback, reinterpret_cast<void *>(100), nullptr);
+
+	table.add(first);
+	table.add(second);
+	table.add(third);
+	EXPECT_EQ(3, table.size());
+	EXPECT_TRUE(table.contains(second));
+
+	// Index access keeps the order the callbacks were added in
+	EXPECT_EQ(0xFEF1, table[1].get_parameter_group_number());
+
+	// Callbacks for the same PGN are visited in the order they were added
+	std::vector<void *> visitedParents;
+	table.for_each_matching(0xEF00, [&visitedParents](const ParameterGroupNumberCallbackData &callback) {
+		visitedParents.push_back(callback.get_parent());
+	});
+	EXPECT_EQ((std::vector<void *>{ first.get_parent(), third.get_parent() }), visitedParents);
+
+	CANMessage message(0);
+	callbackHitCount = 0;
+	table.for_each_matching(0xFEF1, [&message](const ParameterGroupNumberCallbackData &callback) {
+		callback.get_callback()(message, callback.get_parent());
+	});
+	EXPECT_EQ(10, callbackHitCount);
+
+	// No callbacks for an unregistered PGN
+	callbackHitCount = 0;
+	table.for_each_matching(0xE800, [&message](const ParameterGroupNumberCallbackData &callback) {
+		callback.get_callback()(message, callback.get_parent());
+	});
+	EXPECT_EQ(0, callbackHitCount);
+
+	EXPECT_TRUE(table.remove(first));
+	EXPECT_FALSE(table.remove(first));
+	EXPECT_EQ(2, table.size());
+
+	visitedParents.clear();
+	table.for_each_matching(0xEF00, [&visitedParents](const ParameterGroupNumberCallbackData &callback) {
+		visitedParents.push_back(callback.get_parent());
+	});
+	EXPECT_EQ((std::vector<void *>{ third.get_parent() }), visitedParents);
+}
+
+TEST(PGN_CALLBACK_TABLE_TESTS, ModifiedDuringDispatch)
+{
+	ParameterGroupNumberCallbackTable table;
+	const ParameterGroupNumberCallbackData removesItself(0xEF00, count_callback, reinterpret_cast<void *>(1), nullptr);
+	const ParameterGroupNumberCallbackData other(0xEF00, count_callback, reinterpret_cast<void *>(10), nullptr);
+	const ParameterGroupNumberCallbackData added(0xEF00, count_callback, reinterpret_cast<void *>(100), nullptr);
+	const ParameterGroupNumberCallbackData unrelated(0xFEF1, count_callback, reinterpret_cast<void *>(1000), nullptr);
+
+	table.add(removesItself);
+	table.add(other);
+	table.add(unrelated);
+
+	// A callback that unregisters itself and registers another one, like a one-shot response handler
+	std::vector<void *> visitedParents;
+	table.for_each_matching(0xEF00, [&](const ParameterGroupNumberCallbackData &callback) {
+		visitedParents.push_back(callback.get_parent());
+		if (callback == removesItself)
+		{
+			EXPECT_TRUE(table.remove(callback));
+			table.add(added);
+			table.add(ParameterGroupNumberCallbackData(0xE800, count_callback, nullptr, nullptr));
+		}
+	});
+
+	// Every callback that was visited was one for the PGN being dispatched
+	ASSERT_FALSE(visitedParents.empty());
+	EXPECT_EQ(removesItself.get_parent(), visitedParents.front());
+	for (void *parent : visitedParents)
+	{
+		EXPECT_NE(unrelated.get_parent(), parent);
+		EXPECT_NE(nullptr, parent);
+	}
+
+	EXPECT_FALSE(table.contains(removesItself));
+	EXPECT_TRUE(table.contains(added));
+	EXPECT_EQ(4, table.size());
+
+	visitedParents.clear();
+	table.for_each_matching(0xEF00, [&visitedParents](const ParameterGroupNumberCallbackData &callback) {
+		visitedParents.push_back(callback.get_parent());
+	});
+	EXPECT_EQ((std::vector<void *>{ other.get_parent(), added.get_parent() }), visitedParents);
+}
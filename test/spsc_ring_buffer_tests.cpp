@@ -0,0 +1,122 @@
+#include <gtest/gtest.h>
+
+#include "isobus/utility/spsc_ring_buffer.hpp"
+
+#include <thread>
+#include <vector>
+
+using namespace isobus;
+
+TEST(SPSC_RING_BUFFER_TESTS, CapacityIsRoundedToPowerOfTwo)
+{
+	SPSCRingBuffer<int> buffer1(1);
+	SPSCRingBuffer<int> buffer5(5);
+	SPSCRingBuffer<int> buffer64(64);
+
+	EXPECT_EQ(1, buffer1.capacity());
+	EXPECT_EQ(8, buffer5.capacity());
+	EXPECT_EQ(64, buffer64.capacity());
+	EXPECT_TRUE(buffer5.empty());
+}
+
+TEST(SPSC_RING_BUFFER_TESTS, PushConsumeAndOverflow)
+{
+	SPSCRingBuffer<int> buffer(4);
+
+	for (int i = 0; i < 4; i++)
+	{
+		EXPECT_TRUE(buffer.push(i));
+	}
+	EXPECT_EQ(4, buffer.size());
+	EXPECT_EQ(0, buffer.get_overflow_count());
+
+	EXPECT_FALSE(buffer.push(4));
+	EXPECT_FALSE(buffer.push(5));
+	EXPECT_EQ(2, buffer.get_overflow_count());
+
+	std::vector<int> received;
+	EXPECT_EQ(3, buffer.consume([&received](int &value) { received.push_back(value); }, 3));
+	EXPECT_EQ(1, buffer.size());
+
+	// Space released by the batch is usable again, including across the wrap point
+	EXPECT_TRUE(buffer.push(6));
+	EXPECT_TRUE(buffer.push(7));
+	EXPECT_EQ(3, buffer.consume_all([&received](int &value) { received.push_back(value); }));
+
+	int value = 0;
+	EXPECT_FALSE(buffer.pop(value));
+	EXPECT_EQ((std::vector<int>{ 0, 1, 2, 3, 6, 7 }), received);
+}
+
+TEST(SPSC_RING_BUFFER_TESTS, NonAssignableItemsAreDestroyed)
+{
+	static int liveItems = 0;
+	struct Item
+	{
+		explicit Item(int value) :
+		  value(value)
+		{
+			liveItems++;
+		}
+		Item(const Item &other) :
+		  value(other.value)
+		{
+			liveItems++;
+		}
+		~Item()
+		{
+			liveItems--;
+		}
+		Item &operator=(const Item &) = delete;
+		const int value;
+	};
+
+	{
+		SPSCRingBuffer<Item> buffer(8);
+		EXPECT_TRUE(buffer.emplace(1));
+		EXPECT_TRUE(buffer.push(Item(2)));
+		EXPECT_TRUE(buffer.emplace(3));
+		EXPECT_EQ(3, liveItems);
+
+		int sum = 0;
+		EXPECT_EQ(1, buffer.consume([&sum](Item &item) { sum += item.value; }, 1));
+		EXPECT_EQ(1, sum);
+		EXPECT_EQ(2, liveItems);
+	}
+	// Remaining items are destroyed with the buffer
+	EXPECT_EQ(0, liveItems);
+}
+
+TEST(SPSC_RING_BUFFER_TESTS, ConcurrentProducerAndConsumer)
+{
+	constexpr std::uint32_t NUMBER_OF_ITEMS = 200000;
+	SPSCRingBuffer<std::uint32_t> buffer(64);
+
+	std::thread producer([&buffer]() {
+		for (std::uint32_t i = 0; i < NUMBER_OF_ITEMS; i++)
+		{
+			while (!buffer.push(i))
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	std::uint32_t expected = 0;
+	bool inOrder = true;
+	while (expected < NUMBER_OF_ITEMS)
+	{
+		if (0 == buffer.consume_all([&expected, &inOrder](std::uint32_t &value) {
+			    inOrder = inOrder && (value == expected);
+			    expected++;
+		    }))
+		{
+			std::this_thread::yield();
+		}
+	}
+	producer.join();
+
+	EXPECT_TRUE(inOrder);
+	EXPECT_EQ(NUMBER_OF_ITEMS, expected);
+	EXPECT_TRUE(buffer.empty());
+}
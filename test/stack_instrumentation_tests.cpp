@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include "isobus/isobus/can_network_manager.hpp"
+#include "isobus/isobus/can_stack_instrumentation.hpp"
+#include "isobus/utility/system_timing.hpp"
+
+using namespace isobus;
+
+TEST(STACK_INSTRUMENTATION_TESTS, QueueHighWaterMarks)
+{
+	CANStackInstrumentation instrumentation;
+
+	instrumentation.record_queue_depth(CANStackInstrumentation::Queue::ReceivedMessages, 0, 5);
+	instrumentation.record_queue_depth(CANStackInstrumentation::Queue::ReceivedMessages, 0, 3);
+	instrumentation.record_queue_depth(CANStackInstrumentation::Queue::ReceivedMessages, 1, 7);
+	instrumentation.record_queue_depth(CANStackInstrumentation::Queue::FastPacketProtocolSessions, 0, 2);
+	instrumentation.record_queue_depth(CANStackInstrumentation::Queue::ReceivedMessages, CAN_PORT_MAXIMUM, 100);
+
+	EXPECT_EQ(5, instrumentation.get_queue_high_water_mark(CANStackInstrumentation::Queue::ReceivedMessages, 0));
+	EXPECT_EQ(7, instrumentation.get_queue_high_water_mark(CANStackInstrumentation::Queue::ReceivedMessages, 1));
+	EXPECT_EQ(2, instrumentation.get_queue_high_water_mark(CANStackInstrumentation::Queue::FastPacketProtocolSessions, 0));
+	EXPECT_EQ(0, instrumentation.get_queue_high_water_mark(CANStackInstrumentation::Queue::TransportProtocolSessions, 0));
+	EXPECT_EQ(0, instrumentation.get_queue_high_water_mark(CANStackInstrumentation::Queue::ReceivedMessages, CAN_PORT_MAXIMUM));
+	EXPECT_EQ(0, instrumentation.get_queue_high_water_mark(CANStackInstrumentation::Queue::NumberOfQueues, 0));
+
+	instrumentation.get_update_duration().record(100);
+	instrumentation.reset();
+	EXPECT_EQ(0, instrumentation.get_queue_high_water_mark(CANStackInstrumentation::Queue::ReceivedMessages, 0));
+	EXPECT_EQ(0, instrumentation.get_update_duration().get_count());
+}
+
+#ifdef CAN_STACK_ENABLE_INSTRUMENTATION
+TEST(STACK_INSTRUMENTATION_TESTS, NetworkManagerRecordsLatencyAndQueueDepth)
+{
+	CANNetworkManager network;
+	network.update();
+
+	CANMessageFrame frame = {};
+	frame.identifier = 0x18FEF180;
+	frame.isExtendedFrame = true;
+	frame.dataLength = 8;
+	for (std::uint8_t i = 0; i < 3; i++)
+	{
+		network.on_can_frame_received(frame);
+	}
+	EXPECT_EQ(3, network.get_instrumentation().get_queue_high_water_mark(CANStackInstrumentation::Queue::ReceivedMessages, 0));
+
+	network.update();
+	EXPECT_EQ(3, network.get_instrumentation().get_receive_to_dispatch_latency().get_count());
+	EXPECT_EQ(2, network.get_instrumentation().get_update_duration().get_count());
+}
+#endif
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include "isobus/utility/thread_pool.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace isobus;
+
+TEST(THREAD_POOL_TESTS, NoWorkersRunsOnCallingThread)
+{
+	ThreadPool pool;
+	std::vector<std::size_t> taskOrder;
+	bool allOnCallingThread = true;
+	const std::thread::id callingThread = std::this_thread::get_id();
+
+	EXPECT_EQ(0, pool.get_number_of_threads());
+	pool.run_parallel(5, [&](std::size_t taskIndex) {
+		taskOrder.push_back(taskIndex);
+		allOnCallingThread = allOnCallingThread && (callingThread == std::this_thread::get_id());
+	});
+
+	EXPECT_EQ(std::vector<std::size_t>({ 0, 1, 2, 3, 4 }), taskOrder);
+	EXPECT_TRUE(allOnCallingThread);
+}
+
+TEST(THREAD_POOL_TESTS, EveryTaskRunsOnce)
+{
+	ThreadPool pool;
+	std::array<std::atomic<int>, 100> runCounts;
+
+	pool.set_number_of_threads(3);
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+	EXPECT_EQ(3, pool.get_number_of_threads());
+#endif
+
+	for (int batch = 0; batch < 50; batch++)
+	{
+		for (auto &count : runCounts)
+		{
+			count = 0;
+		}
+		pool.run_parallel(runCounts.size(), [&runCounts](std::size_t taskIndex) {
+			runCounts[taskIndex]++;
+		});
+
+		for (const auto &count : runCounts)
+		{
+			ASSERT_EQ(1, count);
+		}
+	}
+
+	// Shrinking and growing the pool shouldn't lose any work
+	pool.set_number_of_threads(0);
+	EXPECT_EQ(0, pool.get_number_of_threads());
+	pool.run_parallel(runCounts.size(), [&runCounts](std::size_t taskIndex) {
+		runCounts[taskIndex]++;
+	});
+	pool.set_number_of_threads(2);
+	pool.run_parallel(runCounts.size(), [&runCounts](std::size_t taskIndex) {
+		runCounts[taskIndex]++;
+	});
+
+	for (const auto &count : runCounts)
+	{
+		EXPECT_EQ(3, count);
+	}
+}
+
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+TEST(THREAD_POOL_TESTS, TasksRunInParallel)
+{
+	constexpr std::size_t NUMBER_OF_TASKS = 4;
+	ThreadPool pool;
+	std::atomic<std::size_t> tasksStarted(0);
+	std::atomic<bool> allTasksOverlapped(true);
+
+	pool.set_number_of_threads(NUMBER_OF_TASKS - 1);
+
+	// Each task waits for all of the others to start, which can only happen if they run at the same time
+	pool.run_parallel(NUMBER_OF_TASKS, [&](std::size_t) {
+		tasksStarted++;
+		const auto startTime = std::chrono::steady_clock::now();
+
+		while ((tasksStarted < NUMBER_OF_TASKS) &&
+		       (std::chrono::steady_clock::now() - startTime < std::chrono::seconds(5)))
+		{
+			std::this_thread::yield();
+		}
+
+		if (tasksStarted < NUMBER_OF_TASKS)
+		{
+			allTasksOverlapped = false;
+		}
+	});
+
+	EXPECT_EQ(NUMBER_OF_TASKS, tasksStarted);
+	EXPECT_TRUE(allTasksOverlapped);
+}
+#endif
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include "isobus/hardware_integration/can_hardware_interface.hpp"
+#include "isobus/hardware_integration/can_trace_recorder.hpp"
+#include "isobus/hardware_integration/virtual_can_plugin.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace isobus;
+
+namespace
+{
+	bool read_trace(const std::string &filePath, CANTraceFileHeader &header, std::vector<CANTraceRecord> &records)
+	{
+		std::ifstream file(filePath, std::ios::binary);
+		bool retVal = false;
+
+		if (file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+		{
+			records.resize(static_cast<std::size_t>(header.capacity));
+			retVal = static_cast<bool>(file.read(reinterpret_cast<char *>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(CANTraceRecord))));
+		}
+		return retVal;
+	}
+
+	CANMessageFrame create_trace_test_frame(std::uint8_t sequence)
+	{
+		CANMessageFrame frame = {};
+		frame.identifier = 0x18FEF180;
+		frame.isExtendedFrame = true;
+		frame.dataLength = 8;
+		frame.timestamp_us = 1000 + sequence;
+		frame.channel = 0;
+		frame.data[0] = sequence;
+		return frame;
+	}
+} // namespace
+
+TEST(TRACE_RECORDER_TESTS, RecordsFramesIntoFile)
+{
+	const std::string filePath = "trace_recorder_test.bin";
+	CANTraceRecorder recorder;
+	EXPECT_FALSE(recorder.get_is_open());
+	EXPECT_FALSE(recorder.open(filePath, 0));
+
+	ASSERT_TRUE(recorder.open(filePath, 6));
+	EXPECT_TRUE(recorder.get_is_open());
+	EXPECT_EQ(8, recorder.get_capacity());
+	EXPECT_FALSE(recorder.open(filePath));
+
+	CANMessageFrame frame = create_trace_test_frame(1);
+	recorder.record(frame, false);
+	frame = create_trace_test_frame(2);
+	frame.identifier = 0x123;
+	frame.isExtendedFrame = false;
+	frame.channel = 3;
+	recorder.record(frame, true);
+	frame = create_trace_test_frame(3);
+	frame.isFDFrame = true;
+	frame.isBitRateSwitch = true;
+	frame.dataLength = 64;
+	frame.data[63] = 0xAB;
+	recorder.record(frame, false);
+	EXPECT_EQ(3, recorder.get_number_of_records());
+	recorder.close();
+	EXPECT_FALSE(recorder.get_is_open());
+
+	CANTraceFileHeader header;
+	std::vector<CANTraceRecord> records;
+	ASSERT_TRUE(read_trace(filePath, header, records));
+	EXPECT_EQ(static_cast<std::uint64_t>(CANTraceFileHeader::MAGIC), header.magic);
+	EXPECT_EQ(static_cast<std::uint32_t>(CANTraceFileHeader::CURRENT_VERSION), header.version);
+	EXPECT_EQ(sizeof(CANTraceRecord), header.recordSize);
+	EXPECT_EQ(8, header.capacity);
+	EXPECT_EQ(3, header.recordsWritten);
+
+	EXPECT_EQ(0x18FEF180, records[0].identifier);
+	EXPECT_EQ(static_cast<std::uint8_t>(CANTraceRecord::EXTENDED_FRAME_FLAG), records[0].flags);
+	EXPECT_EQ(1001, records[0].timestamp_us);
+	EXPECT_EQ(8, records[0].dataLength);
+	EXPECT_EQ(1, records[0].data[0]);
+
+	EXPECT_EQ(0x123, records[1].identifier);
+	EXPECT_EQ(static_cast<std::uint8_t>(CANTraceRecord::TRANSMITTED_FLAG), records[1].flags);
+	EXPECT_EQ(3, records[1].channel);
+
+	EXPECT_EQ(CANTraceRecord::EXTENDED_FRAME_FLAG | CANTraceRecord::FD_FRAME_FLAG | CANTraceRecord::BIT_RATE_SWITCH_FLAG, records[2].flags);
+	EXPECT_EQ(64, records[2].dataLength);
+	EXPECT_EQ(0xAB, records[2].data[63]);
+	EXPECT_LE(records[0].recordTime_us, records[1].recordTime_us);
+	EXPECT_LE(records[1].recordTime_us, records[2].recordTime_us);
+
+	std::remove(filePath.c_str());
+}
+
+TEST(TRACE_RECORDER_TESTS, RingOverwritesOldestFrames)
+{
+	const std::string filePath = "trace_recorder_ring_test.bin";
+	CANTraceRecorder recorder;
+
+	ASSERT_TRUE(recorder.open(filePath, 4));
+	for (std::uint8_t i = 0; i < 10; i++)
+	{
+		recorder.record(create_trace_test_frame(i), false);
+	}
+	recorder.close();
+
+	CANTraceFileHeader header;
+	std::vector<CANTraceRecord> records;
+	ASSERT_TRUE(read_trace(filePath, header, records));
+	EXPECT_EQ(10, header.recordsWritten);
+	ASSERT_EQ(4, records.size());
+
+	// Only the newest frames are left, each in the slot for its record number
+	for (std::uint64_t recordNumber = header.recordsWritten - header.capacity; recordNumber < header.recordsWritten; recordNumber++)
+	{
+		EXPECT_EQ(recordNumber, records[recordNumber % header.capacity].data[0]);
+	}
+
+	std::remove(filePath.c_str());
+}
+
+TEST(TRACE_RECORDER_TESTS, RecordsHardwareInterfaceTraffic)
+{
+	const std::string filePath = "trace_recorder_interface_test.bin";
+	auto device = std::make_shared<VirtualCANPlugin>();
+	auto otherDevice = std::make_shared<VirtualCANPlugin>();
+	otherDevice->open();
+	CANHardwareInterface::set_number_of_can_channels(1);
+	CANHardwareInterface::assign_can_channel_frame_handler(0, device);
+	CANHardwareInterface::start();
+
+	CANTraceRecorder recorder;
+	ASSERT_TRUE(recorder.open(filePath));
+	device->write_frame_as_if_received(create_trace_test_frame(1));
+	for (std::uint32_t i = 0; (i < 500) && (recorder.get_number_of_records() < 1); i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	EXPECT_TRUE(CANHardwareInterface::transmit_can_frame(create_trace_test_frame(2)));
+	for (std::uint32_t i = 0; (i < 500) && (recorder.get_number_of_records() < 2); i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	CANHardwareInterface::stop();
+	recorder.close();
+	otherDevice->close();
+
+	CANTraceFileHeader header;
+	std::vector<CANTraceRecord> records;
+	ASSERT_TRUE(read_trace(filePath, header, records));
+	ASSERT_EQ(2, header.recordsWritten);
+	EXPECT_EQ(1, records[0].data[0]);
+	EXPECT_EQ(0, records[0].flags & CANTraceRecord::TRANSMITTED_FLAG);
+	EXPECT_EQ(2, records[1].data[0]);
+	EXPECT_NE(0, records[1].flags & CANTraceRecord::TRANSMITTED_FLAG);
+
+	std::remove(filePath.c_str());
+}
@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+
+#include "isobus/hardware_integration/can_hardware_interface.hpp"
+#include "isobus/hardware_integration/can_trace_format.hpp"
+#include "isobus/hardware_integration/can_trace_replay_plugin.hpp"
+#include "isobus/isobus/can_network_manager.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+using namespace isobus;
+
+namespace
+{
+	void write_text_file(const std::string &filePath, const std::string &contents)
+	{
+		std::ofstream file(filePath, std::ios::binary);
+		file << contents;
+	}
+
+	std::vector<CANMessageFrame> read_all_frames(CANTraceReplayPlugin &plugin)
+	{
+		std::vector<CANMessageFrame> retVal;
+		std::array<CANMessageFrame, 4> frames;
+
+		while (!plugin.get_is_finished())
+		{
+			const std::size_t numberOfFrames = plugin.read_frames(frames.data(), frames.size());
+			retVal.insert(retVal.end(), frames.begin(), frames.begin() + numberOfFrames);
+		}
+		return retVal;
+	}
+} // namespace
+
+TEST(TRACE_REPLAY_TESTS, ReplaysCandumpLog)
+{
+	const std::string filePath = "trace_replay_test.log";
+	write_text_file(filePath,
+	                "(1436509052.249713) can0 18FEF180#0102030405060708\n"
+	                "(1436509052.250713) can1 123#AABB\n"
+	                "this line isn't a frame\n"
+	                "(1436509052.251713) can0 1CECFF80##1000102030405060708090A0B\n"
+	                "(1436509052.252713) can0 18EAFF80#R\n"
+	                "(1436509052.253713) can0 0CFE4980#01 T\n");
+
+	CANTraceReplayPlugin plugin(filePath);
+	EXPECT_TRUE(plugin.set_replay_mode(CANTraceReplayPlugin::ReplayMode::AsFastAsPossible));
+	EXPECT_FALSE(plugin.get_is_valid());
+	plugin.open();
+	ASSERT_TRUE(plugin.get_is_valid());
+	EXPECT_FALSE(plugin.set_replay_mode(CANTraceReplayPlugin::ReplayMode::RealTime));
+	EXPECT_EQ(4, plugin.get_number_of_frames());
+
+	const std::vector<CANMessageFrame> frames = read_all_frames(plugin);
+	ASSERT_EQ(4, frames.size());
+	EXPECT_EQ(0x18FEF180, frames[0].identifier);
+	EXPECT_TRUE(frames[0].isExtendedFrame);
+	EXPECT_EQ(8, frames[0].dataLength);
+	EXPECT_EQ(0x08, frames[0].data[7]);
+
+	EXPECT_EQ(0x123, frames[1].identifier);
+	EXPECT_FALSE(frames[1].isExtendedFrame);
+	EXPECT_EQ(2, frames[1].dataLength);
+	EXPECT_EQ(0xBB, frames[1].data[1]);
+
+	EXPECT_TRUE(frames[2].isFDFrame);
+	EXPECT_TRUE(frames[2].isBitRateSwitch);
+	EXPECT_EQ(12, frames[2].dataLength);
+	EXPECT_EQ(0x0B, frames[2].data[11]);
+
+	EXPECT_EQ(0x0CFE4980, frames[3].identifier);
+	EXPECT_EQ(4, plugin.get_number_of_frames_replayed());
+	plugin.close();
+
+	// Only replay the second interface, and nothing that was transmitted
+	CANTraceReplayPlugin filteredPlugin(filePath, CANTraceReplayPlugin::TraceFormat::Candump);
+	EXPECT_TRUE(filteredPlugin.set_trace_channel(1));
+	EXPECT_TRUE(filteredPlugin.set_replay_transmitted_frames(false));
+	filteredPlugin.open();
+	EXPECT_EQ(1, filteredPlugin.get_number_of_frames());
+	filteredPlugin.close();
+
+	std::remove(filePath.c_str());
+}
+
+TEST(TRACE_REPLAY_TESTS, ReplaysVectorASC)
+{
+	const std::string filePath = "trace_replay_test.asc";
+	write_text_file(filePath,
+	                "date Mon Jan 2 03:04:05 pm 2023\n"
+	                "base hex  timestamps absolute\n"
+	                "internal events logged\n"
+	                "Begin Triggerblock Mon Jan 2 03:04:05 pm 2023\n"
+	                "   0.000000 Start of measurement\n"
+	                "   0.010000 1  18FEF180x       Rx   d 8 01 02 03 04 05 06 07 08  Length = 280000 BitCount = 145 ID = 419361152x\n"
+	                "   0.020000 2  123             Tx   d 2 AA BB\n"
+	                "   0.030000 1  ErrorFrame\n"
+	                "   0.040000 CANFD   1 Rx 1CECFF80x  1 0 c 12 00 01 02 03 04 05 06 07 08 09 0a 0b   0 0 0 0 0 0 0 0\n"
+	                "End TriggerBlock\n");
+
+	CANTraceReplayPlugin plugin(filePath);
+	plugin.set_replay_mode(CANTraceReplayPlugin::ReplayMode::AsFastAsPossible);
+	plugin.open();
+	ASSERT_TRUE(plugin.get_is_valid());
+
+	const std::vector<CANMessageFrame> frames = read_all_frames(plugin);
+	ASSERT_EQ(3, frames.size());
+	EXPECT_EQ(0x18FEF180, frames[0].identifier);
+	EXPECT_TRUE(frames[0].isExtendedFrame);
+	EXPECT_EQ(0x01, frames[0].data[0]);
+	EXPECT_EQ(0x123, frames[1].identifier);
+	EXPECT_FALSE(frames[1].isExtendedFrame);
+	EXPECT_EQ(0x1CECFF80, frames[2].identifier);
+	EXPECT_TRUE(frames[2].isFDFrame);
+	EXPECT_TRUE(frames[2].isBitRateSwitch);
+	EXPECT_EQ(12, frames[2].dataLength);
+	EXPECT_EQ(0x0B, frames[2].data[11]);
+	plugin.close();
+
+	CANTraceReplayPlugin firstChannelPlugin(filePath);
+	firstChannelPlugin.set_trace_channel(0);
+	firstChannelPlugin.open();
+	EXPECT_EQ(2, firstChannelPlugin.get_number_of_frames());
+	firstChannelPlugin.close();
+
+	std::remove(filePath.c_str());
+}
+
+TEST(TRACE_REPLAY_TESTS, ReplaysBinaryRingInOrder)
+{
+	const std::string filePath = "trace_replay_test.bin";
+	CANTraceFileHeader header = {};
+	std::array<CANTraceRecord, 4> records = {};
+
+	// Six records were written into four slots, so record 2 is the oldest one left, in slot 2
+	header.magic = CANTraceFileHeader::MAGIC;
+	header.version = CANTraceFileHeader::CURRENT_VERSION;
+	header.recordSize = sizeof(CANTraceRecord);
+	header.capacity = records.size();
+	header.recordsWritten = 6;
+	for (std::uint8_t recordNumber = 2; recordNumber < 6; recordNumber++)
+	{
+		CANTraceRecord &record = records[recordNumber % records.size()];
+		record.recordTime_us = 1000 * recordNumber;
+		record.identifier = 0x18FEF180;
+		record.flags = CANTraceRecord::EXTENDED_FRAME_FLAG;
+		record.dataLength = 8;
+		record.data[0] = recordNumber;
+	}
+	{
+		std::ofstream file(filePath, std::ios::binary);
+		file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char *>(records.data()), sizeof(records));
+	}
+
+	CANTraceReplayPlugin plugin(filePath);
+	plugin.set_replay_mode(CANTraceReplayPlugin::ReplayMode::AsFastAsPossible);
+	plugin.open();
+	ASSERT_TRUE(plugin.get_is_valid());
+
+	const std::vector<CANMessageFrame> frames = read_all_frames(plugin);
+	ASSERT_EQ(4, frames.size());
+	for (std::uint8_t i = 0; i < 4; i++)
+	{
+		EXPECT_EQ(i + 2, frames[i].data[0]);
+		EXPECT_TRUE(frames[i].isExtendedFrame);
+	}
+	plugin.close();
+
+	std::remove(filePath.c_str());
+}
+
+TEST(TRACE_REPLAY_TESTS, ScaledTimeKeepsRelativeTiming)
+{
+	const std::string filePath = "trace_replay_timing_test.log";
+	write_text_file(filePath,
+	                "(100.000000) can0 18FEF180#01\n"
+	                "(100.100000) can0 18FEF180#02\n"
+	                "(100.200000) can0 18FEF180#03\n");
+
+	CANTraceReplayPlugin plugin(filePath);
+	EXPECT_FALSE(plugin.set_replay_mode(CANTraceReplayPlugin::ReplayMode::ScaledTime, 0.0f));
+	EXPECT_TRUE(plugin.set_replay_mode(CANTraceReplayPlugin::ReplayMode::ScaledTime, 4.0f));
+	plugin.open();
+
+	// The 200ms trace should take about 50ms at four times the speed
+	const auto startTime = std::chrono::steady_clock::now();
+	const std::vector<CANMessageFrame> frames = read_all_frames(plugin);
+	const auto duration = std::chrono::steady_clock::now() - startTime;
+	ASSERT_EQ(3, frames.size());
+	EXPECT_GE(duration, std::chrono::milliseconds(45));
+	EXPECT_LT(duration, std::chrono::milliseconds(150));
+	plugin.close();
+
+	std::remove(filePath.c_str());
+}
+
+TEST(TRACE_REPLAY_TESTS, ReplaysIntoTheStack)
+{
+	constexpr std::uint32_t NUMBER_OF_FRAMES = 500;
+	const std::string filePath = "trace_replay_stack_test.log";
+	std::string trace;
+	for (std::uint32_t i = 0; i < NUMBER_OF_FRAMES; i++)
+	{
+		trace += "(100." + std::string(6 - std::to_string(i).size(), '0') + std::to_string(i) + ") can0 18FEF180#0102030405060708\n";
+	}
+	write_text_file(filePath, trace);
+
+	auto plugin = std::make_shared<CANTraceReplayPlugin>(filePath);
+	plugin->set_replay_mode(CANTraceReplayPlugin::ReplayMode::AsFastAsPossible);
+	std::atomic<std::uint32_t> messagesReceived = { 0 };
+	auto pgn_callback = [](const CANMessage &, void *parent) {
+		(*static_cast<std::atomic<std::uint32_t> *>(parent))++;
+	};
+	CANNetworkManager::CANNetwork.add_any_control_function_parameter_group_number_callback(0xFEF1, pgn_callback, &messagesReceived);
+
+	CANNetworkManager::CANNetwork.initialize();
+	const std::uint32_t initialDroppedMessages = CANNetworkManager::CANNetwork.get_number_rx_messages_dropped(0);
+	CANHardwareInterface::set_number_of_can_channels(1);
+	CANHardwareInterface::assign_can_channel_frame_handler(0, plugin);
+	CANHardwareInterface::start();
+	// Replaying as fast as possible can outrun the stack's Rx queue, so every frame is either processed or counted as dropped
+	std::uint32_t droppedMessages = 0;
+	for (std::uint32_t i = 0; (i < 500) && ((messagesReceived + droppedMessages) < NUMBER_OF_FRAMES); i++)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		droppedMessages = CANNetworkManager::CANNetwork.get_number_rx_messages_dropped(0) - initialDroppedMessages;
+	}
+	EXPECT_TRUE(plugin->get_is_finished());
+	EXPECT_EQ(NUMBER_OF_FRAMES, plugin->get_number_of_frames_replayed());
+	CANHardwareInterface::stop();
+	CANNetworkManager::CANNetwork.remove_any_control_function_parameter_group_number_callback(0xFEF1, pgn_callback, &messagesReceived);
+	EXPECT_NE(0, messagesReceived);
+	EXPECT_EQ(NUMBER_OF_FRAMES, messagesReceived + droppedMessages);
+
+	std::remove(filePath.c_str());
+}
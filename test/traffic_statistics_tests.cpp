@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+
+#include "isobus/isobus/can_network_manager.hpp"
+#include "isobus/isobus/can_traffic_statistics.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using namespace isobus;
+
+namespace
+{
+	CANMessageFrame create_frame(std::uint8_t channel, std::uint32_t parameterGroupNumber, std::uint8_t sourceAddress, std::uint8_t dataLength)
+	{
+		CANMessageFrame retVal = {};
+		retVal.channel = channel;
+		retVal.identifier = (static_cast<std::uint32_t>(6) << 26) | (parameterGroupNumber << 8) | sourceAddress;
+		retVal.isExtendedFrame = true;
+		retVal.dataLength = dataLength;
+		return retVal;
+	}
+
+	const CANTrafficStatistics::Entry *find_entry(const std::vector<CANTrafficStatistics::Entry> &entries, std::uint8_t channel, std::uint32_t parameterGroupNumber, std::uint8_t sourceAddress)
+	{
+		auto result = std::find_if(entries.begin(), entries.end(), [&](const CANTrafficStatistics::Entry &entry) {
+			return (channel == entry.channel) && (parameterGroupNumber == entry.parameterGroupNumber) && (sourceAddress == entry.sourceAddress);
+		});
+		return (entries.end() != result) ? &(*result) : nullptr;
+	}
+} // namespace
+
+TEST(TRAFFIC_STATISTICS_TESTS, CountsPerChannelPGNAndSource)
+{
+	CANTrafficStatistics statistics;
+
+	// Nothing is recorded until the statistics are turned on
+	EXPECT_FALSE(statistics.get_enabled());
+	statistics.record_frame(create_frame(0, 0xFEF1, 0x1C, 8));
+	EXPECT_TRUE(statistics.get_snapshot().empty());
+
+	statistics.set_enabled(true);
+	EXPECT_TRUE(statistics.get_enabled());
+	for (std::uint8_t i = 0; i < 3; i++)
+	{
+		statistics.record_frame(create_frame(0, 0xFEF1, 0x1C, 8));
+	}
+	statistics.record_frame(create_frame(0, 0xFEF1, 0x1D, 8));
+	statistics.record_frame(create_frame(1, 0xFEF1, 0x1C, 4));
+	statistics.record_frame(create_frame(0, 0xEF00, 0x1C, 3));
+
+	const auto snapshot = statistics.get_snapshot();
+	ASSERT_EQ(4, snapshot.size());
+
+	const auto *busiest = find_entry(snapshot, 0, 0xFEF1, 0x1C);
+	ASSERT_NE(nullptr, busiest);
+	EXPECT_EQ(3, busiest->totalFrames);
+	EXPECT_EQ(24, busiest->totalBytes);
+	EXPECT_EQ(3 * create_frame(0, 0xFEF1, 0x1C, 8).get_number_bits_in_message(), busiest->totalBits);
+
+	const auto *otherChannel = find_entry(snapshot, 1, 0xFEF1, 0x1C);
+	ASSERT_NE(nullptr, otherChannel);
+	EXPECT_EQ(1, otherChannel->totalFrames);
+	EXPECT_EQ(4, otherChannel->totalBytes);
+
+	const auto *destinationSpecific = find_entry(snapshot, 0, 0xEF00, 0x1C);
+	ASSERT_NE(nullptr, destinationSpecific);
+	EXPECT_EQ(1, destinationSpecific->totalFrames);
+	EXPECT_EQ(0, statistics.get_number_untracked_frames());
+
+	// Resetting clears the counts but keeps the combinations
+	statistics.reset();
+	const auto resetSnapshot = statistics.get_snapshot();
+	EXPECT_EQ(4, resetSnapshot.size());
+	EXPECT_TRUE(std::all_of(resetSnapshot.begin(), resetSnapshot.end(), [](const CANTrafficStatistics::Entry &entry) { return 0 == entry.totalFrames; }));
+}
+
+TEST(TRAFFIC_STATISTICS_TESTS, FullTableCountsUntrackedFrames)
+{
+	CANTrafficStatistics statistics(2);
+	statistics.set_enabled(true);
+
+	statistics.record_frame(create_frame(0, 0xFEF1, 0x01, 8));
+	statistics.record_frame(create_frame(0, 0xFEF1, 0x02, 8));
+	statistics.record_frame(create_frame(0, 0xFEF1, 0x03, 8));
+	statistics.record_frame(create_frame(0, 0xFEF1, 0x01, 8));
+
+	EXPECT_EQ(2, statistics.get_snapshot().size());
+	EXPECT_EQ(1, statistics.get_number_untracked_frames());
+}
+
+TEST(TRAFFIC_STATISTICS_TESTS, RatesAndTopEntries)
+{
+	CANTrafficStatistics statistics;
+	statistics.set_enabled(true);
+
+	// Rates aren't known until a full window has passed
+	statistics.update();
+	EXPECT_NE(0, statistics.get_time_until_next_update_ms());
+	for (std::uint8_t i = 0; i < 10; i++)
+	{
+		statistics.record_frame(create_frame(0, 0xFEF1, 0x1C, 8));
+	}
+	for (std::uint8_t i = 0; i < 20; i++)
+	{
+		statistics.record_frame(create_frame(0, 0xFE6C, 0x1D, 1));
+	}
+	statistics.record_frame(create_frame(0, 0xFECA, 0x1E, 8));
+
+	std::this_thread::sleep_for(std::chrono::milliseconds(1010));
+	EXPECT_EQ(0, statistics.get_time_until_next_update_ms());
+	statistics.update();
+
+	const auto snapshot = statistics.get_snapshot();
+	const auto *entry = find_entry(snapshot, 0, 0xFE6C, 0x1D);
+	ASSERT_NE(nullptr, entry);
+	EXPECT_GE(entry->framesPerSecond, 15);
+	EXPECT_LE(entry->framesPerSecond, 20);
+
+	const auto topByFrames = statistics.get_top_entries(2, CANTrafficStatistics::Metric::FramesPerSecond);
+	ASSERT_EQ(2, topByFrames.size());
+	EXPECT_EQ(0x1D, topByFrames[0].sourceAddress);
+	EXPECT_EQ(0x1C, topByFrames[1].sourceAddress);
+
+	const auto topByBytes = statistics.get_top_entries(5, CANTrafficStatistics::Metric::BytesPerSecond);
+	ASSERT_EQ(3, topByBytes.size());
+	EXPECT_EQ(0x1C, topByBytes[0].sourceAddress);
+
+	// Nothing was sent in the next window, so the rates should drop back to zero
+	std::this_thread::sleep_for(std::chrono::milliseconds(1010));
+	statistics.update();
+	const auto idleTop = statistics.get_top_entries(1);
+	ASSERT_EQ(1, idleTop.size());
+	EXPECT_EQ(0, idleTop[0].bitsPerSecond);
+	EXPECT_EQ(10, find_entry(statistics.get_snapshot(), 0, 0xFEF1, 0x1C)->totalFrames);
+}
+
+TEST(TRAFFIC_STATISTICS_TESTS, NetworkManagerCountsReceivedAndTransmittedFrames)
+{
+	CANNetworkManager network;
+	network.get_traffic_statistics().set_enabled(true);
+
+	network.on_can_frame_received(create_frame(0, 0xFEF1, 0x80, 8));
+	network.on_can_frame_received(create_frame(0, 0xFEF1, 0x80, 8));
+	network.on_can_frame_transmitted(create_frame(0, 0xFEF1, 0x81, 8));
+
+	const auto snapshot = network.get_traffic_statistics().get_snapshot();
+	ASSERT_EQ(2, snapshot.size());
+	EXPECT_EQ(2, find_entry(snapshot, 0, 0xFEF1, 0x80)->totalFrames);
+	EXPECT_EQ(1, find_entry(snapshot, 0, 0xFEF1, 0x81)->totalFrames);
+}
@@ -2,6 +2,11 @@
 
 #include "isobus/hardware_integration/virtual_can_plugin.hpp"
 
+#include <array>
+#include <memory>
+#include <thread>
+#include <vector>
+
 using namespace isobus;
 
 TEST(VIRTUAL_CAN_PLUGIN_TESTS, ReceivesOwnMessages)
@@ -70,3 +75,130 @@ TEST(VIRTUAL_CAN_PLUGIN_TESTS, OtherReceivesMessage)
 	EXPECT_EQ(receiveFrame.data[7], 0x08);
 	EXPECT_EQ(receiveFrame.dataLength, 8);
 }
+
+TEST(VIRTUAL_CAN_PLUGIN_TESTS, ReadsAndWritesFramesInBatches)
+{
+	VirtualCANPlugin testPlugin("batch");
+	VirtualCANPlugin otherPlugin("batch");
+
+	CANMessageFrame sentFrames[5];
+	for (std::uint8_t i = 0; i < 5; i++)
+	{
+		sentFrames[i].identifier = 0x18FFA200 + i;
+		sentFrames[i].isExtendedFrame = true;
+		sentFrames[i].dataLength = 1;
+		sentFrames[i].data[0] = i;
+	}
+	EXPECT_EQ(5, testPlugin.write_frames(sentFrames, 5));
+
+	// Only up to the requested number of frames are read, in the order they were sent
+	CANMessageFrame receiveFrames[5];
+	EXPECT_EQ(3, otherPlugin.read_frames(receiveFrames, 3));
+	EXPECT_EQ(0x18FFA200, receiveFrames[0].identifier);
+	EXPECT_EQ(0x18FFA202, receiveFrames[2].identifier);
+
+	EXPECT_EQ(2, otherPlugin.read_frames(receiveFrames, 5));
+	EXPECT_EQ(0x18FFA203, receiveFrames[0].identifier);
+	EXPECT_EQ(4, receiveFrames[1].data[0]);
+	EXPECT_TRUE(otherPlugin.get_queue_empty());
+}
+
+TEST(VIRTUAL_CAN_PLUGIN_TESTS, WritesNeedSomeoneToReceiveThem)
+{
+	VirtualCANPlugin testPlugin("lonely");
+	CANMessageFrame sentFrame = {};
+	sentFrame.identifier = 0x18FFA227;
+	sentFrame.isExtendedFrame = true;
+
+	EXPECT_FALSE(testPlugin.write_frame(sentFrame));
+	{
+		VirtualCANPlugin otherPlugin("lonely");
+		EXPECT_TRUE(testPlugin.write_frame(sentFrame));
+		EXPECT_FALSE(otherPlugin.get_queue_empty());
+		EXPECT_TRUE(testPlugin.get_queue_empty());
+	}
+	EXPECT_FALSE(testPlugin.write_frame(sentFrame));
+
+	// Frames written as if received only go to the plugin itself
+	VirtualCANPlugin otherPlugin("lonely");
+	testPlugin.write_frame_as_if_received(sentFrame);
+	EXPECT_FALSE(testPlugin.get_queue_empty());
+	EXPECT_TRUE(otherPlugin.get_queue_empty());
+	testPlugin.clear_queue();
+	EXPECT_TRUE(testPlugin.get_queue_empty());
+}
+
+TEST(VIRTUAL_CAN_PLUGIN_TESTS, ConcurrentWritersDontLoseFrames)
+{
+	constexpr std::uint32_t NUMBER_OF_WRITERS = 4;
+	constexpr std::uint32_t FRAMES_PER_WRITER = 500;
+	VirtualCANPlugin reader("fan_out");
+	std::vector<std::unique_ptr<VirtualCANPlugin>> writers;
+	std::vector<std::thread> threads;
+
+	reader.open();
+	for (std::uint32_t i = 0; i < NUMBER_OF_WRITERS; i++)
+	{
+		writers.emplace_back(new VirtualCANPlugin("fan_out"));
+	}
+	for (std::uint32_t i = 0; i < NUMBER_OF_WRITERS; i++)
+	{
+		threads.emplace_back([&writers, i]() {
+			CANMessageFrame frame = {};
+			frame.isExtendedFrame = true;
+			for (std::uint32_t j = 0; j < FRAMES_PER_WRITER; j++)
+			{
+				frame.identifier = (i << 16) | j;
+				writers[i]->write_frame(frame);
+			}
+		});
+	}
+
+	// Every writer's frames arrive, in the order that writer sent them
+	std::array<std::uint32_t, NUMBER_OF_WRITERS> nextExpected = {};
+	std::uint32_t framesRead = 0;
+	CANMessageFrame frame;
+	while ((framesRead < NUMBER_OF_WRITERS * FRAMES_PER_WRITER) && reader.read_frame(frame))
+	{
+		const std::uint32_t writer = frame.identifier >> 16;
+		ASSERT_LT(writer, NUMBER_OF_WRITERS);
+		EXPECT_EQ(nextExpected[writer], frame.identifier & 0xFFFF);
+		nextExpected[writer] = (frame.identifier & 0xFFFF) + 1;
+		framesRead++;
+	}
+
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+	EXPECT_EQ(NUMBER_OF_WRITERS * FRAMES_PER_WRITER, framesRead);
+	EXPECT_TRUE(reader.get_queue_empty());
+	reader.close();
+}
+
+TEST(VIRTUAL_CAN_PLUGIN_TESTS, LappedReaderLosesOldestFrames)
+{
+	constexpr std::uint32_t NUMBER_OF_FRAMES = 10000;
+	VirtualCANPlugin writer("lapped");
+	VirtualCANPlugin reader("lapped");
+	CANMessageFrame frame = {};
+
+	for (std::uint32_t i = 0; i < NUMBER_OF_FRAMES; i++)
+	{
+		frame.identifier = i;
+		EXPECT_TRUE(writer.write_frame(frame));
+	}
+
+	// Like an overflowing receive buffer, only the newest frames are still there, and still in order
+	std::uint32_t framesRead = 0;
+	std::uint32_t lastIdentifier = 0;
+	while (reader.read_frame(frame, 0))
+	{
+		EXPECT_TRUE((0 == framesRead) || (frame.identifier == lastIdentifier + 1));
+		lastIdentifier = frame.identifier;
+		framesRead++;
+	}
+	EXPECT_NE(0u, framesRead);
+	EXPECT_LT(framesRead, NUMBER_OF_FRAMES);
+	EXPECT_EQ(NUMBER_OF_FRAMES - 1, lastIdentifier);
+}
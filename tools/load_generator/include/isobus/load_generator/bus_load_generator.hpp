@@ -0,0 +1,267 @@
+//================================================================================================
+/// @file bus_load_generator.hpp
+///
+/// @brief Simulates many ECUs on a virtual CAN channel, to load a stack under test.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#ifndef BUS_LOAD_GENERATOR_HPP
+#define BUS_LOAD_GENERATOR_HPP
+
+#include "isobus/hardware_integration/virtual_can_plugin.hpp"
+#include "isobus/isobus/can_callbacks.hpp"
+#include "isobus/isobus/can_constants.hpp"
+#include "isobus/isobus/can_internal_control_function.hpp"
+#include "isobus/isobus/can_NAME_filter.hpp"
+#include "isobus/isobus/can_network_manager.hpp"
+#include "isobus/isobus/can_partnered_control_function.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace isobus
+{
+	//================================================================================================
+	/// @class BusLoadGenerator
+	///
+	/// @brief Simulates a number of ECUs on a virtual CAN channel, to see how a stack behaves on a busy bus
+	/// @details Each simulated ECU claims an address, then broadcasts a configurable mix of PGNs at
+	/// configurable rates, starts BAM, CMDT and ETP transfers, and answers requests for the PGNs it broadcasts.
+	/// The ECUs share their own network manager, which is not the default one, and a single thread that
+	/// connects it to a `VirtualCANPlugin` on the chosen channel. Put the stack under test on a `VirtualCANPlugin`
+	/// with the same channel name to load it.
+	///
+	/// The first 8 bytes of every message the generator sends are the time it was sent, from
+	/// `SystemTiming::get_timestamp_us`, so the receiver can measure its latency. See `BusLoadMonitor`.
+	//================================================================================================
+	class BusLoadGenerator
+	{
+	public:
+		/// @brief The kinds of multi-frame transfers the simulated ECUs can start
+		enum class TransferType : std::uint8_t
+		{
+			BroadcastAnnounce, ///< A TP broadcast (BAM) to the global address, up to 1785 bytes
+			ConnectionMode, ///< A destination specific TP (CMDT) transfer, up to 1785 bytes
+			ExtendedConnectionMode ///< A destination specific ETP transfer, more than 1785 bytes
+		};
+
+		/// @brief A message that each simulated ECU sends on an interval
+		struct PeriodicMessage
+		{
+			bool isTransfer; ///< `true` for a multi-frame transfer, `false` for a single frame broadcast
+			TransferType type; ///< How the transfer is sent, single frame broadcasts ignore this
+			std::uint32_t parameterGroupNumber; ///< The PGN of the message
+			std::uint32_t dataLength; ///< The length of the message in bytes
+			std::uint32_t interval_ms; ///< How often each ECU sends the message
+		};
+
+		/// @brief Constructor for the load generator
+		/// @param[in] channelName The name of the virtual CAN channel to simulate the ECUs on
+		explicit BusLoadGenerator(const std::string &channelName = "");
+
+		/// @brief Deleted copy constructor, the generator owns a thread
+		BusLoadGenerator(const BusLoadGenerator &) = delete;
+
+		/// @brief Deleted copy assignment operator
+		/// @returns Nothing, this is deleted
+		BusLoadGenerator &operator=(const BusLoadGenerator &) = delete;
+
+		/// @brief The destructor for the load generator, which stops it
+		~BusLoadGenerator();
+
+		/// @brief Sets how many ECUs to simulate
+		/// @note The function will fail if the generator is running
+		/// @param[in] numberOfControlFunctionsToSimulate The number of ECUs to simulate, between 1 and 120
+		/// @returns `true` if the number was set, otherwise `false`
+		bool set_number_of_control_functions(std::uint8_t numberOfControlFunctionsToSimulate);
+
+		/// @brief Returns how many ECUs are simulated
+		/// @returns The number of simulated ECUs
+		std::uint8_t get_number_of_control_functions() const;
+
+		/// @brief Adds a single frame message that every simulated ECU broadcasts, and answers requests for
+		/// @note The function will fail if the generator is running
+		/// @param[in] parameterGroupNumber The PGN to broadcast
+		/// @param[in] interval_ms How often each ECU sends the message
+		/// @returns `true` if the message was added, otherwise `false`
+		bool add_broadcast_message(std::uint32_t parameterGroupNumber, std::uint32_t interval_ms);
+
+		/// @brief Adds a multi-frame transfer that every simulated ECU starts on an interval
+		/// @details A new transfer is only started once the ECU's last transfer of the same kind has finished,
+		/// so a slow receiver lowers the rate rather than piling up sessions.
+		/// Destination specific transfers go to the control function set with `set_transfer_destination`.
+		/// @note The function will fail if the generator is running
+		/// @param[in] type The kind of transfer
+		/// @param[in] parameterGroupNumber The PGN to send, which must be PDU1 for destination specific transfers
+		/// @param[in] dataLength The length of the message, which must need more than one frame and fit the kind of transfer
+		/// @param[in] interval_ms How often each ECU starts the transfer
+		/// @returns `true` if the transfer was added, otherwise `false`
+		bool add_transfer(TransferType type, std::uint32_t parameterGroupNumber, std::uint32_t dataLength, std::uint32_t interval_ms);
+
+		/// @brief Returns every message and transfer that has been added
+		/// @returns The messages each simulated ECU sends
+		const std::vector<PeriodicMessage> &get_messages() const;
+
+		/// @brief Sets the control function that destination specific transfers go to, usually the stack under test
+		/// @note The function will fail if the generator is running
+		/// @param[in] NAMEFilters The NAME filters that identify the destination
+		/// @returns `true` if the destination was set, otherwise `false`
+		bool set_transfer_destination(const std::vector<NAMEFilter> &NAMEFilters);
+
+		/// @brief Starts the simulation
+		/// @returns `true` if the simulation was started, `false` if it was already running, has nothing to simulate,
+		/// or has destination specific transfers but no destination
+		bool start();
+
+		/// @brief Stops the simulation, and removes the simulated ECUs from the bus
+		/// @details Transfers that are still going are given a few seconds to finish first
+		void stop();
+
+		/// @brief Returns if the simulation is running
+		/// @returns `true` if the simulation is running, otherwise `false`
+		bool get_is_running() const;
+
+		/// @brief Returns how many simulated ECUs have claimed an address
+		/// @returns The number of simulated ECUs with a valid address
+		std::uint8_t get_number_of_claimed_control_functions() const;
+
+		/// @brief Returns the number of messages the simulated ECUs have sent, including finished transfers
+		/// @returns The number of messages sent
+		std::uint64_t get_number_of_messages_sent() const;
+
+		/// @brief Returns the number of messages that couldn't be sent, or whose transfer failed
+		/// @returns The number of messages that failed
+		std::uint64_t get_number_of_messages_failed() const;
+
+		/// @brief Returns the number of requests the simulated ECUs have answered
+		/// @returns The number of requests answered
+		std::uint64_t get_number_of_requests_answered() const;
+
+		/// @brief Returns the number of frames the simulated ECUs have put on the bus
+		/// @returns The number of frames transmitted
+		std::uint64_t get_number_of_frames_transmitted() const;
+
+		/// @brief Returns the CPU time used by the simulation's thread, so it can be told apart from the stack under test's
+		/// @note This is only measured on platforms with per-thread CPU clocks, like Linux, and is `0` elsewhere
+		/// @returns The CPU time used by the simulation in microseconds
+		std::uint64_t get_cpu_time_us() const;
+
+	private:
+		/// @brief The state of one simulated ECU
+		struct SimulatedControlFunction
+		{
+			/// @brief The state of one message or transfer that the ECU sends
+			struct MessageState
+			{
+				BusLoadGenerator *parent; ///< The generator the message belongs to
+				std::uint32_t nextSend_ms; ///< When the message is next due
+				bool inProgress; ///< If `true`, a transfer of this message hasn't finished yet
+			};
+
+			BusLoadGenerator *parent; ///< The generator the ECU belongs to
+			std::shared_ptr<InternalControlFunction> internalControlFunction; ///< The simulated ECU
+			std::vector<MessageState> messageStates; ///< The state of each message in `messages`
+		};
+
+		/// @brief The longest the thread waits for a frame before checking if anything needs to be sent
+		static constexpr std::uint32_t READ_TIMEOUT_MS = 1;
+
+		/// @brief The most frames read from the bus before the network manager is updated, so its receive queue can't overflow
+		static constexpr std::size_t MAX_FRAMES_PER_UPDATE = 64;
+
+		/// @brief The longest `stop` waits for transfers that are still going to finish
+		static constexpr std::uint32_t STOP_TIMEOUT_MS = 3000;
+
+		/// @brief The first address the simulated ECUs try to claim, they are self-configurable addresses
+		static constexpr std::uint8_t FIRST_PREFERRED_ADDRESS = 0x80;
+
+		/// @brief The most ECUs that fit in the self-configurable address range
+		static constexpr std::uint8_t MAX_NUMBER_OF_CONTROL_FUNCTIONS = 120;
+
+		/// @brief The most data a TP session can carry, anything bigger needs ETP
+		static constexpr std::uint32_t MAX_TP_DATA_LENGTH = 1785;
+
+		/// @brief The identity number of the first simulated ECU, the rest count up from it
+		static constexpr std::uint32_t FIRST_IDENTITY_NUMBER = 0x1A0000;
+
+		/// @brief Sends the network manager's frames out on the virtual channel
+		/// @param[in] frame The frame to send
+		/// @param[in] parentPointer The generator
+		/// @returns `true` if the frame was sent, otherwise `false`
+		static bool transmit_frame(const CANMessageFrame &frame, void *parentPointer);
+
+		/// @brief Answers a request for one of the PGNs a simulated ECU broadcasts
+		/// @param[in] parameterGroupNumber The requested PGN
+		/// @param[in] requestingControlFunction The control function that made the request
+		/// @param[out] acknowledge Set to `false`, the response is the message itself
+		/// @param[out] acknowledgeType Not used
+		/// @param[in] parentPointer The simulated ECU that was asked
+		/// @returns `true` if the PGN is one the ECU broadcasts, otherwise `false`
+		static bool process_request(std::uint32_t parameterGroupNumber,
+		                            std::shared_ptr<ControlFunction> requestingControlFunction,
+		                            bool &acknowledge,
+		                            AcknowledgementType &acknowledgeType,
+		                            void *parentPointer);
+
+		/// @brief Counts a transfer that finished, and lets the next one start
+		/// @param[in] parameterGroupNumber The PGN of the transfer
+		/// @param[in] dataLength The length of the transfer
+		/// @param[in] sourceControlFunction The simulated ECU that sent the transfer
+		/// @param[in] destinationControlFunction The destination of the transfer
+		/// @param[in] successful `true` if the transfer was sent, otherwise `false`
+		/// @param[in] parentPointer The `MessageState` of the message that was transferred
+		static void process_transfer_complete(std::uint32_t parameterGroupNumber,
+		                                      std::uint32_t dataLength,
+		                                      std::shared_ptr<InternalControlFunction> sourceControlFunction,
+		                                      std::shared_ptr<ControlFunction> destinationControlFunction,
+		                                      bool successful,
+		                                      void *parentPointer);
+
+		/// @brief Returns if a PGN is PDU1, so it can be sent to a specific destination
+		/// @param[in] parameterGroupNumber The PGN to check
+		/// @returns `true` if the PGN is PDU1, otherwise `false`
+		static bool get_is_pdu1(std::uint32_t parameterGroupNumber);
+
+		/// @brief Sends one of the configured messages from a simulated ECU
+		/// @param[in] controlFunction The simulated ECU to send from
+		/// @param[in] messageIndex The index of the message in `messages`
+		/// @returns `true` if the message was sent or its transfer was started, otherwise `false`
+		bool send_message(SimulatedControlFunction &controlFunction, std::size_t messageIndex);
+
+		/// @brief Returns if any simulated ECU has a transfer that hasn't finished yet
+		/// @returns `true` if a transfer is still going, otherwise `false`
+		bool get_is_any_transfer_in_progress() const;
+
+		/// @brief Passes received frames from the virtual channel to the network manager, then updates it
+		void update_network();
+
+		/// @brief The simulation's thread, which moves frames between the virtual channel and the network manager and sends messages when they are due
+		void worker_thread_function();
+
+		/// @brief Sends every message that is due from every simulated ECU with an address
+		void send_due_messages();
+
+		VirtualCANPlugin plugin; ///< The simulation's connection to the virtual channel
+		CANNetworkManager network; ///< The network manager shared by the simulated ECUs
+		std::vector<PeriodicMessage> messages; ///< The messages each simulated ECU sends
+		std::vector<NAMEFilter> transferDestinationFilters; ///< The NAME filters of the destination for transfers
+		std::shared_ptr<PartneredControlFunction> transferDestination; ///< Where the simulated ECUs send destination specific transfers
+		std::vector<std::unique_ptr<SimulatedControlFunction>> controlFunctions; ///< The simulated ECUs
+		std::vector<std::uint8_t> payload; ///< A buffer to build message data in
+		std::thread workerThread; ///< The simulation's thread
+		std::atomic_bool running = { false }; ///< If `true`, the simulation is running
+		std::atomic<std::uint64_t> messagesSent = { 0 }; ///< The number of messages sent
+		std::atomic<std::uint64_t> messagesFailed = { 0 }; ///< The number of messages that failed
+		std::atomic<std::uint64_t> requestsAnswered = { 0 }; ///< The number of requests answered
+		std::atomic<std::uint64_t> framesTransmitted = { 0 }; ///< The number of frames put on the bus
+		std::atomic<std::uint64_t> cpuTime_us = { 0 }; ///< The CPU time used by the simulation's thread
+		std::uint8_t numberOfControlFunctions = 1; ///< The number of ECUs to simulate
+	};
+} // namespace isobus
+
+#endif // BUS_LOAD_GENERATOR_HPP
@@ -0,0 +1,106 @@
+//================================================================================================
+/// @file bus_load_monitor.hpp
+///
+/// @brief Measures how a stack under test copes with the load from a BusLoadGenerator.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#ifndef BUS_LOAD_MONITOR_HPP
+#define BUS_LOAD_MONITOR_HPP
+
+#include "isobus/isobus/can_message.hpp"
+#include "isobus/isobus/can_network_manager.hpp"
+#include "isobus/load_generator/bus_load_generator.hpp"
+#include "isobus/utility/latency_histogram.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace isobus
+{
+	//================================================================================================
+	/// @class BusLoadMonitor
+	///
+	/// @brief Watches the messages a BusLoadGenerator sends arrive at a stack under test
+	/// @details The monitor adds a callback to the stack's network manager for every PGN the generator sends,
+	/// and measures the time from when the generator sent each message to when the stack called back with it,
+	/// using the timestamp the generator puts in the first 8 bytes. For transfers, that includes the time the
+	/// transfer took. Both ends have to share a clock, so the generator and the stack have to run in the same process.
+	///
+	/// It also keeps track of the messages the stack dropped and the CPU time the process used since
+	/// the monitor was last reset, so the cost of the stack can be found by taking away the generator's.
+	//================================================================================================
+	class BusLoadMonitor
+	{
+	public:
+		/// @brief Constructor for the monitor
+		/// @param[in] networkManager The network manager of the stack under test
+		/// @param[in] canChannel The channel the generator is connected to in the stack under test
+		explicit BusLoadMonitor(CANNetworkManager &networkManager = CANNetworkManager::CANNetwork, std::uint8_t canChannel = 0);
+
+		/// @brief Deleted copy constructor
+		BusLoadMonitor(const BusLoadMonitor &) = delete;
+
+		/// @brief Deleted copy assignment operator
+		/// @returns Nothing, this is deleted
+		BusLoadMonitor &operator=(const BusLoadMonitor &) = delete;
+
+		/// @brief The destructor for the monitor, which removes its callbacks from the network manager
+		~BusLoadMonitor();
+
+		/// @brief Starts watching for the messages a generator sends, and resets the measurements
+		/// @note Add all messages to the generator before calling this
+		/// @param[in] generator The generator to watch
+		void monitor(const BusLoadGenerator &generator);
+
+		/// @brief Removes the monitor's callbacks from the network manager
+		void stop_monitoring();
+
+		/// @brief Clears all measurements, to start measuring again from now
+		void reset();
+
+		/// @brief Returns the number of generated messages the stack has called back with
+		/// @returns The number of messages received
+		std::uint64_t get_number_of_messages_received() const;
+
+		/// @brief Returns the number of frames the stack has dropped on the monitored channel since the last reset
+		/// @returns The number of dropped frames
+		std::uint32_t get_number_of_messages_dropped() const;
+
+		/// @brief Returns the CPU time the whole process has used since the last reset
+		/// @returns The CPU time used, in microseconds
+		std::uint64_t get_process_cpu_time_us() const;
+
+		/// @brief Returns the time since the last reset
+		/// @returns The time since the last reset, in milliseconds
+		std::uint32_t get_elapsed_time_ms() const;
+
+		/// @brief Returns the latencies of single frame messages
+		/// @returns The latencies of single frame messages, in microseconds
+		const LatencyHistogram &get_single_frame_latency() const;
+
+		/// @brief Returns the latencies of messages that were sent with a transport protocol
+		/// @returns The latencies of multi-frame messages, in microseconds
+		const LatencyHistogram &get_multi_frame_latency() const;
+
+	private:
+		/// @brief Measures the latency of a generated message
+		/// @param[in] message The message from the generator
+		/// @param[in] parentPointer The monitor
+		static void process_message(const CANMessage &message, void *parentPointer);
+
+		CANNetworkManager &network; ///< The network manager of the stack under test
+		std::vector<std::uint32_t> monitoredParameterGroupNumbers; ///< The PGNs the monitor has callbacks for
+		LatencyHistogram singleFrameLatency; ///< Latencies of single frame messages
+		LatencyHistogram multiFrameLatency; ///< Latencies of multi-frame messages
+		std::atomic<std::uint64_t> messagesReceived = { 0 }; ///< The number of messages received since the last reset
+		std::uint64_t startCPUTime_us = 0; ///< The process CPU time at the last reset
+		std::uint32_t startDroppedMessages = 0; ///< The number of dropped frames at the last reset
+		std::uint32_t startTimestamp_ms = 0; ///< The time of the last reset
+		const std::uint8_t channel; ///< The channel the generator is connected to
+	};
+} // namespace isobus
+
+#endif // BUS_LOAD_MONITOR_HPP
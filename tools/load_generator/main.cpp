@@ -0,0 +1,284 @@
+#include "isobus/hardware_integration/can_hardware_interface.hpp"
+#include "isobus/hardware_integration/virtual_can_plugin.hpp"
+#include "isobus/isobus/can_internal_control_function.hpp"
+#include "isobus/isobus/can_network_manager.hpp"
+#include "isobus/isobus/can_parameter_group_number_request_protocol.hpp"
+#include "isobus/load_generator/bus_load_generator.hpp"
+#include "isobus/load_generator/bus_load_monitor.hpp"
+#include "isobus/utility/system_timing.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+static std::atomic_bool running = { true };
+
+void signal_handler(int)
+{
+	running = false;
+}
+
+static void print_usage()
+{
+	std::cout << "Usage: isobus_load_generator [options]" << std::endl
+	          << "Simulates ECUs on a virtual CAN channel, and reports how a stack on the same channel copes." << std::endl
+	          << std::endl
+	          << "  --ecus N                Number of ECUs to simulate, 1 to 120 (default 60)" << std::endl
+	          << "  --duration S            Seconds to run for, 0 runs until Ctrl+C (default 10)" << std::endl
+	          << "  --broadcast PGN:MS      Each ECU broadcasts a single frame PGN every MS milliseconds" << std::endl
+	          << "  --bam PGN:LEN:MS        Each ECU broadcasts LEN bytes of PGN with TP every MS milliseconds" << std::endl
+	          << "  --cmdt PGN:LEN:MS       Each ECU sends LEN bytes of PGN to the stack with TP every MS milliseconds" << std::endl
+	          << "  --etp PGN:LEN:MS        Each ECU sends LEN bytes of PGN to the stack with ETP every MS milliseconds" << std::endl
+	          << "  --request-interval MS   The stack requests one of the broadcast PGNs from everyone every MS milliseconds" << std::endl
+	          << "  --channel NAME          The name of the virtual CAN channel (default isobus_load_generator)" << std::endl
+	          << std::endl
+	          << "With no messages given, each ECU sends 0xFEF1:100, 0xF004:20 and a 20 byte BAM of 0xFECA every second." << std::endl;
+}
+
+// Parses "PGN:MS" or "PGN:LEN:MS", where each number can be decimal or 0x hex
+static bool parse_message(const char *argument, bool hasLength, std::uint32_t &parameterGroupNumber, std::uint32_t &dataLength, std::uint32_t &interval_ms)
+{
+	char *end = nullptr;
+	bool retVal = false;
+
+	parameterGroupNumber = static_cast<std::uint32_t>(std::strtoul(argument, &end, 0));
+	if (hasLength && (':' == *end))
+	{
+		dataLength = static_cast<std::uint32_t>(std::strtoul(end + 1, &end, 0));
+	}
+
+	if (':' == *end)
+	{
+		interval_ms = static_cast<std::uint32_t>(std::strtoul(end + 1, &end, 0));
+		retVal = ('\0' == *end);
+	}
+	return retVal;
+}
+
+static void print_latency(const char *label, const isobus::LatencyHistogram &histogram)
+{
+	std::cout << label;
+	if (0 == histogram.get_count())
+	{
+		std::cout << "none received" << std::endl;
+	}
+	else
+	{
+		std::cout << "mean " << histogram.get_mean()
+		          << " us, p50 " << histogram.get_value_at_percentile(50.0)
+		          << " us, p99 " << histogram.get_value_at_percentile(99.0)
+		          << " us, max " << histogram.get_max() << " us" << std::endl;
+	}
+}
+
+int main(int argc, char **argv)
+{
+	constexpr std::uint32_t STACK_IDENTITY_NUMBER = 0x1B0000;
+	std::uint32_t numberOfECUs = 60;
+	std::uint32_t duration_s = 10;
+	std::uint32_t requestInterval_ms = 0;
+	std::string channelName = "isobus_load_generator";
+	std::vector<std::uint32_t> requestableParameterGroupNumbers;
+	std::vector<std::string> messageArguments;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string option = argv[i];
+
+		if (("--help" == option) || ("-h" == option))
+		{
+			print_usage();
+			return 0;
+		}
+		else if (i + 1 >= argc)
+		{
+			std::cout << "Missing a value for " << option << std::endl;
+			print_usage();
+			return -1;
+		}
+		else if ("--ecus" == option)
+		{
+			numberOfECUs = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+		}
+		else if ("--duration" == option)
+		{
+			duration_s = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+		}
+		else if ("--request-interval" == option)
+		{
+			requestInterval_ms = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+		}
+		else if ("--channel" == option)
+		{
+			channelName = argv[++i];
+		}
+		else if (("--broadcast" == option) || ("--bam" == option) || ("--cmdt" == option) || ("--etp" == option))
+		{
+			messageArguments.push_back(option);
+			messageArguments.push_back(argv[++i]);
+		}
+		else
+		{
+			std::cout << "Unknown option " << option << std::endl;
+			print_usage();
+			return -1;
+		}
+	}
+
+	isobus::BusLoadGenerator generator(channelName);
+
+	if ((numberOfECUs > 0xFF) || (!generator.set_number_of_control_functions(static_cast<std::uint8_t>(numberOfECUs))))
+	{
+		std::cout << "The number of ECUs must be between 1 and 120" << std::endl;
+		return -1;
+	}
+
+	if (messageArguments.empty())
+	{
+		generator.add_broadcast_message(0xFEF1, 100);
+		generator.add_broadcast_message(0xF004, 20);
+		generator.add_transfer(isobus::BusLoadGenerator::TransferType::BroadcastAnnounce, 0xFECA, 20, 1000);
+		requestableParameterGroupNumbers = { 0xFEF1, 0xF004 };
+	}
+
+	for (std::size_t i = 0; i < messageArguments.size(); i += 2)
+	{
+		const std::string &option = messageArguments[i];
+		const bool isBroadcast = ("--broadcast" == option);
+		std::uint32_t parameterGroupNumber = 0;
+		std::uint32_t dataLength = 0;
+		std::uint32_t interval_ms = 0;
+		bool added = false;
+
+		if (parse_message(messageArguments[i + 1].c_str(), !isBroadcast, parameterGroupNumber, dataLength, interval_ms))
+		{
+			if (isBroadcast)
+			{
+				added = generator.add_broadcast_message(parameterGroupNumber, interval_ms);
+				requestableParameterGroupNumbers.push_back(parameterGroupNumber);
+			}
+			else if ("--bam" == option)
+			{
+				added = generator.add_transfer(isobus::BusLoadGenerator::TransferType::BroadcastAnnounce, parameterGroupNumber, dataLength, interval_ms);
+			}
+			else if ("--cmdt" == option)
+			{
+				added = generator.add_transfer(isobus::BusLoadGenerator::TransferType::ConnectionMode, parameterGroupNumber, dataLength, interval_ms);
+			}
+			else
+			{
+				added = generator.add_transfer(isobus::BusLoadGenerator::TransferType::ExtendedConnectionMode, parameterGroupNumber, dataLength, interval_ms);
+			}
+		}
+
+		if (!added)
+		{
+			std::cout << "Invalid message " << option << " " << messageArguments[i + 1] << std::endl;
+			print_usage();
+			return -1;
+		}
+	}
+
+	// The stack under test is the default network manager, on its own connection to the virtual channel
+	isobus::CANNetworkManager::CANNetwork.initialize();
+	isobus::CANHardwareInterface::set_number_of_can_channels(1);
+	isobus::CANHardwareInterface::assign_can_channel_frame_handler(0, std::make_shared<isobus::VirtualCANPlugin>(channelName));
+
+	if (!isobus::CANHardwareInterface::start())
+	{
+		std::cout << "Failed to start hardware interface" << std::endl;
+		return -2;
+	}
+
+	isobus::NAME stackNAME(0);
+	stackNAME.set_arbitrary_address_capable(true);
+	stackNAME.set_industry_group(2);
+	stackNAME.set_manufacturer_code(1407);
+	stackNAME.set_identity_number(STACK_IDENTITY_NUMBER);
+	auto stackECU = isobus::InternalControlFunction::create(stackNAME, 0x1C, 0);
+
+	generator.set_transfer_destination({ isobus::NAMEFilter(isobus::NAME::NAMEParameters::IdentityNumber, STACK_IDENTITY_NUMBER),
+	                                     isobus::NAMEFilter(isobus::NAME::NAMEParameters::ManufacturerCode, 1407) });
+
+	std::signal(SIGINT, signal_handler);
+
+	isobus::BusLoadMonitor monitor;
+	monitor.monitor(generator);
+
+	if (!generator.start())
+	{
+		std::cout << "Failed to start the load generator" << std::endl;
+		isobus::CANHardwareInterface::stop();
+		return -3;
+	}
+
+	std::uint32_t lastStatus_ms = isobus::SystemTiming::get_timestamp_ms();
+	std::uint32_t lastRequest_ms = lastStatus_ms;
+	std::size_t nextRequest = 0;
+
+	while (running && ((0 == duration_s) || (monitor.get_elapsed_time_ms() < duration_s * 1000)))
+	{
+		if ((0 != requestInterval_ms) &&
+		    (!requestableParameterGroupNumbers.empty()) &&
+		    stackECU->get_address_valid() &&
+		    isobus::SystemTiming::time_expired_ms(lastRequest_ms, requestInterval_ms))
+		{
+			isobus::ParameterGroupNumberRequestProtocol::request_parameter_group_number(requestableParameterGroupNumbers[nextRequest], stackECU, nullptr);
+			nextRequest = (nextRequest + 1) % requestableParameterGroupNumbers.size();
+			lastRequest_ms = isobus::SystemTiming::get_timestamp_ms();
+		}
+
+		if (isobus::SystemTiming::time_expired_ms(lastStatus_ms, 1000))
+		{
+			std::cout << "[" << (monitor.get_elapsed_time_ms() / 1000) << " s] "
+			          << static_cast<int>(generator.get_number_of_claimed_control_functions()) << " ECUs claimed, "
+			          << generator.get_number_of_frames_transmitted() << " frames sent, "
+			          << monitor.get_number_of_messages_received() << " messages received, "
+			          << monitor.get_number_of_messages_dropped() << " dropped" << std::endl;
+			lastStatus_ms = isobus::SystemTiming::get_timestamp_ms();
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	const std::uint64_t processCPUTime_us = monitor.get_process_cpu_time_us();
+	const std::uint64_t generatorCPUTime_us = generator.get_cpu_time_us();
+	const std::uint32_t elapsed_ms = monitor.get_elapsed_time_ms();
+
+	std::cout << std::endl
+	          << "Ran for " << elapsed_ms << " ms with "
+	          << static_cast<int>(generator.get_number_of_claimed_control_functions()) << " of "
+	          << static_cast<int>(generator.get_number_of_control_functions()) << " ECUs claimed" << std::endl
+	          << "Generator: " << generator.get_number_of_messages_sent() << " messages sent, "
+	          << generator.get_number_of_messages_failed() << " failed, "
+	          << generator.get_number_of_requests_answered() << " requests answered, "
+	          << generator.get_number_of_frames_transmitted() << " frames" << std::endl
+	          << "Stack under test: " << monitor.get_number_of_messages_received() << " messages received, "
+	          << monitor.get_number_of_messages_dropped() << " frames dropped" << std::endl;
+	print_latency("Single frame latency: ", monitor.get_single_frame_latency());
+	print_latency("Multi-frame latency: ", monitor.get_multi_frame_latency());
+
+	if ((0 != generatorCPUTime_us) && (0 != elapsed_ms))
+	{
+		const std::uint64_t stackCPUTime_us = (processCPUTime_us > generatorCPUTime_us) ? (processCPUTime_us - generatorCPUTime_us) : 0;
+		std::cout << "CPU time: " << (processCPUTime_us / 1000) << " ms in total, "
+		          << (generatorCPUTime_us / 1000) << " ms generating, "
+		          << (stackCPUTime_us / 1000) << " ms in the stack under test ("
+		          << std::fixed << std::setprecision(1) << ((static_cast<double>(stackCPUTime_us) / 10.0) / elapsed_ms) << "% of a core)" << std::endl;
+	}
+	else
+	{
+		std::cout << "CPU time: " << (processCPUTime_us / 1000) << " ms in total, including the generator" << std::endl;
+	}
+
+	generator.stop();
+	isobus::CANHardwareInterface::stop();
+	stackECU->destroy();
+	return 0;
+}
@@ -0,0 +1,490 @@
+//================================================================================================
+/// @file bus_load_generator.cpp
+///
+/// @brief Simulates many ECUs on a virtual CAN channel, to load a stack under test.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#include "isobus/load_generator/bus_load_generator.hpp"
+
+#include "isobus/isobus/can_parameter_group_number_request_protocol.hpp"
+#include "isobus/isobus/can_stack_logger.hpp"
+#include "isobus/utility/system_timing.hpp"
+#include "isobus/utility/to_string.hpp"
+
+#include <algorithm>
+#include <ctime>
+
+namespace isobus
+{
+	BusLoadGenerator::BusLoadGenerator(const std::string &channelName) :
+	  plugin(channelName)
+	{
+		network.set_can_frame_transmit_callback(transmit_frame, this);
+		network.get_configuration().set_minimum_time_between_transport_protocol_bam_frames(10);
+		network.initialize();
+	}
+
+	BusLoadGenerator::~BusLoadGenerator()
+	{
+		stop();
+	}
+
+	bool BusLoadGenerator::set_number_of_control_functions(std::uint8_t numberOfControlFunctionsToSimulate)
+	{
+		bool retVal = false;
+
+		if ((!running) &&
+		    (0 != numberOfControlFunctionsToSimulate) &&
+		    (numberOfControlFunctionsToSimulate <= MAX_NUMBER_OF_CONTROL_FUNCTIONS))
+		{
+			numberOfControlFunctions = numberOfControlFunctionsToSimulate;
+			retVal = true;
+		}
+		return retVal;
+	}
+
+	std::uint8_t BusLoadGenerator::get_number_of_control_functions() const
+	{
+		return numberOfControlFunctions;
+	}
+
+	bool BusLoadGenerator::add_broadcast_message(std::uint32_t parameterGroupNumber, std::uint32_t interval_ms)
+	{
+		bool retVal = false;
+
+		if ((!running) &&
+		    (parameterGroupNumber <= 0x3FFFF) &&
+		    (0 != interval_ms))
+		{
+			messages.push_back({ false, TransferType::BroadcastAnnounce, parameterGroupNumber, CAN_DATA_LENGTH, interval_ms });
+			retVal = true;
+		}
+		return retVal;
+	}
+
+	bool BusLoadGenerator::add_transfer(TransferType type, std::uint32_t parameterGroupNumber, std::uint32_t dataLength, std::uint32_t interval_ms)
+	{
+		bool retVal = false;
+
+		if ((!running) &&
+		    (parameterGroupNumber <= 0x3FFFF) &&
+		    (0 != interval_ms))
+		{
+			switch (type)
+			{
+				case TransferType::BroadcastAnnounce:
+				{
+					retVal = ((dataLength > CAN_DATA_LENGTH) && (dataLength <= MAX_TP_DATA_LENGTH));
+				}
+				break;
+
+				case TransferType::ConnectionMode:
+				{
+					retVal = ((dataLength > CAN_DATA_LENGTH) && (dataLength <= MAX_TP_DATA_LENGTH) && get_is_pdu1(parameterGroupNumber));
+				}
+				break;
+
+				case TransferType::ExtendedConnectionMode:
+				{
+					retVal = ((dataLength > MAX_TP_DATA_LENGTH) && (dataLength <= CANMessage::ABSOLUTE_MAX_MESSAGE_LENGTH) && get_is_pdu1(parameterGroupNumber));
+				}
+				break;
+			}
+
+			if (retVal)
+			{
+				messages.push_back({ true, type, parameterGroupNumber, dataLength, interval_ms });
+			}
+		}
+		return retVal;
+	}
+
+	const std::vector<BusLoadGenerator::PeriodicMessage> &BusLoadGenerator::get_messages() const
+	{
+		return messages;
+	}
+
+	bool BusLoadGenerator::set_transfer_destination(const std::vector<NAMEFilter> &NAMEFilters)
+	{
+		bool retVal = false;
+
+		if (!running)
+		{
+			transferDestinationFilters = NAMEFilters;
+			retVal = true;
+		}
+		return retVal;
+	}
+
+	bool BusLoadGenerator::start()
+	{
+		bool retVal = false;
+		std::uint32_t numberOfTransfers = 0;
+		bool needsDestination = false;
+		std::uint32_t largestMessage = 0;
+
+		for (const auto &message : messages)
+		{
+			if (message.isTransfer)
+			{
+				numberOfTransfers++;
+				needsDestination = needsDestination || (TransferType::BroadcastAnnounce != message.type);
+			}
+			largestMessage = std::max(largestMessage, message.dataLength);
+		}
+
+		if (running)
+		{
+			CANStackLogger::error("[LG]: The load generator is already running");
+		}
+		else if (needsDestination && transferDestinationFilters.empty())
+		{
+			CANStackLogger::error("[LG]: Destination specific transfers need a destination, set one with set_transfer_destination");
+		}
+		else
+		{
+			// Each ECU only has one session per transfer at a time, so this makes sure none of them are ever turned away
+			const std::uint32_t maxSessions = numberOfControlFunctions * numberOfTransfers;
+			if (maxSessions > network.get_configuration().get_max_number_transport_protocol_sessions())
+			{
+				network.get_configuration().set_max_number_transport_protocol_sessions(maxSessions);
+			}
+
+			payload.resize(std::max(largestMessage, static_cast<std::uint32_t>(CAN_DATA_LENGTH)));
+			for (std::size_t i = 0; i < payload.size(); i++)
+			{
+				payload[i] = static_cast<std::uint8_t>(i);
+			}
+
+			if (needsDestination)
+			{
+				transferDestination = PartneredControlFunction::create(0, transferDestinationFilters, network);
+			}
+
+			const std::uint32_t now = SystemTiming::get_timestamp_ms();
+			for (std::uint8_t i = 0; i < numberOfControlFunctions; i++)
+			{
+				NAME controlFunctionNAME(0);
+				controlFunctionNAME.set_arbitrary_address_capable(true);
+				controlFunctionNAME.set_industry_group(2);
+				controlFunctionNAME.set_manufacturer_code(1407);
+				controlFunctionNAME.set_identity_number(FIRST_IDENTITY_NUMBER + i);
+
+				std::unique_ptr<SimulatedControlFunction> controlFunction(new SimulatedControlFunction());
+				controlFunction->parent = this;
+				controlFunction->internalControlFunction = InternalControlFunction::create(controlFunctionNAME, FIRST_PREFERRED_ADDRESS + i, 0, network);
+				controlFunction->messageStates.resize(messages.size());
+
+				for (std::size_t j = 0; j < messages.size(); j++)
+				{
+					// Spread the ECUs out over each interval, so they don't all send at once
+					controlFunction->messageStates[j].parent = this;
+					controlFunction->messageStates[j].nextSend_ms = now + ((messages[j].interval_ms * i) / numberOfControlFunctions);
+					controlFunction->messageStates[j].inProgress = false;
+
+					if (!messages[j].isTransfer)
+					{
+						if (auto pgnRequestProtocol = controlFunction->internalControlFunction->get_pgn_request_protocol().lock())
+						{
+							pgnRequestProtocol->register_pgn_request_callback(messages[j].parameterGroupNumber, process_request, controlFunction.get());
+						}
+					}
+				}
+				controlFunctions.push_back(std::move(controlFunction));
+			}
+
+			messagesSent = 0;
+			messagesFailed = 0;
+			requestsAnswered = 0;
+			framesTransmitted = 0;
+			cpuTime_us = 0;
+			plugin.open();
+			running = true;
+			workerThread = std::thread([this]() { worker_thread_function(); });
+			CANStackLogger::info("[LG]: Simulating " + isobus::to_string(static_cast<int>(numberOfControlFunctions)) + " ECUs on virtual channel \"" + plugin.get_channel_name() + "\"");
+			retVal = true;
+		}
+		return retVal;
+	}
+
+	void BusLoadGenerator::stop()
+	{
+		if (running)
+		{
+			running = false;
+			workerThread.join();
+
+			// Let transfers that are still going finish, so no session outlives the control functions it refers to
+			const std::uint32_t stopTimestamp_ms = SystemTiming::get_timestamp_ms();
+			while (get_is_any_transfer_in_progress() && !SystemTiming::time_expired_ms(stopTimestamp_ms, STOP_TIMEOUT_MS))
+			{
+				update_network();
+			}
+			plugin.close();
+
+			for (auto &controlFunction : controlFunctions)
+			{
+				if (auto pgnRequestProtocol = controlFunction->internalControlFunction->get_pgn_request_protocol().lock())
+				{
+					for (const auto &message : messages)
+					{
+						if (!message.isTransfer)
+						{
+							pgnRequestProtocol->remove_pgn_request_callback(message.parameterGroupNumber, process_request, controlFunction.get());
+						}
+					}
+				}
+				controlFunction->internalControlFunction->destroy();
+			}
+			controlFunctions.clear();
+
+			if (nullptr != transferDestination)
+			{
+				transferDestination->destroy();
+				transferDestination.reset();
+			}
+		}
+	}
+
+	bool BusLoadGenerator::get_is_running() const
+	{
+		return running;
+	}
+
+	std::uint8_t BusLoadGenerator::get_number_of_claimed_control_functions() const
+	{
+		std::uint8_t retVal = 0;
+
+		for (const auto &controlFunction : controlFunctions)
+		{
+			if (controlFunction->internalControlFunction->get_address_valid())
+			{
+				retVal++;
+			}
+		}
+		return retVal;
+	}
+
+	std::uint64_t BusLoadGenerator::get_number_of_messages_sent() const
+	{
+		return messagesSent;
+	}
+
+	std::uint64_t BusLoadGenerator::get_number_of_messages_failed() const
+	{
+		return messagesFailed;
+	}
+
+	std::uint64_t BusLoadGenerator::get_number_of_requests_answered() const
+	{
+		return requestsAnswered;
+	}
+
+	std::uint64_t BusLoadGenerator::get_number_of_frames_transmitted() const
+	{
+		return framesTransmitted;
+	}
+
+	std::uint64_t BusLoadGenerator::get_cpu_time_us() const
+	{
+		return cpuTime_us;
+	}
+
+	bool BusLoadGenerator::transmit_frame(const CANMessageFrame &frame, void *parentPointer)
+	{
+		auto generator = static_cast<BusLoadGenerator *>(parentPointer);
+		bool retVal = generator->plugin.write_frame(frame);
+
+		if (retVal)
+		{
+			generator->framesTransmitted++;
+		}
+		return retVal;
+	}
+
+	bool BusLoadGenerator::process_request(std::uint32_t parameterGroupNumber,
+	                                       std::shared_ptr<ControlFunction>,
+	                                       bool &acknowledge,
+	                                       AcknowledgementType &,
+	                                       void *parentPointer)
+	{
+		auto controlFunction = static_cast<SimulatedControlFunction *>(parentPointer);
+		BusLoadGenerator *generator = controlFunction->parent;
+		bool retVal = false;
+
+		// The answer to a request is the message itself
+		acknowledge = false;
+
+		for (std::size_t i = 0; i < generator->messages.size(); i++)
+		{
+			if ((!generator->messages[i].isTransfer) &&
+			    (parameterGroupNumber == generator->messages[i].parameterGroupNumber))
+			{
+				if (generator->send_message(*controlFunction, i))
+				{
+					generator->requestsAnswered++;
+				}
+				retVal = true;
+				break;
+			}
+		}
+		return retVal;
+	}
+
+	void BusLoadGenerator::process_transfer_complete(std::uint32_t,
+	                                                 std::uint32_t,
+	                                                 std::shared_ptr<InternalControlFunction>,
+	                                                 std::shared_ptr<ControlFunction>,
+	                                                 bool successful,
+	                                                 void *parentPointer)
+	{
+		auto messageState = static_cast<SimulatedControlFunction::MessageState *>(parentPointer);
+
+		if (successful)
+		{
+			messageState->parent->messagesSent++;
+		}
+		else
+		{
+			messageState->parent->messagesFailed++;
+		}
+		messageState->inProgress = false;
+	}
+
+	bool BusLoadGenerator::get_is_pdu1(std::uint32_t parameterGroupNumber)
+	{
+		return (((parameterGroupNumber >> 8) & 0xFF) < 0xF0);
+	}
+
+	bool BusLoadGenerator::send_message(SimulatedControlFunction &controlFunction, std::size_t messageIndex)
+	{
+		const PeriodicMessage &message = messages[messageIndex];
+		const std::uint64_t timestamp_us = SystemTiming::get_timestamp_us();
+		bool retVal = false;
+
+		for (std::uint8_t i = 0; i < CAN_DATA_LENGTH; i++)
+		{
+			payload[i] = static_cast<std::uint8_t>(timestamp_us >> (8 * i));
+		}
+
+		if (!message.isTransfer)
+		{
+			retVal = network.send_can_message(message.parameterGroupNumber, payload.data(), message.dataLength, controlFunction.internalControlFunction);
+
+			if (retVal)
+			{
+				messagesSent++;
+			}
+		}
+		else
+		{
+			SimulatedControlFunction::MessageState &state = controlFunction.messageStates[messageIndex];
+			std::shared_ptr<ControlFunction> destination = nullptr;
+
+			if (TransferType::BroadcastAnnounce != message.type)
+			{
+				destination = transferDestination;
+			}
+
+			state.inProgress = true;
+			retVal = network.send_can_message(message.parameterGroupNumber,
+			                                  payload.data(),
+			                                  message.dataLength,
+			                                  controlFunction.internalControlFunction,
+			                                  destination,
+			                                  CANIdentifier::CANPriority::PriorityLowest7,
+			                                  process_transfer_complete,
+			                                  &state);
+
+			if (!retVal)
+			{
+				state.inProgress = false;
+			}
+		}
+
+		if (!retVal)
+		{
+			messagesFailed++;
+		}
+		return retVal;
+	}
+
+	bool BusLoadGenerator::get_is_any_transfer_in_progress() const
+	{
+		bool retVal = false;
+
+		for (const auto &controlFunction : controlFunctions)
+		{
+			for (const auto &state : controlFunction->messageStates)
+			{
+				retVal = retVal || state.inProgress;
+			}
+		}
+		return retVal;
+	}
+
+	void BusLoadGenerator::update_network()
+	{
+		CANMessageFrame frame = {};
+
+		for (std::size_t i = 0; (i < MAX_FRAMES_PER_UPDATE) && plugin.read_frame(frame, READ_TIMEOUT_MS); i++)
+		{
+			frame.channel = 0;
+			network.on_can_frame_received(frame);
+		}
+		network.update();
+	}
+
+	void BusLoadGenerator::worker_thread_function()
+	{
+		while (running)
+		{
+			update_network();
+			send_due_messages();
+
+#ifdef CLOCK_THREAD_CPUTIME_ID
+			timespec threadCPUTime;
+			if (0 == clock_gettime(CLOCK_THREAD_CPUTIME_ID, &threadCPUTime))
+			{
+				cpuTime_us = (static_cast<std::uint64_t>(threadCPUTime.tv_sec) * 1000000) + (static_cast<std::uint64_t>(threadCPUTime.tv_nsec) / 1000);
+			}
+#endif
+		}
+	}
+
+	void BusLoadGenerator::send_due_messages()
+	{
+		const bool destinationReady = ((nullptr != transferDestination) && transferDestination->get_address_valid());
+		const std::uint32_t now = SystemTiming::get_timestamp_ms();
+
+		for (auto &controlFunction : controlFunctions)
+		{
+			if (!controlFunction->internalControlFunction->get_address_valid())
+			{
+				continue;
+			}
+
+			for (std::size_t i = 0; i < messages.size(); i++)
+			{
+				SimulatedControlFunction::MessageState &state = controlFunction->messageStates[i];
+				const std::uint32_t interval_ms = messages[i].interval_ms;
+
+				if ((!state.inProgress) &&
+				    (static_cast<std::int32_t>(now - state.nextSend_ms) >= 0) &&
+				    ((!messages[i].isTransfer) || (TransferType::BroadcastAnnounce == messages[i].type) || destinationReady))
+				{
+					send_message(*controlFunction, i);
+
+					// If we've fallen more than an interval behind, skip ahead rather than sending a burst to catch up
+					state.nextSend_ms += interval_ms;
+					if (static_cast<std::int32_t>(now - state.nextSend_ms) >= 0)
+					{
+						state.nextSend_ms = now + interval_ms;
+					}
+				}
+			}
+		}
+	}
+} // namespace isobus
@@ -0,0 +1,118 @@
+//================================================================================================
+/// @file bus_load_monitor.cpp
+///
+/// @brief Measures how a stack under test copes with the load from a BusLoadGenerator.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#include "isobus/load_generator/bus_load_monitor.hpp"
+
+#include "isobus/isobus/can_constants.hpp"
+#include "isobus/utility/system_timing.hpp"
+
+#include <algorithm>
+#include <ctime>
+
+namespace isobus
+{
+	BusLoadMonitor::BusLoadMonitor(CANNetworkManager &networkManager, std::uint8_t canChannel) :
+	  network(networkManager),
+	  channel(canChannel)
+	{
+		reset();
+	}
+
+	BusLoadMonitor::~BusLoadMonitor()
+	{
+		stop_monitoring();
+	}
+
+	void BusLoadMonitor::monitor(const BusLoadGenerator &generator)
+	{
+		stop_monitoring();
+
+		for (const auto &message : generator.get_messages())
+		{
+			if (monitoredParameterGroupNumbers.end() == std::find(monitoredParameterGroupNumbers.begin(), monitoredParameterGroupNumbers.end(), message.parameterGroupNumber))
+			{
+				monitoredParameterGroupNumbers.push_back(message.parameterGroupNumber);
+				network.add_any_control_function_parameter_group_number_callback(message.parameterGroupNumber, process_message, this);
+			}
+		}
+		reset();
+	}
+
+	void BusLoadMonitor::stop_monitoring()
+	{
+		for (const auto parameterGroupNumber : monitoredParameterGroupNumbers)
+		{
+			network.remove_any_control_function_parameter_group_number_callback(parameterGroupNumber, process_message, this);
+		}
+		monitoredParameterGroupNumbers.clear();
+	}
+
+	void BusLoadMonitor::reset()
+	{
+		singleFrameLatency.reset();
+		multiFrameLatency.reset();
+		messagesReceived = 0;
+		startCPUTime_us = static_cast<std::uint64_t>((static_cast<double>(std::clock()) * 1000000.0) / CLOCKS_PER_SEC);
+		startDroppedMessages = network.get_number_rx_messages_dropped(channel);
+		startTimestamp_ms = SystemTiming::get_timestamp_ms();
+	}
+
+	std::uint64_t BusLoadMonitor::get_number_of_messages_received() const
+	{
+		return messagesReceived;
+	}
+
+	std::uint32_t BusLoadMonitor::get_number_of_messages_dropped() const
+	{
+		return network.get_number_rx_messages_dropped(channel) - startDroppedMessages;
+	}
+
+	std::uint64_t BusLoadMonitor::get_process_cpu_time_us() const
+	{
+		const auto cpuTime_us = static_cast<std::uint64_t>((static_cast<double>(std::clock()) * 1000000.0) / CLOCKS_PER_SEC);
+		return cpuTime_us - startCPUTime_us;
+	}
+
+	std::uint32_t BusLoadMonitor::get_elapsed_time_ms() const
+	{
+		return SystemTiming::get_time_elapsed_ms(startTimestamp_ms);
+	}
+
+	const LatencyHistogram &BusLoadMonitor::get_single_frame_latency() const
+	{
+		return singleFrameLatency;
+	}
+
+	const LatencyHistogram &BusLoadMonitor::get_multi_frame_latency() const
+	{
+		return multiFrameLatency;
+	}
+
+	void BusLoadMonitor::process_message(const CANMessage &message, void *parentPointer)
+	{
+		auto monitor = static_cast<BusLoadMonitor *>(parentPointer);
+
+		if ((message.get_data_length() >= CAN_DATA_LENGTH) &&
+		    (monitor->channel == message.get_can_port_index()))
+		{
+			const std::uint64_t sent_us = message.get_uint64_at(0);
+			const std::uint64_t now_us = SystemTiming::get_timestamp_us();
+			const std::uint64_t latency_us = (now_us > sent_us) ? (now_us - sent_us) : 0;
+
+			if (message.get_data_length() > CAN_DATA_LENGTH)
+			{
+				monitor->multiFrameLatency.record(latency_us);
+			}
+			else
+			{
+				monitor->singleFrameLatency.record(latency_us);
+			}
+			monitor->messagesReceived++;
+		}
+	}
+} // namespace isobus
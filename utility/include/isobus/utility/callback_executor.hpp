@@ -0,0 +1,141 @@
+//================================================================================================
+/// @file callback_executor.hpp
+///
+/// @brief Runs application callbacks away from the thread that updates the CAN stack.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#ifndef CALLBACK_EXECUTOR_HPP
+#define CALLBACK_EXECUTOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace isobus
+{
+	//================================================================================================
+	/// @class CallbackExecutor
+	///
+	/// @brief A bounded queue of callbacks that are run by a set of worker threads
+	/// @details Every callback is posted for a subscriber, and all callbacks for the same subscriber
+	/// always go to the same worker, so they run one at a time in the order they were posted.
+	/// Callbacks for different subscribers may run at the same time on different workers.
+	/// An executor without any worker threads just queues callbacks until run_pending is called,
+	/// which lets an application run them on a thread of its own choosing.
+	/// When threads are disabled, the executor never has any workers.
+	//================================================================================================
+	class CallbackExecutor
+	{
+	public:
+		static constexpr std::size_t DEFAULT_QUEUE_LIMIT = 1024; ///< The default maximum number of callbacks waiting to run
+
+		/// @brief Constructs an executor without any worker threads
+		CallbackExecutor();
+
+		/// @brief Stops and joins all worker threads, after they finish the callbacks already queued for them
+		~CallbackExecutor();
+
+		/// @brief Deleted copy constructor
+		CallbackExecutor(const CallbackExecutor &) = delete;
+
+		/// @brief Deleted copy assignment operator
+		/// @returns Nothing, this is deleted
+		CallbackExecutor &operator=(const CallbackExecutor &) = delete;
+
+		/// @brief Changes the number of worker threads
+		/// @details Callbacks that are already queued are moved to their new worker in order, so ordering is kept.
+		/// If run_pending is running on another thread, this waits for it to finish first.
+		/// @note Must not be called from inside a callback run by run_pending or wait_until_idle
+		/// @param[in] numberOfThreads The number of worker threads to run
+		void set_number_of_threads(std::size_t numberOfThreads);
+
+		/// @brief Returns the number of worker threads
+		/// @returns The number of worker threads
+		std::size_t get_number_of_threads() const;
+
+		/// @brief Sets the maximum number of callbacks that can be waiting to run at once
+		/// @param[in] maximumQueuedCallbacks The maximum number of queued callbacks, must be at least 1
+		/// @returns `true` if the limit was changed, otherwise `false`
+		bool set_queue_limit(std::size_t maximumQueuedCallbacks);
+
+		/// @brief Returns the maximum number of callbacks that can be waiting to run at once
+		/// @returns The maximum number of queued callbacks
+		std::size_t get_queue_limit() const;
+
+		/// @brief Queues a callback to be run by the worker that handles a subscriber
+		/// @param[in] subscriber Identifies who the callback is for, callbacks with the same subscriber run in order
+		/// @param[in] callback The callback to run
+		/// @returns `true` if the callback was queued, `false` if the queue was full and it was dropped
+		bool post(const void *subscriber, std::function<void()> callback);
+
+		/// @brief Runs all queued callbacks on the calling thread
+		/// @details Only does anything when the executor has no worker threads.
+		/// @note Only one thread at a time should call this
+		/// @returns The number of callbacks that were run
+		std::size_t run_pending();
+
+		/// @brief Waits until every queued callback has finished running
+		/// @details If the executor has no worker threads, the callbacks are run on the calling thread instead.
+		/// @param[in] timeout_ms The longest time to wait in milliseconds
+		/// @returns `true` if all callbacks finished, `false` if the timeout expired first
+		bool wait_until_idle(std::uint32_t timeout_ms);
+
+		/// @brief Returns the number of callbacks that are queued or running
+		/// @returns The number of callbacks that haven't finished yet
+		std::size_t get_number_pending() const;
+
+		/// @brief Returns the number of callbacks that were dropped because the queue was full
+		/// @returns The number of dropped callbacks
+		std::size_t get_number_dropped() const;
+
+	private:
+		/// @brief A callback waiting to run, and who it is for
+		struct QueuedCallback
+		{
+			const void *subscriber; ///< The subscriber the callback was posted for
+			std::function<void()> callback; ///< The callback to run
+		};
+
+		/// @brief Returns the queue that a subscriber's callbacks go in
+		/// @param[in] subscriber The subscriber to find the queue of
+		/// @returns The index of the subscriber's queue
+		std::size_t get_lane_index(const void *subscriber) const;
+
+		/// @brief Runs every callback that is queued in any lane on the calling thread
+		/// @returns The number of callbacks that were run
+		std::size_t run_all_lanes();
+
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		/// @brief The loop each worker thread runs until the executor is stopped
+		/// @param[in] laneIndex The queue of callbacks the worker runs
+		void worker_thread_function(std::size_t laneIndex);
+
+		/// @brief Stops and joins all worker threads, after they finish the callbacks already queued for them
+		void stop_threads();
+
+		std::vector<std::thread> workerThreads; ///< The worker threads, one for each lane
+		mutable std::mutex executorMutex; ///< Protects the queues and counters
+		std::condition_variable callbackAvailableCondition; ///< Wakes the workers when a callback is posted or the executor stops
+		std::condition_variable idleCondition; ///< Wakes threads waiting for all callbacks to finish
+		bool stopRequested = false; ///< Tells the workers to exit once their lane is empty
+		bool runningAllLanes = false; ///< Stores if run_all_lanes is running callbacks, which stops the lanes from being replaced
+#endif
+		std::vector<std::deque<QueuedCallback>> lanes; ///< The queued callbacks, one queue per worker
+		std::size_t queueLimit = DEFAULT_QUEUE_LIMIT; ///< The maximum number of callbacks waiting to run
+		std::size_t numberOfPendingCallbacks = 0; ///< The number of callbacks that are queued or running
+		std::size_t numberOfDroppedCallbacks = 0; ///< The number of callbacks dropped because the queue was full
+	};
+} // namespace isobus
+
+#endif // CALLBACK_EXECUTOR_HPP
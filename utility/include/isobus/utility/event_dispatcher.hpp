@@ -9,6 +9,8 @@
 #ifndef EVENT_DISPATCHER_HPP
 #define EVENT_DISPATCHER_HPP
 
+#include "isobus/utility/callback_executor.hpp"
+
 #include <algorithm>
 #include <functional>
 #include <memory>
@@ -42,6 +44,22 @@ namespace isobus
 			return shared;
 		}
 
+		/// @brief Register a callback to be run on an executor when the event is invoked.
+		/// @details The event's arguments are copied and the callback is posted to the executor, so it runs
+		/// on one of the executor's threads in the same order as the events. If the executor's queue is full, the event is dropped for this listener.
+		/// Events that were already posted still run after the listener is removed.
+		/// @param callback The callback to register.
+		/// @param executor The executor to run the callback on, which must outlive the listener.
+		/// @return A shared pointer to the callback.
+		std::shared_ptr<std::function<void(const E &...)>> add_listener(const std::function<void(const E &...)> &callback, CallbackExecutor &executor)
+		{
+			auto subscriber = std::make_shared<std::function<void(const E &...)>>(callback);
+			std::function<void(const E &...)> callbackWrapper = [subscriber, &executor](const E &...args) {
+				executor.post(subscriber.get(), std::bind([subscriber](const E &...copiedArgs) { (*subscriber)(copiedArgs...); }, args...));
+			};
+			return add_listener(callbackWrapper);
+		}
+
 		/// @brief Register a callback to be invoked when the event is invoked.
 		/// @param callback The callback to register.
 		/// @param context The context object to pass through to the callback.
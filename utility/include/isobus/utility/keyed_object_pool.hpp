@@ -0,0 +1,336 @@
+//================================================================================================
+/// @file keyed_object_pool.hpp
+///
+/// @brief A slab allocated pool of objects that can be looked up by a key in constant time.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#ifndef KEYED_OBJECT_POOL_HPP
+#define KEYED_OBJECT_POOL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace isobus
+{
+	//================================================================================================
+	/// @class KeyedObjectPool
+	///
+	/// @brief A fixed capacity pool of objects, each stored under a unique key.
+	/// @details Objects are constructed in place in slabs of preallocated storage, so creating and
+	/// destroying them never touches the heap once the pool has been sized with reserve().
+	/// Objects never move once they are created, so pointers to them stay valid until they are destroyed.
+	/// Lookups by key use an open addressing hash table, so they don't get slower as more objects are added.
+	/// @note This class is not thread safe
+	//================================================================================================
+	template<typename T, typename Key, typename KeyHash = std::hash<Key>>
+	class KeyedObjectPool
+	{
+	public:
+		/// @brief Constructs an empty pool with no capacity
+		KeyedObjectPool() = default;
+
+		/// @brief Destroys any objects still in the pool
+		~KeyedObjectPool()
+		{
+			clear();
+		}
+
+		/// @brief Deleted copy constructor
+		KeyedObjectPool(const KeyedObjectPool &) = delete;
+
+		/// @brief Deleted copy assignment operator
+		/// @returns Nothing, this is deleted
+		KeyedObjectPool &operator=(const KeyedObjectPool &) = delete;
+
+		/// @brief Makes sure the pool can hold at least the requested number of objects
+		/// @details The pool only ever grows. Growing adds a new slab, so existing objects are not moved.
+		/// @param[in] requestedCapacity The number of objects the pool needs to be able to hold
+		void reserve(std::size_t requestedCapacity)
+		{
+			if (requestedCapacity > slots.size())
+			{
+				const std::size_t oldCapacity = slots.size();
+				const std::size_t slabSize = requestedCapacity - oldCapacity;
+				std::unique_ptr<Slot[]> slab(new Slot[slabSize]);
+
+				slots.reserve(requestedCapacity);
+				freeSlots.reserve(requestedCapacity);
+				for (std::size_t i = 0; i < slabSize; i++)
+				{
+					slots.push_back(&slab[i]);
+				}
+
+				// Hand out the lowest indices first
+				for (std::size_t i = requestedCapacity; i > oldCapacity; i--)
+				{
+					freeSlots.push_back(i - 1);
+				}
+				slabs.push_back(std::move(slab));
+				rebuild_index();
+			}
+		}
+
+		/// @brief Makes sure the pool has room for one more object, doubling its capacity if it is full
+		/// @details Doubling keeps the number of slabs and index rebuilds logarithmic when the pool keeps growing one object at a time.
+		/// @param[in] minimumCapacity The smallest capacity the pool should have
+		void reserve_for_one_more(std::size_t minimumCapacity)
+		{
+			if (numberOfObjects >= slots.size())
+			{
+				reserve(std::max(minimumCapacity, 2 * slots.size()));
+			}
+			else
+			{
+				reserve(minimumCapacity);
+			}
+		}
+
+		/// @brief Constructs a new object in the pool
+		/// @param[in] key The key to store the object under, which must not already be in use
+		/// @param[in] args The arguments to forward to the object's constructor
+		/// @returns Pointer to the new object, or `nullptr` if the pool is full or the key is already in use
+		template<typename... Args>
+		T *create(const Key &key, Args &&...args)
+		{
+			T *retVal = nullptr;
+
+			if ((!freeSlots.empty()) &&
+			    (nullptr == find(key)))
+			{
+				const std::size_t slotIndex = freeSlots.back();
+				Slot *slot = slots[slotIndex];
+
+				retVal = new (&slot->storage) T(std::forward<Args>(args)...);
+				freeSlots.pop_back();
+				slot->key = key;
+				slot->inUse = true;
+				insert_into_index(slotIndex);
+				numberOfObjects++;
+			}
+			return retVal;
+		}
+
+		/// @brief Destroys an object and returns its storage to the pool
+		/// @param[in] object The object to destroy, which must have been created by this pool
+		/// @returns `true` if the object was in the pool and was destroyed, otherwise `false`
+		bool destroy(const T *object)
+		{
+			bool retVal = false;
+
+			if (nullptr != object)
+			{
+				// Objects are the first member of their slot, so the slot's key can be looked up in the index directly
+				const Slot *slot = reinterpret_cast<const Slot *>(object);
+				const std::size_t slotIndex = find_slot_index(slot->key);
+
+				if ((EMPTY_BUCKET != slotIndex) &&
+				    (slot == slots[slotIndex]))
+				{
+					remove_from_index(slotIndex);
+					slots[slotIndex]->inUse = false;
+					slots[slotIndex]->get()->~T();
+					freeSlots.push_back(slotIndex);
+					numberOfObjects--;
+					retVal = true;
+				}
+			}
+			return retVal;
+		}
+
+		/// @brief Finds the object stored under a key
+		/// @param[in] key The key to look for
+		/// @returns Pointer to the object, or `nullptr` if no object is stored under that key
+		T *find(const Key &key) const
+		{
+			const std::size_t slotIndex = find_slot_index(key);
+			return (EMPTY_BUCKET != slotIndex) ? slots[slotIndex]->get() : nullptr;
+		}
+
+		/// @brief Calls a function on every object in the pool
+		/// @details It is safe for the function to destroy the object it was called with, or to create
+		/// new objects, which may or may not be visited by this call.
+		/// @param[in] function A callable that accepts a `T *`
+		template<typename Function>
+		void for_each(Function &&function)
+		{
+			for (std::size_t i = 0; i < slots.size(); i++)
+			{
+				if (slots[i]->inUse)
+				{
+					function(slots[i]->get());
+				}
+			}
+		}
+
+		/// @brief Calls a function on every object in the pool
+		/// @param[in] function A callable that accepts a `const T *`
+		template<typename Function>
+		void for_each(Function &&function) const
+		{
+			for (std::size_t i = 0; i < slots.size(); i++)
+			{
+				if (slots[i]->inUse)
+				{
+					function(static_cast<const T *>(slots[i]->get()));
+				}
+			}
+		}
+
+		/// @brief Destroys every object in the pool, but keeps the storage
+		void clear()
+		{
+			for (std::size_t i = 0; i < slots.size(); i++)
+			{
+				if (slots[i]->inUse)
+				{
+					slots[i]->inUse = false;
+					slots[i]->get()->~T();
+					freeSlots.push_back(i);
+				}
+			}
+			numberOfObjects = 0;
+			rebuild_index();
+		}
+
+		/// @brief Returns the number of objects in the pool
+		/// @returns The number of objects in the pool
+		std::size_t size() const
+		{
+			return numberOfObjects;
+		}
+
+		/// @brief Returns if there are no objects in the pool
+		/// @returns `true` if the pool has no objects in it, otherwise `false`
+		bool empty() const
+		{
+			return 0 == numberOfObjects;
+		}
+
+		/// @brief Returns the maximum number of objects the pool can currently hold
+		/// @returns The capacity of the pool
+		std::size_t capacity() const
+		{
+			return slots.size();
+		}
+
+	private:
+		static constexpr std::size_t EMPTY_BUCKET = static_cast<std::size_t>(-1); ///< Marks an unused bucket in the index
+
+		/// @brief Storage for one object and the key it is stored under
+		struct Slot
+		{
+			/// @brief Returns a pointer to the object in this slot
+			/// @returns Pointer to the object in this slot
+			T *get()
+			{
+				return reinterpret_cast<T *>(&storage);
+			}
+
+			typename std::aligned_storage<sizeof(T), alignof(T)>::type storage; ///< Uninitialized storage for the object, which must stay the first member so destroy() can find the slot
+			Key key = Key(); ///< The key the object is stored under
+			bool inUse = false; ///< Tracks if an object is currently constructed in this slot
+		};
+
+		/// @brief Finds the slot an object is stored in by its key
+		/// @param[in] key The key to look for
+		/// @returns The index of the slot, or `EMPTY_BUCKET` if no object is stored under that key
+		std::size_t find_slot_index(const Key &key) const
+		{
+			std::size_t retVal = EMPTY_BUCKET;
+
+			if (!index.empty())
+			{
+				for (std::size_t bucket = KeyHash()(key) & indexMask; EMPTY_BUCKET != index[bucket]; bucket = (bucket + 1) & indexMask)
+				{
+					if (key == slots[index[bucket]]->key)
+					{
+						retVal = index[bucket];
+						break;
+					}
+				}
+			}
+			return retVal;
+		}
+
+		/// @brief Recreates the index from the slots that are in use, sized for the current capacity
+		void rebuild_index()
+		{
+			std::size_t numberOfBuckets = 1;
+
+			// Keep the load factor at or below one half so probe sequences stay short
+			while (numberOfBuckets < (2 * slots.size()))
+			{
+				numberOfBuckets <<= 1;
+			}
+			index.assign(numberOfBuckets, EMPTY_BUCKET);
+			indexMask = numberOfBuckets - 1;
+
+			for (std::size_t i = 0; i < slots.size(); i++)
+			{
+				if (slots[i]->inUse)
+				{
+					insert_into_index(i);
+				}
+			}
+		}
+
+		/// @brief Adds a slot to the index under its key
+		/// @param[in] slotIndex The slot to add
+		void insert_into_index(std::size_t slotIndex)
+		{
+			std::size_t bucket = KeyHash()(slots[slotIndex]->key) & indexMask;
+
+			while (EMPTY_BUCKET != index[bucket])
+			{
+				bucket = (bucket + 1) & indexMask;
+			}
+			index[bucket] = slotIndex;
+		}
+
+		/// @brief Removes a slot from the index, shifting back any entries that probed past it
+		/// @param[in] slotIndex The slot to remove
+		void remove_from_index(std::size_t slotIndex)
+		{
+			std::size_t bucket = KeyHash()(slots[slotIndex]->key) & indexMask;
+
+			while (slotIndex != index[bucket])
+			{
+				bucket = (bucket + 1) & indexMask;
+			}
+			index[bucket] = EMPTY_BUCKET;
+
+			for (std::size_t next = (bucket + 1) & indexMask; EMPTY_BUCKET != index[next]; next = (next + 1) & indexMask)
+			{
+				const std::size_t home = KeyHash()(slots[index[next]]->key) & indexMask;
+
+				// Move the entry into the hole if the hole lies between its home bucket and where it is now
+				if (((next - home) & indexMask) >= ((next - bucket) & indexMask))
+				{
+					index[bucket] = index[next];
+					index[next] = EMPTY_BUCKET;
+					bucket = next;
+				}
+			}
+		}
+
+		std::vector<std::unique_ptr<Slot[]>> slabs; ///< The blocks of storage the slots live in
+		std::vector<Slot *> slots; ///< Every slot in every slab, in order
+		std::vector<std::size_t> freeSlots; ///< The indices of slots that are not in use
+		std::vector<std::size_t> index; ///< Open addressing hash table of slot indices
+		std::size_t indexMask = 0; ///< Mask to convert a hash into a bucket in the index
+		std::size_t numberOfObjects = 0; ///< The number of objects currently in the pool
+	};
+
+	template<typename T, typename Key, typename KeyHash>
+	constexpr std::size_t KeyedObjectPool<T, Key, KeyHash>::EMPTY_BUCKET;
+} // namespace isobus
+
+#endif // KEYED_OBJECT_POOL_HPP
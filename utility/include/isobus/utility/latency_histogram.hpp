@@ -0,0 +1,100 @@
+//================================================================================================
+/// @file latency_histogram.hpp
+///
+/// @brief A fixed-size, lock-free histogram for recording durations and other positive values.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace isobus
+{
+	//================================================================================================
+	/// @class LatencyHistogram
+	///
+	/// @brief Records values into log-linear buckets, like an HDR histogram
+	/// @details Every power of two range is split into 16 equal buckets, so any value up to the
+	/// full 64 bit range is recorded with a relative error of at most 1/16th, using a fixed amount of memory.
+	/// Recording a value only updates a few atomic counters, so values can be recorded from any number of
+	/// threads while others read the histogram. Reads may be slightly out of step with each other while values are still being recorded.
+	//================================================================================================
+	class LatencyHistogram
+	{
+	public:
+		/// @brief Constructs an empty histogram
+		LatencyHistogram() = default;
+
+		/// @brief Deleted copy constructor
+		LatencyHistogram(const LatencyHistogram &) = delete;
+
+		/// @brief Deleted copy assignment operator
+		/// @returns Nothing, this is deleted
+		LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+		/// @brief Adds a value to the histogram
+		/// @param[in] value The value to add, usually a duration in microseconds
+		void record(std::uint64_t value);
+
+		/// @brief Returns the number of values that have been recorded
+		/// @returns The number of values that have been recorded since the histogram was last reset
+		std::uint64_t get_count() const;
+
+		/// @brief Returns the smallest recorded value
+		/// @returns The smallest recorded value, or `0` if nothing has been recorded
+		std::uint64_t get_min() const;
+
+		/// @brief Returns the largest recorded value
+		/// @returns The largest recorded value, or `0` if nothing has been recorded
+		std::uint64_t get_max() const;
+
+		/// @brief Returns the average of the recorded values
+		/// @returns The average of the recorded values, or `0` if nothing has been recorded
+		std::uint64_t get_mean() const;
+
+		/// @brief Returns the value that a percentage of the recorded values are less than or equal to
+		/// @details The result is the highest value that falls in the same bucket, but never more than the largest recorded value.
+		/// @param[in] percentile The percentage of values to include, from 0 to 100
+		/// @returns The value at the percentile, or `0` if nothing has been recorded
+		std::uint64_t get_value_at_percentile(double percentile) const;
+
+		/// @brief Clears all recorded values
+		/// @note Values recorded while the histogram is being reset may be partly lost
+		void reset();
+
+	private:
+		/// @brief The number of bits of each value that select a bucket within its power of two range
+		static constexpr std::uint32_t SUB_BUCKET_BITS = 4;
+
+		/// @brief The number of buckets in each power of two range
+		static constexpr std::uint32_t SUB_BUCKET_COUNT = (1 << SUB_BUCKET_BITS);
+
+		/// @brief The number of buckets needed to cover every 64 bit value
+		static constexpr std::size_t NUMBER_OF_BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+		/// @brief Returns the bucket a value is counted in
+		/// @param[in] value The value to find the bucket of
+		/// @returns The index of the value's bucket
+		static std::size_t get_bucket_index(std::uint64_t value);
+
+		/// @brief Returns the highest value that is counted in a bucket
+		/// @param[in] bucketIndex The index of the bucket
+		/// @returns The highest value of the bucket
+		static std::uint64_t get_bucket_highest_value(std::size_t bucketIndex);
+
+		std::array<std::atomic<std::uint64_t>, NUMBER_OF_BUCKETS> bucketCounts = {}; ///< The number of values recorded in each bucket
+		std::atomic<std::uint64_t> totalCount = { 0 }; ///< The number of values recorded
+		std::atomic<std::uint64_t> totalSum = { 0 }; ///< The sum of all recorded values, used for the mean
+		std::atomic<std::uint64_t> minimumValue = { std::numeric_limits<std::uint64_t>::max() }; ///< The smallest recorded value
+		std::atomic<std::uint64_t> maximumValue = { 0 }; ///< The largest recorded value
+	};
+} // namespace isobus
+
+#endif // LATENCY_HISTOGRAM_HPP
@@ -0,0 +1,220 @@
+//================================================================================================
+/// @file spsc_ring_buffer.hpp
+///
+/// @brief A bounded, preallocated, lock-free single-producer/single-consumer ring buffer.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#ifndef SPSC_RING_BUFFER_HPP
+#define SPSC_RING_BUFFER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace isobus
+{
+	//================================================================================================
+	/// @class SPSCRingBuffer
+	///
+	/// @brief A fixed capacity FIFO that is safe to use from exactly one producer thread
+	/// and exactly one consumer thread at the same time without any locking.
+	/// @details All storage is allocated when the buffer is constructed, so pushing and popping
+	/// never touch the heap. Items are constructed in place when pushed and destroyed when consumed,
+	/// so the stored type only needs to be constructible, not assignable.
+	/// When the buffer is full, new items are rejected and counted as overflows.
+	//================================================================================================
+	template<typename T>
+	class SPSCRingBuffer
+	{
+	public:
+		/// @brief Constructs the ring buffer
+		/// @param[in] requestedCapacity The minimum number of items the buffer must hold.
+		/// This is rounded up to the next power of two.
+		explicit SPSCRingBuffer(std::size_t requestedCapacity) :
+		  bufferCapacity(round_up_to_power_of_two(requestedCapacity)),
+		  indexMask(bufferCapacity - 1),
+		  storage(new Slot[bufferCapacity])
+		{
+		}
+
+		/// @brief Destroys any items still in the buffer
+		~SPSCRingBuffer()
+		{
+			clear();
+		}
+
+		/// @brief Deleted copy constructor
+		SPSCRingBuffer(const SPSCRingBuffer &) = delete;
+
+		/// @brief Deleted copy assignment operator
+		/// @returns Nothing, this is deleted
+		SPSCRingBuffer &operator=(const SPSCRingBuffer &) = delete;
+
+		/// @brief Constructs an item in place at the back of the buffer. Producer side only.
+		/// @param[in] args The arguments to forward to the item's constructor
+		/// @returns `true` if the item was added, `false` if the buffer was full
+		template<typename... Args>
+		bool emplace(Args &&...args)
+		{
+			const std::size_t currentHead = head.load(std::memory_order_relaxed);
+
+			if ((currentHead - cachedTail) >= bufferCapacity)
+			{
+				cachedTail = tail.load(std::memory_order_acquire);
+
+				if ((currentHead - cachedTail) >= bufferCapacity)
+				{
+					overflowCount.fetch_add(1, std::memory_order_relaxed);
+					return false;
+				}
+			}
+			new (slot_at(currentHead)) T(std::forward<Args>(args)...);
+			head.store(currentHead + 1, std::memory_order_release);
+			return true;
+		}
+
+		/// @brief Copies an item into the back of the buffer. Producer side only.
+		/// @param[in] item The item to add
+		/// @returns `true` if the item was added, `false` if the buffer was full
+		bool push(const T &item)
+		{
+			return emplace(item);
+		}
+
+		/// @brief Moves an item into the back of the buffer. Producer side only.
+		/// @param[in] item The item to add
+		/// @returns `true` if the item was added, `false` if the buffer was full
+		bool push(T &&item)
+		{
+			return emplace(std::move(item));
+		}
+
+		/// @brief Processes items from the front of the buffer in place. Consumer side only.
+		/// @details Only items that were already in the buffer when this is called are processed,
+		/// so a busy producer cannot starve the caller. Space is handed back to the
+		/// producer once per batch rather than once per item.
+		/// @param[in] handler A callable that accepts a `T &` for each item
+		/// @param[in] maxItems The maximum number of items to process in this batch
+		/// @returns The number of items that were processed
+		template<typename Handler>
+		std::size_t consume(Handler &&handler, std::size_t maxItems)
+		{
+			const std::size_t currentTail = tail.load(std::memory_order_relaxed);
+			const std::size_t available = head.load(std::memory_order_acquire) - currentTail;
+			const std::size_t count = (available < maxItems) ? available : maxItems;
+
+			for (std::size_t i = 0; i < count; i++)
+			{
+				T *item = slot_at(currentTail + i);
+				handler(*item);
+				item->~T();
+			}
+
+			if (0 != count)
+			{
+				tail.store(currentTail + count, std::memory_order_release);
+			}
+			return count;
+		}
+
+		/// @brief Processes every item that is currently in the buffer. Consumer side only.
+		/// @param[in] handler A callable that accepts a `T &` for each item
+		/// @returns The number of items that were processed
+		template<typename Handler>
+		std::size_t consume_all(Handler &&handler)
+		{
+			return consume(std::forward<Handler>(handler), bufferCapacity);
+		}
+
+		/// @brief Moves the item at the front of the buffer out of the buffer. Consumer side only.
+		/// @param[out] item The item that was removed
+		/// @returns `true` if an item was removed, `false` if the buffer was empty
+		bool pop(T &item)
+		{
+			return 1 == consume([&item](T &front) { item = std::move(front); }, 1);
+		}
+
+		/// @brief Destroys all items in the buffer. Consumer side only.
+		void clear()
+		{
+			consume_all([](T &) {});
+		}
+
+		/// @brief Returns the number of items in the buffer
+		/// @note This is only a snapshot if the other side is active at the same time
+		/// @returns The number of items in the buffer
+		std::size_t size() const
+		{
+			return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+		}
+
+		/// @brief Returns if the buffer is empty
+		/// @note This is only a snapshot if the other side is active at the same time
+		/// @returns `true` if the buffer has no items in it
+		bool empty() const
+		{
+			return 0 == size();
+		}
+
+		/// @brief Returns the maximum number of items the buffer can hold
+		/// @returns The capacity of the buffer
+		std::size_t capacity() const
+		{
+			return bufferCapacity;
+		}
+
+		/// @brief Returns the number of items that were rejected because the buffer was full
+		/// @returns The number of items that could not be added to the buffer
+		std::uint32_t get_overflow_count() const
+		{
+			return overflowCount.load(std::memory_order_relaxed);
+		}
+
+	private:
+		/// @brief Uninitialized storage for a single item
+		using Slot = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+		static constexpr std::size_t CACHE_LINE_SIZE = 64; ///< Used to keep the producer and consumer indices from sharing a cache line
+
+		/// @brief Rounds a value up to the next power of two, with a minimum of 1
+		/// @param[in] value The value to round
+		/// @returns The rounded value
+		static std::size_t round_up_to_power_of_two(std::size_t value)
+		{
+			std::size_t retVal = 1;
+
+			while (retVal < value)
+			{
+				retVal <<= 1;
+			}
+			return retVal;
+		}
+
+		/// @brief Returns a pointer to the item storage for a free-running index
+		/// @param[in] index The free-running index
+		/// @returns Pointer to the storage for that index
+		T *slot_at(std::size_t index) const
+		{
+			return reinterpret_cast<T *>(&storage[index & indexMask]);
+		}
+
+		const std::size_t bufferCapacity; ///< The number of slots in the buffer, always a power of two
+		const std::size_t indexMask; ///< Mask to convert a free-running index into a slot index
+		const std::unique_ptr<Slot[]> storage; ///< The preallocated item storage
+
+		char consumerPadding[CACHE_LINE_SIZE]; ///< Keeps the consumer index off the cache line of the read-only members
+		std::atomic<std::size_t> tail = { 0 }; ///< Free-running index of the next item to consume, written by the consumer
+		char producerPadding[CACHE_LINE_SIZE]; ///< Keeps the producer index off the consumer's cache line
+		std::atomic<std::size_t> head = { 0 }; ///< Free-running index of the next slot to fill, written by the producer
+		std::size_t cachedTail = 0; ///< The producer's last known value of the consumer index
+		std::atomic<std::uint32_t> overflowCount = { 0 }; ///< The number of items rejected because the buffer was full
+	};
+} // namespace isobus
+
+#endif // SPSC_RING_BUFFER_HPP
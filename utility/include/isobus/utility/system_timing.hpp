@@ -23,6 +23,8 @@ namespace isobus
 		static bool time_expired_ms(std::uint32_t timestamp_ms, std::uint32_t timeout_ms);
 		static bool time_expired_us(std::uint64_t timestamp_us, std::uint64_t timeout_us);
 
+		static std::uint32_t get_time_remaining_ms(std::uint32_t timestamp_ms, std::uint32_t timeout_ms);
+
 	private:
 		static std::uint32_t incrementing_difference(std::uint32_t currentValue, std::uint32_t previousValue);
 		static std::uint64_t incrementing_difference(std::uint64_t currentValue, std::uint64_t previousValue);
@@ -0,0 +1,87 @@
+//================================================================================================
+/// @file thread_pool.hpp
+///
+/// @brief A small pool of worker threads for running independent pieces of work in parallel.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace isobus
+{
+	//================================================================================================
+	/// @class ThreadPool
+	///
+	/// @brief Runs a batch of tasks across a fixed set of worker threads and the calling thread.
+	/// @details The calling thread always takes part in the work, so a pool with no workers
+	/// just runs every task on the calling thread. When threads are disabled, the pool never has any workers.
+	/// @note Only one thread at a time should call run_parallel
+	//================================================================================================
+	class ThreadPool
+	{
+	public:
+		/// @brief Constructs a pool without any worker threads
+		ThreadPool() = default;
+
+		/// @brief Stops and joins all worker threads
+		~ThreadPool();
+
+		/// @brief Deleted copy constructor
+		ThreadPool(const ThreadPool &) = delete;
+
+		/// @brief Deleted copy assignment operator
+		/// @returns Nothing, this is deleted
+		ThreadPool &operator=(const ThreadPool &) = delete;
+
+		/// @brief Changes the number of worker threads, not counting the thread that calls run_parallel
+		/// @param[in] numberOfThreads The number of worker threads to run
+		void set_number_of_threads(std::size_t numberOfThreads);
+
+		/// @brief Returns the number of worker threads, not counting the thread that calls run_parallel
+		/// @returns The number of worker threads
+		std::size_t get_number_of_threads() const;
+
+		/// @brief Calls a function once for each task index, spread across the pool, and waits for all of them to finish
+		/// @param[in] numberOfTasks The number of tasks to run, the function is called with indices 0 to numberOfTasks - 1
+		/// @param[in] task The function to call for each task index
+		void run_parallel(std::size_t numberOfTasks, const std::function<void(std::size_t)> &task);
+
+	private:
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		/// @brief The loop each worker thread runs until the pool is stopped
+		void worker_thread_function();
+
+		/// @brief Runs tasks from the current batch until there are none left to start
+		/// @param[in] lock The lock on the pool's mutex, which is released while tasks run
+		void run_tasks(std::unique_lock<std::mutex> &lock);
+
+		/// @brief Stops and joins all worker threads
+		void stop_threads();
+
+		std::vector<std::thread> workerThreads; ///< The worker threads
+		std::mutex poolMutex; ///< Protects the current batch of tasks
+		std::condition_variable workAvailableCondition; ///< Wakes the workers when a batch starts or the pool stops
+		std::condition_variable workCompleteCondition; ///< Wakes the calling thread when the last task of a batch finishes
+		const std::function<void(std::size_t)> *currentTask = nullptr; ///< The function being run by the current batch
+		std::size_t numberOfTasksInBatch = 0; ///< The number of tasks in the current batch
+		std::size_t nextTaskIndex = 0; ///< The next task index in the current batch that hasn't been started
+		std::size_t numberOfTasksRunning = 0; ///< The number of tasks that have been started but haven't finished
+		bool stopRequested = false; ///< Tells the workers to exit
+#endif
+	};
+} // namespace isobus
+
+#endif // THREAD_POOL_HPP
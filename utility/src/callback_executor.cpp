@@ -0,0 +1,266 @@
+//================================================================================================
+/// @file callback_executor.cpp
+///
+/// @brief Runs application callbacks away from the thread that updates the CAN stack.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#include "isobus/utility/callback_executor.hpp"
+
+#include <cstdint>
+
+namespace isobus
+{
+	CallbackExecutor::CallbackExecutor() :
+	  lanes(1)
+	{
+	}
+
+	CallbackExecutor::~CallbackExecutor()
+	{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		stop_threads();
+#endif
+	}
+
+	void CallbackExecutor::set_number_of_threads(std::size_t numberOfThreads)
+	{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		if (numberOfThreads != workerThreads.size())
+		{
+			stop_threads();
+
+			{
+				std::unique_lock<std::mutex> lock(executorMutex);
+
+				// run_pending may be part way through the lanes on another thread, so wait for it before replacing them
+				while (runningAllLanes)
+				{
+					idleCondition.wait_for(lock, std::chrono::milliseconds(100));
+				}
+				std::vector<std::deque<QueuedCallback>> oldLanes(std::move(lanes));
+
+				// Anything still queued (only possible without workers) moves to its subscriber's new lane, keeping its order
+				stopRequested = false;
+				lanes.clear();
+				lanes.resize((0 != numberOfThreads) ? numberOfThreads : 1);
+				for (auto &oldLane : oldLanes)
+				{
+					for (auto &queuedCallback : oldLane)
+					{
+						lanes[get_lane_index(queuedCallback.subscriber)].push_back(std::move(queuedCallback));
+					}
+				}
+			}
+
+			for (std::size_t i = 0; i < numberOfThreads; i++)
+			{
+				workerThreads.emplace_back(&CallbackExecutor::worker_thread_function, this, i);
+			}
+		}
+#else
+		(void)numberOfThreads;
+#endif
+	}
+
+	std::size_t CallbackExecutor::get_number_of_threads() const
+	{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		return workerThreads.size();
+#else
+		return 0;
+#endif
+	}
+
+	bool CallbackExecutor::set_queue_limit(std::size_t maximumQueuedCallbacks)
+	{
+		bool retVal = false;
+
+		if (0 != maximumQueuedCallbacks)
+		{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+			const std::lock_guard<std::mutex> lock(executorMutex);
+#endif
+			queueLimit = maximumQueuedCallbacks;
+			retVal = true;
+		}
+		return retVal;
+	}
+
+	std::size_t CallbackExecutor::get_queue_limit() const
+	{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		const std::lock_guard<std::mutex> lock(executorMutex);
+#endif
+		return queueLimit;
+	}
+
+	bool CallbackExecutor::post(const void *subscriber, std::function<void()> callback)
+	{
+		bool retVal = false;
+
+		if (nullptr != callback)
+		{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+			std::unique_lock<std::mutex> lock(executorMutex);
+#endif
+			if (numberOfPendingCallbacks < queueLimit)
+			{
+				QueuedCallback queuedCallback;
+				queuedCallback.subscriber = subscriber;
+				queuedCallback.callback = std::move(callback);
+				lanes[get_lane_index(subscriber)].push_back(std::move(queuedCallback));
+				numberOfPendingCallbacks++;
+				retVal = true;
+			}
+			else
+			{
+				numberOfDroppedCallbacks++;
+			}
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+			lock.unlock();
+
+			if (retVal)
+			{
+				callbackAvailableCondition.notify_all();
+			}
+#endif
+		}
+		return retVal;
+	}
+
+	std::size_t CallbackExecutor::run_pending()
+	{
+		std::size_t retVal = 0;
+
+		if (0 == get_number_of_threads())
+		{
+			retVal = run_all_lanes();
+		}
+		return retVal;
+	}
+
+	bool CallbackExecutor::wait_until_idle(std::uint32_t timeout_ms)
+	{
+		bool retVal = true;
+
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		if (workerThreads.empty())
+		{
+			run_all_lanes();
+		}
+		else
+		{
+			std::unique_lock<std::mutex> lock(executorMutex);
+			retVal = idleCondition.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]() { return 0 == numberOfPendingCallbacks; });
+		}
+#else
+		(void)timeout_ms;
+		run_all_lanes();
+#endif
+		return retVal;
+	}
+
+	std::size_t CallbackExecutor::get_number_pending() const
+	{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		const std::lock_guard<std::mutex> lock(executorMutex);
+#endif
+		return numberOfPendingCallbacks;
+	}
+
+	std::size_t CallbackExecutor::get_number_dropped() const
+	{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		const std::lock_guard<std::mutex> lock(executorMutex);
+#endif
+		return numberOfDroppedCallbacks;
+	}
+
+	std::size_t CallbackExecutor::get_lane_index(const void *subscriber) const
+	{
+		// Subscribers are usually aligned object pointers, so mix all of the bits before picking a lane
+		std::uint64_t key = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(subscriber));
+		key ^= (key >> 33);
+		key *= 0xFF51AFD7ED558CCDULL;
+		key ^= (key >> 33);
+		return static_cast<std::size_t>(key % lanes.size());
+	}
+
+	std::size_t CallbackExecutor::run_all_lanes()
+	{
+		std::size_t retVal = 0;
+
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		std::unique_lock<std::mutex> lock(executorMutex);
+		runningAllLanes = true;
+#endif
+		for (auto &lane : lanes)
+		{
+			while (!lane.empty())
+			{
+				std::function<void()> callback = std::move(lane.front().callback);
+				lane.pop_front();
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+				lock.unlock();
+				callback();
+				lock.lock();
+#else
+				callback();
+#endif
+				numberOfPendingCallbacks--;
+				retVal++;
+			}
+		}
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		runningAllLanes = false;
+		idleCondition.notify_all();
+#endif
+		return retVal;
+	}
+
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+	void CallbackExecutor::worker_thread_function(std::size_t laneIndex)
+	{
+		std::unique_lock<std::mutex> lock(executorMutex);
+
+		while ((!stopRequested) || (!lanes[laneIndex].empty()))
+		{
+			if (lanes[laneIndex].empty())
+			{
+				callbackAvailableCondition.wait_for(lock, std::chrono::milliseconds(1000), [this, laneIndex]() { return (stopRequested) || (!lanes[laneIndex].empty()); });
+			}
+			else
+			{
+				std::function<void()> callback = std::move(lanes[laneIndex].front().callback);
+				lanes[laneIndex].pop_front();
+				lock.unlock();
+				callback();
+				lock.lock();
+				numberOfPendingCallbacks--;
+
+				if (0 == numberOfPendingCallbacks)
+				{
+					idleCondition.notify_all();
+				}
+			}
+		}
+	}
+
+	void CallbackExecutor::stop_threads()
+	{
+		{
+			const std::lock_guard<std::mutex> lock(executorMutex);
+			stopRequested = true;
+		}
+		callbackAvailableCondition.notify_all();
+
+		for (auto &thread : workerThreads)
+		{
+			thread.join();
+		}
+		workerThreads.clear();
+	}
+#endif
+} // namespace isobus
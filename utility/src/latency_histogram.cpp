@@ -0,0 +1,152 @@
+//================================================================================================
+/// @file latency_histogram.cpp
+///
+/// @brief A fixed-size, lock-free histogram for recording durations and other positive values.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#include "isobus/utility/latency_histogram.hpp"
+
+#include <cmath>
+#include <limits>
+
+namespace isobus
+{
+	void LatencyHistogram::record(std::uint64_t value)
+	{
+		bucketCounts[get_bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+		totalSum.fetch_add(value, std::memory_order_relaxed);
+
+		std::uint64_t currentMinimum = minimumValue.load(std::memory_order_relaxed);
+		while ((value < currentMinimum) &&
+		       (!minimumValue.compare_exchange_weak(currentMinimum, value, std::memory_order_relaxed)))
+		{
+		}
+
+		std::uint64_t currentMaximum = maximumValue.load(std::memory_order_relaxed);
+		while ((value > currentMaximum) &&
+		       (!maximumValue.compare_exchange_weak(currentMaximum, value, std::memory_order_relaxed)))
+		{
+		}
+
+		// Counted last, so that anything which sees the count also sees the value in the buckets
+		totalCount.fetch_add(1, std::memory_order_release);
+	}
+
+	std::uint64_t LatencyHistogram::get_count() const
+	{
+		return totalCount.load(std::memory_order_acquire);
+	}
+
+	std::uint64_t LatencyHistogram::get_min() const
+	{
+		std::uint64_t retVal = 0;
+
+		if (0 != get_count())
+		{
+			retVal = minimumValue.load(std::memory_order_relaxed);
+		}
+		return retVal;
+	}
+
+	std::uint64_t LatencyHistogram::get_max() const
+	{
+		return maximumValue.load(std::memory_order_relaxed);
+	}
+
+	std::uint64_t LatencyHistogram::get_mean() const
+	{
+		const std::uint64_t count = get_count();
+		std::uint64_t retVal = 0;
+
+		if (0 != count)
+		{
+			retVal = totalSum.load(std::memory_order_relaxed) / count;
+		}
+		return retVal;
+	}
+
+	std::uint64_t LatencyHistogram::get_value_at_percentile(double percentile) const
+	{
+		const std::uint64_t count = get_count();
+		std::uint64_t retVal = 0;
+
+		if (0 != count)
+		{
+			const double clampedPercentile = (percentile < 0.0) ? 0.0 : ((percentile > 100.0) ? 100.0 : percentile);
+			std::uint64_t targetCount = static_cast<std::uint64_t>(std::ceil((clampedPercentile / 100.0) * static_cast<double>(count)));
+			std::uint64_t countSoFar = 0;
+
+			if (0 == targetCount)
+			{
+				targetCount = 1;
+			}
+
+			retVal = get_max();
+			for (std::size_t i = 0; i < NUMBER_OF_BUCKETS; i++)
+			{
+				countSoFar += bucketCounts[i].load(std::memory_order_relaxed);
+
+				if (countSoFar >= targetCount)
+				{
+					const std::uint64_t bucketHighestValue = get_bucket_highest_value(i);
+
+					if (bucketHighestValue < retVal)
+					{
+						retVal = bucketHighestValue;
+					}
+					break;
+				}
+			}
+		}
+		return retVal;
+	}
+
+	void LatencyHistogram::reset()
+	{
+		totalCount = 0;
+		for (auto &bucketCount : bucketCounts)
+		{
+			bucketCount = 0;
+		}
+		totalSum = 0;
+		minimumValue = std::numeric_limits<std::uint64_t>::max();
+		maximumValue = 0;
+	}
+
+	std::size_t LatencyHistogram::get_bucket_index(std::uint64_t value)
+	{
+		std::size_t retVal = static_cast<std::size_t>(value);
+
+		if (value >= SUB_BUCKET_COUNT)
+		{
+			// Find the most significant bit, the bits below it pick the bucket within its power of two range
+			std::uint32_t mostSignificantBit = 0;
+			for (std::uint32_t step = 32; 0 != step; step >>= 1)
+			{
+				if (0 != (value >> (mostSignificantBit + step)))
+				{
+					mostSignificantBit += step;
+				}
+			}
+
+			const std::uint32_t shift = mostSignificantBit - SUB_BUCKET_BITS;
+			retVal = ((shift + 1) * SUB_BUCKET_COUNT) + static_cast<std::size_t>((value >> shift) - SUB_BUCKET_COUNT);
+		}
+		return retVal;
+	}
+
+	std::uint64_t LatencyHistogram::get_bucket_highest_value(std::size_t bucketIndex)
+	{
+		std::uint64_t retVal = bucketIndex;
+
+		if (bucketIndex >= SUB_BUCKET_COUNT)
+		{
+			const std::uint32_t shift = static_cast<std::uint32_t>(bucketIndex / SUB_BUCKET_COUNT) - 1;
+			const std::uint64_t lowestValue = static_cast<std::uint64_t>((bucketIndex % SUB_BUCKET_COUNT) + SUB_BUCKET_COUNT) << shift;
+			retVal = lowestValue + ((static_cast<std::uint64_t>(1) << shift) - 1);
+		}
+		return retVal;
+	}
+} // namespace isobus
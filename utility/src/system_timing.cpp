@@ -47,6 +47,12 @@ namespace isobus
 		return (get_time_elapsed_us(timestamp_us) >= timeout_us);
 	}
 
+	std::uint32_t SystemTiming::get_time_remaining_ms(std::uint32_t timestamp_ms, std::uint32_t timeout_ms)
+	{
+		std::uint32_t elapsedTime_ms = get_time_elapsed_ms(timestamp_ms);
+		return (elapsedTime_ms >= timeout_ms) ? 0 : (timeout_ms - elapsedTime_ms);
+	}
+
 	std::uint32_t SystemTiming::incrementing_difference(std::uint32_t currentValue, std::uint32_t previousValue)
 	{
 		std::uint32_t retVal;
@@ -0,0 +1,128 @@
+//================================================================================================
+/// @file thread_pool.cpp
+///
+/// @brief A small pool of worker threads for running independent pieces of work in parallel.
+/// @author Adrian Del Grosso
+///
+/// @copyright 2023 Adrian Del Grosso
+//================================================================================================
+#include "isobus/utility/thread_pool.hpp"
+
+namespace isobus
+{
+	ThreadPool::~ThreadPool()
+	{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		stop_threads();
+#endif
+	}
+
+	void ThreadPool::set_number_of_threads(std::size_t numberOfThreads)
+	{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		if (numberOfThreads != workerThreads.size())
+		{
+			stop_threads();
+			stopRequested = false;
+
+			for (std::size_t i = 0; i < numberOfThreads; i++)
+			{
+				workerThreads.emplace_back(&ThreadPool::worker_thread_function, this);
+			}
+		}
+#else
+		(void)numberOfThreads;
+#endif
+	}
+
+	std::size_t ThreadPool::get_number_of_threads() const
+	{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		return workerThreads.size();
+#else
+		return 0;
+#endif
+	}
+
+	void ThreadPool::run_parallel(std::size_t numberOfTasks, const std::function<void(std::size_t)> &task)
+	{
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+		if ((workerThreads.empty()) || (numberOfTasks < 2))
+		{
+			for (std::size_t i = 0; i < numberOfTasks; i++)
+			{
+				task(i);
+			}
+		}
+		else
+		{
+			std::unique_lock<std::mutex> lock(poolMutex);
+			currentTask = &task;
+			numberOfTasksInBatch = numberOfTasks;
+			nextTaskIndex = 0;
+			workAvailableCondition.notify_all();
+
+			run_tasks(lock);
+			while (0 != numberOfTasksRunning)
+			{
+				workCompleteCondition.wait_for(lock, std::chrono::milliseconds(1000), [this]() { return 0 == numberOfTasksRunning; });
+			}
+			currentTask = nullptr;
+		}
+#else
+		for (std::size_t i = 0; i < numberOfTasks; i++)
+		{
+			task(i);
+		}
+#endif
+	}
+
+#if !defined CAN_STACK_DISABLE_THREADS && !defined ARDUINO
+	void ThreadPool::worker_thread_function()
+	{
+		std::unique_lock<std::mutex> lock(poolMutex);
+
+		while (!stopRequested)
+		{
+			workAvailableCondition.wait_for(lock, std::chrono::milliseconds(1000), [this]() { return (stopRequested) || (nextTaskIndex < numberOfTasksInBatch); });
+			run_tasks(lock);
+		}
+	}
+
+	void ThreadPool::run_tasks(std::unique_lock<std::mutex> &lock)
+	{
+		while ((!stopRequested) && (nextTaskIndex < numberOfTasksInBatch))
+		{
+			const std::function<void(std::size_t)> &task = *currentTask;
+			const std::size_t taskIndex = nextTaskIndex;
+
+			nextTaskIndex++;
+			numberOfTasksRunning++;
+			lock.unlock();
+			task(taskIndex);
+			lock.lock();
+			numberOfTasksRunning--;
+
+			if ((0 == numberOfTasksRunning) && (nextTaskIndex >= numberOfTasksInBatch))
+			{
+				workCompleteCondition.notify_all();
+			}
+		}
+	}
+
+	void ThreadPool::stop_threads()
+	{
+		{
+			const std::lock_guard<std::mutex> lock(poolMutex);
+			stopRequested = true;
+		}
+		workAvailableCondition.notify_all();
+
+		for (auto &thread : workerThreads)
+		{
+			thread.join();
+		}
+		workerThreads.clear();
+	}
+#endif
+} // namespace isobus